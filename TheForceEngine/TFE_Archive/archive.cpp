@@ -1,4 +1,5 @@
 #include <cstring>
+#include <cctype>
 
 #include "archive.h"
 #include "gobArchive.h"
@@ -9,6 +10,7 @@
 #include <assert.h>
 #include <string>
 #include <map>
+#include <algorithm>
 
 namespace
 {
@@ -176,3 +178,94 @@ void Archive::deleteCustomArchive(Archive* archive)
 	}
 	delete archive;
 }
+
+// FNV-1a using the same case folding as strcasecmp().
+u32 Archive::hashFileName(const char* file)
+{
+	u32 hash = 2166136261u;
+	for (const u8* c = (const u8*)file; *c; c++)
+	{
+		hash ^= u32(tolower(*c));
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+void Archive::buildFileIndex()
+{
+	const u32 count = getFileCount();
+	// Keep the load factor at or below 50%.
+	u32 capacity = 16;
+	while (capacity < count * 2) { capacity <<= 1; }
+
+	m_fileIndex.assign(capacity, { 0, INVALID_FILE });
+	const u32 mask = capacity - 1;
+	for (u32 i = 0; i < count; i++)
+	{
+		const char* name = getFileName(i);
+		if (!name) { continue; }
+		// Duplicate names resolve to the first entry, matching a linear search.
+		if (findFileIndex(name) != INVALID_FILE) { continue; }
+
+		const u32 hash = hashFileName(name);
+		u32 slot = hash & mask;
+		while (m_fileIndex[slot].index != INVALID_FILE)
+		{
+			slot = (slot + 1) & mask;
+		}
+		m_fileIndex[slot] = { hash, i };
+	}
+	m_directoryVersion++;
+}
+
+void Archive::clearFileIndex()
+{
+	m_fileIndex.clear();
+	m_directoryVersion++;
+}
+
+u32 Archive::findFileIndex(const char* file)
+{
+	if (m_fileIndex.empty() || !file) { return INVALID_FILE; }
+
+	const u32 hash = hashFileName(file);
+	const u32 mask = u32(m_fileIndex.size()) - 1;
+	for (u32 slot = hash & mask; m_fileIndex[slot].index != INVALID_FILE; slot = (slot + 1) & mask)
+	{
+		const FileIndexSlot& entry = m_fileIndex[slot];
+		if (entry.hash == hash && strcasecmp(file, getFileName(entry.index)) == 0)
+		{
+			return entry.index;
+		}
+	}
+	return INVALID_FILE;
+}
+
+bool Archive::mapArchive(const char* archivePath)
+{
+	return m_mapping.open(archivePath);
+}
+
+void Archive::unmapArchive()
+{
+	m_mapping.close();
+}
+
+size_t Archive::readMappedFile(void* data, size_t size, size_t fileStart, size_t fileLength)
+{
+	const size_t offset = size_t(m_fileOffset);
+	if (offset >= fileLength) { return 0; }
+
+	const size_t sizeToRead = std::min(size, fileLength - offset);
+	const u8* src = m_mapping.getRange(fileStart + offset, sizeToRead);
+	if (!src) { return 0; }
+
+	memcpy(data, src, sizeToRead);
+	m_fileOffset += s32(sizeToRead);
+	return sizeToRead;
+}
+
+const u8* Archive::getMappedFile(size_t fileStart, size_t fileLength) const
+{
+	return m_mapping.getRange(fileStart, fileLength);
+}
@@ -4,6 +4,8 @@
 
 #include <TFE_System/types.h>
 #include <TFE_FileSystem/paths.h>
+#include <TFE_FileSystem/mappedFile.h>
+#include <vector>
 
 enum ArchiveType
 {
@@ -29,11 +31,14 @@ public:
 	static void deleteCustomArchive(Archive* archive);
 
 	static ArchiveType getArchiveTypeFromName(const char* path);
+
+	// Case-insensitive file name hash, used by the directory index.
+	static u32 hashFileName(const char* file);
 	
 	// Public Archive API
 public:
-	Archive() : m_type(ARCHIVE_UNKNOWN) {}
-	Archive(ArchiveType type) : m_type(type) {}
+	Archive() : m_type(ARCHIVE_UNKNOWN), m_directoryVersion(0) {}
+	Archive(ArchiveType type) : m_type(type), m_directoryVersion(0) {}
 	virtual ~Archive() {}
 
 	// Archive
@@ -44,6 +49,8 @@ public:
 	const char* getName() const { return m_name; }
 	const char* getPath() const { return m_archivePath; }
 	ArchiveType getType() const { return m_type; }
+	// Incremented whenever the directory of this archive changes.
+	u32 getDirectoryVersion() const { return m_directoryVersion; }
 
 	void setName(const char* name) { strcpy(m_name, name); }
 
@@ -60,6 +67,11 @@ public:
 	virtual size_t readFile(void *data, size_t size) = 0;
 	virtual bool seekFile(s32 offset, s32 origin = SEEK_SET) = 0;
 	virtual size_t getLocInFile() = 0;
+	// Returns a read-only view of the whole current file or null if the archive data is not in memory.
+	// The view stays valid until the archive is closed or modified.
+	virtual const u8* getFileData() { return nullptr; }
+	// Same as above for any file in the archive. This doesn't change the current file so it is safe to call from other threads.
+	virtual const u8* getFileData(u32 index) { return nullptr; }
 
 	// Directory
 	virtual u32 getFileCount() = 0;
@@ -69,6 +81,24 @@ public:
 	// Edit
 	virtual void addFile(const char* fileName, const char* filePath) = 0;
 
+	// Directory Index
+protected:
+	// Hash the directory so files can be found without searching every entry.
+	// Must be called whenever the directory changes.
+	void buildFileIndex();
+	void clearFileIndex();
+	// Returns the index of the first file matching 'file' (case-insensitive) or INVALID_FILE.
+	u32 findFileIndex(const char* file);
+
+	// Memory Mapping
+protected:
+	// Map the archive so files can be read without reopening it, returns false if it has to be read through FileStream.
+	bool mapArchive(const char* archivePath);
+	void unmapArchive();
+	// Read from the current file starting at m_fileOffset, which is advanced by the number of bytes read.
+	size_t readMappedFile(void* data, size_t size, size_t fileStart, size_t fileLength);
+	const u8* getMappedFile(size_t fileStart, size_t fileLength) const;
+
 	// Shared Private State
 protected:
 	ArchiveType m_type;
@@ -76,4 +106,14 @@ protected:
 	char m_archivePath[TFE_MAX_PATH];
 
 	s32 m_fileOffset;
+	MappedFile m_mapping;
+
+private:
+	struct FileIndexSlot
+	{
+		u32 hash;
+		u32 index;	// INVALID_FILE if the slot is empty.
+	};
+	std::vector<FileIndexSlot> m_fileIndex;
+	u32 m_directoryVersion;
 };
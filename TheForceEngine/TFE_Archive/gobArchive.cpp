@@ -76,6 +76,8 @@ bool GobArchive::open(const char *archivePath)
 
 	strcpy(m_archivePath, archivePath);
 	m_file.close();
+	mapArchive(archivePath);
+	buildFileIndex();
 
 	return true;
 }
@@ -83,9 +85,11 @@ bool GobArchive::open(const char *archivePath)
 void GobArchive::close()
 {
 	m_file.close();
+	unmapArchive();
 	m_archiveOpen = false;
 	delete[] m_fileList.entries;
 	m_fileList.entries = nullptr;
+	clearFileIndex();
 }
 
 // File Access
@@ -93,30 +97,15 @@ bool GobArchive::openFile(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
 
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_curFile = -1;
-	m_fileOffset = 0;
-
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			m_curFile = s32(i);
-			break;
-		}
-	}
-
-	if (m_curFile == -1)
+	const u32 index = findFileIndex(file);
+	if (index == INVALID_FILE)
 	{
-		m_file.close();
+		m_curFile = -1;
 		TFE_System::logWrite(LOG_ERROR, "GOB", "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
+		return false;
 	}
-	else
-	{
-		m_file.seek(m_fileList.entries[m_curFile].IX);
-	}
-	return m_curFile > -1 ? true : false;
+	return openFile(index);
 }
 
 bool GobArchive::openFile(u32 index)
@@ -125,15 +114,22 @@ bool GobArchive::openFile(u32 index)
 
 	m_curFile = s32(index);
 	m_fileOffset = 0;
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_file.seek(m_fileList.entries[m_curFile].IX);
+	// If the archive isn't mapped, keep a single read handle open until the archive is closed.
+	if (!m_mapping.isOpen())
+	{
+		if (!m_file.isOpen() && !m_file.open(m_archivePath, Stream::MODE_READ))
+		{
+			m_curFile = -1;
+			return false;
+		}
+		m_file.seek(m_fileList.entries[m_curFile].IX);
+	}
 	return true;
 }
 
 void GobArchive::closeFile()
 {
 	m_curFile = -1;
-	m_file.close();
 }
 
 u32 GobArchive::getFileIndex(const char* file)
@@ -141,14 +137,7 @@ u32 GobArchive::getFileIndex(const char* file)
 	if (!m_archiveOpen) { return INVALID_FILE; }
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 bool GobArchive::fileExists(const char *file)
@@ -157,14 +146,7 @@ bool GobArchive::fileExists(const char *file)
 	m_curFile = -1;
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFileIndex(file) != INVALID_FILE;
 }
 
 bool GobArchive::fileExists(u32 index)
@@ -183,6 +165,11 @@ size_t GobArchive::readFile(void *data, size_t size)
 {
 	if (m_curFile < 0) { return false; }
 	if (size == 0) { size = m_fileList.entries[m_curFile].LEN; }
+	if (m_mapping.isOpen())
+	{
+		return readMappedFile(data, size, m_fileList.entries[m_curFile].IX, m_fileList.entries[m_curFile].LEN);
+	}
+
 	const size_t sizeToRead = std::min(size, (size_t)m_fileList.entries[m_curFile].LEN);
 
 	u32 bytesRead = m_file.readBuffer(data, (u32)sizeToRead);
@@ -217,7 +204,10 @@ bool GobArchive::seekFile(s32 offset, s32 origin)
 		return false;
 	}
 
-	m_file.seek(m_fileList.entries[m_curFile].IX + m_fileOffset);
+	if (!m_mapping.isOpen())
+	{
+		m_file.seek(m_fileList.entries[m_curFile].IX + m_fileOffset);
+	}
 	return true;
 }
 
@@ -226,6 +216,18 @@ size_t GobArchive::getLocInFile()
 	return m_fileOffset;
 }
 
+const u8* GobArchive::getFileData()
+{
+	if (m_curFile < 0) { return nullptr; }
+	return getFileData(u32(m_curFile));
+}
+
+const u8* GobArchive::getFileData(u32 index)
+{
+	if (!m_archiveOpen || index >= getFileCount()) { return nullptr; }
+	return getMappedFile(m_fileList.entries[index].IX, m_fileList.entries[index].LEN);
+}
+
 // Directory
 u32 GobArchive::getFileCount()
 {
@@ -253,6 +255,10 @@ void GobArchive::addFile(const char* fileName, const char* filePath)
 	{
 		return;
 	}
+	// The archive is rewritten below, so release the mapping and shared read handle first.
+	unmapArchive();
+	m_file.close();
+
 	const size_t len = file.getSize();
 	const u32 newId = m_fileList.MASTERN;
 	m_fileList.MASTERN++;
@@ -266,6 +272,7 @@ void GobArchive::addFile(const char* fileName, const char* filePath)
 	newFile->LEN = u32(len);
 	strcpy(newFile->NAME, fileName);
 	m_header.MASTERX += newFile->LEN;
+	buildFileIndex();
 
 	// Read all of the file data.
 	std::vector<std::vector<u8>> fileData(m_fileList.MASTERN);
@@ -297,4 +304,5 @@ void GobArchive::addFile(const char* fileName, const char* filePath)
 		m_file.writeBuffer(m_fileList.entries, sizeof(GOB_Entry_t), m_fileList.MASTERN);
 		m_file.close();
 	}
+	mapArchive(m_archivePath);
 }
@@ -40,6 +40,7 @@ bool GobMemoryArchive::open(const u8* buffer, size_t size)
 	m_fileList.entries = (GobArchive::GOB_Entry_t*)(readBuffer);
 
 	m_archiveOpen = true;
+	buildFileIndex();
 
 	return true;
 }
@@ -49,6 +50,7 @@ void GobMemoryArchive::close()
 	m_archiveOpen = false;
 	free((void*)m_buffer);
 	m_buffer = nullptr;
+	clearFileIndex();
 }
 
 // File Access
@@ -60,13 +62,10 @@ bool GobMemoryArchive::openFile(const char *file)
 	m_fileOffset = 0;
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
+	const u32 index = findFileIndex(file);
+	if (index != INVALID_FILE)
 	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			m_curFile = i;
-			break;
-		}
+		m_curFile = s32(index);
 	}
 
 	if (m_curFile == -1)
@@ -101,14 +100,7 @@ u32 GobMemoryArchive::getFileIndex(const char* file)
 	if (!m_archiveOpen) { return INVALID_FILE; }
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 bool GobMemoryArchive::fileExists(const char *file)
@@ -117,14 +109,7 @@ bool GobMemoryArchive::fileExists(const char *file)
 	m_curFile = -1;
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFileIndex(file) != INVALID_FILE;
 }
 
 bool GobMemoryArchive::fileExists(u32 index)
@@ -187,6 +172,20 @@ size_t GobMemoryArchive::getLocInFile()
 	return m_fileOffset;
 }
 
+const u8* GobMemoryArchive::getFileData()
+{
+	if (m_curFile < 0) { return nullptr; }
+	return getFileData(u32(m_curFile));
+}
+
+const u8* GobMemoryArchive::getFileData(u32 index)
+{
+	if (!m_archiveOpen || index >= getFileCount()) { return nullptr; }
+	const GobArchive::GOB_Entry_t* entry = &m_fileList.entries[index];
+	if (size_t(entry->IX) + entry->LEN > m_size) { return nullptr; }
+	return m_buffer + entry->IX;
+}
+
 // Directory
 u32 GobMemoryArchive::getFileCount()
 {
@@ -36,6 +36,8 @@ bool LabArchive::open(const char *archivePath)
 	m_file.close();
 		
 	strcpy(m_archivePath, archivePath);
+	mapArchive(archivePath);
+	buildFileIndex();
 	
 	return true;
 }
@@ -43,9 +45,11 @@ bool LabArchive::open(const char *archivePath)
 void LabArchive::close()
 {
 	m_file.close();
+	unmapArchive();
 	m_archiveOpen = false;
 	delete[] m_entries;
 	delete[] m_stringTable;
+	clearFileIndex();
 }
 
 // File Access
@@ -53,30 +57,15 @@ bool LabArchive::openFile(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
 
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_curFile = -1;
-	m_fileOffset = 0;
-
 	//search for this file.
-	for (u32 i = 0; i < m_header.fileCount; i++)
-	{
-		if (strcasecmp(file, &m_stringTable[m_entries[i].nameOffset]) == 0)
-		{
-			m_curFile = i;
-			break;
-		}
-	}
-
-	if (m_curFile == -1)
-	{
-		m_file.close();
-		TFE_System::logWrite(LOG_ERROR, "GOB", "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
-	}
-	else
+	const u32 index = findFileIndex(file);
+	if (index == INVALID_FILE)
 	{
-		m_file.seek(m_entries[m_curFile].dataOffset);
+		m_curFile = -1;
+		TFE_System::logWrite(LOG_ERROR, "LAB", "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
+		return false;
 	}
-	return m_curFile > -1 ? true : false;
+	return openFile(index);
 }
 
 bool LabArchive::openFile(u32 index)
@@ -85,15 +74,22 @@ bool LabArchive::openFile(u32 index)
 
 	m_curFile = s32(index);
 	m_fileOffset = 0;
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_file.seek(m_entries[m_curFile].dataOffset);
+	// If the archive isn't mapped, keep a single read handle open until the archive is closed.
+	if (!m_mapping.isOpen())
+	{
+		if (!m_file.isOpen() && !m_file.open(m_archivePath, Stream::MODE_READ))
+		{
+			m_curFile = -1;
+			return false;
+		}
+		m_file.seek(m_entries[m_curFile].dataOffset);
+	}
 	return true;
 }
 
 void LabArchive::closeFile()
 {
 	m_curFile = -1;
-	m_file.close();
 }
 
 u32 LabArchive::getFileIndex(const char* file)
@@ -102,14 +98,7 @@ u32 LabArchive::getFileIndex(const char* file)
 	m_curFile = -1;
 
 	//search for this file.
-	for (u32 i = 0; i < m_header.fileCount; i++)
-	{
-		if (strcasecmp(file, &m_stringTable[m_entries[i].nameOffset]) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 bool LabArchive::fileExists(const char *file)
@@ -118,14 +107,7 @@ bool LabArchive::fileExists(const char *file)
 	m_curFile = -1;
 
 	//search for this file.
-	for (u32 i = 0; i < m_header.fileCount; i++)
-	{
-		if (strcasecmp(file, &m_stringTable[m_entries[i].nameOffset]) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFileIndex(file) != INVALID_FILE;
 }
 
 bool LabArchive::fileExists(u32 index)
@@ -144,6 +126,11 @@ size_t LabArchive::readFile(void *data, size_t size)
 {
 	if (m_curFile < 0) { return false; }
 	if (size == 0) { size = m_entries[m_curFile].len; }
+	if (m_mapping.isOpen())
+	{
+		return readMappedFile(data, size, m_entries[m_curFile].dataOffset, m_entries[m_curFile].len);
+	}
+
 	const size_t sizeToRead = std::min(size, (size_t)m_entries[m_curFile].len);
 
 	size_t bytesRead = m_file.readBuffer(data, (u32)sizeToRead);
@@ -178,7 +165,10 @@ bool LabArchive::seekFile(s32 offset, s32 origin)
 		return false;
 	}
 
-	m_file.seek(m_entries[m_curFile].dataOffset + m_fileOffset);
+	if (!m_mapping.isOpen())
+	{
+		m_file.seek(m_entries[m_curFile].dataOffset + m_fileOffset);
+	}
 	return true;
 }
 
@@ -187,6 +177,18 @@ size_t LabArchive::getLocInFile()
 	return m_fileOffset;
 }
 
+const u8* LabArchive::getFileData()
+{
+	if (m_curFile < 0) { return nullptr; }
+	return getFileData(u32(m_curFile));
+}
+
+const u8* LabArchive::getFileData(u32 index)
+{
+	if (!m_archiveOpen || index >= getFileCount()) { return nullptr; }
+	return getMappedFile(m_entries[index].dataOffset, m_entries[index].len);
+}
+
 // Directory
 u32 LabArchive::getFileCount()
 {
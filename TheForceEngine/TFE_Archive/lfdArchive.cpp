@@ -62,6 +62,8 @@ bool LfdArchive::open(const char *archivePath)
 
 	strcpy(m_archivePath, archivePath);
 	m_file.close();
+	mapArchive(archivePath);
+	buildFileIndex();
 
 	return true;
 }
@@ -69,6 +71,7 @@ bool LfdArchive::open(const char *archivePath)
 void LfdArchive::close()
 {
 	m_file.close();
+	unmapArchive();
 	m_archiveOpen = false;
 
 	if (m_fileList.entries)
@@ -76,6 +79,7 @@ void LfdArchive::close()
 		delete[] m_fileList.entries;
 		m_fileList.entries = nullptr;
 	}
+	clearFileIndex();
 }
 
 // File Access
@@ -83,30 +87,15 @@ bool LfdArchive::openFile(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
 
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_curFile = -1;
-	m_fileOffset = 0;
-
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			m_curFile = i;
-			break;
-		}
-	}
-
-	if (m_curFile == -1)
+	const u32 index = findFileIndex(file);
+	if (index == INVALID_FILE)
 	{
-		m_file.close();
+		m_curFile = -1;
 		TFE_System::logWrite(LOG_ERROR, "LFD", "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
+		return false;
 	}
-	else
-	{
-		m_file.seek(m_fileList.entries[m_curFile].IX);
-	}
-	return m_curFile > -1 ? true : false;
+	return openFile(index);
 }
 
 bool LfdArchive::openFile(u32 index)
@@ -115,15 +104,22 @@ bool LfdArchive::openFile(u32 index)
 
 	m_curFile = s32(index);
 	m_fileOffset = 0;
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_file.seek(m_fileList.entries[m_curFile].IX);
+	// If the archive isn't mapped, keep a single read handle open until the archive is closed.
+	if (!m_mapping.isOpen())
+	{
+		if (!m_file.isOpen() && !m_file.open(m_archivePath, Stream::MODE_READ))
+		{
+			m_curFile = -1;
+			return false;
+		}
+		m_file.seek(m_fileList.entries[m_curFile].IX);
+	}
 	return true;
 }
 
 void LfdArchive::closeFile()
 {
 	m_curFile = -1;
-	m_file.close();
 }
 
 u32 LfdArchive::getFileIndex(const char* file)
@@ -132,14 +128,7 @@ u32 LfdArchive::getFileIndex(const char* file)
 	m_curFile = -1;
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 bool LfdArchive::fileExists(const char *file)
@@ -148,14 +137,7 @@ bool LfdArchive::fileExists(const char *file)
 	m_curFile = -1;
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFileIndex(file) != INVALID_FILE;
 }
 
 bool LfdArchive::fileExists(u32 index)
@@ -174,6 +156,11 @@ size_t LfdArchive::readFile(void *data, size_t size)
 {
 	if (m_curFile < 0) { return false; }
 	if (size == 0) { size = m_fileList.entries[m_curFile].LENGTH; }
+	if (m_mapping.isOpen())
+	{
+		return readMappedFile(data, size, m_fileList.entries[m_curFile].IX, m_fileList.entries[m_curFile].LENGTH);
+	}
+
 	const size_t sizeToRead = std::min(size, (size_t)m_fileList.entries[m_curFile].LENGTH);
 
 	size_t bytesRead = m_file.readBuffer(data, (u32)sizeToRead);
@@ -208,7 +195,10 @@ bool LfdArchive::seekFile(s32 offset, s32 origin)
 		return false;
 	}
 
-	m_file.seek(m_fileList.entries[m_curFile].IX + m_fileOffset);
+	if (!m_mapping.isOpen())
+	{
+		m_file.seek(m_fileList.entries[m_curFile].IX + m_fileOffset);
+	}
 	return true;
 }
 
@@ -217,6 +207,18 @@ size_t LfdArchive::getLocInFile()
 	return m_fileOffset;
 }
 
+const u8* LfdArchive::getFileData()
+{
+	if (m_curFile < 0) { return nullptr; }
+	return getFileData(u32(m_curFile));
+}
+
+const u8* LfdArchive::getFileData(u32 index)
+{
+	if (!m_archiveOpen || index >= getFileCount()) { return nullptr; }
+	return getMappedFile(m_fileList.entries[index].IX, m_fileList.entries[index].LENGTH);
+}
+
 // Directory
 u32 LfdArchive::getFileCount()
 {
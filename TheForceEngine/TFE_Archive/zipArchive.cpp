@@ -76,6 +76,7 @@ bool ZipArchive::open(const char *archivePath)
 
 	strcpy(m_archivePath, archivePath);
 	m_fileHandle = nullptr;
+	buildFileIndex();
 
 	return true;
 }
@@ -86,7 +87,9 @@ void ZipArchive::close()
 
 	delete[] m_entries;
 	m_entries = nullptr;
+	m_entryCount = 0;
 	m_curFile = INVALID_FILE;
+	clearFileIndex();
 }
 
 // File Access
@@ -172,14 +175,7 @@ bool ZipArchive::fileExists(u32 index)
 
 u32 ZipArchive::getFileIndex(const char* file)
 {
-	for (s32 i = 0; i < m_entryCount; i++)
-	{
-		if (strcasecmp(file, m_entries[i].name.c_str()) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 size_t ZipArchive::getFileLength()
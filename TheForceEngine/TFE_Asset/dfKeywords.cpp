@@ -4,7 +4,7 @@
 #include <TFE_System/system.h>
 
 // These strings are taken directly from the Dark Forces EXE.
-static const char* c_keywords[] =
+static constexpr const char* c_keywords[] =
 {
 	"VISIBLE:",
 	"SHADED:",
@@ -229,20 +229,150 @@ static const char* c_keywords[] =
 
 #define KEYWORD_COUNT TFE_ARRAYSIZE(c_keywords)
 
-KEYWORD getKeywordIndex(const char* keywordString)
+//////////////////////////////////////////////////////////////////////
+// Keyword Hash
+// A perfect hash over the keyword table, built at compile time using
+// "hash and displace": keywords are split into buckets by their hash,
+// and each bucket stores the displacement that places its keywords in
+// free slots. So a lookup is one hash and one string compare.
+//////////////////////////////////////////////////////////////////////
+enum KeywordHashConstants : u32
+{
+	KW_HASH_BUCKETS = 128,
+	KW_HASH_SLOTS   = 512,
+	KW_HASH_MAX_BUCKET_SIZE  = 16,
+	KW_HASH_MAX_DISPLACEMENT = 0xffff,
+};
+
+struct KeywordHashTable
+{
+	u16 displacement[KW_HASH_BUCKETS];
+	s16 slots[KW_HASH_SLOTS];
+	bool valid;
+};
+
+// Case insensitive FNV-1a, matching the strcasecmp() used to compare keywords.
+static constexpr u32 keyword_hash(const char* str)
 {
-	s32 result = -1;
-	for (s32 i = 0; i < KEYWORD_COUNT; i++)
+	u32 hash = 2166136261u;
+	for (; *str; str++)
+	{
+		u32 c = u8(*str);
+		if (c >= 'a' && c <= 'z') { c -= 'a' - 'A'; }
+		hash = (hash ^ c) * 16777619u;
+	}
+	return hash;
+}
+
+static constexpr u32 keyword_slot(u32 hash, u32 displacement)
+{
+	u32 x = (hash ^ (displacement * 0x9e3779b9u)) * 0x85ebca6bu;
+	return (x ^ (x >> 15u)) & (KW_HASH_SLOTS - 1);
+}
+
+static constexpr bool keyword_equal(const char* a, const char* b)
+{
+	for (; *a && *a == *b; a++, b++);
+	return *a == *b;
+}
+
+static constexpr KeywordHashTable keyword_buildHashTable()
+{
+	KeywordHashTable table = {};
+	table.valid = true;
+	for (u32 s = 0; s < KW_HASH_SLOTS; s++)
+	{
+		table.slots[s] = -1;
+	}
+
+	// Sort the keywords by bucket, keeping the table order within each bucket.
+	u32 hashes[KEYWORD_COUNT] = {};
+	u32 bucketStart[KW_HASH_BUCKETS + 1] = {};
+	for (u32 i = 0; i < KEYWORD_COUNT; i++)
+	{
+		hashes[i] = keyword_hash(c_keywords[i]);
+		bucketStart[(hashes[i] & (KW_HASH_BUCKETS - 1)) + 1]++;
+	}
+	for (u32 b = 0; b < KW_HASH_BUCKETS; b++)
+	{
+		bucketStart[b + 1] += bucketStart[b];
+	}
+	u32 order[KEYWORD_COUNT] = {};
+	u32 bucketFill[KW_HASH_BUCKETS] = {};
+	for (u32 i = 0; i < KEYWORD_COUNT; i++)
 	{
-		const char* keyword = c_keywords[i];
-		if (toupper(keywordString[0]) == keyword[0])
+		const u32 b = hashes[i] & (KW_HASH_BUCKETS - 1);
+		order[bucketStart[b] + bucketFill[b]++] = i;
+	}
+
+	for (u32 b = 0; b < KW_HASH_BUCKETS; b++)
+	{
+		// Repeated keywords resolve to the first index, like the linear search did.
+		u32 keys[KW_HASH_MAX_BUCKET_SIZE] = {};
+		u32 keyCount = 0;
+		if (bucketStart[b + 1] - bucketStart[b] > KW_HASH_MAX_BUCKET_SIZE)
 		{
-			if (!strcasecmp(keywordString, keyword))
+			table.valid = false;
+			break;
+		}
+		for (u32 o = bucketStart[b]; o < bucketStart[b + 1]; o++)
+		{
+			const u32 i = order[o];
+			bool repeat = false;
+			for (u32 k = 0; k < keyCount && !repeat; k++)
 			{
-				result = i;
-				break;
+				repeat = hashes[keys[k]] == hashes[i] && keyword_equal(c_keywords[keys[k]], c_keywords[i]);
 			}
+			if (!repeat) { keys[keyCount++] = i; }
 		}
+		if (!keyCount) { continue; }
+
+		// Find the first displacement where every keyword in the bucket lands in a different free slot.
+		u32 d = 0;
+		for (; d <= KW_HASH_MAX_DISPLACEMENT; d++)
+		{
+			bool fits = true;
+			for (u32 k = 0; k < keyCount && fits; k++)
+			{
+				const u32 slot = keyword_slot(hashes[keys[k]], d);
+				fits = table.slots[slot] < 0;
+				for (u32 j = 0; j < k && fits; j++)
+				{
+					fits = keyword_slot(hashes[keys[j]], d) != slot;
+				}
+			}
+			if (fits) { break; }
+		}
+		if (d > KW_HASH_MAX_DISPLACEMENT)
+		{
+			table.valid = false;
+			break;
+		}
+
+		table.displacement[b] = u16(d);
+		for (u32 k = 0; k < keyCount; k++)
+		{
+			table.slots[keyword_slot(hashes[keys[k]], d)] = s16(keys[k]);
+		}
+	}
+	return table;
+}
+
+static constexpr KeywordHashTable c_keywordHash = keyword_buildHashTable();
+static_assert(c_keywordHash.valid, "Cannot build the keyword hash table, increase KW_HASH_SLOTS.");
+
+KEYWORD getKeywordIndex(const char* keywordString)
+{
+	const u32 hash = keyword_hash(keywordString);
+	const s32 index = c_keywordHash.slots[keyword_slot(hash, c_keywordHash.displacement[hash & (KW_HASH_BUCKETS - 1)])];
+	if (index >= 0 && !strcasecmp(keywordString, c_keywords[index]))
+	{
+		return KEYWORD(index);
 	}
-	return KEYWORD(result);
+	return KW_UNKNOWN;
+}
+
+const char* getKeywordString(KEYWORD keyword)
+{
+	return keyword >= 0 && keyword < s32(KEYWORD_COUNT) ? c_keywords[keyword] : nullptr;
 }
@@ -235,4 +235,5 @@ enum KEYWORD
 	KW_COUNT
 };
 
-extern KEYWORD getKeywordIndex(const char* keywordString);
\ No newline at end of file
+extern KEYWORD getKeywordIndex(const char* keywordString);
+extern const char* getKeywordString(KEYWORD keyword);
\ No newline at end of file
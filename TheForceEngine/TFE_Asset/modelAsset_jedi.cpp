@@ -163,6 +163,9 @@ namespace TFE_Model_Jedi
 	static ModelList s_modelList[POOL_COUNT];
 	static NameList s_modelNames[POOL_COUNT];
 	static std::vector<char> s_buffer;
+	// Current file data, either in place in the archive or in s_buffer.
+	static const char* s_data = nullptr;
+	static size_t s_dataSize = 0;
 
 	// Remove 3DO limits.
 	static std::vector<vec2> s_tmpVtx;
@@ -188,9 +191,7 @@ namespace TFE_Model_Jedi
 		{
 			return nullptr;
 		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
+		s_data = file.readView(s_buffer, &s_dataSize);
 		file.close();
 			
 		s_memRegion = (pool == POOL_GAME) ? s_gameRegion : s_levelRegion;
@@ -363,8 +364,8 @@ namespace TFE_Model_Jedi
 	
 	bool parseModel(JediModel* model, const char* name, AssetPool pool)
 	{
-		if (s_buffer.empty()) { return false; }
-		const size_t len = s_buffer.size();
+		if (!s_data || !s_dataSize) { return false; }
+		const size_t len = s_dataSize;
 
 		model->isBridge = 0;
 		model->vertexCount = 0;
@@ -393,8 +394,8 @@ namespace TFE_Model_Jedi
 
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), len);
-		const char* fileBuffer = s_buffer.data();
+		parser.init(s_data, len);
+		const char* fileBuffer = s_data;
 		parser.addCommentString("#");
 
 		// For now just do what the original code does.
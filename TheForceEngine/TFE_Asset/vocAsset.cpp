@@ -19,6 +19,9 @@ namespace TFE_VocAsset
 	static VocMap s_vocAssets;
 	static VocList s_vocAssetList;
 	static std::vector<u8> s_buffer;
+	// Current file data, either in place in the archive or in s_buffer.
+	static const u8* s_data = nullptr;
+	static size_t s_dataSize = 0;
 
 	bool parseVoc(SoundBuffer* voc);
 
@@ -35,9 +38,7 @@ namespace TFE_VocAsset
 		{
 			return false;
 		}
-		size_t size = vocAsset.getSize();
-		s_buffer.resize(size + 1);
-		vocAsset.readBuffer(s_buffer.data(), (u32)size);
+		s_data = vocAsset.readView(s_buffer, &s_dataSize);
 		vocAsset.close();
 
 		return true;
@@ -297,10 +298,10 @@ namespace TFE_VocAsset
 
 	bool parseVoc(SoundBuffer* voc)
 	{
-		if (s_buffer.empty() || !voc) { return false; }
+		if (!s_data || !s_dataSize || !voc) { return false; }
 
-		const size_t len = s_buffer.size();
-		const u8* buffer = s_buffer.data();
+		const size_t len = s_dataSize;
+		const u8* buffer = s_data;
 		const u8* end = buffer + len;
 		memset(voc, 0, sizeof(SoundBuffer));
 		voc->type = SOUND_DATA_8BIT;
@@ -310,13 +311,15 @@ namespace TFE_VocAsset
 		buffer += sizeof(VocHeader);
 
 		// Parse blocks.
-		buffer = s_buffer.data() + header->datablockOffset;
+		buffer = s_data + header->datablockOffset;
 		while (buffer < end)
 		{
 			const BlockType type = BlockType(*buffer); buffer++;
 			// Break if this is the final block.
 			// TODO: Figure out what type = 170 means; for now abort.
 			if (type == VOC_TERMINATOR || type > VOC_END_REPEAT) { break; }
+			// Stop at a truncated block header, the file is not padded.
+			if (end - buffer < 3) { break; }
 			// All other blocks have a 3 byte size (up to 16MB).
 			const u32 blockLen = buffer[0] | (buffer[1] << 8u) | (buffer[2] << 16u);
 			buffer += 3;
@@ -1,8 +1,66 @@
 #include <cstring>
+#include <cmath>
 #include "audioFilters.h"
+#include <TFE_System/math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define AUDIO_FILTER_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define AUDIO_FILTER_SSE2 0
+#endif
 
 namespace TFE_Audio
 {
+	// Polyphase filter design: a 64 tap Kaiser windowed-sinc low pass at the source Nyquist frequency,
+	// split into 4 phases. Each tap stores the coefficient for every phase twice (left and right) so
+	// that one multiply produces interleaved stereo output.
+	static const f64 c_polyphaseCutoff = 0.115;	// cycles per output sample, 0.125 = source Nyquist.
+	static const f64 c_polyphaseBeta = 7.0;
+	alignas(16) static f32 s_polyphaseCoef[UPSAMPLE_POLYPHASE_TAPS * 8];
+
+	static f64 besselI0(f64 x)
+	{
+		f64 sum = 1.0, term = 1.0;
+		for (s32 k = 1; k < 32; k++)
+		{
+			const f64 t = x / (2.0 * f64(k));
+			term *= t * t;
+			sum += term;
+		}
+		return sum;
+	}
+
+	void upsample_init()
+	{
+		const s32 length = UPSAMPLE_POLYPHASE_TAPS * 4;
+		const f64 center = f64(length - 1) * 0.5;
+		const f64 pi = 3.14159265358979323846;
+
+		f64 coef[UPSAMPLE_POLYPHASE_TAPS * 4];
+		for (s32 i = 0; i < length; i++)
+		{
+			const f64 t = f64(i) - center;
+			const f64 x = 2.0 * pi * c_polyphaseCutoff * t;
+			const f64 r = t / center;
+			const f64 window = besselI0(c_polyphaseBeta * sqrt(1.0 - r * r)) / besselI0(c_polyphaseBeta);
+			coef[i] = window * (x != 0.0 ? sin(x) / x : 1.0);
+		}
+
+		// Normalize each phase to unit gain so DC passes through unchanged.
+		for (s32 p = 0; p < 4; p++)
+		{
+			f64 sum = 0.0;
+			for (s32 k = 0; k < UPSAMPLE_POLYPHASE_TAPS; k++) { sum += coef[k * 4 + p]; }
+			for (s32 k = 0; k < UPSAMPLE_POLYPHASE_TAPS; k++)
+			{
+				const f32 value = f32(coef[k * 4 + p] / sum);
+				s_polyphaseCoef[k * 8 + p * 2 + 0] = value;
+				s_polyphaseCoef[k * 8 + p * 2 + 1] = value;
+			}
+		}
+	}
+
 	void upsample4x_point(f32* output, const f32* input, s32 inputSampleCount)
 	{
 		for (s32 i = 0; i < inputSampleCount; i += 2, output += 8, input += 2)
@@ -50,4 +108,77 @@ namespace TFE_Audio
 			output[7] = inRight0 + deltaRight * 0.75f;
 		}
 	}
+
+	void upsample4x_polyphase(f32* output, const f32* input, s32 inputSampleCount)
+	{
+		// output[4n + p] = sum(k) coef[4k + p] * input[n - k]
+		// The input is read backwards from the current sample, which is why history is required before 'input'.
+	#if AUDIO_FILTER_SSE2
+		for (s32 i = 0; i < inputSampleCount; i += 2, input += 2, output += 8)
+		{
+			__m128 out01 = _mm_setzero_ps();
+			__m128 out23 = _mm_setzero_ps();
+			const f32* in = input;
+			const f32* coef = s_polyphaseCoef;
+			for (s32 k = 0; k < UPSAMPLE_POLYPHASE_TAPS; k++, in -= 2, coef += 8)
+			{
+				// (left, right, left, right)
+				const __m128 sample = _mm_castpd_ps(_mm_load1_pd((const f64*)in));
+				out01 = _mm_add_ps(out01, _mm_mul_ps(sample, _mm_load_ps(coef)));
+				out23 = _mm_add_ps(out23, _mm_mul_ps(sample, _mm_load_ps(coef + 4)));
+			}
+			_mm_storeu_ps(output, out01);
+			_mm_storeu_ps(output + 4, out23);
+		}
+	#else
+		for (s32 i = 0; i < inputSampleCount; i += 2, input += 2, output += 8)
+		{
+			f32 out[8] = { 0 };
+			const f32* in = input;
+			const f32* coef = s_polyphaseCoef;
+			for (s32 k = 0; k < UPSAMPLE_POLYPHASE_TAPS; k++, in -= 2, coef += 8)
+			{
+				for (s32 p = 0; p < 8; p += 2)
+				{
+					out[p + 0] += in[0] * coef[p];
+					out[p + 1] += in[1] * coef[p];
+				}
+			}
+			memcpy(output, out, sizeof(f32) * 8);
+		}
+	#endif
+	}
+
+	void softClip_tanh(f32* buffer, s32 sampleCount)
+	{
+		// Same rational approximation as TFE_Math::tanhf_series(), clamped to [-1, 1] outside of (-4.8, 4.8].
+		s32 i = 0;
+	#if AUDIO_FILTER_SSE2
+		const __m128 limit = _mm_set1_ps(4.8f);
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		for (; i + 4 <= sampleCount; i += 4)
+		{
+			const __m128 beta = _mm_loadu_ps(buffer + i);
+			const __m128 x2 = _mm_mul_ps(beta, beta);
+			__m128 a = _mm_add_ps(_mm_set1_ps(378.0f), x2);
+			a = _mm_add_ps(_mm_set1_ps(17325.0f), _mm_mul_ps(x2, a));
+			a = _mm_add_ps(_mm_set1_ps(135135.0f), _mm_mul_ps(x2, a));
+			a = _mm_mul_ps(beta, a);
+			__m128 b = _mm_add_ps(_mm_set1_ps(3150.0f), _mm_mul_ps(x2, _mm_set1_ps(28.0f)));
+			b = _mm_add_ps(_mm_set1_ps(62370.0f), _mm_mul_ps(x2, b));
+			b = _mm_add_ps(_mm_set1_ps(135135.0f), _mm_mul_ps(x2, b));
+			const __m128 value = _mm_div_ps(a, b);
+
+			// Outside of the range the result is +/-1 with the sign of the input.
+			const __m128 clamped = _mm_or_ps(one, _mm_and_ps(beta, signMask));
+			const __m128 outside = _mm_or_ps(_mm_cmpgt_ps(beta, limit), _mm_cmple_ps(beta, _mm_sub_ps(_mm_setzero_ps(), limit)));
+			_mm_storeu_ps(buffer + i, _mm_or_ps(_mm_and_ps(outside, clamped), _mm_andnot_ps(outside, value)));
+		}
+	#endif
+		for (; i < sampleCount; i++)
+		{
+			buffer[i] = TFE_Math::tanhf_series(buffer[i]);
+		}
+	}
 }
@@ -5,12 +5,26 @@ enum AudioUpsampleFilter
 {
 	AUF_NONE = 0,
 	AUF_LINEAR,
+	AUF_POLYPHASE,
 	AUF_COUNT,
-	AUF_DEFAULT = AUF_LINEAR
+	AUF_DEFAULT = AUF_POLYPHASE
 };
 
+// Number of input taps per output phase used by the polyphase filter.
+// upsample4x_polyphase() reads (UPSAMPLE_POLYPHASE_TAPS - 1) stereo samples *before* the input pointer.
+#define UPSAMPLE_POLYPHASE_TAPS 16
+#define UPSAMPLE_POLYPHASE_HISTORY (UPSAMPLE_POLYPHASE_TAPS - 1)
+
 namespace TFE_Audio
 {
+	// Builds the polyphase coefficient table, must be called before upsample4x_polyphase().
+	void upsample_init();
+
 	void upsample4x_point(f32* output, const f32* input, s32 inputSampleCount);
 	void upsample4x_linear(f32* output, const f32* input, s32 inputSampleCount);
+	// Kaiser windowed-sinc interpolation, the output is delayed by about 8 input samples.
+	void upsample4x_polyphase(f32* output, const f32* input, s32 inputSampleCount);
+
+	// Map samples into [-1, 1] using the tanh series approximation (see TFE_Math::tanhf_series()).
+	void softClip_tanh(f32* buffer, s32 sampleCount);
 }
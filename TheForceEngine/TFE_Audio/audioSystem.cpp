@@ -74,6 +74,8 @@ namespace TFE_Audio
 
 	static AudioUpsampleFilter s_upsampleFilter = AUF_DEFAULT;
 	static AudioThreadCallback s_audioThreadCallback = nullptr;
+	// Polyphase history + 256 stereo samples + oversampling.
+	static f32 s_callbackBuffer[(UPSAMPLE_POLYPHASE_HISTORY + AUDIO_CALLBACK_BUFFER_SIZE + 2)*AUDIO_CHANNEL_COUNT];
 
 	static void audioCallback(void*, unsigned char*, int);
 	void setSoundVolumeConsole(const ConsoleArgList& args);
@@ -101,6 +103,7 @@ namespace TFE_Audio
 
 		TFE_Settings_Sound* soundSettings = TFE_Settings::getSoundSettings();
 		setVolume(soundSettings->soundFxVolume);
+		upsample_init();
 
 		memset(s_sources, 0, sizeof(SoundSource) * MAX_SOUND_SOURCES);
 		for (s32 i = 0; i < MAX_SOUND_SOURCES; i++)
@@ -224,6 +227,7 @@ namespace TFE_Audio
 
 		SDL_LockMutex(s_mutex);
 		s_audioThreadCallback = callback;
+		memset(s_callbackBuffer, 0, sizeof(s_callbackBuffer));
 		SDL_UnlockMutex(s_mutex);
 	}
 
@@ -457,6 +461,8 @@ namespace TFE_Audio
 	// Audio callback
 	static void audioCallback(void* userData, unsigned char* outputBuffer, int bufsize)
 	{
+		TFE_THREAD_NAME("Audio");
+		TFE_ZONE("Audio Callback");
 		f32* buffer = (f32*)outputBuffer;
 		u32 bufferSize = (u32)bufsize;
 		u32 frames = bufferSize / (AUDIO_CHANNEL_COUNT * sizeof(f32));
@@ -472,7 +478,8 @@ namespace TFE_Audio
 		// Then call the audio thread callback
 		if (s_audioThreadCallback && !s_paused)
 		{
-			static f32 callbackBuffer[(AUDIO_CALLBACK_BUFFER_SIZE + 2)*AUDIO_CHANNEL_COUNT];	// 256 stereo + oversampling.
+			// The callback writes after the polyphase history.
+			f32* callbackBuffer = &s_callbackBuffer[UPSAMPLE_POLYPHASE_HISTORY * AUDIO_CHANNEL_COUNT];
 			s_audioThreadCallback(callbackBuffer, AUDIO_CALLBACK_BUFFER_SIZE, s_soundFxVolume * c_soundHeadroom);
 			// The audio buffer is 1/4 as large as it should be.
 			// This means that in-between samples must be interpolated.
@@ -486,7 +493,13 @@ namespace TFE_Audio
 				{
 					upsample4x_linear(buffer, callbackBuffer, AUDIO_CALLBACK_BUFFER_SIZE*AUDIO_CHANNEL_COUNT);
 				}
+				else if (s_upsampleFilter == AUF_POLYPHASE)
+				{
+					upsample4x_polyphase(buffer, callbackBuffer, AUDIO_CALLBACK_BUFFER_SIZE*AUDIO_CHANNEL_COUNT);
+				}
 			}
+			// Keep the last samples as history for the next callback.
+			memcpy(s_callbackBuffer, &s_callbackBuffer[AUDIO_CALLBACK_BUFFER_SIZE * AUDIO_CHANNEL_COUNT], sizeof(f32) * UPSAMPLE_POLYPHASE_HISTORY * AUDIO_CHANNEL_COUNT);
 		}
 
 		// Then loop through the sources.
@@ -567,6 +580,9 @@ namespace TFE_Audio
 
 		// Handle out of range audio samples.
 		buffer = (f32*)outputBuffer;
+	#if defined(AUDIO_SIGMOID_TANH)
+		softClip_tanh(buffer, frames * AUDIO_CHANNEL_COUNT);
+	#else
 		for (u32 i = 0; i < frames; i++, buffer += 2)
 		{
 			const f32 valueLeft  = buffer[0];
@@ -588,6 +604,7 @@ namespace TFE_Audio
 			buffer[1] = valueRight / sqrtf(1.0f + valueRight * valueRight);
 		#endif
 		}
+	#endif
 
 		// Timing
 	#if AUDIO_TIMING == 1
@@ -8,6 +8,7 @@
 #include <SDL_thread.h>
 #include <TFE_Asset/gmidAsset.h>
 #include <TFE_System/system.h>
+#include <TFE_System/profiler.h>
 #include <TFE_Settings/settings.h>
 #include <TFE_FrontEndUI/console.h>
 #include <TFE_Audio/MidiSynth/soundFontDevice.h>
@@ -46,6 +47,84 @@ namespace TFE_MidiPlayer
 	static u32 s_midiCmdCount = 0;
 	static f64 s_maxNoteLength = 16.0;		// defaults to 16 seconds.
 
+	// TFE: Midi events sent from the midi thread to the audio thread.
+	// Producers (the midi thread and the game thread through sendMessageDirect()) serialize on s_mutex
+	// and the audio thread is the only consumer, so the audio thread doesn't need to lock while rendering.
+	enum MidiEventType : u8
+	{
+		MEVT_MESSAGE = 0,
+		MEVT_NOTES_OFF,
+		MEVT_VOLUME,
+	};
+
+	enum MidiEventFlags : u8
+	{
+		MEVT_FLAG_RESYNC = (1 << 0),	// The sequencer time is discontinuous, realign the audio time.
+	};
+
+	struct MidiEvent
+	{
+		u64 time;		// Sequencer time in samples.
+		f32 volume;
+		u8 type;
+		u8 flags;
+		u8 len;
+		u8 msg[3];
+	};
+
+	enum
+	{
+		MIDI_SAMPLE_RATE = 44100,
+		MIDI_EVENT_QUEUE_SIZE = 2048,	// Must be a power of 2.
+		MIDI_EVENT_QUEUE_MASK = MIDI_EVENT_QUEUE_SIZE - 1,
+		// Events are played this many samples after their sequencer time, which must be longer than one audio callback
+		// so events are not late.
+		MIDI_EVENT_LATENCY  = 1536,
+		// If events are further ahead than this, the clocks have drifted and the audio time is realigned.
+		MIDI_EVENT_MAX_LEAD = MIDI_EVENT_LATENCY * 4,
+	};
+
+	static MidiEvent s_eventQueue[MIDI_EVENT_QUEUE_SIZE];
+	static atomic_u32 s_eventWrite;
+	static atomic_u32 s_eventRead;
+	static atomic_bool s_eventQueueReset;
+	// Producer state.
+	static f64 s_eventTime = 0.0;		// Sequencer time in seconds.
+	static bool s_eventResync = true;
+	// Consumer state.
+	static s64 s_renderTime = 0;		// Samples rendered.
+	static s64 s_renderTimeOffset = 0;	// Sequencer time -> render time.
+	// Counters
+	static s32 s_midiQueueDepth = 0;
+	static s32 s_midiLateEvents = 0;
+	static s32 s_midiDroppedEvents = 0;
+
+	// TFE: Optional render-ahead, where midi synthesis runs on a worker thread a few milliseconds ahead of the audio
+	// callback and writes into a ring of rendered samples. The audio callback then only mixes.
+	// Whichever thread holds s_renderLock consumes midi events and renders, so the callback can fall back to
+	// rendering inline when the worker falls behind.
+	enum
+	{
+		MIDI_RENDER_RING_SIZE = 16384,	// Stereo samples, must be a power of 2.
+		MIDI_RENDER_RING_MASK = MIDI_RENDER_RING_SIZE - 1,
+		MIDI_RENDER_CHUNK = 128,		// Stereo samples rendered by the worker while holding the render lock.
+		MIDI_RENDER_AHEAD_MIN_MS = 5,
+		MIDI_RENDER_AHEAD_MAX_MS = 250,
+	};
+
+	static bool s_renderAhead = false;
+	static s32  s_renderAheadMs = 50;
+	static SDL_Thread* s_renderThread = nullptr;
+	static atomic_bool s_runRenderThread;
+	static atomic_bool s_renderLock;
+	static atomic_bool s_renderRingReset;
+	static f32 s_renderRing[MIDI_RENDER_RING_SIZE * 2];
+	static atomic_u32 s_renderRingWrite;
+	static atomic_u32 s_renderRingRead;
+	// Counters
+	static s32 s_midiRenderAheadFill = 0;
+	static s32 s_midiRenderUnderruns = 0;
+
 	struct MidiCallback
 	{
 		void(*callback)(void) = nullptr;	// callback function to call.
@@ -79,6 +158,12 @@ namespace TFE_MidiPlayer
 	static f64 s_curNoteTime = 0.0;
 
 	int midiUpdateFunc(void* userData);
+	int midiRenderFunc(void* userData);
+	void midiLockRender();
+	void midiUnlockRender();
+	void midiDeviceMessage(const u8* msg, u32 len);
+	void midiDeviceNotesOff();
+	void midiDeviceVolume(f32 volume);
 	void stopAllNotes();
 	void changeVolume();
 	void allocateMidiDevice(MidiDeviceType type);
@@ -133,8 +218,23 @@ namespace TFE_MidiPlayer
 			res = false;
 		}
 
+		// The render thread idles unless midiRenderAhead is enabled, if it cannot be created midi is rendered inline.
+		s_runRenderThread.store(true);
+		s_renderThread = SDL_CreateThread(midiRenderFunc, "TFE_MidiRenderThread", nullptr);
+		if (!s_renderThread)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Midi", "cannot create Midi Render Thread, midi will be rendered in the audio callback.");
+		}
+
 		CCMD("setMusicVolume", setMusicVolumeConsole, 1, "Sets the music volume, range is 0.0 to 1.0");
 		CCMD("getMusicVolume", getMusicVolumeConsole, 0, "Get the current music volume where 0 = silent, 1 = maximum.");
+		TFE_COUNTER(s_midiQueueDepth, "MidiQueueDepth");
+		TFE_COUNTER(s_midiLateEvents, "MidiLateEvents");
+		TFE_COUNTER(s_midiDroppedEvents, "MidiDroppedEvents");
+		TFE_COUNTER(s_midiRenderAheadFill, "MidiRenderAheadFill");
+		TFE_COUNTER(s_midiRenderUnderruns, "MidiRenderUnderruns");
+		CVAR_BOOL(s_renderAhead, "midiRenderAhead", CVFLAG_NONE, "Render midi on a worker thread ahead of the audio callback.");
+		CVAR_INT(s_renderAheadMs, "midiRenderAheadMs", CVFLAG_NONE, "How far ahead, in milliseconds, midi is rendered when midiRenderAhead is enabled.");
 
 		TFE_Settings_Sound* soundSettings = TFE_Settings::getSoundSettings();
 		setVolume(soundSettings->musicVolume);
@@ -148,9 +248,15 @@ namespace TFE_MidiPlayer
 		int i;
 
 		TFE_System::logWrite(LOG_MSG, "MidiPlayer", "Shutdown");
-		// Destroy the thread before shutting down the Midi Device.
+		// Destroy the threads before shutting down the Midi Device.
 		s_runMusicThread.store(false);
 		SDL_WaitThread(s_thread, &i);
+		if (s_renderThread)
+		{
+			s_runRenderThread.store(false);
+			SDL_WaitThread(s_renderThread, &i);
+			s_renderThread = nullptr;
+		}
 
 		delete s_midiDevice;
 
@@ -230,6 +336,8 @@ namespace TFE_MidiPlayer
 		if (!s_tPaused && s_mutex)
 		{
 			SDL_LockMutex(s_mutex);
+			// Also keep the render thread and audio callback away from the device, which may be changed.
+			midiLockRender();
 			s_tPaused = true;
 		}
 	}
@@ -238,6 +346,7 @@ namespace TFE_MidiPlayer
 	{
 		if (s_tPaused && s_mutex)
 		{
+			midiUnlockRender();
 			SDL_UnlockMutex(s_mutex);
 			s_tPaused = false;
 		}
@@ -276,14 +385,151 @@ namespace TFE_MidiPlayer
 		SDL_UnlockMutex(s_mutex);
 	}
 
-	void synthesizeMidi(f32* buffer, u32 stereoSampleCount, bool updateBuffer)
+	// Returns the render time of the event, updating the sequencer to render time mapping if needed.
+	s64 midiScheduleEvent(MidiEvent* evt, s64 blockStart)
+	{
+		if (evt->flags & MEVT_FLAG_RESYNC)
+		{
+			s_renderTimeOffset = blockStart + MIDI_EVENT_LATENCY - s64(evt->time);
+			evt->flags &= ~MEVT_FLAG_RESYNC;
+		}
+
+		s64 renderTime = s64(evt->time) + s_renderTimeOffset;
+		if (renderTime < blockStart)
+		{
+			// The midi thread fell behind, play the event now and shift later events to keep their spacing.
+			s_midiLateEvents++;
+			s_renderTimeOffset += blockStart - renderTime;
+			renderTime = blockStart;
+		}
+		else if (renderTime > blockStart + MIDI_EVENT_MAX_LEAD)
+		{
+			s_renderTimeOffset -= renderTime - (blockStart + MIDI_EVENT_LATENCY);
+			renderTime = blockStart + MIDI_EVENT_LATENCY;
+		}
+		return renderTime;
+	}
+
+	void midiApplyEvent(const MidiEvent* evt)
+	{
+		switch (evt->type)
+		{
+			case MEVT_MESSAGE:
+				s_midiDevice->message(evt->msg, evt->len);
+				break;
+			case MEVT_NOTES_OFF:
+				s_midiDevice->noteAllOff();
+				break;
+			case MEVT_VOLUME:
+				s_midiDevice->setVolume(evt->volume);
+				break;
+		}
+	}
+
+	// Render midi into 'output', applying queued events at their sample offsets.
+	// Must be called while holding the render lock. Returns false if the device cannot render.
+	bool midiRender(f32* output, u32 stereoSampleCount)
 	{
+		TFE_ZONE("Midi Render");
+		u32 read = s_eventRead.load(std::memory_order_relaxed);
+		const u32 write = s_eventWrite.load(std::memory_order_acquire);
+		if (s_eventQueueReset.exchange(false))
+		{
+			read = write;
+		}
+
 		// In some cases, such as when using the System Midi Device, the midi audio is generated externally so
 		// rendering is not required.
+		bool result = false;
 		if (s_midiDevice && s_midiDevice->canRender())
+		{
+			// Render up to each event and then apply it, so events land on their exact sample.
+			// The midi device takes the number of stereo samples.
+			const s64 blockStart = s_renderTime;
+			const s64 blockEnd = blockStart + stereoSampleCount;
+			u32 rendered = 0;
+			for (; read != write; read++)
+			{
+				MidiEvent* evt = &s_eventQueue[read & MIDI_EVENT_QUEUE_MASK];
+				const s64 renderTime = std::max(midiScheduleEvent(evt, blockStart), blockStart + rendered);
+				if (renderTime >= blockEnd) { break; }
+
+				const u32 offset = u32(renderTime - blockStart);
+				if (offset > rendered)
+				{
+					s_midiDevice->render(output + rendered * 2, offset - rendered);
+					rendered = offset;
+				}
+				midiApplyEvent(evt);
+			}
+			if (rendered < stereoSampleCount)
+			{
+				s_midiDevice->render(output + rendered * 2, stereoSampleCount - rendered);
+			}
+			s_renderTime = blockEnd;
+			result = true;
+		}
+		else
+		{
+			// Nothing to render, so events are discarded.
+			read = write;
+		}
+
+		s_midiQueueDepth = s32(write - read);
+		s_eventRead.store(read, std::memory_order_release);
+		return result;
+	}
+
+	// Read up to 'stereoSampleCount' samples from the render-ahead ring, returns the number of samples read.
+	u32 midiReadRenderRing(f32* buffer, u32 stereoSampleCount, bool updateBuffer)
+	{
+		u32 read = s_renderRingRead.load(std::memory_order_relaxed);
+		const u32 write = s_renderRingWrite.load(std::memory_order_acquire);
+		if (s_renderRingReset.exchange(false))
+		{
+			read = write;
+		}
+
+		const u32 count = std::min(write - read, stereoSampleCount);
+		if (updateBuffer)
+		{
+			for (u32 i = 0; i < count; i++, buffer += 2)
+			{
+				const f32* sample = &s_renderRing[((read + i) & MIDI_RENDER_RING_MASK) * 2];
+				buffer[0] += sample[0];
+				buffer[1] += sample[1];
+			}
+		}
+		s_renderRingRead.store(read + count, std::memory_order_release);
+		return count;
+	}
+
+	void synthesizeMidi(f32* buffer, u32 stereoSampleCount, bool updateBuffer)
+	{
+		// Samples rendered ahead are always used first, so switching modes does not skip any audio.
+		u32 mixed = midiReadRenderRing(buffer, stereoSampleCount, updateBuffer);
+		if (mixed >= stereoSampleCount) { return; }
+
+		if (s_renderAhead && s_renderThread)
+		{
+			s_midiRenderUnderruns++;
+		}
+
+		// Fall back to rendering inline.
+		// If the worker is in the middle of a chunk, the rest of this buffer is silent rather than blocking.
+		bool expected = false;
+		if (!s_renderLock.compare_exchange_strong(expected, true, std::memory_order_acquire))
+		{
+			return;
+		}
+		// The worker may have finished a chunk before the lock was taken.
+		mixed += midiReadRenderRing(buffer + mixed * 2, stereoSampleCount - mixed, updateBuffer);
+
+		const u32 remaining = stereoSampleCount - mixed;
+		if (remaining)
 		{
 			// Stereo samples -> actual samples.
-			const s32 linearSampleCount = (s32)stereoSampleCount * 2;
+			const s32 linearSampleCount = (s32)remaining * 2;
 			// Make sure the sample buffer is large enough, this should only happen once.
 			if (linearSampleCount > (s32)s_sampleBuffer.size() || !s_sampleBufferPtr)
 			{
@@ -291,23 +537,81 @@ namespace TFE_MidiPlayer
 				s_sampleBufferPtr = s_sampleBuffer.data();
 			}
 
-			SDL_LockMutex(s_mutex);
-			// This is checked again, in case it was immediately changed in another thread; such as when changing midi devices or outputs.
-			if (s_midiDevice && s_midiDevice->canRender())
+			// Accumulate midi samples with existing audio samples (from soundFX).
+			if (midiRender(s_sampleBufferPtr, remaining) && updateBuffer)
 			{
-				// The midi device takes the number of stereo samples.
-				s_midiDevice->render(s_sampleBufferPtr, stereoSampleCount);
-				// Accumulate midi samples with existing audio samples (from soundFX).
-				if (updateBuffer)
+				f32* output = buffer + mixed * 2;
+				for (s32 i = 0; i < linearSampleCount; i++)
 				{
-					for (s32 i = 0; i < linearSampleCount; i++)
-					{
-						buffer[i] += s_sampleBufferPtr[i];
-					}
+					output[i] += s_sampleBufferPtr[i];
 				}
 			}
-			SDL_UnlockMutex(s_mutex);
 		}
+		midiUnlockRender();
+	}
+
+	void midiLockRender()
+	{
+		bool expected = false;
+		while (!s_renderLock.compare_exchange_weak(expected, true, std::memory_order_acquire))
+		{
+			expected = false;
+			TFE_System::sleep(0);
+		}
+	}
+
+	void midiUnlockRender()
+	{
+		s_renderLock.store(false, std::memory_order_release);
+	}
+
+	// Render Thread Function
+	int midiRenderFunc(void* userData)
+	{
+		TFE_THREAD_NAME("Midi Render");
+		static f32 chunk[MIDI_RENDER_CHUNK * 2];
+		while (s_runRenderThread.load())
+		{
+			if (!s_renderAhead)
+			{
+				TFE_System::sleep(5);
+				continue;
+			}
+
+			const u32 write = s_renderRingWrite.load(std::memory_order_relaxed);
+			const u32 fill = write - s_renderRingRead.load(std::memory_order_acquire);
+			const s32 aheadMs = std::max((s32)MIDI_RENDER_AHEAD_MIN_MS, std::min(s_renderAheadMs, (s32)MIDI_RENDER_AHEAD_MAX_MS));
+			const u32 target = u32(aheadMs * MIDI_SAMPLE_RATE / 1000);
+			s_midiRenderAheadFill = s32(fill);
+			if (fill + MIDI_RENDER_CHUNK > target)
+			{
+				TFE_System::sleep(1);
+				continue;
+			}
+
+			bool expected = false;
+			if (!s_renderLock.compare_exchange_strong(expected, true, std::memory_order_acquire))
+			{
+				TFE_System::sleep(0);
+				continue;
+			}
+			if (!midiRender(chunk, MIDI_RENDER_CHUNK))
+			{
+				// Nothing to render (such as the System Midi Device), leave the ring empty.
+				midiUnlockRender();
+				TFE_System::sleep(5);
+				continue;
+			}
+			for (u32 i = 0; i < MIDI_RENDER_CHUNK; i++)
+			{
+				f32* sample = &s_renderRing[((write + i) & MIDI_RENDER_RING_MASK) * 2];
+				sample[0] = chunk[i * 2 + 0];
+				sample[1] = chunk[i * 2 + 1];
+			}
+			s_renderRingWrite.store(write + MIDI_RENDER_CHUNK, std::memory_order_release);
+			midiUnlockRender();
+		}
+		return 0;
 	}
 
 	f32 getVolume()
@@ -321,6 +625,7 @@ namespace TFE_MidiPlayer
 		s_midiCallback.callback = callback;
 		s_midiCallback.timeStep = timeStep;
 		s_midiCallback.accumulator = 0.0;
+		s_eventResync = true;
 
 		for (u32 i = 0; i < MIDI_CHANNEL_COUNT; i++)
 		{
@@ -342,17 +647,82 @@ namespace TFE_MidiPlayer
 	//////////////////////////////////////////////////
 	// Internal
 	//////////////////////////////////////////////////
+	// Must be called while holding s_mutex, which makes the caller the only producer.
+	void midiQueueEvent(MidiEvent* evt)
+	{
+		const u32 write = s_eventWrite.load(std::memory_order_relaxed);
+		if (write - s_eventRead.load(std::memory_order_acquire) >= MIDI_EVENT_QUEUE_SIZE)
+		{
+			// The audio thread is not consuming events, hanging note detection cleans up any dropped note off.
+			s_midiDroppedEvents++;
+			return;
+		}
+
+		evt->time = u64(s_eventTime * f64(MIDI_SAMPLE_RATE));
+		evt->flags = s_eventResync ? MEVT_FLAG_RESYNC : 0;
+		s_eventResync = false;
+		s_eventQueue[write & MIDI_EVENT_QUEUE_MASK] = *evt;
+		s_eventWrite.store(write + 1, std::memory_order_release);
+	}
+
+	// Devices that render are only accessed from the audio thread, devices that don't render receive messages directly.
+	void midiDeviceMessage(const u8* msg, u32 len)
+	{
+		if (!s_midiDevice) { return; }
+		if (!s_midiDevice->canRender())
+		{
+			s_midiDevice->message(msg, len);
+			return;
+		}
+
+		MidiEvent evt = {};
+		evt.type = MEVT_MESSAGE;
+		evt.len = u8(len);
+		memcpy(evt.msg, msg, len);
+		midiQueueEvent(&evt);
+	}
+
+	void midiDeviceNotesOff()
+	{
+		if (!s_midiDevice) { return; }
+		if (!s_midiDevice->canRender())
+		{
+			s_midiDevice->noteAllOff();
+			return;
+		}
+
+		MidiEvent evt = {};
+		evt.type = MEVT_NOTES_OFF;
+		midiQueueEvent(&evt);
+	}
+
+	void midiDeviceVolume(f32 volume)
+	{
+		if (!s_midiDevice) { return; }
+		if (!s_midiDevice->canRender())
+		{
+			s_midiDevice->setVolume(volume);
+			return;
+		}
+
+		MidiEvent evt = {};
+		evt.type = MEVT_VOLUME;
+		evt.volume = volume;
+		midiQueueEvent(&evt);
+	}
+
 	void changeVolume()
 	{
 		if (s_midiDevice && s_midiDevice->hasGlobalVolumeCtrl())
 		{
-			s_midiDevice->setVolume(s_masterVolumeScaled);
+			midiDeviceVolume(s_masterVolumeScaled);
 		}
 		else if (s_midiDevice)
 		{
 			for (u32 i = 0; i < MIDI_CHANNEL_COUNT; i++)
 			{
-				s_midiDevice->message(MID_CONTROL_CHANGE + i, MID_VOLUME_MSB, u8(s_channelSrcVolume[i] * s_masterVolumeScaled));
+				const u8 msg[] = { u8(MID_CONTROL_CHANGE + i), MID_VOLUME_MSB, u8(s_channelSrcVolume[i] * s_masterVolumeScaled) };
+				midiDeviceMessage(msg, 3);
 			}
 		}
 	}
@@ -372,7 +742,8 @@ namespace TFE_MidiPlayer
 				if (s_instrOn[i].channelMask & channelMask)
 				{
 					// Turn off the note.
-					if (s_midiDevice) { s_midiDevice->message(MID_NOTE_OFF | c, i); }
+					const u8 msg[] = { u8(MID_NOTE_OFF | c), u8(i), 0 };
+					midiDeviceMessage(msg, 3);
 
 					// Reset the instrument channel information.
 					s_instrOn[i].channelMask &= ~channelMask;
@@ -381,13 +752,17 @@ namespace TFE_MidiPlayer
 			}
 		}
 
-		if (s_midiDevice) { s_midiDevice->noteAllOff(); }
+		midiDeviceNotesOff();
 		memset(s_instrOn, 0, sizeof(Instrument) * MIDI_INSTRUMENT_COUNT);
 		s_curNoteTime = 0.0;
 	}
 		
 	void sendMessageDirect(u8 type, u8 arg1, u8 arg2)
 	{
+		// TFE: The game thread sends messages directly (iMuse channel setup, stopping sounds), which races with
+		// the midi thread on the event queue and note state. SDL mutexes are recursive so this is safe to call
+		// from the midi callback, which already holds the lock.
+		SDL_LockMutex(s_mutex);
 		u8 msg[] = { type, arg1, arg2 };
 		u8 msgType = (type & 0xf0);
 		u8 len;
@@ -400,7 +775,7 @@ namespace TFE_MidiPlayer
 			s_channelSrcVolume[channelIndex] = arg2;
 			msg[2] = u8(s_channelSrcVolume[channelIndex] * s_masterVolumeScaled);
 		}
-		if (s_midiDevice) { s_midiDevice->message(msg, len); }
+		midiDeviceMessage(msg, len);
 
 		// Record currently playing instruments and the note-on times.
 		if (msgType == MID_NOTE_OFF || msgType == MID_NOTE_ON)
@@ -418,6 +793,7 @@ namespace TFE_MidiPlayer
 				s_instrOn[instr].time[channel] = s_curNoteTime;
 			}
 		}
+		SDL_UnlockMutex(s_mutex);
 	}
 	
 	void detectHangingNotes()
@@ -447,6 +823,7 @@ namespace TFE_MidiPlayer
 	// Thread Function
 	int midiUpdateFunc(void* userData)
 	{
+		TFE_THREAD_NAME("Midi Update");
 		bool runThread  = true;
 		bool wasPlaying = false;
 		bool isPlaying  = false;
@@ -474,6 +851,7 @@ namespace TFE_MidiPlayer
 					case MIDI_RESUME:
 					{
 						isPaused = false;
+						s_eventResync = true;
 					} break;
 					case MIDI_CHANGE_VOL:
 					{
@@ -487,6 +865,7 @@ namespace TFE_MidiPlayer
 						// Reset callback time.
 						localTimeCallback = 0;
 						s_midiCallback.accumulator = 0.0;
+						s_eventResync = true;
 					} break;
 				}
 			}
@@ -495,12 +874,15 @@ namespace TFE_MidiPlayer
 			// Process the midi callback, if it exists.
 			if (s_midiCallback.callback && !isPaused)
 			{
+				TFE_ZONE("Midi Callback");
 				s_midiCallback.accumulator += TFE_System::updateThreadLocal(&localTimeCallback);
 				while (s_midiCallback.callback && s_midiCallback.accumulator >= s_midiCallback.timeStep)
 				{
 					s_midiCallback.callback();
 					s_midiCallback.accumulator -= s_midiCallback.timeStep;
 					s_curNoteTime += s_midiCallback.timeStep;
+					// Events from the next callback are stamped one time step later.
+					s_eventTime += s_midiCallback.timeStep;
 				}
 
 				// Check for hanging notes.
@@ -538,6 +920,10 @@ namespace TFE_MidiPlayer
 		if (s_midiDevice && s_midiDevice->getType() == type) { return; }
 		delete s_midiDevice;
 		s_midiDevice = nullptr;
+		// Events and samples queued for the old device are discarded.
+		s_eventQueueReset.store(true);
+		s_renderRingReset.store(true);
+		s_eventResync = true;
 
 		switch (type)
 		{
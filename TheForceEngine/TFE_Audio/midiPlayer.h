@@ -41,6 +41,7 @@ namespace TFE_MidiPlayer
 	// Stop all notes.
 	void stopMidiSound();
 
+	// Called from the audio thread, queued midi events are applied at their sample offset without locking.
 	void synthesizeMidi(f32* buffer, u32 stereoSampleCount, bool updateBuffer = true);
 
 	///////////////////////////////////////////////////////////
@@ -9,6 +9,7 @@
 #include "gameMusic.h"
 #include "hud.h"
 #include "item.h"
+#include "loadBenchmark.h"
 #include "mission.h"
 #include "player.h"
 #include "pickup.h"
@@ -317,6 +318,7 @@ namespace TFE_DarkForces
 		// TFE Specific
 		agentMenu_load(&s_sharedState.langKeys);
 		escapeMenu_load(&s_sharedState.langKeys);
+		loadBenchmark_registerCommands();
 		// Add texture callbacks.
 		renderer_addHudTextureCallback(TFE_Jedi::level_getLevelTextures);
 		renderer_addHudTextureCallback(TFE_Jedi::level_getObjectTextures);
@@ -774,6 +776,8 @@ namespace TFE_DarkForces
 			case GMODE_MISSION:
 			{
 				sound_levelStart();
+				// TFE: The level memory is unused until the mission is set up below.
+				loadBenchmark_runPending();
 
 				bitmap_setAllocator(s_levelRegion);
 				actor_clearState();
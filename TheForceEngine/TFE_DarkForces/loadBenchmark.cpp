@@ -0,0 +1,596 @@
+#include <cstring>
+
+#include "loadBenchmark.h"
+#include "agent.h"
+#include "mission.h"
+#include <TFE_DarkForces/Actor/actor.h>
+#include <TFE_Asset/dfKeywords.h>
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_FrontEndUI/console.h>
+#include <TFE_Game/igame.h>
+#include <TFE_Memory/memoryRegion.h>
+#include <TFE_Jedi/InfSystem/infSystem.h>
+#include <TFE_Jedi/InfSystem/message.h>
+#include <TFE_Jedi/Level/level.h>
+#include <TFE_Jedi/Level/levelData.h>
+#include <TFE_Jedi/Level/rtexture.h>
+#include <TFE_Jedi/Math/core_math.h>
+#include <TFE_Jedi/Task/task.h>
+#include <TFE_System/parser.h>
+#include <TFE_System/system.h>
+#include <cctype>
+#include <string>
+#include <vector>
+
+using namespace TFE_Jedi;
+
+namespace TFE_DarkForces
+{
+	enum LoadBenchmarkConst
+	{
+		BENCH_DEFAULT_ITERATIONS = 20,
+		BENCH_MAX_ITERATIONS = 10000,
+	};
+
+	static s32 loadBenchmark_getIterations(const ConsoleArgList& args)
+	{
+		const s32 iterations = args.size() >= 2 ? (s32)TFE_Console::getFloatArg(args[1]) : BENCH_DEFAULT_ITERATIONS;
+		return clamp(iterations, 1, (s32)BENCH_MAX_ITERATIONS);
+	}
+
+	static void loadBenchmark_print(const char* msg)
+	{
+		TFE_Console::addToHistory(msg);
+		TFE_System::logWrite(LOG_MSG, "Benchmark", "%s", msg);
+	}
+
+	// Read a level file as a null terminated buffer, returns false if it doesn't exist.
+	static bool loadBenchmark_readLevelFile(const char* levelName, const char* ext, std::vector<char>& buffer)
+	{
+		char fileName[TFE_MAX_PATH];
+		sprintf(fileName, "%s%s", levelName, ext);
+
+		FilePath filePath;
+		FileStream file;
+		if (!TFE_Paths::getFilePath(fileName, &filePath) || !file.open(&filePath, Stream::MODE_READ))
+		{
+			return false;
+		}
+		const size_t size = file.getSize();
+		buffer.resize(size + 1);
+		file.readBuffer(buffer.data(), u32(size));
+		buffer[size] = 0;
+		file.close();
+		return true;
+	}
+
+	//////////////////////////////////////////////////////////////////////
+	// Load benchmark
+	// Every level in the level list is loaded with level_load() before
+	// the next mission is set up, when the level memory is unused. The
+	// keyword and address lookups made while loading are also timed
+	// against the original linear searches.
+	//////////////////////////////////////////////////////////////////////
+	struct LoadBenchAddress
+	{
+		char name[17];
+		RSector* sector;
+	};
+
+	static s32 s_benchLoadIterations = 0;
+	static size_t s_benchLoadSink = 0;
+
+	// The original linear search replaced by getKeywordIndex().
+	static KEYWORD loadBench_getKeywordLinear(const char* keywordString)
+	{
+		for (s32 i = 0; i < KW_COUNT; i++)
+		{
+			const char* keyword = getKeywordString(KEYWORD(i));
+			if (toupper(keywordString[0]) == keyword[0] && !strcasecmp(keywordString, keyword))
+			{
+				return KEYWORD(i);
+			}
+		}
+		return KW_UNKNOWN;
+	}
+
+	// The original linear search replaced by message_getAddress(), over a copy of the address list.
+	static const LoadBenchAddress* loadBench_getAddressLinear(const std::vector<LoadBenchAddress>& list, const char* name)
+	{
+		for (size_t i = 0; i < list.size(); i++)
+		{
+			if (strncasecmp(name, list[i].name, 16) == 0)
+			{
+				return &list[i];
+			}
+		}
+		return nullptr;
+	}
+
+	// Every word in the level .O and .INF files, which is a superset of the strings passed to getKeywordIndex() while loading.
+	static void loadBench_gatherWords(const char* levelName, std::vector<std::string>& words)
+	{
+		static const char* c_keywordFiles[] = { ".O", ".INF" };
+		std::vector<char> buffer;
+		words.clear();
+		for (size_t f = 0; f < TFE_ARRAYSIZE(c_keywordFiles); f++)
+		{
+			if (!loadBenchmark_readLevelFile(levelName, c_keywordFiles[f], buffer)) { continue; }
+
+			const char* c = buffer.data();
+			while (*c)
+			{
+				while (*c && isspace(u8(*c))) { c++; }
+				const char* start = c;
+				while (*c && !isspace(u8(*c))) { c++; }
+				// Keywords always start with a letter, skip numbers and symbols.
+				if (c > start && isalpha(u8(*start)))
+				{
+					words.push_back(std::string(start, c - start));
+				}
+			}
+		}
+	}
+
+	// The sector names in the .LEV file, in the order message_addAddress() is called while loading.
+	// Must be called while the level is loaded.
+	static void loadBench_gatherAddresses(const char* levelName, std::vector<LoadBenchAddress>& list)
+	{
+		std::vector<char> buffer;
+		list.clear();
+		if (!loadBenchmark_readLevelFile(levelName, ".LEV", buffer)) { return; }
+
+		s32 sectorIndex = -1;
+		for (char* line = strtok(buffer.data(), "\r\n"); line; line = strtok(nullptr, "\r\n"))
+		{
+			s32 id;
+			char name[256];
+			if (sscanf(line, " SECTOR %d", &id) == 1)
+			{
+				sectorIndex++;
+			}
+			else if (sectorIndex >= 0 && sectorIndex < s32(s_levelState.sectorCount) && sscanf(line, " NAME %255s", name) == 1)
+			{
+				LoadBenchAddress addr;
+				strncpy(addr.name, name, 16);
+				addr.name[16] = 0;
+				addr.sector = &s_levelState.sectors[sectorIndex];
+				list.push_back(addr);
+			}
+		}
+	}
+
+	// Time the hashed and linear lookups for the loaded level in milliseconds per load, returns the number of mismatches.
+	static s32 loadBench_timeLookups(const char* levelName, s32 iterations, f64* hashTime, f64* linearTime, s32* lookupCount)
+	{
+		std::vector<std::string> words;
+		std::vector<LoadBenchAddress> addresses;
+		loadBench_gatherWords(levelName, words);
+		loadBench_gatherAddresses(levelName, addresses);
+		*lookupCount = s32(words.size() + addresses.size());
+
+		s32 mismatches = 0;
+		for (size_t w = 0; w < words.size(); w++)
+		{
+			if (getKeywordIndex(words[w].c_str()) != loadBench_getKeywordLinear(words[w].c_str())) { mismatches++; }
+		}
+		for (size_t a = 0; a < addresses.size(); a++)
+		{
+			const MessageAddress* msgAddr = message_getAddress(addresses[a].name);
+			const LoadBenchAddress* linearAddr = loadBench_getAddressLinear(addresses, addresses[a].name);
+			if (!msgAddr || msgAddr->sector != linearAddr->sector) { mismatches++; }
+		}
+
+		// The results are summed so the lookups cannot be optimized out.
+		size_t checksum = 0;
+		u64 ticks = TFE_System::getCurrentTimeInTicks();
+		for (s32 it = 0; it < iterations; it++)
+		{
+			for (size_t w = 0; w < words.size(); w++) { checksum += size_t(getKeywordIndex(words[w].c_str())); }
+			for (size_t a = 0; a < addresses.size(); a++) { checksum += size_t(message_getAddress(addresses[a].name)); }
+		}
+		*hashTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - ticks) * 1000.0 / f64(iterations);
+
+		ticks = TFE_System::getCurrentTimeInTicks();
+		for (s32 it = 0; it < iterations; it++)
+		{
+			for (size_t w = 0; w < words.size(); w++) { checksum += size_t(loadBench_getKeywordLinear(words[w].c_str())); }
+			for (size_t a = 0; a < addresses.size(); a++) { checksum += size_t(loadBench_getAddressLinear(addresses, addresses[a].name)); }
+		}
+		*linearTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - ticks) * 1000.0 / f64(iterations);
+
+		s_benchLoadSink += checksum;
+		return mismatches;
+	}
+
+	// Set up the same state as the start of a mission.
+	static void loadBench_beginLoad()
+	{
+		bitmap_setAllocator(s_levelRegion);
+		actor_clearState();
+		task_reset();
+		inf_clearState();
+		mission_setupTasks();
+	}
+
+	// Free the level the same way as the end of a mission.
+	static void loadBench_endLoad()
+	{
+		task_freeAll();
+		task_reset();
+		TFE_Memory::region_clear(s_levelRegion);
+		bitmap_clearLevelData();
+		bitmap_setAllocator(s_gameRegion);
+		level_freeAllAssets();
+	}
+
+	static void loadBench_addTimes(LevelLoadTimes* sum, const LevelLoadTimes* times)
+	{
+		sum->prefetch += times->prefetch;
+		sum->geometry += times->geometry;
+		sum->objects  += times->objects;
+		sum->inf      += times->inf;
+		sum->goals    += times->goals;
+		sum->total    += times->total;
+	}
+
+	static void loadBench_printTimes(const char* name, const LevelLoadTimes* times, f64 hashTime, f64 linearTime, s32 lookupCount, s32 mismatches)
+	{
+		char msg[256];
+		sprintf(msg, "%s: %.2f ms (geometry %.2f, objects %.2f, INF %.2f), %d lookups: hashed %.3f ms, linear %.3f ms, %d mismatches.",
+			name, times->total, times->geometry, times->objects, times->inf, lookupCount, hashTime, linearTime, mismatches);
+		loadBenchmark_print(msg);
+	}
+
+	static void console_benchLoad(const ConsoleArgList& args)
+	{
+		s_benchLoadIterations = loadBenchmark_getIterations(args);
+		loadBenchmark_print("The load benchmark will run when the next mission starts.");
+	}
+
+	void loadBenchmark_runPending()
+	{
+		if (s_benchLoadIterations <= 0) { return; }
+		const s32 iterations = s_benchLoadIterations;
+		s_benchLoadIterations = 0;
+
+		char msg[256];
+		sprintf(msg, "Loading each level %d times, times are per load:", iterations);
+		loadBenchmark_print(msg);
+
+		const u8 difficulty = s_agentData[s_agentId].difficulty;
+		LevelLoadTimes total = {};
+		f64 totalHashTime = 0.0, totalLinearTime = 0.0;
+		s32 totalLookups = 0, totalMismatches = 0, levelCount = 0;
+		for (s32 i = 0; i < s_maxLevelIndex; i++)
+		{
+			const char* levelName = s_levelGamePaths[i];
+			if (!levelName) { continue; }
+
+			LevelLoadTimes sum = {};
+			f64 hashTime = 0.0, linearTime = 0.0;
+			s32 loads = 0, lookupCount = 0, mismatches = 0;
+			for (s32 it = 0; it < iterations; it++)
+			{
+				loadBench_beginLoad();
+				const JBool loaded = level_load(levelName, difficulty);
+				if (loaded)
+				{
+					loadBench_addTimes(&sum, level_getLoadTimes());
+					loads++;
+					// The addresses only exist while the level is loaded.
+					if (it == 0) { mismatches = loadBench_timeLookups(levelName, iterations, &hashTime, &linearTime, &lookupCount); }
+				}
+				loadBench_endLoad();
+				if (!loaded) { break; }
+			}
+			if (!loads)
+			{
+				sprintf(msg, "%s: failed to load.", levelName);
+				loadBenchmark_print(msg);
+				continue;
+			}
+
+			const f64 scale = 1.0 / f64(loads);
+			LevelLoadTimes average = {};
+			average.prefetch = sum.prefetch * scale;
+			average.geometry = sum.geometry * scale;
+			average.objects  = sum.objects * scale;
+			average.inf      = sum.inf * scale;
+			average.goals    = sum.goals * scale;
+			average.total    = sum.total * scale;
+			loadBench_printTimes(levelName, &average, hashTime, linearTime, lookupCount, mismatches);
+			loadBench_addTimes(&total, &average);
+			totalHashTime += hashTime;
+			totalLinearTime += linearTime;
+			totalLookups += lookupCount;
+			totalMismatches += mismatches;
+			levelCount++;
+		}
+
+		if (levelCount)
+		{
+			sprintf(msg, "All %d levels", levelCount);
+			loadBench_printTimes(msg, &total, totalHashTime, totalLinearTime, totalLookups, totalMismatches);
+		}
+		else
+		{
+			loadBenchmark_print("No levels found in the level list.");
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////
+	// Parse benchmark
+	// The lines the loaders tokenize are parsed both with the original
+	// sscanf() calls and with TFE_Parser::tokenizeLine() + TFE_Token,
+	// reading the same fields in the same order as the loaders.
+	//////////////////////////////////////////////////////////////////////
+	enum ParseBenchKind
+	{
+		PB_SECTOR = 0,
+		PB_AMBIENT,
+		PB_FLOOR_TEXTURE,
+		PB_FLOOR_ALTITUDE,
+		PB_CEILING_TEXTURE,
+		PB_CEILING_ALTITUDE,
+		PB_SECOND_ALTITUDE,
+		PB_FLAGS,
+		PB_LAYER,
+		PB_VERTICES,
+		PB_VERTEX,
+		PB_WALLS,
+		PB_WALL,
+		PB_POD,
+		PB_SPR,
+		PB_FME,
+		PB_SOUND,
+		PB_CLASS,
+		PB_INF_ARGS,
+		PB_COUNT
+	};
+
+	enum ParseBenchFile
+	{
+		PB_FILE_LEV = 0,
+		PB_FILE_O,
+		PB_FILE_INF,
+		PB_FILE_COUNT
+	};
+
+	enum { PB_MAX_TOKENS = 48, PB_MAX_LINE = 4096 };
+
+	// 'layout' lists the fields read by the loader: k = keyword, i = int, f = float, s = string.
+	// Keywords are matched against 'keys' in order.
+	struct ParseBenchFormat
+	{
+		ParseBenchFile file;
+		const char* layout;
+		const char* keys[12];
+	};
+
+	static const ParseBenchFormat c_parseBenchFormats[PB_COUNT] =
+	{
+		{ PB_FILE_LEV, "ki",     { "SECTOR" } },
+		{ PB_FILE_LEV, "ki",     { "AMBIENT" } },
+		{ PB_FILE_LEV, "kkiffi", { "FLOOR", "TEXTURE" } },
+		{ PB_FILE_LEV, "kkf",    { "FLOOR", "ALTITUDE" } },
+		{ PB_FILE_LEV, "kkiffi", { "CEILING", "TEXTURE" } },
+		{ PB_FILE_LEV, "kkf",    { "CEILING", "ALTITUDE" } },
+		{ PB_FILE_LEV, "kkf",    { "SECOND", "ALTITUDE" } },
+		{ PB_FILE_LEV, "kiii",   { "FLAGS" } },
+		{ PB_FILE_LEV, "ki",     { "LAYER" } },
+		{ PB_FILE_LEV, "ki",     { "VERTICES" } },
+		{ PB_FILE_LEV, "kfkf",   { "X", "Z" } },
+		{ PB_FILE_LEV, "ki",     { "WALLS" } },
+		{ PB_FILE_LEV, "kkikikiffikiffikiffikiffkikikikiiiki", { "WALL", "LEFT", "RIGHT", "MID", "TOP", "BOT", "SIGN", "ADJOIN", "MIRROR", "WALK", "FLAGS", "LIGHT" } },
+		{ PB_FILE_O,   "ks",     { "POD" } },
+		{ PB_FILE_O,   "ks",     { "SPR" } },
+		{ PB_FILE_O,   "ks",     { "FME" } },
+		{ PB_FILE_O,   "ks",     { "SOUND" } },
+		{ PB_FILE_O,   "kskikfkfkfkfkfkfki", { "CLASS", "DATA", "X", "Y", "Z", "PCH", "YAW", "ROL", "DIFF" } },
+		{ PB_FILE_INF, "sssssss", { } },
+	};
+	static const char* c_parseBenchExt[PB_FILE_COUNT] = { ".LEV", ".O", ".INF" };
+
+	struct ParseBenchLine
+	{
+		std::string text;
+		ParseBenchKind kind;
+	};
+
+	// Scratch outputs, large enough for any line the parser returns.
+	static s32  s_benchInt[32];
+	static f32  s_benchFloat[32];
+	static char s_benchStr[7][PB_MAX_LINE];
+
+	// Configure the parser the same way as the loader for each file type.
+	static void parseBench_initParser(TFE_Parser& parser, ParseBenchFile file, const char* data, size_t len)
+	{
+		parser.init(data, len);
+		if (file != PB_FILE_LEV)
+		{
+			parser.enableBlockComments();
+			parser.addCommentString("//");
+		}
+		if (file != PB_FILE_INF)
+		{
+			parser.addCommentString("#");
+			parser.enableColonSeperator();
+		}
+		else
+		{
+			parser.enableWhitespaceOnlyTokens(true);
+		}
+		parser.convertToUpperCase(true);
+	}
+
+	static ParseBenchKind parseBench_classify(ParseBenchFile file, const TokenSpan* tokens, s32 count)
+	{
+		if (file == PB_FILE_INF) { return PB_INF_ARGS; }
+		for (s32 k = 0; k < PB_INF_ARGS; k++)
+		{
+			const ParseBenchFormat* format = &c_parseBenchFormats[k];
+			if (format->file != file || count < 1 || !TFE_Token::equals(tokens[0], format->keys[0])) { continue; }
+			// The second keyword is only part of the line type if it directly follows the first.
+			if (format->layout[1] == 'k' && (count < 2 || !TFE_Token::equals(tokens[1], format->keys[1]))) { continue; }
+			return ParseBenchKind(k);
+		}
+		return PB_COUNT;
+	}
+
+	// The original sscanf() calls used by the loaders.
+	static s32 parseBench_scan(const char* line, ParseBenchKind kind)
+	{
+		s32* i = s_benchInt;
+		f32* f = s_benchFloat;
+		switch (kind)
+		{
+			case PB_SECTOR:           return sscanf(line, " SECTOR %d", &i[0]);
+			case PB_AMBIENT:          return sscanf(line, " AMBIENT %d", &i[0]);
+			case PB_FLOOR_TEXTURE:    return sscanf(line, " FLOOR TEXTURE %d %f %f %d", &i[0], &f[0], &f[1], &i[1]);
+			case PB_FLOOR_ALTITUDE:   return sscanf(line, " FLOOR ALTITUDE %f", &f[0]);
+			case PB_CEILING_TEXTURE:  return sscanf(line, " CEILING TEXTURE %d %f %f %d", &i[0], &f[0], &f[1], &i[1]);
+			case PB_CEILING_ALTITUDE: return sscanf(line, " CEILING ALTITUDE %f", &f[0]);
+			case PB_SECOND_ALTITUDE:  return sscanf(line, " SECOND ALTITUDE %f", &f[0]);
+			case PB_FLAGS:            return sscanf(line, " FLAGS %d %d %d", &i[0], &i[1], &i[2]);
+			case PB_LAYER:            return sscanf(line, " LAYER %d", &i[0]);
+			case PB_VERTICES:         return sscanf(line, " VERTICES %d", &i[0]);
+			case PB_VERTEX:           return sscanf(line, " X: %f Z: %f ", &f[0], &f[1]);
+			case PB_WALLS:            return sscanf(line, " WALLS %d", &i[0]);
+			case PB_WALL:
+				return sscanf(line, " WALL LEFT: %d RIGHT: %d MID: %d %f %f %d TOP: %d %f %f %d BOT: %d %f %f %d SIGN: %d %f %f ADJOIN: %d MIRROR: %d WALK: %d FLAGS: %d %d %d LIGHT: %d",
+					&i[0], &i[1], &i[2], &f[0], &f[1], &i[3], &i[4], &f[2], &f[3], &i[5], &i[6], &f[4], &f[5], &i[7], &i[8], &f[6], &f[7],
+					&i[9], &i[10], &i[11], &i[12], &i[13], &i[14], &i[15]);
+			case PB_POD:   return sscanf(line, " POD: %s", s_benchStr[0]);
+			case PB_SPR:   return sscanf(line, " SPR: %s ", s_benchStr[0]);
+			case PB_FME:   return sscanf(line, " FME: %s ", s_benchStr[0]);
+			case PB_SOUND: return sscanf(line, " SOUND: %s ", s_benchStr[0]);
+			case PB_CLASS:
+				return sscanf(line, " CLASS: %s DATA: %d X: %f Y: %f Z: %f PCH: %f YAW: %f ROL: %f DIFF: %d", s_benchStr[0], &i[0], &f[0], &f[1], &f[2], &f[3], &f[4], &f[5], &i[1]);
+			case PB_INF_ARGS:
+				return sscanf(line, " %s %s %s %s %s %s %s", s_benchStr[0], s_benchStr[1], s_benchStr[2], s_benchStr[3], s_benchStr[4], s_benchStr[5], s_benchStr[6]);
+			default:
+				break;
+		}
+		return 0;
+	}
+
+	// Tokenize and read the fields in the same order as the loaders, returns the number of values read.
+	static s32 parseBench_tokenize(TFE_Parser& parser, const char* line, ParseBenchKind kind)
+	{
+		const ParseBenchFormat* format = &c_parseBenchFormats[kind];
+		TokenSpan tokens[PB_MAX_TOKENS];
+		const s32 count = parser.tokenizeLine(line, tokens, PB_MAX_TOKENS);
+
+		s32 values = 0, key = 0, intIndex = 0, floatIndex = 0;
+		for (s32 t = 0; t < count && format->layout[t]; t++)
+		{
+			switch (format->layout[t])
+			{
+				case 'k':
+					if (!TFE_Token::equals(tokens[t], format->keys[key++])) { return values; }
+					break;
+				case 'i':
+					if (!TFE_Token::toInt(tokens[t], &s_benchInt[intIndex++])) { return values; }
+					values++;
+					break;
+				case 'f':
+					if (!TFE_Token::toFloat(tokens[t], &s_benchFloat[floatIndex++])) { return values; }
+					values++;
+					break;
+				case 's':
+					TFE_Token::copy(tokens[t], s_benchStr[values], PB_MAX_LINE);
+					values++;
+					break;
+			}
+		}
+		return values;
+	}
+
+	// Times the original sscanf() parsing of the .LEV, .O and .INF lines against the tokenizer, for every level in the level list.
+	static void console_benchParse(const ConsoleArgList& args)
+	{
+		const s32 iterations = loadBenchmark_getIterations(args);
+		char msg[256];
+
+		std::vector<ParseBenchLine> lines[PB_FILE_COUNT];
+		size_t bytes[PB_FILE_COUNT] = { 0 };
+		s32 fileCount[PB_FILE_COUNT] = { 0 };
+		std::vector<char> buffer;
+		for (s32 i = 0; i < s_maxLevelIndex; i++)
+		{
+			if (!s_levelGamePaths[i]) { continue; }
+			for (s32 f = 0; f < PB_FILE_COUNT; f++)
+			{
+				if (!loadBenchmark_readLevelFile(s_levelGamePaths[i], c_parseBenchExt[f], buffer)) { continue; }
+				fileCount[f]++;
+				bytes[f] += buffer.size() - 1;
+
+				TFE_Parser parser;
+				parseBench_initParser(parser, ParseBenchFile(f), buffer.data(), buffer.size() - 1);
+				size_t bufferPos = 0;
+				while (const char* line = parser.readLine(bufferPos))
+				{
+					TokenSpan tokens[PB_MAX_TOKENS];
+					const s32 count = parser.tokenizeLine(line, tokens, PB_MAX_TOKENS);
+					const ParseBenchKind kind = parseBench_classify(ParseBenchFile(f), tokens, count);
+					if (kind != PB_COUNT)
+					{
+						lines[f].push_back({ line, kind });
+					}
+				}
+			}
+		}
+
+		bool found = false;
+		for (s32 f = 0; f < PB_FILE_COUNT; f++)
+		{
+			if (lines[f].empty()) { continue; }
+			found = true;
+
+			TFE_Parser parser;
+			parseBench_initParser(parser, ParseBenchFile(f), nullptr, 0);
+			const std::vector<ParseBenchLine>& list = lines[f];
+
+			s32 mismatches = 0;
+			for (size_t l = 0; l < list.size(); l++)
+			{
+				if (parseBench_scan(list[l].text.c_str(), list[l].kind) != parseBench_tokenize(parser, list[l].text.c_str(), list[l].kind)) { mismatches++; }
+			}
+
+			// The value counts are summed so the parsing cannot be optimized out.
+			s64 checksum[2] = { 0 };
+			u64 ticks = TFE_System::getCurrentTimeInTicks();
+			for (s32 it = 0; it < iterations; it++)
+			{
+				for (size_t l = 0; l < list.size(); l++) { checksum[0] += parseBench_scan(list[l].text.c_str(), list[l].kind); }
+			}
+			const f64 scanTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - ticks);
+
+			ticks = TFE_System::getCurrentTimeInTicks();
+			for (s32 it = 0; it < iterations; it++)
+			{
+				for (size_t l = 0; l < list.size(); l++) { checksum[1] += parseBench_tokenize(parser, list[l].text.c_str(), list[l].kind); }
+			}
+			const f64 tokenTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - ticks);
+
+			const f64 lineCount = f64(list.size()) * f64(iterations);
+			sprintf(msg, "%s: %d files, %.1f KB, %d lines x %d, sscanf %.2fM lines/s, tokenizer %.2fM lines/s, %d mismatches%s.",
+				c_parseBenchExt[f], fileCount[f], f64(bytes[f]) / 1024.0, (s32)list.size(), iterations,
+				lineCount / max(scanTime, 1.0e-9) * 1.0e-6, lineCount / max(tokenTime, 1.0e-9) * 1.0e-6,
+				mismatches, checksum[0] == checksum[1] ? "" : " (checksum differs)");
+			loadBenchmark_print(msg);
+		}
+		if (!found)
+		{
+			loadBenchmark_print("No level .LEV, .O or .INF files found.");
+		}
+	}
+
+	void loadBenchmark_registerCommands()
+	{
+		CCMD("benchParse", console_benchParse, 0, "Time parsing the level .LEV, .O and .INF lines with sscanf() against the tokenizer - benchParse [iterations]");
+		CCMD("benchLoad", console_benchLoad, 0, "Time loading every level in the level list when the next mission starts, and the keyword and INF address lookups against the original linear searches - benchLoad [iterations]");
+	}
+}
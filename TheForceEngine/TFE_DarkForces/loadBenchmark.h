@@ -0,0 +1,15 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Dark Forces Load Benchmarks
+// Console commands that time level loading, and the loading lookups
+// and parsing against the original code paths, using the levels in the
+// current level list, so the results can be reproduced on any install.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+namespace TFE_DarkForces
+{
+	void loadBenchmark_registerCommands();
+	// Runs the load benchmark if it was requested, called before the next mission is set up.
+	void loadBenchmark_runPending();
+}
@@ -16,6 +16,7 @@
 #include <TFE_FrontEndUI/frontEndUi.h>
 #include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_System/system.h>
+#include <TFE_System/jobs.h>
 #include <TFE_Settings/settings.h>
 #include <TFE_FileSystem/filestream.h>
 #include <TFE_FileSystem/fileutil.h>
@@ -29,6 +30,8 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <atomic>
 
 using namespace TFE_Editor;
 
@@ -99,9 +102,61 @@ namespace AssetBrowser
 	static ViewerInfo s_viewInfo = {};
 	static AssetList s_viewAssetList;
 	static AssetList s_projectAssetList[TYPE_COUNT];
+	// Maps the upper case asset name to its index in s_projectAssetList.
+	static std::unordered_map<std::string, s32> s_projectAssetLookup[TYPE_COUNT];
+
+	// Level Index
+	// Finding the palette and assets used by each level requires reading and parsing every level,
+	// so the results are saved to disk keyed by the archive path, size and modification time.
+	// Levels missing from the index are parsed on the job workers while the browser shows the progress.
+	enum LevelIndexConst : u32
+	{
+		LEVEL_INDEX_MAGIC = 0x58444941,	// "AIDX"
+		// Increment whenever the index format or the level parsing changes.
+		LEVEL_INDEX_VERSION = 1,
+		// No level references anywhere near this many assets of one type, larger counts mean the index is corrupt.
+		LEVEL_INDEX_MAX_LIST = 65536,
+	};
+	static const char* c_levelIndexName = "assetIndex.dat";
+
+	struct IndexedLevel
+	{
+		LevelAssets assets;
+		bool valid = false;
+	};
+
+	struct IndexedArchive
+	{
+		u64 size = 0;
+		u64 modifiedTime = 0;
+		std::map<std::string, IndexedLevel> levels;
+	};
+
+	struct LevelIndexItem
+	{
+		std::string archivePath;
+		std::string key;
+		IndexedLevel level;
+		// Level data to parse, empty if the level was found in the index.
+		std::vector<u8> levData;
+		std::vector<u8> objData;
+	};
+
+	static std::map<std::string, IndexedArchive> s_levelIndex;
+	static bool s_levelIndexLoaded = false;
+	static std::vector<LevelIndexItem> s_levelIndexItems;
+	static std::vector<s32> s_levelParseList;
+	static JobCounter s_levelParseCounter;
+	static std::atomic<s32> s_levelParseDone(0);
+	static bool s_levelIndexPending = false;
 
 	// Forward Declarations
-	void updateAssetList();
+	void updateAssetList(bool waitForLevelIndex = false);
+	void applyLevelIndex();
+	void finishLevelIndexing();
+	void cancelLevelIndexing();
+	std::string getAssetKey(const char* name);
+	bool pollLevelIndexing();
 	void reloadAsset(Asset* asset, s32 palId, s32 lightLevel = 32);
 	bool isSelected(s32 index);
 	void unselect(s32 index);
@@ -117,6 +172,7 @@ namespace AssetBrowser
 
 	void destroy()
 	{
+		cancelLevelIndexing();
 		s_reloadProjectAssets = true;
 		s_assetsNeedProcess = true;
 		s_palettes.clear();
@@ -128,6 +184,7 @@ namespace AssetBrowser
 		for (s32 i = 0; i < TYPE_COUNT; i++)
 		{
 			s_projectAssetList[i].clear();
+			s_projectAssetLookup[i].clear();
 		}
 		freeAllAssetData();
 	}
@@ -877,7 +934,11 @@ namespace AssetBrowser
 		ImGui::Begin("Asset List", &active, window_flags);
 
 		// Draw items
-		if (!s_viewAssetList.empty())
+		if (s_levelIndexPending)
+		{
+			ImGui::Text("Indexing levels... %d / %d", s_levelParseDone.load(), (s32)s_levelParseList.size());
+		}
+		else if (!s_viewAssetList.empty())
 		{
 			drawAssetList(w, h);
 
@@ -935,7 +996,7 @@ namespace AssetBrowser
 		s_selectRange[0] = -1;
 		s_selectRange[1] = -1;
 
-		updateAssetList();
+		updateAssetList(true);
 		selectByAssetName(selectName);
 	}
 	
@@ -978,6 +1039,11 @@ namespace AssetBrowser
 			s_assetsNeedProcess = true;
 			updateAssetList();
 		}
+		// Fill in the asset list once the levels have been indexed.
+		if (pollLevelIndexing())
+		{
+			updateAssetList();
+		}
 
 		DisplayInfo displayInfo;
 		TFE_RenderBackend::getDisplayInfo(&displayInfo);
@@ -1053,14 +1119,10 @@ namespace AssetBrowser
 
 	Asset* findAsset(const char* name, AssetType type)
 	{
-		const size_t len = s_projectAssetList[type].size();
-		Asset* asset = s_projectAssetList[type].data();
-		for (size_t i = 0; i < len; i++, asset++)
+		std::unordered_map<std::string, s32>::iterator iAsset = s_projectAssetLookup[type].find(getAssetKey(name));
+		if (iAsset != s_projectAssetLookup[type].end())
 		{
-			if (strcasecmp(asset->name.c_str(), name) == 0)
-			{
-				return asset;
-			}
+			return &s_projectAssetList[type][iAsset->second];
 		}
 		return nullptr;
 	}
@@ -1068,6 +1130,17 @@ namespace AssetBrowser
 	////////////////////////////////////////////////
 	// Internal
 	////////////////////////////////////////////////
+	std::string getAssetKey(const char* name)
+	{
+		std::string key = name;
+		const size_t len = key.length();
+		for (size_t i = 0; i < len; i++)
+		{
+			key[i] = toupper(key[i]);
+		}
+		return key;
+	}
+
 	Archive* getArchive(const char* name, GameID gameId)
 	{
 		TFE_Settings_Game* game = TFE_Settings::getGameSettings();
@@ -1194,10 +1267,364 @@ namespace AssetBrowser
 		assetList.push_back(assetName);
 	}
 
+	// Parse a level for 1) the palette, 2) the data lists.
+	// This only reads the level data, so it can run on the job workers.
+	bool parseLevelAssets(const u8* levData, size_t levSize, const u8* objData, size_t objSize, LevelAssets* levelAssets)
+	{
+		// .LEV
+		{
+			TFE_Parser parser;
+			size_t bufferPos = 0;
+			parser.init((const char*)levData, levSize);
+			parser.addCommentString("#");
+			parser.convertToUpperCase(true);
+
+			// Read just enough of the file...
+			const char* line;
+			line = parser.readLine(bufferPos);
+			s32 versionMajor, versionMinor;
+			if (!line || sscanf(line, " LEV %d.%d", &versionMajor, &versionMinor) != 2)
+			{
+				return false;
+			}
+
+			char readBuffer[256];
+			line = parser.readLine(bufferPos);
+			if (!line || sscanf(line, " LEVELNAME %s", readBuffer) != 1)
+			{
+				return false;
+			}
+
+			// This gets read here just to be overwritten later... so just ignore for now.
+			line = parser.readLine(bufferPos);
+			if (!line || sscanf(line, " PALETTE %s", readBuffer) != 1)
+			{
+				return false;
+			}
+			// Fixup the palette, strip any path.
+			char paletteName[TFE_MAX_PATH];
+			FileUtil::getFileNameFromPath(readBuffer, paletteName, true);
+			levelAssets->paletteName = paletteName;
+
+			// Another value that is ignored.
+			line = parser.readLine(bufferPos);
+			if (line && sscanf(line, " MUSIC %s", readBuffer) == 1)
+			{
+				line = parser.readLine(bufferPos);
+			}
+
+			// Sky Parallax - this option until version 1.9, so handle its absence.
+			f32 x, z;
+			if (line && sscanf(line, " PARALLAX %f %f", &x, &z) == 2)
+			{
+				line = parser.readLine(bufferPos);
+			}
+
+			// Number of textures used by the level.
+			s32 textureCount = 0;
+			if (!line || sscanf(line, " TEXTURES %d", &textureCount) != 1)
+			{
+				return false;
+			}
+
+			// Read texture names.
+			char textureName[256];
+			for (s32 i = 0; i < textureCount && line; i++)
+			{
+				line = parser.readLine(bufferPos);
+				if (line && sscanf(line, " TEXTURE: %s ", textureName) == 1)
+				{
+					addToLevelAssets(levelAssets->textures, textureName);
+				}
+			}
+			// Sometimes there are extra textures, just add them - they will be compacted later.
+			while (line && sscanf(line, " TEXTURE: %s ", textureName) == 1)
+			{
+				addToLevelAssets(levelAssets->textures, textureName);
+				line = parser.readLine(bufferPos);
+			}
+		}
+
+		// .O File
+		if (objData)
+		{
+			TFE_Parser parser;
+			size_t bufferPos = 0;
+			parser.init((const char*)objData, objSize);
+			parser.addCommentString("#");
+			parser.convertToUpperCase(true);
+
+			enum ProcessFlags
+			{
+				PFLAG_POD = (1 << 0),
+				PFLAG_SPRITE = (1 << 1),
+				PFLAG_FRAME = (1 << 2),
+				PFLAG_PROCESS_DONE = PFLAG_POD | PFLAG_SPRITE | PFLAG_FRAME
+			};
+			u32 processFlags = 0;
+			const char* line;
+			while ((line = parser.readLine(bufferPos)) && (processFlags != PFLAG_PROCESS_DONE))
+			{
+				// Search for "PODS"
+				s32 count = 0;
+				char assetName[32];
+				if (sscanf(line, "PODS %d", &count) == 1)
+				{
+					for (s32 p = 0; p < count; p++)
+					{
+						line = parser.readLine(bufferPos);
+						if (line)
+						{
+							if (sscanf(line, " POD: %s", assetName) == 1)
+							{
+								addToLevelAssets(levelAssets->pods, assetName);
+							}
+						}
+					}
+					processFlags |= PFLAG_POD;
+				}
+				else if (sscanf(line, "SPRS %d", &count) == 1)
+				{
+					for (s32 p = 0; p < count; p++)
+					{
+						line = parser.readLine(bufferPos);
+						if (line)
+						{
+							if (sscanf(line, " SPR: %s", assetName) == 1)
+							{
+								addToLevelAssets(levelAssets->sprites, assetName);
+							}
+						}
+					}
+					processFlags |= PFLAG_SPRITE;
+				}
+				else if (sscanf(line, "FMES %d", &count) == 1)
+				{
+					for (s32 p = 0; p < count; p++)
+					{
+						line = parser.readLine(bufferPos);
+						if (line)
+						{
+							if (sscanf(line, " FME: %s", assetName) == 1)
+							{
+								addToLevelAssets(levelAssets->frames, assetName);
+							}
+						}
+					}
+					processFlags |= PFLAG_FRAME;
+				}
+			}
+		}
+		return true;
+	}
+
+	void parseLevelJob(void* userData, s32 index)
+	{
+		LevelIndexItem* item = &s_levelIndexItems[s_levelParseList[index]];
+		item->level.valid = parseLevelAssets(item->levData.data(), item->levData.size(),
+			item->objData.empty() ? nullptr : item->objData.data(), item->objData.size(), &item->level.assets);
+
+		// Free the level data as soon as it is parsed.
+		std::vector<u8>().swap(item->levData);
+		std::vector<u8>().swap(item->objData);
+		s_levelParseDone++;
+	}
+
+	void writeIndexString(Stream* stream, const std::string& str)
+	{
+		u16 len = (u16)std::min(str.length(), (size_t)TFE_MAX_PATH);
+		stream->write(&len);
+		stream->writeBuffer(str.data(), len);
+	}
+
+	bool readIndexString(Stream* stream, std::string& str)
+	{
+		char buffer[TFE_MAX_PATH];
+		u16 len = 0;
+		stream->read(&len);
+		if (len > TFE_MAX_PATH || stream->getLoc() + len > stream->getSize()) { return false; }
+		stream->readBuffer(buffer, len);
+		str.assign(buffer, len);
+		return true;
+	}
+
+	void writeIndexStringList(Stream* stream, const std::vector<std::string>& list)
+	{
+		u32 count = (u32)list.size();
+		stream->write(&count);
+		for (u32 i = 0; i < count; i++)
+		{
+			writeIndexString(stream, list[i]);
+		}
+	}
+
+	bool readIndexStringList(Stream* stream, std::vector<std::string>& list)
+	{
+		u32 count = 0;
+		stream->read(&count);
+		// Each string takes at least 2 bytes.
+		if (count > LEVEL_INDEX_MAX_LIST || stream->getLoc() + (size_t)count * 2 > stream->getSize()) { return false; }
+		list.resize(count);
+		for (u32 i = 0; i < count; i++)
+		{
+			if (!readIndexString(stream, list[i])) { return false; }
+		}
+		return true;
+	}
+
+	void getLevelIndexPath(char* path)
+	{
+		TFE_Paths::appendPath(PATH_USER_DOCUMENTS, c_levelIndexName, path);
+	}
+
+	void readLevelIndex()
+	{
+		s_levelIndex.clear();
+		s_levelIndexLoaded = true;
+
+		char indexPath[TFE_MAX_PATH];
+		getLevelIndexPath(indexPath);
+		FileStream stream;
+		if (!stream.open(indexPath, Stream::MODE_READ)) { return; }
+
+		u32 magic = 0, version = 0, archiveCount = 0;
+		stream.read(&magic);
+		stream.read(&version);
+		stream.read(&archiveCount);
+		if (magic != LEVEL_INDEX_MAGIC || version != LEVEL_INDEX_VERSION)
+		{
+			TFE_System::logWrite(LOG_MSG, "Asset Browser", "The level index is out of date, it will be rebuilt.");
+			return;
+		}
+
+		bool valid = true;
+		for (u32 a = 0; a < archiveCount && valid; a++)
+		{
+			std::string archivePath;
+			IndexedArchive archive;
+			u32 levelCount = 0;
+			valid = readIndexString(&stream, archivePath);
+			stream.read(&archive.size);
+			stream.read(&archive.modifiedTime);
+			stream.read(&levelCount);
+
+			for (u32 l = 0; l < levelCount && valid; l++)
+			{
+				std::string key;
+				IndexedLevel level;
+				u8 levelValid = 0;
+				stream.read(&levelValid);
+				level.valid = levelValid != 0;
+				valid = readIndexString(&stream, key) &&
+					readIndexString(&stream, level.assets.levelName) &&
+					readIndexString(&stream, level.assets.paletteName) &&
+					readIndexStringList(&stream, level.assets.textures) &&
+					readIndexStringList(&stream, level.assets.frames) &&
+					readIndexStringList(&stream, level.assets.sprites) &&
+					readIndexStringList(&stream, level.assets.pods);
+				archive.levels[key] = level;
+			}
+			if (stream.getLoc() > stream.getSize()) { valid = false; }
+			if (valid) { s_levelIndex[archivePath] = archive; }
+		}
+		if (!valid)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Asset Browser", "The level index is corrupt, it will be rebuilt.");
+			s_levelIndex.clear();
+		}
+		stream.close();
+	}
+
+	void writeLevelIndex()
+	{
+		char indexPath[TFE_MAX_PATH];
+		getLevelIndexPath(indexPath);
+		FileStream stream;
+		if (!stream.open(indexPath, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_WARNING, "Asset Browser", "Cannot write the level index '%s'.", indexPath);
+			return;
+		}
+
+		// Drop archives that no longer exist.
+		std::map<std::string, IndexedArchive>::iterator iArchive = s_levelIndex.begin();
+		while (iArchive != s_levelIndex.end())
+		{
+			if (!FileUtil::exists(iArchive->first.c_str())) { iArchive = s_levelIndex.erase(iArchive); }
+			else { ++iArchive; }
+		}
+
+		u32 value = LEVEL_INDEX_MAGIC;
+		stream.write(&value);
+		value = LEVEL_INDEX_VERSION;
+		stream.write(&value);
+		value = (u32)s_levelIndex.size();
+		stream.write(&value);
+		for (iArchive = s_levelIndex.begin(); iArchive != s_levelIndex.end(); ++iArchive)
+		{
+			const IndexedArchive& archive = iArchive->second;
+			writeIndexString(&stream, iArchive->first);
+			stream.write(&archive.size);
+			stream.write(&archive.modifiedTime);
+			value = (u32)archive.levels.size();
+			stream.write(&value);
+
+			std::map<std::string, IndexedLevel>::const_iterator iLevel = archive.levels.begin();
+			for (; iLevel != archive.levels.end(); ++iLevel)
+			{
+				const IndexedLevel& level = iLevel->second;
+				u8 levelValid = level.valid ? 1 : 0;
+				stream.write(&levelValid);
+				writeIndexString(&stream, iLevel->first);
+				writeIndexString(&stream, level.assets.levelName);
+				writeIndexString(&stream, level.assets.paletteName);
+				writeIndexStringList(&stream, level.assets.textures);
+				writeIndexStringList(&stream, level.assets.frames);
+				writeIndexStringList(&stream, level.assets.sprites);
+				writeIndexStringList(&stream, level.assets.pods);
+			}
+		}
+		stream.close();
+	}
+
+	// Find the index entry for an archive, the entry is reset if the archive has changed.
+	IndexedArchive* getIndexedArchive(Archive* archive)
+	{
+		const char* archivePath = archive->getPath();
+		u64 size = 0;
+		FileStream file;
+		if (file.open(archivePath, Stream::MODE_READ))
+		{
+			size = file.getSize();
+			file.close();
+		}
+		const u64 modifiedTime = FileUtil::getModifiedTime(archivePath);
+
+		IndexedArchive* indexedArchive = &s_levelIndex[archivePath];
+		if (indexedArchive->size != size || indexedArchive->modifiedTime != modifiedTime)
+		{
+			indexedArchive->size = size;
+			indexedArchive->modifiedTime = modifiedTime;
+			indexedArchive->levels.clear();
+		}
+		return indexedArchive;
+	}
+
+	bool readArchiveFile(Archive* archive, const char* name, std::vector<u8>& buffer)
+	{
+		if (!archive->openFile(name)) { return false; }
+		const size_t len = archive->getFileLength();
+		buffer.resize(len);
+		archive->readFile(buffer.data(), len);
+		archive->closeFile();
+		return true;
+	}
+
 	void preprocessAssets()
 	{
 		if (!s_assetsNeedProcess) { return; }
 		s_assetsNeedProcess = false;
+		cancelLevelIndexing();
 		s_levelAssets.clear();
 
 		const u32 count = (u32)s_projectAssetList[TYPE_PALETTE].size();
@@ -1209,8 +1636,12 @@ namespace AssetBrowser
 			addPalette(projAsset->name.c_str(), projAsset->archive);
 		}
 
-		// Then for levels.
-		WorkBuffer buffer;
+		// Then for levels, using the index where possible.
+		if (!s_levelIndexLoaded)
+		{
+			readLevelIndex();
+		}
+		std::map<Archive*, IndexedArchive*> archiveMap;
 		const u32 levelCount = (u32)s_projectAssetList[TYPE_LEVEL].size();
 		projAsset = s_projectAssetList[TYPE_LEVEL].data();
 		for (u32 f = 0; f < levelCount; f++, projAsset++)
@@ -1219,185 +1650,126 @@ namespace AssetBrowser
 			// TODO: Handle non-archive levels.
 			if (!archive) { continue; }
 
-			// Parse the level for 1) the palette, 2) the data lists.
-			if (archive->openFile(projAsset->name.c_str()))
+			std::map<Archive*, IndexedArchive*>::iterator iArchive = archiveMap.find(archive);
+			IndexedArchive* indexedArchive = nullptr;
+			if (iArchive == archiveMap.end())
 			{
-				LevelAssets levelAssets;
-				levelAssets.levelName = projAsset->name;
-				s32 paletteId = s_defaultPal;
-
-				// .LEV
-				{
-					size_t len = archive->getFileLength();
-					buffer.resize(len);
-					archive->readFile(buffer.data(), len);
-					archive->closeFile();
-
-					TFE_Parser parser;
-					size_t bufferPos = 0;
-					parser.init((char*)buffer.data(), buffer.size());
-					parser.addCommentString("#");
-					parser.convertToUpperCase(true);
-
-					// Read just enough of the file...
-					const char* line;
-					line = parser.readLine(bufferPos);
-					s32 versionMajor, versionMinor;
-					if (sscanf(line, " LEV %d.%d", &versionMajor, &versionMinor) != 2)
-					{
-						continue;
-					}
+				indexedArchive = getIndexedArchive(archive);
+				archiveMap[archive] = indexedArchive;
+			}
+			else
+			{
+				indexedArchive = iArchive->second;
+			}
 
-					char readBuffer[256];
-					line = parser.readLine(bufferPos);
-					if (sscanf(line, " LEVELNAME %s", readBuffer) != 1)
-					{
-						continue;
-					}
+			LevelIndexItem item;
+			item.archivePath = archive->getPath();
+			item.key = getAssetKey(projAsset->name.c_str());
+			std::map<std::string, IndexedLevel>::iterator iLevel = indexedArchive->levels.find(item.key);
+			if (iLevel != indexedArchive->levels.end())
+			{
+				item.level = iLevel->second;
+				s_levelIndexItems.push_back(item);
+				continue;
+			}
 
-					// This gets read here just to be overwritten later... so just ignore for now.
-					line = parser.readLine(bufferPos);
-					if (sscanf(line, " PALETTE %s", readBuffer) != 1)
-					{
-						continue;
-					}
-					// Fixup the palette, strip any path.
-					char paletteName[TFE_MAX_PATH];
-					FileUtil::getFileNameFromPath(readBuffer, paletteName, true);
-					paletteId = getPaletteId(paletteName);
-					if (paletteId < 0) { paletteId = 0; }
+			// Archives are not thread safe, so the level data is read here and then parsed on the job workers.
+			if (!readArchiveFile(archive, projAsset->name.c_str(), item.levData)) { continue; }
+			char objFile[TFE_MAX_PATH];
+			FileUtil::replaceExtension(projAsset->name.c_str(), "O", objFile);
+			readArchiveFile(archive, objFile, item.objData);
 
-					levelAssets.paletteName = paletteName;
+			item.level.assets.levelName = projAsset->name;
+			s_levelParseList.push_back((s32)s_levelIndexItems.size());
+			s_levelIndexItems.push_back(item);
+		}
 
-					// Another value that is ignored.
-					line = parser.readLine(bufferPos);
-					if (sscanf(line, " MUSIC %s", readBuffer) == 1)
-					{
-						line = parser.readLine(bufferPos);
-					}
+		if (s_levelParseList.empty())
+		{
+			applyLevelIndex();
+			return;
+		}
+		TFE_System::logWrite(LOG_MSG, "Asset Browser", "Indexing %d levels, %d found in the level index.",
+			(s32)s_levelParseList.size(), (s32)(s_levelIndexItems.size() - s_levelParseList.size()));
+		s_levelParseDone = 0;
+		s_levelIndexPending = true;
+		TFE_Jobs::submit(parseLevelJob, nullptr, (s32)s_levelParseList.size(), &s_levelParseCounter);
+	}
 
-					// Sky Parallax - this option until version 1.9, so handle its absence.
-					f32 x, z;
-					if (sscanf(line, " PARALLAX %f %f", &x, &z) == 2)
-					{
-						line = parser.readLine(bufferPos);
-					}
+	// Build the level asset lists and asset palettes from the indexed levels.
+	void applyLevelIndex()
+	{
+		s_levelAssets.clear();
+		const size_t itemCount = s_levelIndexItems.size();
+		for (size_t i = 0; i < itemCount; i++)
+		{
+			const IndexedLevel* level = &s_levelIndexItems[i].level;
+			if (!level->valid) { continue; }
 
-					// Number of textures used by the level.
-					s32 textureCount = 0;
-					if (sscanf(line, " TEXTURES %d", &textureCount) != 1)
-					{
-						continue;
-					}
+			s32 paletteId = getPaletteId(level->assets.paletteName.c_str());
+			if (paletteId < 0) { paletteId = 0; }
 
-					// Read texture names.
-					char textureName[256];
-					for (s32 i = 0; i < textureCount; i++)
-					{
-						line = parser.readLine(bufferPos);
-						if (sscanf(line, " TEXTURE: %s ", textureName) == 1)
-						{
-							setAssetPalette(textureName, paletteId);
-							addToLevelAssets(levelAssets.textures, textureName);
-						}
-					}
-					// Sometimes there are extra textures, just add them - they will be compacted later.
-					bool readNext = true;
-					while (sscanf(line, " TEXTURE: %s ", textureName) == 1)
-					{
-						setAssetPalette(textureName, paletteId);
-						addToLevelAssets(levelAssets.textures, textureName);
-						line = parser.readLine(bufferPos);
-						readNext = false;
-					}
+			const std::vector<std::string>* lists[] = { &level->assets.textures, &level->assets.pods, &level->assets.sprites, &level->assets.frames };
+			for (size_t l = 0; l < TFE_ARRAYSIZE(lists); l++)
+			{
+				const size_t nameCount = lists[l]->size();
+				for (size_t n = 0; n < nameCount; n++)
+				{
+					setAssetPalette((*lists[l])[n].c_str(), paletteId);
 				}
+			}
+			s_levelAssets.push_back(level->assets);
+		}
+		if (s_viewInfo.levelSource >= (s32)s_levelAssets.size())
+		{
+			s_viewInfo.levelSource = -1;
+		}
 
-				// .O File
-				char objFile[TFE_MAX_PATH];
-				FileUtil::replaceExtension(projAsset->name.c_str(), "O", objFile);
-				if (archive->openFile(objFile))
-				{
-					size_t len = archive->getFileLength();
-					buffer.resize(len);
-					archive->readFile(buffer.data(), len);
-					archive->closeFile();
+		s_levelIndexItems.clear();
+		s_levelParseList.clear();
+	}
 
-					TFE_Parser parser;
-					size_t bufferPos = 0;
-					parser.init((char*)buffer.data(), buffer.size());
-					parser.addCommentString("#");
-					parser.convertToUpperCase(true);
+	// Wait for the level parsing jobs, then add the results to the index and write it.
+	bool storeParsedLevels()
+	{
+		if (!s_levelIndexPending) { return false; }
+		TFE_Jobs::wait(&s_levelParseCounter);
+		s_levelIndexPending = false;
 
-					enum ProcessFlags
-					{
-						PFLAG_POD = (1 << 0),
-						PFLAG_SPRITE = (1 << 1),
-						PFLAG_FRAME = (1 << 2),
-						PFLAG_PROCESS_DONE = PFLAG_POD | PFLAG_SPRITE | PFLAG_FRAME
-					};
-					u32 processFlags = 0;
-					const char* line;
-					while ((line = parser.readLine(bufferPos)) && (processFlags != PFLAG_PROCESS_DONE))
-					{
-						// Search for "PODS"
-						s32 count = 0;
-						char assetName[32];
-						if (sscanf(line, "PODS %d", &count) == 1)
-						{
-							for (s32 p = 0; p < count; p++)
-							{
-								line = parser.readLine(bufferPos);
-								if (line)
-								{
-									if (sscanf(line, " POD: %s", assetName) == 1)
-									{
-										setAssetPalette(assetName, paletteId);
-										addToLevelAssets(levelAssets.pods, assetName);
-									}
-								}
-							}
-							processFlags |= PFLAG_POD;
-						}
-						else if (sscanf(line, "SPRS %d", &count) == 1)
-						{
-							for (s32 p = 0; p < count; p++)
-							{
-								line = parser.readLine(bufferPos);
-								if (line)
-								{
-									if (sscanf(line, " SPR: %s", assetName) == 1)
-									{
-										setAssetPalette(assetName, paletteId);
-										addToLevelAssets(levelAssets.sprites, assetName);
-									}
-								}
-							}
-							processFlags |= PFLAG_SPRITE;
-						}
-						else if (sscanf(line, "FMES %d", &count) == 1)
-						{
-							for (s32 p = 0; p < count; p++)
-							{
-								line = parser.readLine(bufferPos);
-								if (line)
-								{
-									if (sscanf(line, " FME: %s", assetName) == 1)
-									{
-										setAssetPalette(assetName, paletteId);
-										addToLevelAssets(levelAssets.frames, assetName);
-									}
-								}
-							}
-							processFlags |= PFLAG_FRAME;
-						}
-					}
-				}
+		const size_t parseCount = s_levelParseList.size();
+		for (size_t i = 0; i < parseCount; i++)
+		{
+			const LevelIndexItem* item = &s_levelIndexItems[s_levelParseList[i]];
+			s_levelIndex[item->archivePath].levels[item->key] = item->level;
+		}
+		writeLevelIndex();
+		return true;
+	}
 
-				s_levelAssets.push_back(levelAssets);
-			}
+	void finishLevelIndexing()
+	{
+		if (storeParsedLevels())
+		{
+			applyLevelIndex();
 		}
 	}
 
+	// The parsed levels are still stored in the index, so the work isn't repeated when the assets are processed again.
+	void cancelLevelIndexing()
+	{
+		storeParsedLevels();
+		s_levelIndexItems.clear();
+		s_levelParseList.clear();
+	}
+
+	// Returns true when the level indexing started by preprocessAssets() has just finished.
+	bool pollLevelIndexing()
+	{
+		if (!s_levelIndexPending || !TFE_Jobs::isDone(&s_levelParseCounter)) { return false; }
+		finishLevelIndexing();
+		return true;
+	}
+
 	void reloadAsset(Asset* asset, s32 palId, s32 lightLevel)
 	{
 		if (asset && asset->archive)
@@ -1464,19 +1836,8 @@ namespace AssetBrowser
 
 	s32 findAsset(Asset& asset)
 	{
-		s32 foundId = -1;
-		const AssetList& list = s_projectAssetList[asset.type];
-		const s32 count = (s32)list.size();
-		const Asset* assetList = list.data();
-		for (s32 i = 0; i < count; i++)
-		{
-			if (strcasecmp(assetList[i].name.c_str(), asset.name.c_str()) == 0)
-			{
-				foundId = i;
-				break;
-			}
-		}
-		return foundId;
+		std::unordered_map<std::string, s32>::iterator iAsset = s_projectAssetLookup[asset.type].find(getAssetKey(asset.name.c_str()));
+		return iAsset != s_projectAssetLookup[asset.type].end() ? iAsset->second : -1;
 	}
 	
 	bool extractArchive(Archive* srcArchive, const char* filename, char* outPath)
@@ -1549,6 +1910,7 @@ namespace AssetBrowser
 				AssetList& list = s_projectAssetList[type];
 				if (id < 0)
 				{
+					s_projectAssetLookup[type][getAssetKey(fileName)] = (s32)list.size();
 					list.push_back(newAsset);
 				}
 				else
@@ -1634,6 +1996,7 @@ namespace AssetBrowser
 					AssetList& list = s_projectAssetList[type];
 					if (id < 0)
 					{
+						s_projectAssetLookup[type][getAssetKey(fileName)] = (s32)list.size();
 						list.push_back(newAsset);
 					}
 					else
@@ -1661,6 +2024,14 @@ namespace AssetBrowser
 		for (u32 i = 0; i < TYPE_COUNT; i++)
 		{
 			std::sort(s_projectAssetList[i].begin(), s_projectAssetList[i].end(), sortByAssetSource);
+
+			// The indices have changed, so rebuild the lookup.
+			s_projectAssetLookup[i].clear();
+			const s32 count = (s32)s_projectAssetList[i].size();
+			for (s32 a = 0; a < count; a++)
+			{
+				s_projectAssetLookup[i][getAssetKey(s_projectAssetList[i][a].name.c_str())] = a;
+			}
 		}
 	}
 
@@ -1673,6 +2044,7 @@ namespace AssetBrowser
 		for (u32 i = 0; i < TYPE_COUNT; i++)
 		{
 			s_projectAssetList[i].clear();
+			s_projectAssetLookup[i].clear();
 		}
 
 		u32 resCount = 0;
@@ -1778,6 +2150,8 @@ namespace AssetBrowser
 
 	AssetHandle loadAssetData(const Asset* asset)
 	{
+		// The asset palette comes from the level index.
+		finishLevelIndexing();
 		s32 palId = getAssetPalette(asset->name.c_str());
 		AssetColorData colorData = { s_palettes[palId].data, nullptr, palId, 32 };
 		return loadAssetData(asset->type, asset->archive, &colorData, asset->name.c_str());
@@ -1836,6 +2210,7 @@ namespace AssetBrowser
 
 	void getLevelTextures(AssetList& list, const char* levelName)
 	{
+		finishLevelIndexing();
 		list.clear();
 		const u32 count = (u32)s_projectAssetList[TYPE_TEXTURE].size();
 		const Asset* projAsset = s_projectAssetList[TYPE_TEXTURE].data();
@@ -1859,7 +2234,7 @@ namespace AssetBrowser
 		}
 	}
 
-	void updateAssetList()
+	void updateAssetList(bool waitForLevelIndex)
 	{
 		// Only Dark Forces for now.
 		// TODO
@@ -1872,6 +2247,13 @@ namespace AssetBrowser
 
 		preprocessAssets();
 		s_viewAssetList.clear();
+		// The asset palettes and level filters depend on the level index,
+		// update() fills in the list once indexing has finished.
+		if (s_levelIndexPending)
+		{
+			if (!waitForLevelIndex) { return; }
+			finishLevelIndexing();
+		}
 		if (s_viewInfo.type == TYPE_TEXTURE)
 		{
 			const u32 count = (u32)s_projectAssetList[TYPE_TEXTURE].size();
@@ -551,6 +551,18 @@ namespace LevelEditor
 		dst->layer = src->layer;
 	}
 
+	// Re-triangulate the sectors touched by an edit in one batch.
+	void updateSectorPolygons(const std::vector<s32>& sectorIds)
+	{
+		const s32 count = (s32)sectorIds.size();
+		std::vector<EditorSector*> list(count);
+		for (s32 i = 0; i < count; i++)
+		{
+			list[i] = &s_level.sectors[sectorIds[i]];
+		}
+		sectorsToPolygons(count, list.data());
+	}
+
 	void addToAdjoinFixupList(s32 id, std::vector<s32>& adjoinSectorsToFix)
 	{
 		const s32 count = (s32)adjoinSectorsToFix.size();
@@ -997,6 +1009,8 @@ namespace LevelEditor
 		EditorSector** candidateList = candidates.data();
 		std::vector<BPolygon> outPoly;
 		std::vector<s32> deleteId;
+		// Sectors are added while clipping, so store ids and update the polygons once clipping is done.
+		std::vector<s32> changedSectors;
 
 		// Mark and clear adjoins
 		for (s32 s = 0; s < candidateCount; s++)
@@ -1091,7 +1105,7 @@ namespace LevelEditor
 				// Re-use the existing sector for the first result.
 				std::vector<EditorWall> walls = candidate->walls;
 				updateSectorFromPolygon(candidate, outPoly[0]);
-				sectorToPolygon(candidate);
+				changedSectors.push_back(candidate->id);
 				addToAdjoinFixupList(candidate->id, adjoinSectorsToFix);
 
 				// Handle clip-interior polygons.
@@ -1118,7 +1132,7 @@ namespace LevelEditor
 					addToAdjoinFixupList(newPtr->id, adjoinSectorsToFix);
 
 					updateSectorFromPolygon(newPtr, outPoly[p]);
-					sectorToPolygon(newPtr);
+					changedSectors.push_back(newPtr->id);
 				}
 
 				candidatePoly.insert(candidatePoly.end(), outPoly.begin(), outPoly.end());
@@ -1196,7 +1210,7 @@ namespace LevelEditor
 					addToAdjoinFixupList(newPtr->id, adjoinSectorsToFix);
 
 					updateSectorFromPolygon(newPtr, clipPoly[p]);
-					sectorToPolygon(newPtr);
+					changedSectors.push_back(newPtr->id);
 				}
 			}
 			else  // Nothing to clip against, just accept it as-is...
@@ -1210,9 +1224,10 @@ namespace LevelEditor
 				addToAdjoinFixupList(newPtr->id, adjoinSectorsToFix);
 
 				updateSectorFromPolygon(newPtr, shapePolyClip);
-				sectorToPolygon(newPtr);
+				changedSectors.push_back(newPtr->id);
 			}
 		}
+		updateSectorPolygons(changedSectors);
 
 		// Fix-up adjoins.
 		fixupSectorAdjoins(adjoinSectorsToFix);
@@ -8,6 +8,7 @@
 #include "groups.h"
 #include "sharedState.h"
 #include "selection.h"
+#include "sectorIndex.h"
 #include <TFE_Input/input.h>
 #include <TFE_Editor/editor.h>
 #include <TFE_Editor/errorMessages.h>
@@ -994,6 +995,7 @@ namespace LevelEditor
 		if (layer != sector->layer)
 		{
 			sector->layer = layer;
+			sectorIndex_update(sector);
 			// Adjust layer range.
 			s_level.layerRange[0] = std::min(s_level.layerRange[0], (s32)layer);
 			s_level.layerRange[1] = std::max(s_level.layerRange[1], (s32)layer);
@@ -8,6 +8,7 @@
 #include "entity.h"
 #include "groups.h"
 #include "selection.h"
+#include "sectorIndex.h"
 #include "infoPanel.h"
 #include "browser.h"
 #include "camera.h"
@@ -122,6 +123,7 @@ namespace LevelEditor
 	u32 s_searchKey = 0;
 	static std::vector<VertexWallGroup> s_vertexWallGroups;
 	static std::vector<EditorSector*> s_sortedHoverSectors;
+	static SectorList s_sectorQueryList;
 
 	bool s_editMove = false;
 	static SectorList s_workList;
@@ -365,6 +367,7 @@ namespace LevelEditor
 	void destroy()
 	{
 		s_level.sectors.clear();
+		sectorIndex_invalidate();
 		viewport_destroy();
 		TFE_RenderShared::destroy();
 
@@ -390,11 +393,14 @@ namespace LevelEditor
 
 	EditorSector* findSector2d(Vec2f pos, s32 layer)
 	{
-		const size_t sectorCount = s_level.sectors.size();
-		EditorSector* sector = s_level.sectors.data();
+		// Only test the sectors near the position, padded to match the tolerance used by isPointInsideSector2d().
+		const f32 eps = 0.001f;
+		sectorIndex_query(layer, { pos.x - eps, pos.z - eps }, { pos.x + eps, pos.z + eps }, &s_sectorQueryList);
+		const size_t sectorCount = s_sectorQueryList.size();
 		s_sortedHoverSectors.clear();
-		for (size_t s = 0; s < sectorCount; s++, sector++)
+		for (size_t s = 0; s < sectorCount; s++)
 		{
+			EditorSector* sector = s_sectorQueryList[s];
 			// Make sure the sector is in a visible/unlocked group.
 			if (!sector_isInteractable(sector)) { continue; }
 			if (isPointInsideSector2d(sector, pos, layer))
@@ -460,10 +466,11 @@ namespace LevelEditor
 				{ std::max(worldPos[0].x, worldPos[1].x), 0.0f, std::max(worldPos[0].z, worldPos[1].z) }
 			};
 
-			const size_t sectorCount = s_level.sectors.size();
-			EditorSector* sector = s_level.sectors.data();
-			for (size_t s = 0; s < sectorCount; s++, sector++)
+			sectorIndex_query(s_curLayer, { aabb[0].x, aabb[0].z }, { aabb[1].x, aabb[1].z }, &s_sectorQueryList);
+			const size_t sectorCount = s_sectorQueryList.size();
+			for (size_t s = 0; s < sectorCount; s++)
 			{
+				EditorSector* sector = s_sectorQueryList[s];
 				if (s_curLayer != sector->layer && s_curLayer != LAYER_ANY) { continue; }
 				if (!sector_isInteractable(sector)) { continue; }
 				if (!aabbOverlap2d(sector->bounds, aabb)) { continue; }
@@ -646,10 +653,11 @@ namespace LevelEditor
 				{ std::max(worldPos[0].x, worldPos[1].x), 0.0f, std::max(worldPos[0].z, worldPos[1].z) }
 			};
 
-			const size_t sectorCount = s_level.sectors.size();
-			EditorSector* sector = s_level.sectors.data();
-			for (size_t s = 0; s < sectorCount; s++, sector++)
+			sectorIndex_query(s_curLayer, { aabb[0].x, aabb[0].z }, { aabb[1].x, aabb[1].z }, &s_sectorQueryList);
+			const size_t sectorCount = s_sectorQueryList.size();
+			for (size_t s = 0; s < sectorCount; s++)
 			{
+				EditorSector* sector = s_sectorQueryList[s];
 				if (s_curLayer != sector->layer && s_curLayer != LAYER_ANY) { continue; }
 				if (!sector_isInteractable(sector)) { continue; }
 				if (!aabbOverlap2d(sector->bounds, aabb)) { continue; }
@@ -1286,6 +1294,7 @@ namespace LevelEditor
 			// Get the ID and then erase it from the level.
 			s32 delId = sector->id;
 			s_level.sectors.erase(s_level.sectors.begin() + delId);
+			sectorIndex_invalidate();
 
 			// Update Sector IDs
 			const s32 levSectorCount = (s32)s_level.sectors.size();
@@ -1498,6 +1507,7 @@ namespace LevelEditor
 
 		// Then erase the sector.
 		s_level.sectors.erase(s_level.sectors.begin() + sectorId);
+		sectorIndex_invalidate();
 
 		// Finally fix-up any references.
 		sectorCount = (s32)s_level.sectors.size();
@@ -1907,13 +1917,13 @@ namespace LevelEditor
 		EditorSector* rootSector = &s_level.sectors[sectorId];
 		// Save the selection and clear.
 		SelectionList curSelection = s_selectionList;
-		s_selectionList.clear();
+		selection_clear(false);
 
 		// Find similar walls.
 		selectSimilarWalls(rootSector, wallIndex, part, true);
 
 		// Restore the selection.
-		s_selectionList = curSelection;
+		selection_set((s32)curSelection.size(), curSelection.data());
 	}
 		
 	void selectSimilarWalls(EditorSector* rootSector, s32 wallIndex, HitPart part, bool autoAlign/*=false*/)
@@ -2138,7 +2148,7 @@ namespace LevelEditor
 			{
 				if (!TFE_Input::keyModDown(KEYMOD_SHIFT))
 				{
-					s_selectionList.clear();
+					selection_clear(false);
 				}
 				if (s_featureHovered.part == HP_FLOOR || s_featureHovered.part == HP_CEIL)
 				{
@@ -2563,6 +2573,7 @@ namespace LevelEditor
 			return;
 		}
 
+		s_sectorChangeList.clear();
 		const s32* indices = selectedSectors.data();
 		for (s32 s = 0; s < sectorCount; s++)
 		{
@@ -2675,8 +2686,9 @@ namespace LevelEditor
 					}
 				}
 			}
-			sectorToPolygon(sector);
+			s_sectorChangeList.push_back(sector);
 		}
+		sectorsToPolygons((s32)s_sectorChangeList.size(), s_sectorChangeList.data());
 	}
 
 	void edit_cleanSectors()
@@ -3581,7 +3593,7 @@ namespace LevelEditor
 			s_selectSaveState.selectionList = s_selectionList;
 			s_selectSaveStateSaved = true;
 
-			s_selectionList.clear();
+			selection_clear(false);
 			s_featureHovered = {};
 			s_featureCur = {};
 			s_featureCurWall = {};
@@ -3595,7 +3607,7 @@ namespace LevelEditor
 			s_featureHovered = s_selectSaveState.featureHovered;
 			s_featureCur = s_selectSaveState.featureCur;
 			s_featureCurWall = s_selectSaveState.featureCurWall;
-			s_selectionList = s_selectSaveState.selectionList;
+			selection_set((s32)s_selectSaveState.selectionList.size(), s_selectSaveState.selectionList.data());
 			s_selectSaveStateSaved = false;
 		}
 	}
@@ -4834,13 +4846,7 @@ namespace LevelEditor
 		}
 
 		// Update sectors after changes.
-		const size_t changeCount = s_sectorChangeList.size();
-		EditorSector** list = s_sectorChangeList.data();
-		for (size_t i = 0; i < changeCount; i++)
-		{
-			EditorSector* sector = list[i];
-			sectorToPolygon(sector);
-		}
+		sectorsToPolygons((s32)s_sectorChangeList.size(), s_sectorChangeList.data());
 	}
 		
 	void moveVertex(Vec2f worldPos2d)
@@ -5539,7 +5545,7 @@ namespace LevelEditor
 
 	void edit_clearSelections()
 	{
-		s_selectionList.clear();
+		selection_clear(false);
 		s_featureCur = {};
 		s_featureCurWall = {};
 		s_featureHovered = {};
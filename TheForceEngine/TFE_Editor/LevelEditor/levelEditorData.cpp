@@ -5,6 +5,7 @@
 #include "shell.h"
 #include "levelEditorInf.h"
 #include "sharedState.h"
+#include "sectorIndex.h"
 #include <TFE_Editor/history.h>
 #include <TFE_Editor/errorMessages.h>
 #include <TFE_Editor/editorConfig.h>
@@ -35,6 +36,7 @@
 #include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_System/parser.h>
 #include <TFE_System/math.h>
+#include <TFE_System/jobs.h>
 #include <TFE_Ui/ui.h>
 
 #include <climits>
@@ -67,6 +69,7 @@ namespace LevelEditor
 	static const u8* s_readBuffer;
 
 	EditorLevel s_level = {};
+	static SectorList s_sectorQueryList;
 
 	extern AssetList s_levelTextureList;
 	extern void edit_clearSelections();
@@ -487,6 +490,8 @@ namespace LevelEditor
 		s_featureHovered = {};
 		s_featureCur = {};
 		s_featureTex = {};
+		// The sectors are about to be replaced.
+		sectorIndex_invalidate();
 
 		// Clear notes.
 		s_level.notes.clear();
@@ -801,9 +806,9 @@ namespace LevelEditor
 
 			level->layerRange[0] = min(level->layerRange[0], sector->layer);
 			level->layerRange[1] = max(level->layerRange[1], sector->layer);
-
-			sectorToPolygon(sector);
 		}
+		sectorsToPolygons((s32)count, level->sectors.data());
+
 		loadLevelObjFromAsset(asset);
 		loadLevelInfFromAsset(asset);
 
@@ -964,8 +969,8 @@ namespace LevelEditor
 			}
 
 			sector->searchKey = 0;
-			sectorToPolygon(sector);
 		}
+		sectorsToPolygons((s32)sectorCount, s_level.sectors.data());
 
 		// Entity Definitions.
 		if (version >= LEF_EntityList)
@@ -1812,7 +1817,8 @@ namespace LevelEditor
 	}
 
 	// Update the sector's polygon from the sector data.
-	void sectorToPolygon(EditorSector* sector)
+	// This doesn't touch the sector index, so it is safe to run on the job workers.
+	void sectorBuildPolygon(EditorSector* sector)
 	{
 		Polygon& poly = sector->poly;
 		poly.edge.resize(sector->walls.size());
@@ -1852,6 +1858,59 @@ namespace LevelEditor
 		sector->bounds[1].y = max(sector->floorHeight, sector->ceilHeight);
 	}
 
+	void sectorToPolygon(EditorSector* sector)
+	{
+		sectorBuildPolygon(sector);
+		sectorIndex_update(sector);
+	}
+
+	struct SectorPolygonBatch
+	{
+		EditorSector** list;
+		EditorSector* sectors;
+		s32 count;
+		std::atomic<s32> next;
+	};
+
+	void sectorsToPolygonsJob(void* userData, s32 index)
+	{
+		SectorPolygonBatch* batch = (SectorPolygonBatch*)userData;
+		// Sector complexity varies a lot, so each job keeps taking the next sector until none are left.
+		for (s32 i = batch->next++; i < batch->count; i = batch->next++)
+		{
+			sectorBuildPolygon(batch->list ? batch->list[i] : &batch->sectors[i]);
+		}
+	}
+
+	void sectorsToPolygonsBatch(s32 count, EditorSector** list, EditorSector* sectors)
+	{
+		if (count <= 0) { return; }
+
+		SectorPolygonBatch batch;
+		batch.list = list;
+		batch.sectors = sectors;
+		batch.count = count;
+		batch.next = 0;
+		TFE_Jobs::parallelFor(sectorsToPolygonsJob, &batch, std::min(count, TFE_Jobs::getWorkerCount() + 1));
+
+		// Then re-index the sectors on the calling thread.
+		for (s32 i = 0; i < count; i++)
+		{
+			sectorIndex_update(list ? list[i] : &sectors[i]);
+		}
+	}
+
+	// Update the polygons for a list of sectors, the triangulation is split between the job workers.
+	void sectorsToPolygons(s32 count, EditorSector** list)
+	{
+		sectorsToPolygonsBatch(count, list, nullptr);
+	}
+
+	void sectorsToPolygons(s32 count, EditorSector* sectors)
+	{
+		sectorsToPolygonsBatch(count, nullptr, sectors);
+	}
+
 	// Update the sector itself from the sector's polygon.
 	void polygonToSector(EditorSector* sector)
 	{
@@ -1878,15 +1937,15 @@ namespace LevelEditor
 	{
 		if (s_level.sectors.empty()) { return -1; }
 
-		const s32 sectorCount = (s32)s_level.sectors.size();
-		EditorSector* sectors = s_level.sectors.data();
-
-		for (s32 i = 0; i < sectorCount; i++)
+		sectorIndex_query(layer, *pos, *pos, &s_sectorQueryList);
+		const s32 candidateCount = (s32)s_sectorQueryList.size();
+		EditorSector** candidates = s_sectorQueryList.data();
+		for (s32 i = 0; i < candidateCount; i++)
 		{
-			if (sectors[i].layer != layer) { continue; }
-			if (TFE_Polygon::pointInsidePolygon(&sectors[i].poly, *pos))
+			if (candidates[i]->layer != layer) { continue; }
+			if (TFE_Polygon::pointInsidePolygon(&candidates[i]->poly, *pos))
 			{
-				return i;
+				return candidates[i]->id;
 			}
 		}
 		return -1;
@@ -2428,13 +2487,16 @@ namespace LevelEditor
 
 	EditorSector* findSector3d(Vec3f pos, s32 layer)
 	{
-		const size_t sectorCount = s_level.sectors.size();
-		EditorSector* sector = s_level.sectors.data();
-		for (size_t s = 0; s < sectorCount; s++, sector++)
+		// Pad the query to match the tolerance used by isPointInsideSector3d().
+		const f32 eps = 0.001f;
+		sectorIndex_query(layer, { pos.x - eps, pos.z - eps }, { pos.x + eps, pos.z + eps }, &s_sectorQueryList);
+		const size_t candidateCount = s_sectorQueryList.size();
+		EditorSector** candidates = s_sectorQueryList.data();
+		for (size_t s = 0; s < candidateCount; s++)
 		{
-			if (isPointInsideSector3d(sector, pos, layer))
+			if (isPointInsideSector3d(candidates[s], pos, layer))
 			{
-				return sector;
+				return candidates[s];
 			}
 		}
 		return nullptr;
@@ -2470,16 +2532,16 @@ namespace LevelEditor
 		return closestId;
 	}
 
-	// TODO: Spatial data structure to handle cases where there are 10k, 100k, etc. sectors.
 	bool getOverlappingSectorsPt(const Vec3f* pos, s32 curLayer, SectorList* result, f32 padding)
 	{
 		if (!pos || !result) { return false; }
 
 		result->clear();
-		const s32 count = (s32)s_level.sectors.size();
-		EditorSector* sector = s_level.sectors.data();
-		for (s32 i = 0; i < count; i++, sector++)
+		sectorIndex_query(curLayer, { pos->x - padding, pos->z - padding }, { pos->x + padding, pos->z + padding }, &s_sectorQueryList);
+		const s32 count = (s32)s_sectorQueryList.size();
+		for (s32 i = 0; i < count; i++)
 		{
+			EditorSector* sector = s_sectorQueryList[i];
 			// It has to be on a visible layer.
 			if (sector->layer != LAYER_ANY && sector->layer != curLayer) { continue; }
 			// The group has to be interactible.
@@ -2504,10 +2566,11 @@ namespace LevelEditor
 		if (!bounds || !result) { return false; }
 
 		result->clear();
-		const s32 count = (s32)s_level.sectors.size();
-		EditorSector* sector = s_level.sectors.data();
-		for (s32 i = 0; i < count; i++, sector++)
+		sectorIndex_query(LAYER_ANY, { bounds[0].x, bounds[0].z }, { bounds[1].x, bounds[1].z }, &s_sectorQueryList);
+		const s32 count = (s32)s_sectorQueryList.size();
+		for (s32 i = 0; i < count; i++)
 		{
+			EditorSector* sector = s_sectorQueryList[i];
 			if (aabbOverlap3d(sector->bounds, bounds))
 			{
 				result->push_back(sector);
@@ -2696,12 +2759,10 @@ namespace LevelEditor
 				readData(sector->walls.data(), u32(sizeof(EditorWall) * wallCount));
 				readData(sector->obj.data(), u32(sizeof(EditorObject) * objCount));
 
-				// Compute derived data.
-				sectorToPolygon(sector);
-				sector->bounds[0] = { sector->poly.bounds[0].x, std::min(sector->floorHeight, sector->ceilHeight), sector->poly.bounds[0].z };
-				sector->bounds[1] = { sector->poly.bounds[1].x, std::max(sector->floorHeight, sector->ceilHeight), sector->poly.bounds[1].z };
 				sector->searchKey = 0;
 			}
+			// Compute derived data, this also sets the sector bounds.
+			sectorsToPolygons((s32)sectorCount, s_curSnapshot.sectors.data());
 
 			// Compute final snapshot bounds.
 			s_curSnapshot.bounds[0] = {  FLT_MAX,  FLT_MAX,  FLT_MAX };
@@ -2725,6 +2786,7 @@ namespace LevelEditor
 		}
 		// Then copy the snapshot to the level data itself. Its the new state.
 		s_level = s_curSnapshot;
+		sectorIndex_invalidate();
 
 		// For now until the way snapshot memory is handled is refactored, to avoid duplicate code that will be removed later.
 		// TODO: Handle edit state properly here too.
@@ -237,6 +237,9 @@ namespace LevelEditor
 	bool saveLevel();
 	bool exportLevel(const char* path, const char* name, const StartPoint* start);
 	void sectorToPolygon(EditorSector* sector);
+	// Update the polygons of many sectors at once, such as after loading or a bulk edit.
+	void sectorsToPolygons(s32 count, EditorSector** list);
+	void sectorsToPolygons(s32 count, EditorSector* sectors);
 	void polygonToSector(EditorSector* sector);
 
 	s32 addEntityToLevel(const Entity* newEntity);
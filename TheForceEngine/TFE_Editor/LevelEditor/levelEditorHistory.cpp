@@ -2,6 +2,7 @@
 #include "sharedState.h"
 #include <TFE_Editor/LevelEditor/levelEditor.h>
 #include <TFE_Editor/LevelEditor/levelEditorData.h>
+#include <TFE_Editor/editorConfig.h>
 #include <TFE_System/system.h>
 #include <assert.h>
 #include <algorithm>
@@ -60,6 +61,7 @@ namespace LevelEditor
 	void levHistory_init()
 	{
 		history_init(level_unpackSnapshot, level_createSnapshot);
+		history_setMemoryBudget(u32(std::max(s_editorConfig.undoMemoryBudget, 1)) * 1024u * 1024u);
 
 		history_registerCommand(LCmd_MoveVertex, cmd_applyMoveVertices);
 		history_registerCommand(LCmd_SetVertex, cmd_applySetVertex);
@@ -171,10 +173,10 @@ namespace LevelEditor
 	{
 		s_editMode = (LevelEditMode)hBuffer_getU32();
 		u32 selectionCount = hBuffer_getU32();
-		s_selectionList.resize(selectionCount);
+		selection_clear(false);
 		if (selectionCount)
 		{
-			memcpy(s_selectionList.data(), hBuffer_getArrayU64(selectionCount), sizeof(u64) * selectionCount);
+			selection_set((s32)selectionCount, (const FeatureId*)hBuffer_getArrayU64(selectionCount));
 		}
 		restoreFeature(s_featureHovered);
 		restoreFeature(s_featureCur);
@@ -5053,12 +5053,7 @@ namespace LevelEditor
 
 	void fixupSectors()
 	{
-		const s32 count = (s32)s_sectorsToFixup.size();
-		EditorSector** list = s_sectorsToFixup.data();
-		for (s32 i = 0; i < count; i++)
-		{
-			sectorToPolygon(list[i]);
-		}
+		sectorsToPolygons((s32)s_sectorsToFixup.size(), s_sectorsToFixup.data());
 	}
 
 	void moveWalls(Editor_InfElevator* elev, EditorSector* sector, const EditorSector* srcSector, f32 value)
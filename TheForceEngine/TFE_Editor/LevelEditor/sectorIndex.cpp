@@ -0,0 +1,257 @@
+#include "sectorIndex.h"
+#include "sharedState.h"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include <map>
+#include <cmath>
+
+namespace LevelEditor
+{
+	enum SectorIndexConst
+	{
+		// Sectors covering more cells than this are kept in a per-layer list instead of the grid.
+		SIDX_MAX_SECTOR_CELLS = 256,
+		SIDX_MAX_CELL_COORD = (1 << 22),
+	};
+	static const f32 c_sectorIndexCellSize = 64.0f;
+
+	struct SectorIndexEntry
+	{
+		s32 layer = 0;
+		s32 cellMin[2] = { 0 };
+		s32 cellMax[2] = { 0 };
+		u32 queryKey = 0;
+		bool indexed = false;
+		bool large = false;
+	};
+
+	struct SectorIndexLayer
+	{
+		std::unordered_map<u64, std::vector<s32>> cells;
+		std::vector<s32> large;
+	};
+
+	static std::map<s32, SectorIndexLayer> s_indexLayers;
+	static std::vector<SectorIndexEntry> s_indexEntries;
+	static u32 s_indexQueryKey = 0;
+	static bool s_indexDirty = true;
+
+	static s32 sectorIndex_cellCoord(f32 value)
+	{
+		const f32 cell = floorf(value / c_sectorIndexCellSize);
+		return s32(std::max(-f32(SIDX_MAX_CELL_COORD), std::min(f32(SIDX_MAX_CELL_COORD), cell)));
+	}
+
+	static u64 sectorIndex_cellKey(s32 x, s32 z)
+	{
+		return (u64(u32(x)) << 32ull) | u64(u32(z));
+	}
+
+	static void sectorIndex_eraseId(std::vector<s32>& list, s32 id)
+	{
+		auto iter = std::find(list.begin(), list.end(), id);
+		if (iter != list.end())
+		{
+			*iter = list.back();
+			list.pop_back();
+		}
+	}
+
+	static void sectorIndex_remove(s32 id)
+	{
+		SectorIndexEntry* entry = &s_indexEntries[id];
+		if (!entry->indexed) { return; }
+		entry->indexed = false;
+
+		auto layerIter = s_indexLayers.find(entry->layer);
+		if (layerIter == s_indexLayers.end()) { return; }
+		SectorIndexLayer& layer = layerIter->second;
+
+		if (entry->large)
+		{
+			sectorIndex_eraseId(layer.large, id);
+			return;
+		}
+		for (s32 z = entry->cellMin[1]; z <= entry->cellMax[1]; z++)
+		{
+			for (s32 x = entry->cellMin[0]; x <= entry->cellMax[0]; x++)
+			{
+				auto cellIter = layer.cells.find(sectorIndex_cellKey(x, z));
+				if (cellIter == layer.cells.end()) { continue; }
+
+				sectorIndex_eraseId(cellIter->second, id);
+				if (cellIter->second.empty()) { layer.cells.erase(cellIter); }
+			}
+		}
+	}
+
+	static void sectorIndex_insert(s32 id, const EditorSector* sector)
+	{
+		SectorIndexEntry* entry = &s_indexEntries[id];
+		// Sectors without geometry (or that haven't been built yet) are not indexed.
+		const Vec3f* bounds = sector->bounds;
+		if (!std::isfinite(bounds[0].x) || !std::isfinite(bounds[0].z) || !std::isfinite(bounds[1].x) || !std::isfinite(bounds[1].z) ||
+			bounds[0].x > bounds[1].x || bounds[0].z > bounds[1].z)
+		{
+			entry->indexed = false;
+			return;
+		}
+
+		entry->layer = sector->layer;
+		entry->cellMin[0] = sectorIndex_cellCoord(bounds[0].x);
+		entry->cellMin[1] = sectorIndex_cellCoord(bounds[0].z);
+		entry->cellMax[0] = sectorIndex_cellCoord(bounds[1].x);
+		entry->cellMax[1] = sectorIndex_cellCoord(bounds[1].z);
+		entry->indexed = true;
+
+		const s64 cellCount = s64(entry->cellMax[0] - entry->cellMin[0] + 1) * s64(entry->cellMax[1] - entry->cellMin[1] + 1);
+		entry->large = cellCount > SIDX_MAX_SECTOR_CELLS;
+
+		SectorIndexLayer& layer = s_indexLayers[entry->layer];
+		if (entry->large)
+		{
+			layer.large.push_back(id);
+			return;
+		}
+		for (s32 z = entry->cellMin[1]; z <= entry->cellMax[1]; z++)
+		{
+			for (s32 x = entry->cellMin[0]; x <= entry->cellMax[0]; x++)
+			{
+				layer.cells[sectorIndex_cellKey(x, z)].push_back(id);
+			}
+		}
+	}
+
+	static void sectorIndex_rebuild()
+	{
+		s_indexLayers.clear();
+		s_indexEntries.clear();
+
+		const s32 count = (s32)s_level.sectors.size();
+		s_indexEntries.resize(count);
+		const EditorSector* sector = s_level.sectors.data();
+		for (s32 i = 0; i < count; i++, sector++)
+		{
+			sectorIndex_insert(i, sector);
+		}
+		s_indexDirty = false;
+	}
+
+	void sectorIndex_invalidate()
+	{
+		s_indexDirty = true;
+	}
+
+	void sectorIndex_update(EditorSector* sector)
+	{
+		// Only sectors in the current level are indexed (not snapshots or levels being loaded).
+		const size_t count = s_level.sectors.size();
+		if (s_indexDirty || !sector || sector < s_level.sectors.data() || sector >= s_level.sectors.data() + count) { return; }
+
+		// New sectors are appended to the level.
+		const s32 id = s32(sector - s_level.sectors.data());
+		if (id >= (s32)s_indexEntries.size())
+		{
+			s_indexEntries.resize(id + 1);
+		}
+		sectorIndex_remove(id);
+		sectorIndex_insert(id, sector);
+	}
+
+	static void sectorIndex_queryLayer(const SectorIndexLayer& layer, const s32* cellMin, const s32* cellMax, SectorList* result)
+	{
+		EditorSector* sectors = s_level.sectors.data();
+		for (size_t i = 0; i < layer.large.size(); i++)
+		{
+			const s32 id = layer.large[i];
+			SectorIndexEntry* entry = &s_indexEntries[id];
+			if (entry->cellMax[0] < cellMin[0] || entry->cellMin[0] > cellMax[0] ||
+				entry->cellMax[1] < cellMin[1] || entry->cellMin[1] > cellMax[1])
+			{
+				continue;
+			}
+			entry->queryKey = s_indexQueryKey;
+			result->push_back(&sectors[id]);
+		}
+
+		// Walk whichever is smaller - the cells covered by the query or the occupied cells.
+		const s64 queryCellCount = s64(cellMax[0] - cellMin[0] + 1) * s64(cellMax[1] - cellMin[1] + 1);
+		if (queryCellCount <= (s64)layer.cells.size())
+		{
+			for (s32 z = cellMin[1]; z <= cellMax[1]; z++)
+			{
+				for (s32 x = cellMin[0]; x <= cellMax[0]; x++)
+				{
+					auto cellIter = layer.cells.find(sectorIndex_cellKey(x, z));
+					if (cellIter == layer.cells.end()) { continue; }
+
+					const std::vector<s32>& list = cellIter->second;
+					for (size_t i = 0; i < list.size(); i++)
+					{
+						SectorIndexEntry* entry = &s_indexEntries[list[i]];
+						if (entry->queryKey == s_indexQueryKey) { continue; }
+						entry->queryKey = s_indexQueryKey;
+						result->push_back(&sectors[list[i]]);
+					}
+				}
+			}
+		}
+		else
+		{
+			for (auto cellIter = layer.cells.begin(); cellIter != layer.cells.end(); ++cellIter)
+			{
+				const s32 x = s32(u32(cellIter->first >> 32ull));
+				const s32 z = s32(u32(cellIter->first));
+				if (x < cellMin[0] || x > cellMax[0] || z < cellMin[1] || z > cellMax[1]) { continue; }
+
+				const std::vector<s32>& list = cellIter->second;
+				for (size_t i = 0; i < list.size(); i++)
+				{
+					SectorIndexEntry* entry = &s_indexEntries[list[i]];
+					if (entry->queryKey == s_indexQueryKey) { continue; }
+					entry->queryKey = s_indexQueryKey;
+					result->push_back(&sectors[list[i]]);
+				}
+			}
+		}
+	}
+
+	void sectorIndex_query(s32 layer, Vec2f boundsMin, Vec2f boundsMax, SectorList* result)
+	{
+		result->clear();
+		// Catch sectors added or removed without going through the edit functions.
+		if (s_indexDirty || s_indexEntries.size() != s_level.sectors.size())
+		{
+			sectorIndex_rebuild();
+		}
+		if (s_indexEntries.empty()) { return; }
+
+		s_indexQueryKey++;
+		if (s_indexQueryKey == 0)
+		{
+			for (size_t i = 0; i < s_indexEntries.size(); i++) { s_indexEntries[i].queryKey = 0; }
+			s_indexQueryKey = 1;
+		}
+
+		const s32 cellMin[] = { sectorIndex_cellCoord(std::min(boundsMin.x, boundsMax.x)), sectorIndex_cellCoord(std::min(boundsMin.z, boundsMax.z)) };
+		const s32 cellMax[] = { sectorIndex_cellCoord(std::max(boundsMin.x, boundsMax.x)), sectorIndex_cellCoord(std::max(boundsMin.z, boundsMax.z)) };
+		if (layer == LAYER_ANY)
+		{
+			for (auto layerIter = s_indexLayers.begin(); layerIter != s_indexLayers.end(); ++layerIter)
+			{
+				sectorIndex_queryLayer(layerIter->second, cellMin, cellMax, result);
+			}
+		}
+		else
+		{
+			auto layerIter = s_indexLayers.find(layer);
+			if (layerIter != s_indexLayers.end()) { sectorIndex_queryLayer(layerIter->second, cellMin, cellMax, result); }
+			layerIter = s_indexLayers.find(LAYER_ANY);
+			if (layerIter != s_indexLayers.end()) { sectorIndex_queryLayer(layerIter->second, cellMin, cellMax, result); }
+		}
+
+		// Keep the same order as a linear search through the level sectors.
+		std::sort(result->begin(), result->end());
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// The Force Engine Editor
+// A system built to view and edit Dark Forces data files.
+// The viewing aspect needs to be put in place at the beginning
+// in order to properly test elements in isolation without having
+// to "play" the game as intended.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include "levelEditorData.h"
+
+namespace LevelEditor
+{
+	// Per-layer grid over the 2D sector bounds of the current level, used to limit
+	// picking and hover queries to nearby sectors.
+	// Sectors are re-indexed as their polygons are rebuilt, adding, removing or
+	// replacing sectors invalidates the index which is rebuilt by the next query.
+	void sectorIndex_invalidate();
+	void sectorIndex_update(EditorSector* sector);
+
+	// Get the sectors whose 2D bounds may overlap [boundsMin, boundsMax], in sector id order.
+	// The results include sectors on 'layer' and LAYER_ANY (or all layers if 'layer' is LAYER_ANY),
+	// the caller still needs to do the exact tests.
+	void sectorIndex_query(s32 layer, Vec2f boundsMin, Vec2f boundsMax, SectorList* result);
+}
@@ -40,6 +40,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_set>
 
 using namespace TFE_Editor;
 
@@ -49,6 +50,9 @@ namespace LevelEditor
 	SelectionList s_vertexList;
 	SectorList s_sectorChangeList;
 	DragSelect s_dragSelect = {};
+	// Hashed copies of the selection lists (using the masked compare values) for fast lookups.
+	static std::unordered_set<u64> s_selectionSet;
+	static std::unordered_set<u64> s_vertexSet;
 
 	enum FeatureIdPacking : u64
 	{
@@ -85,27 +89,28 @@ namespace LevelEditor
 	void selection_clear(bool clearDragSelect)
 	{
 		s_selectionList.clear();
+		s_selectionSet.clear();
 		if (clearDragSelect) { s_dragSelect.active = false; }
 	}
-		
-	bool selection_doesFeatureExist(FeatureId id)
+
+	void selection_set(s32 count, const FeatureId* list)
 	{
-		const u64 compareValue = u64(id) & FID_COMPARE_MASK;
-		const size_t count = s_selectionList.size();
-		const FeatureId* feature = s_selectionList.data();
-		for (size_t i = 0; i < count; i++, feature++)
+		s_selectionList.clear();
+		s_selectionSet.clear();
+		for (s32 i = 0; i < count; i++)
 		{
-			if ((u64(*feature) & FID_COMPARE_MASK) == compareValue)
-			{
-				return true;
-			}
+			selection_add(list[i]);
 		}
-		return false;
+	}
+		
+	bool selection_doesFeatureExist(FeatureId id)
+	{
+		return s_selectionSet.find(u64(id) & FID_COMPARE_MASK) != s_selectionSet.end();
 	}
 
 	bool selection_add(FeatureId id)
 	{
-		if (selection_doesFeatureExist(id)) { return false; }
+		if (!s_selectionSet.insert(u64(id) & FID_COMPARE_MASK).second) { return false; }
 		s_selectionList.push_back(id);
 		return true;
 	}
@@ -113,6 +118,8 @@ namespace LevelEditor
 	void selection_remove(FeatureId id)
 	{
 		const u64 compareValue = u64(id) & FID_COMPARE_MASK;
+		if (s_selectionSet.erase(compareValue) == 0) { return; }
+
 		const size_t count = s_selectionList.size();
 		const FeatureId* feature = s_selectionList.data();
 		for (size_t i = 0; i < count; i++, feature++)
@@ -139,26 +146,17 @@ namespace LevelEditor
 	void vtxSelection_clear()
 	{
 		s_vertexList.clear();
+		s_vertexSet.clear();
 	}
 
 	bool vtxSelection_doesFeatureExist(FeatureId id)
 	{
-		const u64 compareValue = u64(id) & FID_COMPARE_MASK;
-		const size_t count = s_vertexList.size();
-		const FeatureId* feature = s_vertexList.data();
-		for (size_t i = 0; i < count; i++, feature++)
-		{
-			if ((u64(*feature) & FID_COMPARE_MASK) == compareValue)
-			{
-				return true;
-			}
-		}
-		return false;
+		return s_vertexSet.find(u64(id) & FID_COMPARE_MASK) != s_vertexSet.end();
 	}
 
 	bool vtxSelection_add(FeatureId id)
 	{
-		if (vtxSelection_doesFeatureExist(id)) { return false; }
+		if (!s_vertexSet.insert(u64(id) & FID_COMPARE_MASK).second) { return false; }
 		s_vertexList.push_back(id);
 		return true;
 	}
@@ -166,8 +164,10 @@ namespace LevelEditor
 	void vtxSelection_remove(FeatureId id)
 	{
 		const u64 compareValue = u64(id) & FID_COMPARE_MASK;
+		if (s_vertexSet.erase(compareValue) == 0) { return; }
+
 		const size_t count = s_vertexList.size();
-		const FeatureId* feature = s_selectionList.data();
+		const FeatureId* feature = s_vertexList.data();
 		for (size_t i = 0; i < count; i++, feature++)
 		{
 			if ((u64(*feature) & FID_COMPARE_MASK) == compareValue)
@@ -45,6 +45,8 @@ namespace LevelEditor
 
 	// Selection
 	void selection_clear(bool clearDragSelect = true);
+	// Replace the current selection, s_selectionList should only be changed through these functions.
+	void selection_set(s32 count, const FeatureId* list);
 	bool selection_add(FeatureId id);
 	void selection_remove(FeatureId id);
 	void selection_toggle(FeatureId id);
@@ -1,5 +1,8 @@
+#include <algorithm>
+
 #include "editorConfig.h"
 #include "editor.h"
+#include "history.h"
 #include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_System/system.h>
 #include <TFE_System/parser.h>
@@ -114,6 +117,7 @@ namespace TFE_Editor
 		// Level Editor
 		TFE_IniParser::writeKeyValue_Int(configFile, "Interface_Flags", s_editorConfig.interfaceFlags);
 		TFE_IniParser::writeKeyValue_Float(configFile, "Curve_SegmentSize", s_editorConfig.curve_segmentSize);
+		TFE_IniParser::writeKeyValue_Int(configFile, "Undo_MemoryBudget", s_editorConfig.undoMemoryBudget);
 
 		// Recent files.
 		std::vector<RecentProject>* recentProjects = getRecentProjects();
@@ -198,6 +202,10 @@ namespace TFE_Editor
 
 			fontScaleControl();
 			thumbnailSizeControl();
+			if (ImGui::SliderInt("Undo Memory (MB)", &s_editorConfig.undoMemoryBudget, 16, 1024))
+			{
+				history_setMemoryBudget(u32(std::max(s_editorConfig.undoMemoryBudget, 1)) * 1024u * 1024u);
+			}
 			ImGui::Separator();
 
 			if (ImGui::Button("Save Config"))
@@ -278,6 +286,10 @@ namespace TFE_Editor
 		{
 			s_editorConfig.curve_segmentSize = TFE_IniParser::parseFloat(value);
 		}
+		else if (strcasecmp(key, "Undo_MemoryBudget") == 0)
+		{
+			s_editorConfig.undoMemoryBudget = TFE_IniParser::parseInt(value);
+		}
 		else if (strncasecmp(key, "Recent", strlen("Recent")) == 0)
 		{
 			addToRecents(value);
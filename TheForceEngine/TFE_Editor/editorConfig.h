@@ -23,6 +23,7 @@ namespace TFE_Editor
 		// Level editor
 		s32 interfaceFlags = 0;
 		f32 curve_segmentSize = 2.0f;
+		s32 undoMemoryBudget = 64;	// Megabytes of compressed undo snapshots.
 	};
 	enum EditorFontConst
 	{
@@ -1,5 +1,9 @@
 #include "history.h"
 #include "errorMessages.h"
+#include <TFE_System/system.h>
+#include <TFE_System/jobs.h>
+#define MINIZ_HEADER_FILE_ONLY
+#include <TFE_Archive/zip/miniz.h>
 #include <assert.h>
 #include <algorithm>
 #include <cstring>
@@ -10,6 +14,9 @@ namespace TFE_Editor
 	enum
 	{
 		CMD_MAX_DEPTH = 64,
+		// Every Nth snapshot is stored whole, the rest are stored as a delta from the previous snapshot.
+		SNAPSHOT_KEYFRAME_INTERVAL = 8,
+		SNAPSHOT_DEFAULT_BUDGET = 64 * 1024 * 1024,
 	};
 
 	struct Snapshot
@@ -17,9 +24,26 @@ namespace TFE_Editor
 		std::string name;
 		u32 uncompressedSize;
 		u32 compressedSize;
+		u32 historyIndex;
+		// Keyframes hold the whole snapshot, otherwise the data is the previous snapshot XOR this one.
+		bool keyframe;
+		// False if compression failed and the data was stored as-is.
+		bool compressed;
 		std::vector<u8> compressedData;
 	};
 
+	// Snapshots are compressed on a job, the result is moved into the snapshot list when the job is finished.
+	struct SnapshotJob
+	{
+		s32 id;
+		bool keyframe;
+		bool compressed;
+		const SnapshotBuffer* data;
+		const SnapshotBuffer* base;
+		std::vector<u8> delta;
+		std::vector<u8> output;
+	};
+
 	struct CommandHeader
 	{
 		u16 cmdId;
@@ -42,6 +66,26 @@ namespace TFE_Editor
 	u32 s_curBufferAddr = 0;
 	u32 s_curSnapshot = 0;
 
+	// The newest snapshot is kept uncompressed as the base for the next delta,
+	// and the last snapshot restored by undo/redo is cached so stepping through history stays fast.
+	SnapshotBuffer s_latestSnapshot;
+	s32 s_latestSnapshotId = -1;
+	SnapshotBuffer s_decodedSnapshot;
+	s32 s_decodedSnapshotId = -1;
+	SnapshotBuffer s_decodeBuffer;
+
+	SnapshotJob s_snapshotJob;
+	JobCounter s_snapshotJobCounter;
+	bool s_snapshotPending = false;
+
+	// Once the compressed snapshots exceed the budget the oldest are discarded, along with the history that depends on them.
+	u32 s_snapshotMemoryBudget = SNAPSHOT_DEFAULT_BUDGET;
+	size_t s_snapshotMemory = 0;
+	s32 s_firstSnapshot = 0;
+	u32 s_firstValidPos = 0;
+
+	void history_finishSnapshot();
+
 	void history_init(UnpackSnapshotFunc snapshotUnpackFunc, CreateSnapshotFunc createSnapshotFunc)
 	{
 		s_snapshotUnpack = snapshotUnpackFunc;
@@ -56,16 +100,41 @@ namespace TFE_Editor
 
 	void history_destroy()
 	{
+		history_clear();
+		s_snapshotBuffer = SnapshotBuffer();
+		s_latestSnapshot = SnapshotBuffer();
+		s_decodedSnapshot = SnapshotBuffer();
+		s_decodeBuffer = SnapshotBuffer();
+		s_snapshotJob.delta = std::vector<u8>();
 	}
 
 	void history_clear()
 	{
+		// Make sure a background job isn't still using the snapshot buffers.
+		history_finishSnapshot();
+
 		s_snapShots.clear();
 		s_history.clear();
 		s_historyBuffer.clear();
 		s_curPosInHistory = 0;
 		s_curBufferAddr = 0;
 		s_curSnapshot = 0;
+
+		s_latestSnapshotId = -1;
+		s_decodedSnapshotId = -1;
+		s_snapshotMemory = 0;
+		s_firstSnapshot = 0;
+		s_firstValidPos = 0;
+	}
+
+	void history_setMemoryBudget(u32 bytes)
+	{
+		s_snapshotMemoryBudget = bytes;
+	}
+
+	size_t history_getMemoryUsage()
+	{
+		return s_snapshotMemory;
 	}
 
 	// Register general commands and names.
@@ -116,19 +185,160 @@ namespace TFE_Editor
 		return (CommandHeader*)(s_historyBuffer.data() + addr);
 	}
 		
+	////////////////////////////////
+	// Snapshot storage
+	////////////////////////////////
+	void history_compressSnapshotJob(void* userData, s32 index)
+	{
+		SnapshotJob* job = (SnapshotJob*)userData;
+		const u32 size = (u32)job->data->size();
+		const u8* src = job->data->data();
+		if (!job->keyframe)
+		{
+			// Bytes that did not change since the previous snapshot become zero, which compresses very well.
+			const u32 baseSize = std::min(size, (u32)job->base->size());
+			const u8* base = job->base->data();
+			job->delta.resize(size);
+			u8* delta = job->delta.data();
+			for (u32 i = 0; i < baseSize; i++)
+			{
+				delta[i] = src[i] ^ base[i];
+			}
+			memcpy(delta + baseSize, src + baseSize, size - baseSize);
+			src = delta;
+		}
+
+		mz_ulong compressedSize = mz_compressBound(size);
+		job->output.resize(compressedSize);
+		job->compressed = mz_compress2(job->output.data(), &compressedSize, src, size, MZ_BEST_SPEED) == MZ_OK;
+		if (!job->compressed)
+		{
+			compressedSize = size;
+			job->output.resize(size);
+			memcpy(job->output.data(), src, size);
+		}
+		job->output.resize(compressedSize);
+		job->output.shrink_to_fit();
+	}
+
+	// Discard the oldest keyframe and its deltas until the snapshots fit in the budget, the newest keyframe is always kept.
+	void history_trimSnapshots()
+	{
+		const s32 count = (s32)s_snapShots.size();
+		while (s_snapshotMemory > s_snapshotMemoryBudget)
+		{
+			s32 nextKeyframe = s_firstSnapshot + 1;
+			while (nextKeyframe < count && !s_snapShots[nextKeyframe].keyframe) { nextKeyframe++; }
+			if (nextKeyframe >= count) { break; }
+
+			for (s32 i = s_firstSnapshot; i < nextKeyframe; i++)
+			{
+				s_snapshotMemory -= s_snapShots[i].compressedSize;
+				s_snapShots[i].compressedData = std::vector<u8>();
+				s_snapShots[i].compressedSize = 0;
+			}
+			s_firstSnapshot = nextKeyframe;
+			s_firstValidPos = s_snapShots[nextKeyframe].historyIndex;
+			if (s_decodedSnapshotId < nextKeyframe) { s_decodedSnapshotId = -1; }
+		}
+	}
+
+	// Wait for the snapshot being compressed, if any, and store the result.
+	void history_finishSnapshot()
+	{
+		if (!s_snapshotPending) { return; }
+		TFE_Jobs::wait(&s_snapshotJobCounter);
+		s_snapshotPending = false;
+
+		Snapshot* snapshot = &s_snapShots[s_snapshotJob.id];
+		snapshot->compressed = s_snapshotJob.compressed;
+		snapshot->compressedSize = (u32)s_snapshotJob.output.size();
+		snapshot->compressedData = std::move(s_snapshotJob.output);
+		s_snapshotJob.output = std::vector<u8>();
+		s_snapshotMemory += snapshot->compressedSize;
+
+		// The snapshot just compressed becomes the base for the next delta.
+		std::swap(s_latestSnapshot, s_snapshotBuffer);
+		s_latestSnapshotId = s_snapshotJob.id;
+
+		history_trimSnapshots();
+	}
+
+	bool history_decompressSnapshot(const Snapshot* snapshot, u8* output)
+	{
+		if (!snapshot->compressed)
+		{
+			memcpy(output, snapshot->compressedData.data(), snapshot->uncompressedSize);
+			return true;
+		}
+		mz_ulong size = snapshot->uncompressedSize;
+		return mz_uncompress(output, &size, snapshot->compressedData.data(), snapshot->compressedSize) == MZ_OK && size == snapshot->uncompressedSize;
+	}
+
+	// Returns the uncompressed snapshot data, or null if the snapshot has been discarded.
+	const SnapshotBuffer* history_getSnapshotData(s32 id)
+	{
+		// The newest snapshot is always available uncompressed, even while it is being compressed.
+		if (s_snapshotPending && id == s_snapshotJob.id) { return &s_snapshotBuffer; }
+		if (id == s_latestSnapshotId) { return &s_latestSnapshot; }
+		if (id < s_firstSnapshot) { return nullptr; }
+		if (id == s_decodedSnapshotId) { return &s_decodedSnapshot; }
+
+		// Start from the nearest keyframe, or from the cached snapshot if it is on the way.
+		s32 start = id;
+		while (!s_snapShots[start].keyframe) { start--; }
+		if (s_decodedSnapshotId > start && s_decodedSnapshotId < id)
+		{
+			start = s_decodedSnapshotId;
+		}
+		else
+		{
+			const Snapshot* keyframe = &s_snapShots[start];
+			s_decodedSnapshot.resize(keyframe->uncompressedSize);
+			if (!history_decompressSnapshot(keyframe, s_decodedSnapshot.data()))
+			{
+				s_decodedSnapshotId = -1;
+				return nullptr;
+			}
+		}
+
+		// Then apply the deltas.
+		for (s32 i = start + 1; i <= id; i++)
+		{
+			const Snapshot* snapshot = &s_snapShots[i];
+			const u32 size = snapshot->uncompressedSize;
+			s_decodeBuffer.resize(size);
+			if (!history_decompressSnapshot(snapshot, s_decodeBuffer.data()))
+			{
+				s_decodedSnapshotId = -1;
+				return nullptr;
+			}
+			// Bytes past the end of the previous snapshot were XORed with zero.
+			s_decodedSnapshot.resize(size, 0);
+			u8* dst = s_decodedSnapshot.data();
+			const u8* delta = s_decodeBuffer.data();
+			for (u32 b = 0; b < size; b++)
+			{
+				dst[b] ^= delta[b];
+			}
+		}
+		s_decodedSnapshotId = id;
+		return &s_decodedSnapshot;
+	}
+
 	// Create new commands and snapshots.
-	s32 history_createSnapshotInternal(u32 size, void* data, const char* name/*=nullptr*/)
+	// The snapshot data is in s_snapshotBuffer, it is compressed in the background.
+	s32 history_createSnapshotInternal(const char* name/*=nullptr*/)
 	{
+		const s32 id = (s32)s_snapShots.size();
+		const u32 historyIndex = (u32)s_history.size();
+
 		Snapshot snapshot = {};
-		snapshot.uncompressedSize = size;
-		// TODO: Compress
-		// For now just pretend and copy the data.
-		snapshot.compressedSize = size;
-		snapshot.compressedData.resize(size);
 		snapshot.name = name ? name : "";
-		memcpy(snapshot.compressedData.data(), data, size);
-
-		s32 id = (s32)s_snapShots.size();
+		snapshot.uncompressedSize = (u32)s_snapshotBuffer.size();
+		snapshot.historyIndex = historyIndex;
+		snapshot.keyframe = (id % SNAPSHOT_KEYFRAME_INTERVAL) == 0 || s_latestSnapshotId != id - 1;
+		snapshot.compressed = true;
 		s_snapShots.push_back(std::move(snapshot));
 		s_curSnapshot = u32(id);
 
@@ -137,16 +347,28 @@ namespace TFE_Editor
 		header->cmdName = 0;
 		header->parentId = id;
 		header->depth = 0;
+		// New commands build on the snapshot.
+		s_curPosInHistory = historyIndex;
+
+		s_snapshotJob.id = id;
+		s_snapshotJob.keyframe = s_snapShots[id].keyframe;
+		s_snapshotJob.data = &s_snapshotBuffer;
+		s_snapshotJob.base = &s_latestSnapshot;
+		s_snapshotPending = true;
+		TFE_Jobs::submit(history_compressSnapshotJob, &s_snapshotJob, 1, &s_snapshotJobCounter);
 
 		return id;
 	}
 
 	void history_createSnapshot(const char* name/*=nullptr*/)
 	{
+		// The previous snapshot has to be finished before s_snapshotBuffer can be reused.
+		history_finishSnapshot();
+
 		// Callback setup by the client.
 		s_snapshotBuffer.clear();
 		s_snapshotCreate(&s_snapshotBuffer);
-		history_createSnapshotInternal((u32)s_snapshotBuffer.size(), s_snapshotBuffer.data(), name);
+		history_createSnapshotInternal(name);
 	}
 		
 	bool history_createCommand(u16 cmd, u16 name)
@@ -155,14 +377,8 @@ namespace TFE_Editor
 		const CommandHeader* prevHeader = hBuffer_getHeader(parentId);
 		if (prevHeader->depth >= CMD_MAX_DEPTH)
 		{
-			// Callback setup by the client.
-			s_snapshotBuffer.clear();
-			s_snapshotCreate(&s_snapshotBuffer);
-
-			// TODO: Compress
-
 			// Create the snapshot itself.
-			history_createSnapshotInternal((u32)s_snapshotBuffer.size(), s_snapshotBuffer.data(), "");
+			history_createSnapshot("");
 			// Return false to let the caller know a snapshot was created instead of the command.
 			return false;
 		}
@@ -177,16 +393,36 @@ namespace TFE_Editor
 		return true;
 	}
 
+	// Returns false if the position depends on a snapshot that has been discarded.
+	bool history_isPosAvailable(s32 pos)
+	{
+		const CommandHeader* header = hBuffer_getHeader(pos);
+		for (s32 i = 0; i <= CMD_MAX_DEPTH && header->cmdId != CMD_SNAPSHOT; i++)
+		{
+			header = hBuffer_getHeader(header->parentId);
+		}
+		return header->cmdId == CMD_SNAPSHOT && header->parentId >= s_firstSnapshot;
+	}
+
 	void history_step(s32 count)
 	{
-		s32 pos = std::max(0, std::min((s32)s_history.size() - 1, (s32)s_curPosInHistory + count));
+		const s32 lastPos = (s32)s_history.size() - 1;
+		s32 pos = std::max((s32)s_firstValidPos, std::min(lastPos, (s32)s_curPosInHistory + count));
+
+		// Skip over positions that can no longer be restored.
+		const s32 dir = count < 0 ? -1 : 1;
+		while (!history_isPosAvailable(pos))
+		{
+			pos += dir;
+			if (pos < (s32)s_firstValidPos || pos > lastPos) { return; }
+		}
 		history_setPos(pos);
 	}
 
 	void history_setPos(s32 pos)
 	{
 		assert(pos >= 0 && pos < (s32)s_history.size());
-		s_curPosInHistory = pos;
+		const s32 newPos = pos;
 
 		// 1. Traverse backward through the parentIds until a snapshot is reached.
 		u16 cmdList[257], listCount = 0;
@@ -201,6 +437,16 @@ namespace TFE_Editor
 		}
 		assert(listCount <= 256);
 
+		// The snapshot may have been discarded to stay within the memory budget.
+		const s32 snapshotId = hBuffer_getHeader(cmdList[listCount - 1])->parentId;
+		const SnapshotBuffer* snapshotData = history_getSnapshotData(snapshotId);
+		if (!snapshotData)
+		{
+			TFE_System::logWrite(LOG_WARNING, "History", "Cannot restore history position %d, its snapshot is no longer available.", newPos);
+			return;
+		}
+		s_curPosInHistory = newPos;
+
 		// 2. Go backward towards the snapshot...
 		for (s32 i = (s32)listCount - 1; i >= 0; i--)
 		{
@@ -209,10 +455,7 @@ namespace TFE_Editor
 
 			if (cmdHeader->cmdId == CMD_SNAPSHOT)
 			{
-				Snapshot* snapshot = &s_snapShots[cmdHeader->parentId];
-				// TODO: decompress data if snapshot ID != cached ID.
-				// For now we aren't compressing so just pass it along...
-				s_snapshotUnpack(cmdHeader->parentId, snapshot->compressedSize, snapshot->compressedData.data());
+				s_snapshotUnpack(cmdHeader->parentId, (u32)snapshotData->size(), (void*)snapshotData->data());
 			}
 			else
 			{
@@ -27,6 +27,11 @@ namespace TFE_Editor
 	void history_init(UnpackSnapshotFunc snapshotUnpackFunc, CreateSnapshotFunc createSnapshotFunc);
 	void history_destroy();
 	void history_clear();
+	// Snapshots are compressed in the background and stored as deltas, the oldest are discarded
+	// (along with the history that depends on them) once the compressed size exceeds the budget.
+	// A new budget is applied when the next snapshot is stored.
+	void history_setMemoryBudget(u32 bytes);
+	size_t history_getMemoryUsage();
 
 	// Register general commands and names.
 	void history_registerCommand(u16 id, CmdApplyFunc func);
@@ -0,0 +1,71 @@
+#include "fileTable.h"
+#include <TFE_Archive/archive.h>
+#include <cctype>
+#include <string>
+#include <unordered_map>
+
+namespace TFE_FileTable
+{
+	typedef std::unordered_map<std::string, FileTableEntry> FileTable;
+	typedef std::unordered_map<std::string, s32> SearchPathTable;
+	static FileTable s_fileTable;
+	static SearchPathTable s_searchPathTable;
+
+	// Names are stored in lower case, matching the strcasecmp() behavior of the archives.
+	static std::string getKey(const char* fileName)
+	{
+		std::string key(fileName);
+		for (size_t i = 0; i < key.length(); i++)
+		{
+			key[i] = tolower((u8)key[i]);
+		}
+		return key;
+	}
+
+	void clear()
+	{
+		s_fileTable.clear();
+	}
+
+	void addArchive(Archive* archive)
+	{
+		if (!archive) { return; }
+
+		const u32 count = archive->getFileCount();
+		s_fileTable.reserve(s_fileTable.size() + count);
+		for (u32 i = 0; i < count; i++)
+		{
+			const char* name = archive->getFileName(i);
+			if (!name) { continue; }
+
+			// The first archive with the name keeps it.
+			const FileTableEntry entry = { archive, i };
+			s_fileTable.insert({ getKey(name), entry });
+		}
+	}
+
+	const FileTableEntry* find(const char* fileName)
+	{
+		FileTable::const_iterator iEntry = s_fileTable.find(getKey(fileName));
+		return iEntry != s_fileTable.end() ? &iEntry->second : nullptr;
+	}
+
+	void clearSearchPaths()
+	{
+		s_searchPathTable.clear();
+	}
+
+	bool findSearchPath(const char* fileName, s32* searchPath)
+	{
+		SearchPathTable::const_iterator iEntry = s_searchPathTable.find(getKey(fileName));
+		if (iEntry == s_searchPathTable.end()) { return false; }
+
+		*searchPath = iEntry->second;
+		return true;
+	}
+
+	void setSearchPath(const char* fileName, s32 searchPath)
+	{
+		s_searchPathTable[getKey(fileName)] = searchPath;
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Virtual File Table
+// Merged, case-insensitive view of the files provided by the search
+// paths and archives, used by TFE_Paths::getFilePath().
+//
+// Archive entries are added when the table is built, TFE_Paths clears
+// them whenever the mounted archives change. Search path results are
+// kept separately: each name is probed the first time it is requested
+// and the result is cached until the search paths change.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+class Archive;
+
+namespace TFE_FileTable
+{
+	struct FileTableEntry
+	{
+		Archive* archive;	// First archive with the file.
+		u32  index;			// File index in 'archive'.
+	};
+
+	// Clear the archive entries.
+	void clear();
+	// Add every file in the archive, archives added first take priority.
+	void addArchive(Archive* archive);
+	// Returns null if no archive has the file.
+	const FileTableEntry* find(const char* fileName);
+
+	// Clear the cached search path results.
+	void clearSearchPaths();
+	// Returns false if the name has not been probed yet, otherwise 'searchPath' is the index of the first search path with the file or -1.
+	bool findSearchPath(const char* fileName, s32* searchPath);
+	void setSearchPath(const char* fileName, s32 searchPath);
+}
@@ -199,6 +199,11 @@ bool FileStream::isOpen() const
 	return m_file!=nullptr || m_archive!=nullptr;
 }
 
+const u8* FileStream::getData()
+{
+	return m_archive ? m_archive->getFileData() : nullptr;
+}
+
 u32 FileStream::readBuffer(void* ptr, u32 size, u32 count)
 {
 	assert(m_mode == MODE_READ || m_mode == MODE_READWRITE);
@@ -2,6 +2,7 @@
 #include <TFE_FileSystem/stream.h>
 #include <TFE_FileSystem/paths.h>
 #include <cassert>
+#include <vector>
 
 ////////////////////////////////////////////////////
 // TODO: FileStream directly accesses arhive data.
@@ -31,6 +32,23 @@ public:
 	size_t getSize() override;
 	bool   isOpen()  const;
 
+	// Returns the file data in place if it is in memory (such as a memory mapped archive), otherwise null.
+	const u8* getData();
+	// Returns a read-only view of the whole file, reading it into 'buffer' only if the data is not already in memory.
+	// The view stays valid until the archive is closed or 'buffer' is modified.
+	template <typename T>
+	const T* readView(std::vector<T>& buffer, size_t* size)
+	{
+		static_assert(sizeof(T) == 1, "readView() requires a byte buffer.");
+		*size = getSize();
+		const u8* data = getData();
+		if (data) { return (const T*)data; }
+
+		buffer.resize(*size);
+		readBuffer(buffer.data(), u32(*size));
+		return buffer.data();
+	}
+
 	void flush();
 
 	void read(s8*  ptr, u32 count=1) override { readType(ptr, count); }
@@ -0,0 +1,82 @@
+#include "mappedFile.h"
+#include <TFE_System/system.h>
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace FileUtil {
+	extern char* findFileNoCase(const char *fn);
+}
+
+MappedFile::MappedFile() : m_data(nullptr), m_size(0), m_handle(nullptr)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const char* filename)
+{
+	close();
+
+	s32 fd = ::open(filename, O_RDONLY);
+	if (fd < 0 && errno == ENOENT)
+	{
+		// Try to find a file name with a different case, matching FileStream.
+		char* fn2 = FileUtil::findFileNoCase(filename);
+		if (fn2)
+		{
+			fd = ::open(fn2, O_RDONLY);
+			free(fn2);
+		}
+	}
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	// The mapping keeps its own reference to the file, so the descriptor can be closed right away.
+	void* data = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (data == MAP_FAILED)
+	{
+		TFE_System::logWrite(LOG_WARNING, "MappedFile", "Failed to map \"%s\".", filename);
+		return false;
+	}
+
+	m_data = (const u8*)data;
+	m_size = size_t(st.st_size);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_data)
+	{
+		munmap((void*)m_data, m_size);
+	}
+	m_data = nullptr;
+	m_size = 0;
+	m_handle = nullptr;
+}
+
+const u8* MappedFile::getRange(size_t offset, size_t size) const
+{
+	if (!m_data || offset > m_size || size > m_size - offset)
+	{
+		return nullptr;
+	}
+	return m_data + offset;
+}
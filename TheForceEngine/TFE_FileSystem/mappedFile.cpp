@@ -0,0 +1,75 @@
+#include "mappedFile.h"
+#include <TFE_System/system.h>
+#include <Windows.h>
+
+MappedFile::MappedFile() : m_data(nullptr), m_size(0), m_handle(nullptr)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const char* filename)
+{
+	close();
+
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	// The mapping keeps its own reference to the file, so the file handle can be closed right away.
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping)
+	{
+		return false;
+	}
+
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		CloseHandle(mapping);
+		TFE_System::logWrite(LOG_WARNING, "MappedFile", "Failed to map \"%s\".", filename);
+		return false;
+	}
+
+	m_data = (const u8*)data;
+	m_size = size_t(size.QuadPart);
+	m_handle = mapping;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_data)
+	{
+		UnmapViewOfFile(m_data);
+	}
+	if (m_handle)
+	{
+		CloseHandle((HANDLE)m_handle);
+	}
+	m_data = nullptr;
+	m_size = 0;
+	m_handle = nullptr;
+}
+
+const u8* MappedFile::getRange(size_t offset, size_t size) const
+{
+	if (!m_data || offset > m_size || size > m_size - offset)
+	{
+		return nullptr;
+	}
+	return m_data + offset;
+}
@@ -0,0 +1,35 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Memory Mapped File
+// Read-only view of a whole file. Archives map themselves once when
+// opened so that files can be read without reopening the archive and
+// so loaders can parse the data in place.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	// Returns false if the file cannot be mapped, in which case the caller should fall back to FileStream.
+	bool open(const char* filename);
+	void close();
+
+	bool isOpen() const { return m_data != nullptr; }
+	const u8* getData() const { return m_data; }
+	size_t getSize() const { return m_size; }
+
+	// Returns a pointer to [offset, offset + size) or null if the range is outside of the file.
+	const u8* getRange(size_t offset, size_t size) const;
+
+private:
+	// Non-copyable, the mapping is released in the destructor.
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const u8* m_data;
+	size_t m_size;
+	void* m_handle;	// Platform mapping handle.
+};
@@ -3,6 +3,7 @@
 #include "paths.h"
 #include "fileutil.h"
 #include "filestream.h"
+#include "fileTable.h"
 #include <TFE_System/system.h>
 #include <TFE_Archive/archive.h>
 #include <algorithm>
@@ -27,6 +28,10 @@ namespace TFE_Paths
 	static std::deque<std::string> s_searchPaths;
 	static std::deque<FileMapping> s_fileMappings;
 	static std::deque<std::string> s_systemPaths;	// TFE Support data paths
+	// The file table is rebuilt when the search paths or archives change.
+	static bool s_fileTableDirty = true;
+	// The directory version of each local archive when the file table was built.
+	static std::vector<u32> s_fileTableVersions;
 
 	bool isPortableInstall();
 
@@ -209,6 +214,7 @@ namespace TFE_Paths
 			}
 		}
 		s_searchPaths.push_back(workpath);
+		TFE_FileTable::clearSearchPaths();
 	}
 
 	void addSearchPathToHead(const char *fullPath)
@@ -227,12 +233,14 @@ namespace TFE_Paths
 			}
 		}
 		s_searchPaths.push_front(workpath);
+		TFE_FileTable::clearSearchPaths();
 	}
 
 	void clearSearchPaths(void)
 	{
 		s_searchPaths.clear();
 		s_fileMappings.clear();
+		TFE_FileTable::clearSearchPaths();
 	}
 
 	void clearLocalArchives(void)
@@ -240,6 +248,7 @@ namespace TFE_Paths
 		std::for_each(s_localArchives.begin(), s_localArchives.end(),
 				[](Archive *a) { Archive::freeArchive(a); });
 		s_localArchives.clear();
+		s_fileTableDirty = true;
 	}
 
 	// Add a single file that can be referenced by 'fileName' even though the real name may be different.
@@ -287,21 +296,53 @@ namespace TFE_Paths
 	void addLocalArchiveToFront(Archive *a)
 	{
 		s_localArchives.push_front(a);
+		s_fileTableDirty = true;
 	}
 
 	void removeFirstArchive(void)
 	{
 		s_localArchives.pop_front();
+		s_fileTableDirty = true;
 	}
 
 	void addLocalArchive(Archive *a)
 	{
 		s_localArchives.push_back(a);
+		s_fileTableDirty = true;
 	}
 
 	void removeLastArchive(void)
 	{
 		s_localArchives.pop_back();
+		s_fileTableDirty = true;
+	}
+
+	// Local archives can be re-opened or modified without changing the archive list.
+	static bool localArchivesChanged(void)
+	{
+		if (s_localArchives.size() != s_fileTableVersions.size())
+			return true;
+
+		size_t i = 0;
+		for (auto it = s_localArchives.begin(); it != s_localArchives.end(); it++, i++) {
+			if (*it && (*it)->getDirectoryVersion() != s_fileTableVersions[i])
+				return true;
+		}
+		return false;
+	}
+
+	static void updateFileTable(void)
+	{
+		if (!s_fileTableDirty && !localArchivesChanged())
+			return;
+
+		TFE_FileTable::clear();
+		s_fileTableVersions.clear();
+		for (auto it = s_localArchives.begin(); it != s_localArchives.end(); it++) {
+			TFE_FileTable::addArchive(*it);
+			s_fileTableVersions.push_back(*it ? (*it)->getDirectoryVersion() : 0);
+		}
+		s_fileTableDirty = false;
 	}
 
 	bool getFilePath(const char *fileName, FilePath *outPath)
@@ -322,22 +363,30 @@ namespace TFE_Paths
 		}
 
 		// Search in the local search paths before local archives: s_searchPaths.
-		for (auto it = s_searchPaths.begin(); it != s_searchPaths.end(); it++) {
-			sprintf(fullname, "%s%s", it->c_str(), fileName);
-			if (FileUtil::existsNoCase(fullname)) {
-				strncpy(outPath->path, fullname, TFE_MAX_PATH);
-				return true;
+		// The result is cached until the search paths change, so each search path is only probed once per file name.
+		s32 searchPath = -1;
+		if (!TFE_FileTable::findSearchPath(fileName, &searchPath)) {
+			for (auto it = s_searchPaths.begin(); it != s_searchPaths.end(); it++) {
+				sprintf(fullname, "%s%s", it->c_str(), fileName);
+				if (FileUtil::existsNoCase(fullname)) {
+					searchPath = s32(it - s_searchPaths.begin());
+					break;
+				}
 			}
+			TFE_FileTable::setSearchPath(fileName, searchPath);
+		}
+		if (searchPath >= 0) {
+			snprintf(outPath->path, TFE_MAX_PATH, "%s%s", s_searchPaths[searchPath].c_str(), fileName);
+			return true;
 		}
 
 		// Then archives: s_localArchives.
-		for (auto it = s_localArchives.begin(); it != s_localArchives.end(); it++) {
-			u32 index = (*it)->getFileIndex(fileName);
-			if (index != INVALID_FILE) {
-				outPath->archive = *it;
-				outPath->index = index;
-				return true;
-			}
+		updateFileTable();
+		const TFE_FileTable::FileTableEntry *entry = TFE_FileTable::find(fileName);
+		if (entry) {
+			outPath->archive = entry->archive;
+			outPath->index = entry->index;
+			return true;
 		}
 
 		// Finally admit defeat.
@@ -2,6 +2,7 @@
 #include "paths.h"
 #include "fileutil.h"
 #include "filestream.h"
+#include "fileTable.h"
 #include <TFE_System/system.h>
 #include <TFE_Archive/archive.h>
 #include <string>
@@ -31,6 +32,10 @@ namespace TFE_Paths
 	static std::vector<Archive*> s_localArchives;
 	static std::vector<std::string> s_searchPaths;
 	static std::vector<FileMapping> s_fileMappings;
+	// The file table is rebuilt when the search paths or archives change.
+	static bool s_fileTableDirty = true;
+	// The directory version of each local archive when the file table was built.
+	static std::vector<u32> s_fileTableVersions;
 
 	bool insertString(char* text, const char* newFragment, const char* pattern);
 	bool isPortableInstall();
@@ -200,6 +205,7 @@ namespace TFE_Paths
 			}
 
 			s_searchPaths.push_back(fullPath);
+			TFE_FileTable::clearSearchPaths();
 		}
 	}
 
@@ -219,6 +225,7 @@ namespace TFE_Paths
 			}
 
 			s_searchPaths.insert(s_searchPaths.begin(), fullPath);
+			TFE_FileTable::clearSearchPaths();
 		}
 	}
 
@@ -226,6 +233,7 @@ namespace TFE_Paths
 	{
 		s_searchPaths.clear();
 		s_fileMappings.clear();
+		TFE_FileTable::clearSearchPaths();
 	}
 
 	void clearLocalArchives()
@@ -237,6 +245,7 @@ namespace TFE_Paths
 			Archive::freeArchive(archive[i]);
 		}
 		s_localArchives.clear();
+		s_fileTableDirty = true;
 	}
 
 	// Add a single file that can be referenced by 'fileName' even though the real name may be different.
@@ -284,21 +293,61 @@ namespace TFE_Paths
 	void addLocalArchiveToFront(Archive* archive)
 	{
 		s_localArchives.insert(s_localArchives.begin(), archive);
+		s_fileTableDirty = true;
 	}
 
 	void removeFirstArchive()
 	{
 		s_localArchives.erase(s_localArchives.begin());
+		s_fileTableDirty = true;
 	}
 
 	void addLocalArchive(Archive* archive)
 	{
 		s_localArchives.push_back(archive);
+		s_fileTableDirty = true;
 	}
 
 	void removeLastArchive()
 	{
 		s_localArchives.pop_back();
+		s_fileTableDirty = true;
+	}
+
+	// Local archives can be re-opened or modified without changing the archive list.
+	static bool localArchivesChanged()
+	{
+		const size_t archiveCount = s_localArchives.size();
+		if (archiveCount != s_fileTableVersions.size()) { return true; }
+
+		Archive** archive = s_localArchives.data();
+		for (size_t i = 0; i < archiveCount; i++)
+		{
+			if (archive[i] && archive[i]->getDirectoryVersion() != s_fileTableVersions[i])
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void updateFileTable()
+	{
+		if (!s_fileTableDirty && !localArchivesChanged())
+		{
+			return;
+		}
+
+		TFE_FileTable::clear();
+		const size_t archiveCount = s_localArchives.size();
+		Archive** archive = s_localArchives.data();
+		s_fileTableVersions.resize(archiveCount);
+		for (size_t i = 0; i < archiveCount; i++)
+		{
+			TFE_FileTable::addArchive(archive[i]);
+			s_fileTableVersions[i] = archive[i] ? archive[i]->getDirectoryVersion() : 0;
+		}
+		s_fileTableDirty = false;
 	}
 
 	bool getFilePath(const char* fileName, FilePath* outPath)
@@ -322,35 +371,40 @@ namespace TFE_Paths
 		}
 
 		// Search in the local search paths before local archives: s_searchPaths.
-		const size_t pathCount = s_searchPaths.size();
-		const std::string* localPath = s_searchPaths.data();
-		for (size_t i = 0; i < pathCount; i++, localPath++)
+		// The result is cached until the search paths change, so each search path is only probed once per file name.
+		s32 searchPath = -1;
+		if (!TFE_FileTable::findSearchPath(fileName, &searchPath))
 		{
-			char fullName[TFE_MAX_PATH];
-			sprintf(fullName, "%s%s", localPath->c_str(), fileName);
-
-			FileStream file;
-			if (file.exists(fullName))
+			const size_t pathCount = s_searchPaths.size();
+			const std::string* localPath = s_searchPaths.data();
+			for (size_t i = 0; i < pathCount; i++, localPath++)
 			{
-				strncpy(outPath->path, fullName, TFE_MAX_PATH);
-				return true;
+				char fullName[TFE_MAX_PATH];
+				sprintf(fullName, "%s%s", localPath->c_str(), fileName);
+
+				FileStream file;
+				if (file.exists(fullName))
+				{
+					searchPath = s32(i);
+					break;
+				}
 			}
+			TFE_FileTable::setSearchPath(fileName, searchPath);
+		}
+		if (searchPath >= 0)
+		{
+			snprintf(outPath->path, TFE_MAX_PATH, "%s%s", s_searchPaths[searchPath].c_str(), fileName);
+			return true;
 		}
 
 		// Then archives: s_localArchives.
-		const size_t archiveCount = s_localArchives.size();
-		Archive** archive = s_localArchives.data();
-		for (size_t i = 0; i < archiveCount; i++, archive++)
+		updateFileTable();
+		const TFE_FileTable::FileTableEntry* entry = TFE_FileTable::find(fileName);
+		if (entry)
 		{
-			if (!(*archive)) { continue; }	// Avoid crashing if an archive is null.
-
-			u32 index = (*archive)->getFileIndex(fileName);
-			if (index != INVALID_FILE)
-			{
-				outPath->archive = *archive;
-				outPath->index = index;
-				return true;
-			}
+			outPath->archive = entry->archive;
+			outPath->index = entry->index;
+			return true;
 		}
 
 		// Finally admit defeat.
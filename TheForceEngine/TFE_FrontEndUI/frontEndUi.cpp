@@ -1480,6 +1480,7 @@ namespace TFE_FrontEndUI
 	static TextureGpu* s_saveImageView = nullptr;
 	static s32 s_selectedSave = -1;
 	static s32 s_selectedSaveSlot = -1;
+	static s32 s_saveImagePending = -1;
 	static bool s_hasQuicksave = false;
 
 	static char s_newSaveName[256];
@@ -1497,7 +1498,18 @@ namespace TFE_FrontEndUI
 
 	void updateSaveImage(s32 index)
 	{
-		s_saveImageView->update(s_saveDir[index].imageData, TFE_SaveSystem::SAVE_IMAGE_WIDTH * TFE_SaveSystem::SAVE_IMAGE_HEIGHT * 4);
+		// Thumbnails are decoded in the background, show a blank image until it is ready.
+		const u32* image = TFE_SaveSystem::getSaveImage(&s_saveDir[index]);
+		if (image)
+		{
+			s_saveImageView->update(image, TFE_SaveSystem::SAVE_IMAGE_WIDTH * TFE_SaveSystem::SAVE_IMAGE_HEIGHT * 4);
+			s_saveImagePending = -1;
+		}
+		else
+		{
+			if (s_saveImagePending != index) { clearSaveImage(); }
+			s_saveImagePending = index;
+		}
 	}
 
 	void openLoadConfirmPopup()
@@ -1563,10 +1575,11 @@ namespace TFE_FrontEndUI
 		}
 		TFE_SaveSystem::populateSaveDirectory(s_saveDir);
 		s_hasQuicksave = (!s_saveDir.empty() && strcasecmp(s_saveDir[0].saveName, "Quicksave") == 0);
+		s_saveImagePending = -1;
 
 		if (!s_saveDir.empty() && (s_selectedSave > 0 || !save))
 		{
-			updateSaveImage(s_selectedSave);
+			updateSaveImage(s_selectedSave - (save ? 1 : 0));
 		}
 		else
 		{
@@ -1735,9 +1748,14 @@ namespace TFE_FrontEndUI
 				}
 				else
 				{
+					s_saveImagePending = -1;
 					clearSaveImage();
 				}
 			}
+			else if (s_saveImagePending >= 0)
+			{
+				updateSaveImage(s_saveImagePending);
+			}
 			prevSelected = s_selectedSave;
 
 			if (ImGui::BeginPopupModal(s_saveGameConfirmMsg, NULL, ImGuiWindowFlags_AlwaysAutoResize))
@@ -2508,6 +2526,8 @@ namespace TFE_FrontEndUI
 			graphics->asyncFramebuffer = true;
 			graphics->gpuColorConvert = true;
 			ImGui::Checkbox("Extend Adjoin/Portal Limits", &graphics->extendAjoinLimits);
+			ImGui::Checkbox("Multithreaded Rendering", &graphics->multithreadedRender);
+			Tooltip("Split high resolution rendering across several threads.");
 		}
 		else if (graphics->rendererIndex == 1)
 		{
@@ -2860,6 +2880,7 @@ namespace TFE_FrontEndUI
 		TFE_Settings_System* system = TFE_Settings::getSystemSettings();
 		bool gameQuitExitsToMenu = system->gameQuitExitsToMenu;
 		bool returnToModLoader   = system->returnToModLoader;
+		bool levelCache          = system->levelCache;
 		if (ImGui::Checkbox("Game Exit Returns to TFE Menu", &gameQuitExitsToMenu))
 		{
 			system->gameQuitExitsToMenu = gameQuitExitsToMenu;
@@ -2868,6 +2889,10 @@ namespace TFE_FrontEndUI
 		{
 			system->returnToModLoader = returnToModLoader;
 		}
+		if (ImGui::Checkbox("Cache Parsed Levels", &levelCache))
+		{
+			system->levelCache = levelCache;
+		}
 
 		f32 labelW = 140 * s_uiScale;
 		f32 valueW = 260 * s_uiScale - 10;
@@ -9,15 +9,39 @@
 #include <TFE_Ui/ui.h>
 #include <TFE_Ui/markdown.h>
 #include <TFE_System/parser.h>
+#include <TFE_FrontEndUI/console.h>
 
 #include <algorithm>
+#include <ctime>
 
 namespace TFE_ProfilerView
 {
 	static bool s_open = false;
 
+	// Capture the next N frames (default 60) to a trace file in the Chrome trace format.
+	void console_profilerTrace(const ConsoleArgList& args)
+	{
+		const s32 frameCount = args.size() >= 2 ? (s32)TFE_Console::getFloatArg(args[1]) : 60;
+		char timeDate[64];
+		const time_t curTime = time(nullptr);
+		strftime(timeDate, sizeof(timeDate), "%Y%m%d_%H%M%S", localtime(&curTime));
+
+		char path[TFE_MAX_PATH];
+		sprintf(path, "%stfe_trace_%s.json", TFE_Paths::getPath(PATH_USER_DOCUMENTS), timeDate);
+		if (frameCount <= 0 || !TFE_Profiler::beginTraceCapture((u32)frameCount, path))
+		{
+			TFE_Console::addToHistory("Cannot start the trace capture, a capture may already be in progress.");
+			return;
+		}
+
+		char msg[TFE_MAX_PATH + 64];
+		sprintf(msg, "Capturing %d frames to '%s'.", frameCount, path);
+		TFE_Console::addToHistory(msg);
+	}
+
 	bool init()
 	{
+		CCMD("profilerTrace", console_profilerTrace, 0, "Capture profiler zones for N frames and write them as a Chrome/Perfetto trace - profilerTrace [frameCount]");
 		return true;
 	}
 
@@ -70,7 +94,15 @@ namespace TFE_ProfilerView
 
 			ImGui::Text("%0.3fms (%6.03f%%)", info.timeInZoneAve * 1000.0, info.fractOfParentAve * 100.0);
 			ImGui::SameLine(f32(180 + 16*(info.level + 1)));
-			ImGui::Text("%s  [%s:%u]", info.name, info.func, info.lineNumber);
+			if (info.func[0])
+			{
+				ImGui::Text("%s  [%s:%u]", info.name, info.func, info.lineNumber);
+			}
+			else
+			{
+				// Threads other than the main thread.
+				ImGui::Text("[%s]", info.name);
+			}
 
 			for (u32 l = 0; l < info.level; l++)
 			{
@@ -81,6 +113,10 @@ namespace TFE_ProfilerView
 		ImGui::Unindent();
 
 		ImGui::End();
+		if (!s_open)
+		{
+			TFE_Profiler::setEnabled(false);
+		}
 	}
 
 	bool isEnabled()
@@ -91,5 +127,6 @@ namespace TFE_ProfilerView
 	void enable(bool enable)
 	{
 		s_open = enable;
+		TFE_Profiler::setEnabled(enable);
 	}
 }
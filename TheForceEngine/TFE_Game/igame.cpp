@@ -29,6 +29,19 @@ void displayMemoryUsage(const ConsoleArgList& args)
 	sprintf(res, "Level    | %11zu | %16zu | %11zu | %9zu", region_getMemoryUsed(s_levelRegion), region_getMemoryCapacity(s_levelRegion), blockCount, blockSize);
 	TFE_Console::addToHistory(res);
 	TFE_Console::addToHistory("-------------------------------------------------------------------");
+
+	MemoryRegionStats gameStats, levelStats;
+	region_getStats(s_gameRegion, &gameStats);
+	region_getStats(s_levelRegion, &levelStats);
+	TFE_Console::addToHistory("Region   | Free Chunks | Largest Free | Fragmentation | Slab Items");
+	TFE_Console::addToHistory("-------------------------------------------------------------------");
+	sprintf(res, "Game     | %11zu | %12zu | %13.3f | %zu / %zu", gameStats.freeChunkCount, gameStats.largestFreeChunk, gameStats.fragmentation,
+		gameStats.slabItemsUsed, gameStats.slabItemsUsed + gameStats.slabItemsFree);
+	TFE_Console::addToHistory(res);
+	sprintf(res, "Level    | %11zu | %12zu | %13.3f | %zu / %zu", levelStats.freeChunkCount, levelStats.largestFreeChunk, levelStats.fragmentation,
+		levelStats.slabItemsUsed, levelStats.slabItemsUsed + levelStats.slabItemsFree);
+	TFE_Console::addToHistory(res);
+	TFE_Console::addToHistory("-------------------------------------------------------------------");
 }
 
 void game_init()
@@ -2,12 +2,22 @@
 #include <TFE_Input/inputMapping.h>
 #include <TFE_System/system.h>
 #include <TFE_Settings/gameSourceData.h>
+#include <TFE_System/jobs.h>
 #include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/memorystream.h>
+#include <TFE_FrontEndUI/console.h>
+#include <TFE_FrontEndUI/frontEndUi.h>
 
 #include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_Asset/imageAsset.h>
+#define MINIZ_HEADER_FILE_ONLY
+#include <TFE_Archive/zip/miniz.h>
 #include <cassert>
 #include <cstring>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 using namespace TFE_Input;
 
@@ -23,7 +33,21 @@ namespace TFE_SaveSystem
 	enum SaveMasterVersion
 	{
 		SVER_INIT = 1,
-		SVER_CUR = SVER_INIT
+		SVER_COMPRESSED = 2,	// The game state follows the header as a zlib compressed block.
+		SVER_CUR = SVER_COMPRESSED
+	};
+
+	// The game state is serialized into memory on the main thread, the thumbnail encoding,
+	// compression and file write are then done by a background job.
+	struct SaveJob
+	{
+		char filePath[TFE_MAX_PATH];
+		char saveName[SAVE_MAX_NAME_LEN];
+		char timeDate[256];
+		char levelName[256];
+		char modList[256];
+		u32 imageWidth;
+		u32 imageHeight;
 	};
 
 	static SaveRequest s_req = SF_REQ_NONE;
@@ -33,34 +57,333 @@ namespace TFE_SaveSystem
 	static IGame* s_game = nullptr;
 	static s32 s_saveDelay = 0;
 
-	static u32* s_imageBuffer[2] = { nullptr, nullptr };
-	static size_t s_imageBufferSize[2] = { 0 };
+	// Holds the screenshot for the pending save.
+	static u32* s_imageBuffer = nullptr;
+	static size_t s_imageBufferSize = 0;
+
+	static SaveJob s_saveJob;
+	static JobCounter s_saveJobCounter;
+	static MemoryStream s_saveState;
+	static MemoryStream s_loadState;
+	static std::vector<u8> s_compressBuffer;
+
+	// In-memory snapshots used for rewind.
+	// The newest snapshot is kept in full, older snapshots are stored as compressed XOR deltas
+	// against the next newer snapshot. So the oldest can be dropped freely and restoring walks
+	// backwards from the newest state.
+	struct Snapshot
+	{
+		std::vector<u8> delta;
+		u32 size;
+		f64 time;
+	};
+	struct SnapshotJob
+	{
+		MemoryStream* prev;
+		MemoryStream* next;
+		f64 prevTime;
+		s32 maxCount;
+	};
+	static const char* c_rewindName = "rewind";
+
+	static s32 s_snapshotCount = 8;
+	static f32 s_snapshotInterval = 5.0f;
+	static std::vector<Snapshot> s_snapshots;			// Oldest first.
+	static std::vector<std::vector<u8>> s_snapshotPool;	// Recycled delta buffers.
+	static std::vector<u8> s_snapshotXor;
+	static std::vector<u8> s_snapshotRestore;
+	static MemoryStream s_snapshotState[2];
+	static s32  s_snapshotHead = -1;
+	static f64  s_snapshotHeadTime = 0.0;
+	static f64  s_snapshotClock = 0.0;
+	static f64  s_snapshotNextTime = 0.0;
+	static bool s_rewindPending = false;
+	static SnapshotJob s_snapshotJob;
+	static JobCounter s_snapshotJobCounter;
+	static GameID s_snapshotGameId = Game_Count;
+
+	// A copy of the last quicksave, so quickload does not have to go back to disk.
+	static MemoryStream s_quickState;
+	static bool s_quickStateValid = false;
+
+	// The save index caches the headers of every save in the directory, so the save/load menu
+	// only has to read the files that were added or modified since the last time.
+	enum SaveIndexConst : u32
+	{
+		SAVE_INDEX_MAGIC = 0x58444953,	// "SIDX"
+		// Increment whenever the index format or SaveHeader changes.
+		SAVE_INDEX_VERSION = 1,
+		// The modified time, image offset and size, and the length of each of the 5 strings.
+		SAVE_INDEX_MIN_ENTRY_SIZE = 8 + 4 + 4 + 5,
+		// No save directory holds anywhere near this many saves, larger counts mean the index is corrupt.
+		SAVE_INDEX_MAX_COUNT = 65536,
+	};
+	static const char* c_saveIndexName = "saveIndex.dat";
+	static std::vector<SaveHeader> s_saveIndex;
+	static bool s_saveIndexLoaded = false;
+
+	// Decoded thumbnails, the least recently used entry is replaced.
+	// The modified time may only have a resolution of one second, so the key also includes the save generation,
+	// which changes whenever a save is written.
+	struct SaveImage
+	{
+		char fileName[256];
+		u64  modifiedTime;
+		u32  generation;
+		u32  offset;
+		u32  size;
+		u64  lastUse;
+		bool ready;
+		u32* pixels;
+	};
+	static SaveImage s_saveImages[SAVE_IMAGE_CACHE_SIZE] = {};
+	static s32 s_saveImageDecode = -1;
+	static u64 s_saveImageTick = 0;
+	static u32 s_saveGeneration = 0;
+	static char s_saveImagePath[TFE_MAX_PATH];
+	static std::vector<u8> s_saveImagePng;
+	static JobCounter s_saveImageCounter;
+
+	void waitForSave()
+	{
+		TFE_Jobs::wait(&s_saveJobCounter);
+	}
+
+	void waitForSnapshot()
+	{
+		TFE_Jobs::wait(&s_snapshotJobCounter);
+	}
+
+	// XOR 'a' and 'b' into s_snapshotXor, the shorter buffer is treated as zero padded.
+	void snapshotXor(const u8* a, u32 sizeA, const u8* b, u32 sizeB)
+	{
+		const u32 size = std::max(sizeA, sizeB);
+		const u32 common = std::min(sizeA, sizeB);
+		s_snapshotXor.resize(size);
+		u8* out = s_snapshotXor.data();
+		for (u32 i = 0; i < common; i++)
+		{
+			out[i] = a[i] ^ b[i];
+		}
+		const u8* tail = sizeA > sizeB ? a : b;
+		memcpy(out + common, tail + common, size - common);
+	}
+
+	void releaseSnapshots(size_t first)
+	{
+		for (size_t i = first; i < s_snapshots.size(); i++)
+		{
+			s_snapshotPool.push_back(std::move(s_snapshots[i].delta));
+		}
+		s_snapshots.resize(first);
+	}
+
+	// Store the previous head as a delta against the new head.
+	void snapshotDeltaJob(void* userData, s32 index)
+	{
+		const SnapshotJob* job = (const SnapshotJob*)userData;
+		const u32 prevSize = (u32)job->prev->getSize();
+		const u32 nextSize = (u32)job->next->getSize();
+		snapshotXor((const u8*)job->prev->data(), prevSize, (const u8*)job->next->data(), nextSize);
+
+		Snapshot snapshot;
+		if (!s_snapshotPool.empty())
+		{
+			snapshot.delta.swap(s_snapshotPool.back());
+			s_snapshotPool.pop_back();
+		}
+		const u32 xorSize = (u32)s_snapshotXor.size();
+		mz_ulong deltaSize = mz_compressBound(xorSize);
+		snapshot.delta.resize(deltaSize);
+		if (mz_compress2(snapshot.delta.data(), &deltaSize, s_snapshotXor.data(), xorSize, MZ_BEST_SPEED) != MZ_OK)
+		{
+			// Without the delta older snapshots cannot be reached, so drop them.
+			releaseSnapshots(0);
+			return;
+		}
+		snapshot.delta.resize(deltaSize);
+		snapshot.size = prevSize;
+		snapshot.time = job->prevTime;
+		s_snapshots.push_back(std::move(snapshot));
+
+		// The ring holds the head plus (maxCount - 1) deltas.
+		const size_t maxDeltas = (size_t)std::max(job->maxCount - 1, 0);
+		if (s_snapshots.size() > maxDeltas)
+		{
+			const size_t dropCount = s_snapshots.size() - maxDeltas;
+			for (size_t i = 0; i < dropCount; i++)
+			{
+				s_snapshotPool.push_back(std::move(s_snapshots[i].delta));
+			}
+			s_snapshots.erase(s_snapshots.begin(), s_snapshots.begin() + dropCount);
+		}
+	}
+
+	void clearSnapshots()
+	{
+		waitForSnapshot();
+		releaseSnapshots(0);
+		s_snapshotHead = -1;
+		s_snapshotClock = 0.0;
+		s_snapshotNextTime = s_snapshotInterval;
+		s_rewindPending = false;
+	}
+
+	void captureSnapshot()
+	{
+		waitForSnapshot();
+
+		const s32 dst = s_snapshotHead < 0 ? 0 : s_snapshotHead ^ 1;
+		MemoryStream* stream = &s_snapshotState[dst];
+		stream->clear();
+		stream->open(Stream::MODE_WRITE);
+		// No filename, so the game does not show the save message.
+		const bool ret = s_game->serializeGameState(stream, nullptr, true);
+		stream->close();
+		if (!ret) { return; }
+
+		if (s_snapshotHead >= 0 && s_snapshotCount > 1)
+		{
+			s_snapshotJob.prev = &s_snapshotState[s_snapshotHead];
+			s_snapshotJob.next = stream;
+			s_snapshotJob.prevTime = s_snapshotHeadTime;
+			s_snapshotJob.maxCount = s_snapshotCount;
+			TFE_Jobs::submit(snapshotDeltaJob, &s_snapshotJob, 1, &s_snapshotJobCounter);
+		}
+		else
+		{
+			// The existing deltas are relative to the old head.
+			releaseSnapshots(0);
+		}
+		s_snapshotHead = dst;
+		s_snapshotHeadTime = s_snapshotClock;
+	}
+
+	// Rebuild snapshot 'index' into the head buffer and drop the newer snapshots.
+	// Indices count from the oldest delta, s_snapshots.size() is the head itself.
+	bool restoreSnapshot(s32 index)
+	{
+		waitForSnapshot();
+		if (s_snapshotHead < 0 || index < 0 || index > (s32)s_snapshots.size()) { return false; }
+		if (index == (s32)s_snapshots.size())
+		{
+			s_snapshotClock = s_snapshotHeadTime;
+			s_snapshotNextTime = s_snapshotClock + s_snapshotInterval;
+			return true;
+		}
+
+		MemoryStream* head = &s_snapshotState[s_snapshotHead];
+		u32 size = (u32)head->getSize();
+		s_snapshotRestore.resize(size);
+		memcpy(s_snapshotRestore.data(), head->data(), size);
 
-	void saveHeader(Stream* stream, const char* saveName)
+		for (s32 i = (s32)s_snapshots.size() - 1; i >= index; i--)
+		{
+			const Snapshot* snapshot = &s_snapshots[i];
+			mz_ulong xorSize = std::max(size, snapshot->size);
+			s_snapshotXor.resize(xorSize);
+			if (mz_uncompress(s_snapshotXor.data(), &xorSize, snapshot->delta.data(), (mz_ulong)snapshot->delta.size()) != MZ_OK ||
+				xorSize != std::max(size, snapshot->size))
+			{
+				TFE_System::logWrite(LOG_ERROR, "Save", "Cannot decompress the rewind snapshot.");
+				return false;
+			}
+			s_snapshotRestore.resize(xorSize, 0);
+			u8* state = s_snapshotRestore.data();
+			const u8* delta = s_snapshotXor.data();
+			for (u32 b = 0; b < (u32)xorSize; b++)
+			{
+				state[b] ^= delta[b];
+			}
+			size = snapshot->size;
+			s_snapshotRestore.resize(size);
+		}
+
+		if (!head->allocate(size)) { return false; }
+		memcpy(head->data(), s_snapshotRestore.data(), size);
+		s_snapshotHeadTime = s_snapshots[index].time;
+		s_snapshotClock = s_snapshotHeadTime;
+		s_snapshotNextTime = s_snapshotClock + s_snapshotInterval;
+
+		releaseSnapshots(index);
+		return true;
+	}
+
+	void console_rewind(const ConsoleArgList& args)
+	{
+		if (!s_game || s_snapshotHead < 0)
+		{
+			TFE_Console::addToHistory("No rewind snapshots are available yet.");
+			return;
+		}
+		const f64 seconds = args.size() >= 2 ? (f64)TFE_Console::getFloatArg(args[1]) : (f64)s_snapshotInterval;
+
+		waitForSnapshot();
+		// Pick the newest snapshot at least 'seconds' old, or the oldest available.
+		const f64 targetTime = s_snapshotClock - seconds;
+		s32 index = (s32)s_snapshots.size();
+		if (s_snapshotHeadTime > targetTime)
+		{
+			index = 0;
+			for (s32 i = (s32)s_snapshots.size() - 1; i >= 0; i--)
+			{
+				if (s_snapshots[i].time <= targetTime)
+				{
+					index = i;
+					break;
+				}
+			}
+		}
+		// Restore the snapshot before the game is torn down for the load, so a failure leaves the running game as it is.
+		if (!restoreSnapshot(index))
+		{
+			TFE_Console::addToHistory("Cannot restore the rewind snapshot.");
+			return;
+		}
+		s_rewindPending = true;
+		postLoadRequest(c_rewindName);
+
+		// Close the console so the game resumes after the rewind.
+		TFE_FrontEndUI::toggleConsole();
+	}
+
+	// Capture everything the header needs from the main thread.
+	void prepareHeader(SaveJob* job, const char* saveName)
 	{
 		// Generate a screenshot.
 		DisplayInfo displayInfo;
 		TFE_RenderBackend::getDisplayInfo(&displayInfo);
 		size_t size = displayInfo.width * displayInfo.height * 4;
-		if (size > s_imageBufferSize[0])
+		if (size > s_imageBufferSize)
 		{
-			s_imageBuffer[0] = (u32*)realloc(s_imageBuffer[0], size);
-			s_imageBufferSize[0] = size;
+			s_imageBuffer = (u32*)realloc(s_imageBuffer, size);
+			s_imageBufferSize = size;
 		}
-		TFE_RenderBackend::captureScreenToMemory(s_imageBuffer[0]);
+		TFE_RenderBackend::captureScreenToMemory(s_imageBuffer);
+		job->imageWidth  = displayInfo.width;
+		job->imageHeight = displayInfo.height;
+
+		// Save Name.
+		size_t saveNameLen = strlen(saveName);
+		if (saveNameLen > SAVE_MAX_NAME_LEN - 1) { saveNameLen = SAVE_MAX_NAME_LEN - 1; }
+		memcpy(job->saveName, saveName, saveNameLen);
+		job->saveName[saveNameLen] = 0;
+
+		TFE_System::getDateTimeString(job->timeDate);
+		s_game->getLevelName(job->levelName);
+		s_game->getModList(job->modList);
+	}
+
+	void saveHeader(Stream* stream, const SaveJob* job)
+	{
 		// Save to memory.
 		u8* png = (u8*)malloc(SAVE_IMAGE_WIDTH * SAVE_IMAGE_HEIGHT * 4);
 		u32 pngSize = 0;
 		if (png)
 		{
-			pngSize = (u32)TFE_Image::writeImageToMemory(png, displayInfo.width, displayInfo.height,
+			pngSize = (u32)TFE_Image::writeImageToMemory(png, job->imageWidth, job->imageHeight,
 								 SAVE_IMAGE_WIDTH, SAVE_IMAGE_HEIGHT,
-								 s_imageBuffer[0]);
-		}
-		else
-		{
-			pngSize = 0;
-			png = (u8*)s_imageBuffer[0];
+								 s_imageBuffer);
 		}
 
 		// Master version.
@@ -68,32 +391,24 @@ namespace TFE_SaveSystem
 		stream->write(&version);
 
 		// Save Name.
-		size_t saveNameLen = strlen(saveName);
-		if (saveNameLen > SAVE_MAX_NAME_LEN - 1) { saveNameLen = SAVE_MAX_NAME_LEN - 1; }
-		u8 len = (u8)saveNameLen;
+		u8 len = (u8)strlen(job->saveName);
 		stream->write(&len);
-		stream->writeBuffer(saveName, len);
+		stream->writeBuffer(job->saveName, len);
 
 		// Time and Date of Save.
-		char timeDate[256];
-		TFE_System::getDateTimeString(timeDate);
-		len = (u8)strlen(timeDate);
+		len = (u8)strlen(job->timeDate);
 		stream->write(&len);
-		stream->writeBuffer(timeDate, len);
+		stream->writeBuffer(job->timeDate, len);
 
 		// Level Name
-		char levelName[256];
-		s_game->getLevelName(levelName);
-		len = (u8)strlen(levelName);
+		len = (u8)strlen(job->levelName);
 		stream->write(&len);
-		stream->writeBuffer(levelName, len);
+		stream->writeBuffer(job->levelName, len);
 
 		// Mod List
-		char modList[256];
-		s_game->getModList(modList);
-		len = (u8)strlen(modList);
+		len = (u8)strlen(job->modList);
 		stream->write(&len);
-		stream->writeBuffer(modList, len);
+		stream->writeBuffer(job->modList, len);
 
 		// Image.
 		stream->write(&pngSize);
@@ -101,7 +416,36 @@ namespace TFE_SaveSystem
 		free(png);
 	}
 
-	void loadHeader(Stream* stream, SaveHeader* header, const char* fileName)
+	void saveJob(void* userData, s32 index)
+	{
+		const SaveJob* job = (const SaveJob*)userData;
+		const u32 stateSize = (u32)s_saveState.getSize();
+		mz_ulong compressedSize = mz_compressBound(stateSize);
+		s_compressBuffer.resize(compressedSize);
+		if (mz_compress(s_compressBuffer.data(), &compressedSize, (const u8*)s_saveState.data(), stateSize) != MZ_OK)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Save", "Failed to compress save game '%s'.", job->filePath);
+			return;
+		}
+
+		FileStream stream;
+		if (!stream.open(job->filePath, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Save", "Cannot open '%s' for writing.", job->filePath);
+			return;
+		}
+		saveHeader(&stream, job);
+
+		u32 size = stateSize;
+		stream.write(&size);
+		size = (u32)compressedSize;
+		stream.write(&size);
+		stream.writeBuffer(s_compressBuffer.data(), size);
+		stream.close();
+	}
+
+	// Returns the master version.
+	u32 loadHeader(Stream* stream, SaveHeader* header, const char* fileName)
 	{
 		// Master version.
 		u32 version;
@@ -136,74 +480,353 @@ namespace TFE_SaveSystem
 		stream->readBuffer(header->modNames, len);
 		header->modNames[len] = 0;
 
-		// Image, re-use buffer 0 for the PNG.
+		// Image, the PNG is skipped and decoded on demand by getSaveImage().
 		u32 pngSize;
 		stream->read(&pngSize);
-		if (pngSize > s_imageBufferSize[0])
+		header->imageOffset = (u32)stream->getLoc();
+		header->imageSize = pngSize;
+		stream->seek(pngSize, Stream::ORIGIN_CURRENT);
+		return version;
+	}
+
+	void writeIndexString(Stream* stream, const char* str)
+	{
+		u8 len = (u8)std::min(strlen(str), (size_t)255);
+		stream->write(&len);
+		stream->writeBuffer(str, len);
+	}
+
+	bool readIndexString(Stream* stream, char* str, size_t maxLen)
+	{
+		u8 len;
+		stream->read(&len);
+		if (len >= maxLen) { return false; }
+		stream->readBuffer(str, len);
+		str[len] = 0;
+		return true;
+	}
+
+	void getSaveIndexPath(char* path)
+	{
+		sprintf(path, "%s%s", s_gameSavePath, c_saveIndexName);
+	}
+
+	void readSaveIndex()
+	{
+		s_saveIndex.clear();
+		s_saveIndexLoaded = true;
+
+		char indexPath[TFE_MAX_PATH];
+		getSaveIndexPath(indexPath);
+		FileStream stream;
+		if (!stream.open(indexPath, Stream::MODE_READ)) { return; }
+
+		u32 magic = 0, version = 0, count = 0;
+		stream.read(&magic);
+		stream.read(&version);
+		stream.read(&count);
+		if (magic != SAVE_INDEX_MAGIC || version != SAVE_INDEX_VERSION)
+		{
+			TFE_System::logWrite(LOG_MSG, "Save", "The save index is out of date, it will be rebuilt.");
+			return;
+		}
+
+		if (count > SAVE_INDEX_MAX_COUNT || stream.getLoc() + (size_t)count * SAVE_INDEX_MIN_ENTRY_SIZE > stream.getSize())
+		{
+			TFE_System::logWrite(LOG_WARNING, "Save", "The save index is corrupt, it will be rebuilt.");
+			return;
+		}
+
+		s_saveIndex.resize(count);
+		for (u32 i = 0; i < count; i++)
+		{
+			SaveHeader* header = &s_saveIndex[i];
+			stream.read(&header->modifiedTime);
+			stream.read(&header->imageOffset);
+			stream.read(&header->imageSize);
+			if (!readIndexString(&stream, header->fileName,  sizeof(header->fileName))  ||
+				!readIndexString(&stream, header->saveName,  sizeof(header->saveName))  ||
+				!readIndexString(&stream, header->dateTime,  sizeof(header->dateTime))  ||
+				!readIndexString(&stream, header->levelName, sizeof(header->levelName)) ||
+				!readIndexString(&stream, header->modNames,  sizeof(header->modNames))  ||
+				stream.getLoc() > stream.getSize())
+			{
+				TFE_System::logWrite(LOG_WARNING, "Save", "The save index is corrupt, it will be rebuilt.");
+				s_saveIndex.clear();
+				break;
+			}
+		}
+		stream.close();
+	}
+
+	void writeSaveIndex()
+	{
+		char indexPath[TFE_MAX_PATH];
+		getSaveIndexPath(indexPath);
+		FileStream stream;
+		if (!stream.open(indexPath, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_WARNING, "Save", "Cannot write the save index '%s'.", indexPath);
+			return;
+		}
+
+		u32 value = SAVE_INDEX_MAGIC;
+		stream.write(&value);
+		value = SAVE_INDEX_VERSION;
+		stream.write(&value);
+		value = (u32)s_saveIndex.size();
+		stream.write(&value);
+		for (size_t i = 0; i < s_saveIndex.size(); i++)
+		{
+			const SaveHeader* header = &s_saveIndex[i];
+			stream.write(&header->modifiedTime);
+			stream.write(&header->imageOffset);
+			stream.write(&header->imageSize);
+			writeIndexString(&stream, header->fileName);
+			writeIndexString(&stream, header->saveName);
+			writeIndexString(&stream, header->dateTime);
+			writeIndexString(&stream, header->levelName);
+			writeIndexString(&stream, header->modNames);
+		}
+		stream.close();
+	}
+
+	void clearSaveIndex()
+	{
+		s_saveIndex.clear();
+		s_saveIndexLoaded = false;
+
+		TFE_Jobs::wait(&s_saveImageCounter);
+		s_saveImageDecode = -1;
+		for (s32 i = 0; i < SAVE_IMAGE_CACHE_SIZE; i++)
+		{
+			free(s_saveImages[i].pixels);
+			s_saveImages[i] = {};
+		}
+	}
+
+	// Decode the thumbnail PNG for the image slot being decoded.
+	void saveImageJob(void* userData, s32 index)
+	{
+		SaveImage* image = (SaveImage*)userData;
+		const size_t imageSize = SAVE_IMAGE_WIDTH * SAVE_IMAGE_HEIGHT * sizeof(u32);
+		if (!image->pixels)
+		{
+			image->pixels = (u32*)malloc(imageSize);
+		}
+		memset(image->pixels, 0, imageSize);
+
+		FileStream stream;
+		if (image->size && stream.open(s_saveImagePath, Stream::MODE_READ))
+		{
+			s_saveImagePng.resize(image->size);
+			stream.seek(image->offset);
+			const bool readOk = stream.readBuffer(s_saveImagePng.data(), image->size) == image->size;
+			stream.close();
+
+			SDL_Surface* surface = nullptr;
+			if (readOk)
+			{
+				TFE_Image::readImageFromMemory(&surface, image->size, (const u32*)s_saveImagePng.data());
+			}
+			if (surface)
+			{
+				memcpy(image->pixels, surface->pixels, imageSize);
+				TFE_Image::free(surface);
+			}
+		}
+		// Mark the image ready even if decoding failed, so it is not retried every frame.
+		image->ready = true;
+	}
+
+	const u32* getSaveImage(const SaveHeader* header)
+	{
+		if (s_saveImageDecode >= 0 && TFE_Jobs::isDone(&s_saveImageCounter))
 		{
-			s_imageBuffer[0] = (u32*)realloc(s_imageBuffer[0], pngSize);
-			s_imageBufferSize[0] = pngSize;
+			s_saveImageDecode = -1;
 		}
-		stream->readBuffer(s_imageBuffer[0], pngSize);
 
-		SDL_Surface* image;
-		TFE_Image::readImageFromMemory(&image, pngSize, s_imageBuffer[0]);
-		if (image)
+		s32 freeSlot = -1;
+		for (s32 i = 0; i < SAVE_IMAGE_CACHE_SIZE; i++)
 		{
-			const u32 sz = SAVE_IMAGE_WIDTH * SAVE_IMAGE_HEIGHT * sizeof(u32);
-			memcpy(header->imageData, image->pixels, sz);
-			TFE_Image::free(image);
+			SaveImage* image = &s_saveImages[i];
+			if (image->modifiedTime == header->modifiedTime && image->generation == s_saveGeneration && strcasecmp(image->fileName, header->fileName) == 0)
+			{
+				if (i == s_saveImageDecode || !image->ready) { return nullptr; }
+				image->lastUse = ++s_saveImageTick;
+				return image->pixels;
+			}
+			if (i != s_saveImageDecode && (freeSlot < 0 || image->lastUse < s_saveImages[freeSlot].lastUse))
+			{
+				freeSlot = i;
+			}
 		}
+		// Only one image is decoded at a time and not while a save is being written, the caller tries again next frame.
+		if (s_saveImageDecode >= 0 || freeSlot < 0 || !TFE_Jobs::isDone(&s_saveJobCounter)) { return nullptr; }
+
+		SaveImage* image = &s_saveImages[freeSlot];
+		strcpy(image->fileName, header->fileName);
+		image->modifiedTime = header->modifiedTime;
+		image->generation = s_saveGeneration;
+		image->offset = header->imageOffset;
+		image->size = header->imageSize;
+		image->lastUse = ++s_saveImageTick;
+		image->ready = false;
+		sprintf(s_saveImagePath, "%s%s", s_gameSavePath, header->fileName);
+		s_saveImageDecode = freeSlot;
+		TFE_Jobs::submit(saveImageJob, image, 1, &s_saveImageCounter);
+		return nullptr;
+	}
+
+	// Read the compressed game state that follows the header.
+	bool loadCompressedState(Stream* stream, const char* fileName)
+	{
+		u32 stateSize, compressedSize;
+		stream->read(&stateSize);
+		stream->read(&compressedSize);
+		if (!stateSize || !compressedSize || compressedSize > stream->getSize())
+		{
+			TFE_System::logWrite(LOG_ERROR, "Save", "Save game '%s' is corrupt.", fileName);
+			return false;
+		}
+
+		s_compressBuffer.resize(compressedSize);
+		mz_ulong size = stateSize;
+		if (stream->readBuffer(s_compressBuffer.data(), compressedSize) != compressedSize || !s_loadState.allocate(stateSize) ||
+			mz_uncompress((u8*)s_loadState.data(), &size, s_compressBuffer.data(), compressedSize) != MZ_OK || size != stateSize)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Save", "Cannot decompress save game '%s'.", fileName);
+			return false;
+		}
+		return true;
 	}
 
 	void populateSaveDirectory(std::vector<SaveHeader>& dir)
 	{
+		waitForSave();
+		if (!s_saveIndexLoaded)
+		{
+			readSaveIndex();
+		}
+
+		std::unordered_map<std::string, size_t> indexMap;
+		for (size_t i = 0; i < s_saveIndex.size(); i++)
+		{
+			indexMap[s_saveIndex[i].fileName] = i;
+		}
+
 		dir.clear();
 		FileList fileList;
 		FileUtil::readDirectory(s_gameSavePath, "tfe", fileList);
 		size_t saveCount = fileList.size();
 		dir.resize(saveCount);
 
+		// Files that were removed also change the index.
+		bool indexChanged = saveCount != s_saveIndex.size();
 		const std::string* filenames = fileList.data();
 		SaveHeader* headers = dir.data();
 		for (size_t i = 0; i < saveCount; i++)
 		{
-			loadGameHeader(filenames[i].c_str(), &headers[i]);
+			char filePath[TFE_MAX_PATH];
+			sprintf(filePath, "%s%s", s_gameSavePath, filenames[i].c_str());
+			const u64 modifiedTime = FileUtil::getModifiedTime(filePath);
+
+			std::unordered_map<std::string, size_t>::const_iterator iEntry = indexMap.find(filenames[i]);
+			if (iEntry != indexMap.end() && s_saveIndex[iEntry->second].modifiedTime == modifiedTime)
+			{
+				headers[i] = s_saveIndex[iEntry->second];
+			}
+			else
+			{
+				loadGameHeader(filenames[i].c_str(), &headers[i]);
+				indexChanged = true;
+			}
+		}
+
+		s_saveIndex = dir;
+		if (indexChanged)
+		{
+			writeSaveIndex();
 		}
 	}
 
 	void init()
 	{
+		CVAR_INT(s_snapshotCount, "snapshotCount", CVFLAG_NONE, "Number of in-memory game state snapshots kept for rewind, 0 disables them.");
+		CVAR_FLOAT(s_snapshotInterval, "snapshotInterval", CVFLAG_NONE, "Seconds of gameplay between rewind snapshots.");
+		CCMD("rewind", console_rewind, 0, "Rewind the game to a recent snapshot - rewind seconds");
 	}
 
 	void destroy()
 	{
-		for (s32 i = 0; i < 2; i++)
-		{
-			free(s_imageBuffer[i]);
-			s_imageBufferSize[i] = 0;
-			s_imageBuffer[i] = nullptr;
-		}
+		waitForSave();
+		clearSnapshots();
+		clearSaveIndex();
+		free(s_imageBuffer);
+		s_imageBufferSize = 0;
+		s_imageBuffer = nullptr;
 	}
 
 	bool saveGame(const char* filename, const char* saveName)
 	{
-		char filePath[TFE_MAX_PATH];
-		sprintf(filePath, "%s%s", s_gameSavePath, filename);
+		// Only one save is written at a time.
+		waitForSave();
 
-		bool ret = false;
-		FileStream stream;
-		if (stream.open(filePath, Stream::MODE_WRITE))
+		SaveJob* job = &s_saveJob;
+		sprintf(job->filePath, "%s%s", s_gameSavePath, filename);
+		prepareHeader(job, saveName);
+
+		s_saveState.clear();
+		s_saveState.open(Stream::MODE_WRITE);
+		const bool ret = s_game->serializeGameState(&s_saveState, filename, true);
+		s_saveState.close();
+
+		if (ret)
 		{
-			saveHeader(&stream, saveName);
-			ret = s_game->serializeGameState(&stream, filename, true);
-			stream.close();
+			// Force the header to be read again, in case the modified time does not change.
+			for (size_t i = 0; i < s_saveIndex.size(); i++)
+			{
+				if (!strcasecmp(s_saveIndex[i].fileName, filename))
+				{
+					s_saveIndex[i].modifiedTime = 0;
+				}
+			}
+			// And the thumbnails to be decoded again.
+			s_saveGeneration++;
+			if (!strcasecmp(filename, c_quickSaveName))
+			{
+				s_quickStateValid = s_quickState.load(s_saveState.getSize(), s_saveState.data());
+			}
+			TFE_Jobs::submit(saveJob, job, 1, &s_saveJobCounter);
 		}
 		return ret;
 	}
 
 	bool loadGame(const char* filename)
 	{
+		waitForSave();
+
+		// Rewind loads the snapshot restored by console_rewind() and keeps the older snapshots.
+		if (!strcasecmp(filename, c_rewindName) && s_rewindPending)
+		{
+			s_rewindPending = false;
+			MemoryStream* head = &s_snapshotState[s_snapshotHead];
+			head->open(Stream::MODE_READ);
+			const bool ret = s_game->serializeGameState(head, nullptr, false);
+			head->close();
+			return ret;
+		}
+		clearSnapshots();
+
+		// The last quicksave is still in memory, skip reading and parsing the file.
+		if (s_quickStateValid && !strcasecmp(filename, c_quickSaveName))
+		{
+			s_quickState.open(Stream::MODE_READ);
+			const bool ret = s_game->serializeGameState(&s_quickState, filename, false);
+			s_quickState.close();
+			return ret;
+		}
+
 		char filePath[TFE_MAX_PATH];
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
 
@@ -212,8 +835,20 @@ namespace TFE_SaveSystem
 		if (stream.open(filePath, Stream::MODE_READ))
 		{
 			SaveHeader header;
-			loadHeader(&stream, &header, filename);
-			ret = s_game->serializeGameState(&stream, filename, false);
+			const u32 version = loadHeader(&stream, &header, filename);
+			if (version >= SVER_COMPRESSED)
+			{
+				if (loadCompressedState(&stream, filename))
+				{
+					s_loadState.open(Stream::MODE_READ);
+					ret = s_game->serializeGameState(&s_loadState, filename, false);
+					s_loadState.close();
+				}
+			}
+			else
+			{
+				ret = s_game->serializeGameState(&stream, filename, false);
+			}
 			stream.close();
 		}
 		return ret;
@@ -221,6 +856,8 @@ namespace TFE_SaveSystem
 
 	bool loadGameHeader(const char* filename, SaveHeader* header)
 	{
+		waitForSave();
+
 		char filePath[TFE_MAX_PATH];
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
 
@@ -231,6 +868,7 @@ namespace TFE_SaveSystem
 			loadHeader(&stream, header, filename);
 			strcpy(header->fileName, filename);
 			stream.close();
+			header->modifiedTime = FileUtil::getModifiedTime(filePath);
 			ret = true;
 		}
 		return ret;
@@ -285,6 +923,14 @@ namespace TFE_SaveSystem
 
 	void setCurrentGame(GameID id)
 	{
+		// Snapshots are only valid for the game that captured them.
+		if (id != s_snapshotGameId)
+		{
+			clearSnapshots();
+			s_quickStateValid = false;
+			s_snapshotGameId = id;
+		}
+
 		char relativeBasePath[TFE_MAX_PATH];
 		TFE_Paths::appendPath(PATH_USER_DOCUMENTS, "Saves/", relativeBasePath);
 		if (!FileUtil::directoryExits(s_gameSavePath))
@@ -295,7 +941,13 @@ namespace TFE_SaveSystem
 		char relativePath[TFE_MAX_PATH];
 		sprintf(relativePath, "Saves/%s/", TFE_Settings::c_gameName[id]);
 
+		char prevSavePath[TFE_MAX_PATH];
+		strcpy(prevSavePath, s_gameSavePath);
 		TFE_Paths::appendPath(PATH_USER_DOCUMENTS, relativePath, s_gameSavePath);
+		if (strcmp(prevSavePath, s_gameSavePath) != 0)
+		{
+			clearSaveIndex();
+		}
 		if (!FileUtil::directoryExits(s_gameSavePath))
 		{
 			FileUtil::makeDirectory(s_gameSavePath);
@@ -305,6 +957,11 @@ namespace TFE_SaveSystem
 	void setCurrentGame(IGame* game)
 	{
 		s_game = game;
+		// A new game does not continue the previous session, unless it is being created for a rewind.
+		if (!s_rewindPending)
+		{
+			clearSnapshots();
+		}
 		setCurrentGame(game->id);
 	}
 
@@ -335,5 +992,21 @@ namespace TFE_SaveSystem
 		{
 			lastState = 0;
 		}
+
+		// Capture rewind snapshots while the mission is running, and drop them once it ends
+		// so a rewind cannot return to a previous mission.
+		if (!s_game->canSave())
+		{
+			if (s_snapshotHead >= 0 && !s_rewindPending) { clearSnapshots(); }
+		}
+		else if (s_snapshotCount > 0 && !s_game->isPaused() && !s_rewindPending)
+		{
+			s_snapshotClock += TFE_System::getDeltaTime();
+			if (s_snapshotClock >= s_snapshotNextTime)
+			{
+				captureSnapshot();
+				s_snapshotNextTime = s_snapshotClock + std::max(s_snapshotInterval, 0.1f);
+			}
+		}
 	}
 }
\ No newline at end of file
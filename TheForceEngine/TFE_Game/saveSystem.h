@@ -13,6 +13,7 @@ namespace TFE_SaveSystem
 		SAVE_MAX_NAME_LEN = 64,
 		SAVE_IMAGE_WIDTH  = 426,
 		SAVE_IMAGE_HEIGHT = 240,
+		SAVE_IMAGE_CACHE_SIZE = 8,
 	};
 	struct SaveHeader
 	{
@@ -21,7 +22,10 @@ namespace TFE_SaveSystem
 		char dateTime[256];
 		char levelName[256];
 		char modNames[256];
-		u32  imageData[SAVE_IMAGE_WIDTH * SAVE_IMAGE_HEIGHT];
+		// Used to validate the save index and to find the thumbnail PNG within the file.
+		u64  modifiedTime;
+		u32  imageOffset;
+		u32  imageSize;
 	};
 
 	void init();
@@ -32,8 +36,11 @@ namespace TFE_SaveSystem
 	void update();
 	bool saveGame(const char* filename, const char* saveName);
 	bool loadGame(const char* filename);
-	// Load only the header for UI.
+	// Load only the header for UI, the thumbnail is not decoded.
 	bool loadGameHeader(const char* filename, SaveHeader* header);
+	// Returns the decoded thumbnail (SAVE_IMAGE_WIDTH x SAVE_IMAGE_HEIGHT) if it is cached, otherwise
+	// the image is decoded in the background and nullptr is returned; call again on a later frame.
+	const u32* getSaveImage(const SaveHeader* header);
 
 	void postLoadRequest(const char* filename);
 	void postSaveRequest(const char* filename, const char* saveName, s32 delay = 0);
@@ -42,5 +49,6 @@ namespace TFE_SaveSystem
 
 	void getSaveFilenameFromIndex(s32 index, char* name);
 
+	// Headers come from the save index, only new or modified saves are read.
 	void populateSaveDirectory(std::vector<SaveHeader>& dir);
 }
\ No newline at end of file
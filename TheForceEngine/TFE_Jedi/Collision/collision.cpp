@@ -4,6 +4,7 @@
 #include <TFE_Jedi/Level/rwall.h>
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Level/rtexture.h>
+#include <TFE_Jedi/Level/sectorGrid.h>
 #include <TFE_Jedi/Math/core_math.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 // Merge player collision into collision
@@ -450,29 +451,25 @@ namespace TFE_Jedi
 		fixed16_16 z1 = origin.z + radius;
 
 		fixed16_16 secHeightThreshold = origin.y - COL_SEC_HEIGHT_OFFSET;
-		RSector* curSector = s_levelState.sectors;
 
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, curSector++)
+		// TFE: These tests only depend on the start sector, so they are done once instead of for every sector.
+		if (x0 > sector->boundsMax.x || x1 < sector->boundsMin.x || z0 > sector->boundsMax.z || z1 < sector->boundsMin.z)
 		{
-			///////////////////////////////////////////////
-			// These tests should only happen once I think,
-			// unless x0, x1, z0, z1 change over time.
-			///////////////////////////////////////////////
-			if (x0 > sector->boundsMax.x || x1 < sector->boundsMin.x || z0 > sector->boundsMax.z || z1 < sector->boundsMin.z)
-			{
-				continue;
-			}
-
-			fixed16_16 floorHeight, ceilHeight;
-			sector_calculateFloor(sector, origin.y, &floorHeight, &ceilHeight);
-			if (floorHeight < y0 || ceilHeight > y1)
-			{
-				continue;
-			}
-			/////////////////////////////////////////////
-			// End of checks to pull out of the loop.
-			/////////////////////////////////////////////
+			return JFALSE;
+		}
+		fixed16_16 floorHeight, ceilHeight;
+		sector_calculateFloor(sector, origin.y, &floorHeight, &ceilHeight);
+		if (floorHeight < y0 || ceilHeight > y1)
+		{
+			return JFALSE;
+		}
 
+		// TFE: Only visit the sectors that may hold objects in range.
+		JBool objInRange = JFALSE;
+		SectorQuery query = sectorGrid_query(x0, z0, x1, z1);
+		for (u32 i = 0; i < query.count && !objInRange; i++)
+		{
+			RSector* curSector = sectorGrid_getList(query)[i];
 			s32 objCapacity = curSector->objectCapacity;
 			s32 objCount = curSector->objectCount;
 			for (s32 objListIndex = 0, objIndex = 0; objIndex < objCount && objListIndex < objCapacity; objListIndex++)
@@ -505,11 +502,13 @@ namespace TFE_Jedi
 
 				if (curSector == obj->sector)
 				{
-					return JTRUE;
+					objInRange = JTRUE;
+					break;
 				}
 			}
 		}
-		return JFALSE;
+		sectorGrid_endQuery(query);
+		return objInRange;
 	}
 		
 	// Call the effectFunc() for each object within 'range' of point (x,y,z). This will only be called for objects in range and that have a valid collision path.
@@ -525,19 +524,22 @@ namespace TFE_Jedi
 		const fixed16_16 z1 = origin.z + range;
 
 		const fixed16_16 secHeightThreshold = origin.y - COL_SEC_HEIGHT_OFFSET;
-		RSector* sector = s_levelState.sectors;
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+
+		// TFE: Checks the start sector, so it is done once instead of for every sector.
+		if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
 		{
-			// Checks the start sector, should be pulled out of the loop.
-			if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
-			{
-				continue;
-			}
+			return;
+		}
 
+		// TFE: Only visit the sectors that may hold objects in range.
+		// The list is fetched for each sector since the effect function may run its own queries.
+		SectorQuery query = sectorGrid_query(x0, z0, x1, z1);
+		for (u32 i = 0; i < query.count; i++)
+		{
+			RSector* sector = sectorGrid_getList(query)[i];
 			fixed16_16 floor, ceil;
 			sector_calculateFloor(sector, origin.y, &floor, &ceil);
 			if (y0 > floor || y1 < ceil) { continue; }
-			// End of start sector check.
 
 			for (s32 objIndex = 0, objListIndex = 0; objIndex < sector->objectCount && objListIndex < sector->objectCapacity; objListIndex++)
 			{
@@ -565,6 +567,7 @@ namespace TFE_Jedi
 				}
 			}  // Object Loop.
 		}  // Sector loop.
+		sectorGrid_endQuery(query);
 	}
 
 	// Call the effectFunc() for each object within 'range' of point (x,y,z). This will only be called for objects in range and that have a valid collision path.
@@ -585,21 +588,25 @@ namespace TFE_Jedi
 		const fixed16_16 z1 = origin.z + range;
 
 		const fixed16_16 secHeightThreshold = origin.y - COL_SEC_HEIGHT_OFFSET;
-		RSector* sector = s_levelState.sectors;
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+
+		// TFE: Checks the start sector, so it is done once instead of for every sector.
+		if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
 		{
-			// Checks the start sector, should be pulled out of the loop.
-			if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
-			{
-				continue;
-			}
-			fixed16_16 floor, ceil;
-			sector_calculateFloor(startSector, origin.y, &floor, &ceil);
-			if (y0 > floor || y1 < ceil)
-			{
-				continue;
-			}
-			// End of start sector check.
+			return;
+		}
+		fixed16_16 floor, ceil;
+		sector_calculateFloor(startSector, origin.y, &floor, &ceil);
+		if (y0 > floor || y1 < ceil)
+		{
+			return;
+		}
+
+		// TFE: Only visit the sectors that may hold objects in range.
+		// The list is fetched for each sector since the effect function may run its own queries.
+		SectorQuery query = sectorGrid_query(x0, z0, x1, z1);
+		for (u32 i = 0; i < query.count; i++)
+		{
+			RSector* sector = sectorGrid_getList(query)[i];
 
 			for (s32 objIndex = 0, objListIndex = 0; objIndex < sector->objectCount && objListIndex < sector->objectCapacity; objListIndex++)
 			{
@@ -649,6 +656,7 @@ namespace TFE_Jedi
 				}
 			}  // Object Loop.
 		}  // Sector Loop.
+		sectorGrid_endQuery(query);
 	}
 		
 	static RSector*   s_hcolSector;
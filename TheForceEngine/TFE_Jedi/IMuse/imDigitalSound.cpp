@@ -10,10 +10,22 @@
 #include <TFE_Audio/audioSystem.h>
 #include <cassert>
 #include <cstring>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define DIGITAL_SOUND_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define DIGITAL_SOUND_SSE2 0
+#endif
 
 namespace TFE_Jedi
 {
-	#define MAX_SOUND_CHANNELS 16
+	// TFE: The DOS limit was 16 mixed channels.
+	#define MAX_SOUND_CHANNELS 32
+	// TFE: Sounds beyond the mixed channel count play as virtual voices - they advance and fire triggers
+	// but are not mixed until a higher priority sound finishes.
+	#define MAX_SOUND_VOICES 64
 	#define DEFAULT_SOUND_CHANNELS 8
 	#define AUDIO_BUFFER_SIZE 512
 	
@@ -44,6 +56,8 @@ namespace TFE_Jedi
 
 		s32 detuneTrans;
 		s32 mailbox;
+		// TFE
+		JBool audible;
 	};
 
 	struct ImWaveData
@@ -61,23 +75,23 @@ namespace TFE_Jedi
 	atomic_s32 s_digitalPause;
 
 	static ImWaveSound* s_imWaveSoundList = nullptr;
-	static ImWaveSound  s_imWaveSound[MAX_SOUND_CHANNELS];
-	static ImWaveData   s_imWaveData[MAX_SOUND_CHANNELS];
+	static ImWaveSound  s_imWaveSound[MAX_SOUND_VOICES];
+	static ImWaveData   s_imWaveData[MAX_SOUND_VOICES];
+	static ImWaveSound* s_imWaveMixList[MAX_SOUND_VOICES];
 	static u8  s_imWaveChunkData[48];
 	static s32 s_imWaveMixCount = DEFAULT_SOUND_CHANNELS;
 	static s32 s_imWaveNanosecsPerSample;
 	static iMuseInitData* s_imDigitalData;
 
-	// In DOS these are 8-bit outputs since that is what the driver is accepting.
-	// For TFE, floating-point audio output is used, so these convert to floating-point.
-	static f32  s_audioNormalizationMem[MAX_SOUND_CHANNELS * 256 + 4];
-	// Normalizes the sum of all audio playback (16-bit) to a [-1,1) floating point value.
-	// The mapping can be addressed with negative values (i.e. s_audioNormalization[-16]), which is why
-	// it is built this way.
-	static f32* s_audioNormalization = &s_audioNormalizationMem[MAX_SOUND_CHANNELS * 128 + 4];
+	// In DOS the sum of all channels is normalized to 8-bit output using a table built from the channel count.
+	// TFE mixes in floating point and evaluates the same curve directly:
+	//   out = sum * scale / (bias + slope * |sum|)
+	static f32 s_audioNormalizeScale;
+	static f32 s_audioNormalizeBias;
+	static f32 s_audioNormalizeSlope;
 
 	static f32* s_audioDriverOut;
-	static s16 s_audioOut[AUDIO_BUFFER_SIZE + IM_AUDIO_OVERSAMPLE*2];	// Add 2 stereo samples from the next frame for interpolation.
+	static f32 s_audioOut[AUDIO_BUFFER_SIZE + IM_AUDIO_OVERSAMPLE*2];	// Add 2 stereo samples from the next frame for interpolation.
 	static s32 s_audioOutSize;
 	static u8* s_audioData;
 			
@@ -87,13 +101,14 @@ namespace TFE_Jedi
 
 	ImWaveData* ImGetWaveData(s32 index);
 	void ImFreeWaveSound(ImWaveSound* sound);
+	void ImSelectAudibleVoices(s32 voiceCount);
 	s32 ImComputeAudioNormalizationInit(iMuseInitData* initData);
 	s32 ImComputeAudioNormalization(s32 waveMixCount);
 	s32 ImSetWaveParamInternal(ImSoundId soundId, s32 param, s32 value);
 	s32 ImGetWaveParamIntern(ImSoundId soundId, s32 param);
 	s32 ImFreeWaveSoundByIdIntern(ImSoundId soundId);
 	s32 ImStartDigitalSoundIntern(ImSoundId soundId, s32 priority, s32 chunkIndex);
-	s32 audioPlaySoundFrame(ImWaveSound* sound);
+	s32 audioPlaySoundFrame(ImWaveSound* sound, JBool audible);
 	s32 audioWriteToDriver(f32 systemVolume);
 		
 	/////////////////////////////////////////////////////////// 
@@ -102,7 +117,7 @@ namespace TFE_Jedi
 	s32 ImInitializeDigitalAudio(iMuseInitData* initData)
 	{
 		IM_DBG_MSG("TRACKS module...");
-		if (initData->waveMixCount <= 0 || initData->waveMixCount > 16)
+		if (initData->waveMixCount <= 0 || initData->waveMixCount > MAX_SOUND_CHANNELS)
 		{
 			IM_LOG_ERR("%s", "TR: waveMixCount NULL or too big, defaulting to 4...");
 			initData->waveMixCount = 4;
@@ -125,7 +140,7 @@ namespace TFE_Jedi
 		}
 
 		ImWaveSound* sound = s_imWaveSound;
-		for (s32 i = 0; i < s_imWaveMixCount; i++, sound++)
+		for (s32 i = 0; i < MAX_SOUND_VOICES; i++, sound++)
 		{
 			sound->prev = nullptr;
 			sound->next = nullptr;
@@ -159,7 +174,7 @@ namespace TFE_Jedi
 		{
 			s_imWaveMixCount = count;
 			ImWaveSound* sound = s_imWaveSound;
-			for (s32 i = 0; i < s_imWaveMixCount; i++, sound++)
+			for (s32 i = 0; i < MAX_SOUND_VOICES; i++, sound++)
 			{
 				sound->prev = nullptr;
 				sound->next = nullptr;
@@ -196,15 +211,21 @@ namespace TFE_Jedi
 		s_audioDriverOut = buffer;
 		s_audioOutSize = bufferSize;
 		assert(bufferSize * 2 <= AUDIO_BUFFER_SIZE);
-		memset(s_audioOut, 0, 2*(bufferSize + IM_AUDIO_OVERSAMPLE) * sizeof(s16));
+		memset(s_audioOut, 0, 2*(bufferSize + IM_AUDIO_OVERSAMPLE) * sizeof(f32));
+
+		// Snapshot the list since sounds are freed as they finish.
+		s32 voiceCount = 0;
+		for (ImWaveSound* sound = s_imWaveSoundList; sound; sound = sound->next)
+		{
+			s_imWaveMixList[voiceCount++] = sound;
+		}
+		ImSelectAudibleVoices(voiceCount);
 
 		// Write sounds to s_audioOut.
-		ImWaveSound* sound = s_imWaveSoundList;
-		while (sound)
+		for (s32 i = 0; i < voiceCount; i++)
 		{
-			ImWaveSound* next = sound->next;
-			audioPlaySoundFrame(sound);
-			sound = next;
+			ImWaveSound* sound = s_imWaveMixList[i];
+			audioPlaySoundFrame(sound, sound->audible);
 		}
 
 		// Convert s_audioOut to "driver" buffer.
@@ -228,24 +249,48 @@ namespace TFE_Jedi
 	////////////////////////////////////
 	ImWaveData* ImGetWaveData(s32 index)
 	{
-		assert(index < MAX_SOUND_CHANNELS);
+		assert(index < MAX_SOUND_VOICES);
 		return &s_imWaveData[index];
 	}
 
-	s32 ImComputeAudioNormalization(s32 waveMixCount)
+	// TFE: When there are more sounds than mixed channels, only the highest priority sounds are audible.
+	// Ties go to the newest sound, matching the DOS behavior of a new sound replacing an equal priority one.
+	void ImSelectAudibleVoices(s32 voiceCount)
 	{
-		s32 volumeMidPoint = 128;
-		s32 tableSize = waveMixCount << 7;
-		for (s32 i = 0; i < tableSize; i++)
+		if (voiceCount <= s_imWaveMixCount)
 		{
-			// Results for count ~= 8: (i=0) 0.0, 1.5, 2.5, 3.4, 4.4, 5.2, 6.3, 7.2, ... 127.1 (i = 1023).
-			s32 volumeOffset = ((waveMixCount * 127 * i) << 8) / (waveMixCount * 127 + (waveMixCount - 1)*i) + 128;
-			volumeOffset >>= 8;
+			for (s32 i = 0; i < voiceCount; i++)
+			{
+				s_imWaveMixList[i]->audible = JTRUE;
+			}
+			return;
+		}
 
-			// These values are 8-bit in DOS, but converted to floating point for TFE.
-			s_audioNormalization[i] = f32(volumeMidPoint + volumeOffset) / 128.0f - 1.0f;
-			s_audioNormalization[-i - 1] = f32(volumeMidPoint - volumeOffset - 1) / 128.0f - 1.0f;
+		// The list is ordered newest first, so a voice ranks below every earlier voice with the same priority.
+		for (s32 i = 0; i < voiceCount; i++)
+		{
+			const s32 priority = s_imWaveMixList[i]->priority;
+			s32 rank = 0;
+			for (s32 j = 0; j < voiceCount && rank < s_imWaveMixCount; j++)
+			{
+				const s32 otherPriority = s_imWaveMixList[j]->priority;
+				if (otherPriority > priority || (otherPriority == priority && j < i))
+				{
+					rank++;
+				}
+			}
+			s_imWaveMixList[i]->audible = rank < s_imWaveMixCount ? JTRUE : JFALSE;
 		}
+	}
+
+	s32 ImComputeAudioNormalization(s32 waveMixCount)
+	{
+		// DOS table: offset(i) = (waveMixCount * 127 * i) / (waveMixCount * 127 + (waveMixCount - 1) * i)
+		// Results for count ~= 8: (i=0) 0.0, 1.5, 2.5, 3.4, 4.4, 5.2, 6.3, 7.2, ... 127.1 (i = 1023).
+		// The 8-bit output is then offset / 128.
+		s_audioNormalizeScale = f32(waveMixCount * 127) / 128.0f;
+		s_audioNormalizeBias  = f32(waveMixCount * 127);
+		s_audioNormalizeSlope = f32(waveMixCount - 1);
 		return imSuccess;
 	}
 
@@ -400,7 +445,7 @@ namespace TFE_Jedi
 	{
 		ImWaveSound* sound = s_imWaveSound;
 		ImWaveSound* newSound = nullptr;
-		for (s32 i = 0; i < s_imWaveMixCount; i++, sound++)
+		for (s32 i = 0; i < MAX_SOUND_VOICES; i++, sound++)
 		{
 			if (!sound->soundId)
 			{
@@ -601,6 +646,7 @@ namespace TFE_Jedi
 		sound->transpose = 0;
 		sound->detuneTrans = 0;
 		sound->mailbox = 0;
+		sound->audible = JFALSE;
 		if (ImWaveSetupSoundData(sound, chunkIndex) != imSuccess)
 		{
 			IM_LOG_ERR("Failed to setup wave player data - soundId: 0x%x, priority: %d", soundId, priority);
@@ -665,15 +711,35 @@ namespace TFE_Jedi
 		return nextSoundId;
 	}
 	
-	// leftMapping:  map left channel samples to final values based on volume and pan.
-	// rightMapping: map right channel samples to final values based on volume and pan.
-	void digitalAudioOutput_Stereo(s16* audioOut, const u8* sndData, const s8* leftMapping, const s8* rightMapping, s32 size)
+	// leftGain:  scale applied to the left channel based on volume and pan.
+	// rightGain: scale applied to the right channel based on volume and pan.
+	void digitalAudioOutput_Stereo(f32* audioOut, const u8* sndData, f32 leftGain, f32 rightGain, s32 size)
 	{
-		for (s32 i = 0; i < size; i++, sndData++, audioOut+=2)
+		s32 i = 0;
+	#if DIGITAL_SOUND_SSE2
+		// 4 unsigned 8-bit samples -> 4 stereo output samples per iteration.
+		const __m128 gain = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i bias = _mm_set1_epi32(128);
+		for (; i + 4 <= size; i += 4, sndData += 4, audioOut += 8)
 		{
-			const u8 sample = *sndData;
-			audioOut[0] += (s16)leftMapping[sample];
-			audioOut[1] += (s16)rightMapping[sample];
+			s32 packed;
+			memcpy(&packed, sndData, 4);
+			__m128i samples = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero);
+			samples = _mm_sub_epi32(_mm_unpacklo_epi16(samples, zero), bias);
+			const __m128 value = _mm_cvtepi32_ps(samples);
+
+			const __m128 out01 = _mm_mul_ps(_mm_unpacklo_ps(value, value), gain);
+			const __m128 out23 = _mm_mul_ps(_mm_unpackhi_ps(value, value), gain);
+			_mm_storeu_ps(audioOut,     _mm_add_ps(_mm_loadu_ps(audioOut),     out01));
+			_mm_storeu_ps(audioOut + 4, _mm_add_ps(_mm_loadu_ps(audioOut + 4), out23));
+		}
+	#endif
+		for (; i < size; i++, sndData++, audioOut+=2)
+		{
+			const f32 sample = f32(s32(*sndData) - 128);
+			audioOut[0] += sample * leftGain;
+			audioOut[1] += sample * rightGain;
 		}
 	}
 
@@ -698,14 +764,20 @@ namespace TFE_Jedi
 		// Calculate where the in panVolume mapping channel to read from for each channel.
 		s32 leftVolume  = s_audioPanVolumeTable[8 - panTop + vTop*17];
 		s32 rightVolume = s_audioPanVolumeTable[8 + panTop + vTop*17];
-		// Map [0,255] sample values to signed output values based on volume.
-		const s8* leftMapping  = (s8*)&s_audioVolumeToSignedMapping[leftVolume  << 8];
-		const s8* rightMapping = (s8*)&s_audioVolumeToSignedMapping[rightVolume << 8];
+		if (!leftVolume && !rightVolume)
+		{
+			return;
+		}
+		// DOS maps [0,255] sample values to signed output values using a lookup table,
+		// which is (sample - 128) * volume / 16.
+		const f32 leftGain  = f32(leftVolume)  * (1.0f / 16.0f);
+		const f32 rightGain = f32(rightVolume) * (1.0f / 16.0f);
 
-		digitalAudioOutput_Stereo(&s_audioOut[outOffset * 2], audioFrame, leftMapping, rightMapping, size);
+		digitalAudioOutput_Stereo(&s_audioOut[outOffset * 2], audioFrame, leftGain, rightGain, size);
 	}
 
-	s32 audioPlaySoundFrame(ImWaveSound* sound)
+	// TFE: Virtual voices (audible = JFALSE) advance through the sound data without being mixed.
+	s32 audioPlaySoundFrame(ImWaveSound* sound, JBool audible)
 	{
 		ImWaveData* data = sound->data;
 		s32 bufferSize = s_audioOutSize;
@@ -731,8 +803,11 @@ namespace TFE_Jedi
 			// This is required since the results might be interpolated on upsample.
 			const s32 baseReadSize = min(bufferSize, data->chunkSize);
 			const s32 readSize = min(bufferSize+IM_AUDIO_OVERSAMPLE, data->chunkSize);
-			s_audioData = ImInternalGetSoundData(sound->soundId) + data->offset;
-			audioProcessFrame(s_audioData, readSize, offset, sound->volume, sound->pan);
+			if (audible)
+			{
+				s_audioData = ImInternalGetSoundData(sound->soundId) + data->offset;
+				audioProcessFrame(s_audioData, readSize, offset, sound->volume, sound->pan);
+			}
 
 			offset += baseReadSize;
 			bufferSize -= baseReadSize;
@@ -750,11 +825,34 @@ namespace TFE_Jedi
 		}
 
 		s32 bufferSize = 2*(s_audioOutSize + IM_AUDIO_OVERSAMPLE);
-		s16* audioOut  = s_audioOut;
+		const f32* audioOut = s_audioOut;
 		f32* driverOut = s_audioDriverOut;
-		for (s32 i = 0; i < bufferSize; i++, audioOut++, driverOut++)
+		if (s_imWaveMixCount < 1)
+		{
+			memset(driverOut, 0, sizeof(f32) * bufferSize);
+			return imSuccess;
+		}
+
+		const f32 scale = s_audioNormalizeScale * systemVolume;
+		const f32 bias  = s_audioNormalizeBias;
+		const f32 slope = s_audioNormalizeSlope;
+		s32 i = 0;
+	#if DIGITAL_SOUND_SSE2
+		const __m128 scale4 = _mm_set1_ps(scale);
+		const __m128 bias4  = _mm_set1_ps(bias);
+		const __m128 slope4 = _mm_set1_ps(slope);
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		for (; i + 4 <= bufferSize; i += 4)
+		{
+			const __m128 sum = _mm_loadu_ps(audioOut + i);
+			const __m128 denom = _mm_add_ps(bias4, _mm_mul_ps(slope4, _mm_andnot_ps(signMask, sum)));
+			_mm_storeu_ps(driverOut + i, _mm_div_ps(_mm_mul_ps(sum, scale4), denom));
+		}
+	#endif
+		for (; i < bufferSize; i++)
 		{
-			*driverOut = s_audioNormalization[*audioOut] * systemVolume;
+			const f32 sum = audioOut[i];
+			driverOut[i] = sum * scale / (bias + slope * fabsf(sum));
 		}
 		return imSuccess;
 	}
@@ -35,7 +35,7 @@ struct iMuseInitData
 {
 	u32 systemTime = 0;						// iMuse 60Hz timer clock
 	ImWaveSpeed waveSpeed = IM_WAVE_11kHz;  // 0 = 11KHz, 1 = 22KHz
-	s32 waveMixCount = 8;					// set 0 to 16 mixer channels
+	s32 waveMixCount = 8;					// set 0 to 32 mixer channels
 	u32 imuseIntUsecCount = 6944;			// iMuse interrupt freq
 };
 
@@ -41,6 +41,7 @@ namespace TFE_Jedi
 	{
 		s_infSerState = { 0 };
 		s_infState = { 0 };
+		inf_resetElevatorSchedule();
 	}
 
 	void inf_serializeElevator(Stream* stream, InfElevator* elev)
@@ -530,6 +531,7 @@ namespace TFE_Jedi
 					return;
 				inf_serializeElevator(stream, elev);
 			}
+			inf_resetElevatorSchedule();
 		}
 
 		// Teleports
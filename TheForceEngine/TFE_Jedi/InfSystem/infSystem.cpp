@@ -1,4 +1,7 @@
 #include <cstring>
+#include <algorithm>
+#include <set>
+#include <vector>
 
 #include "infSystem.h"
 #include "infState.h"
@@ -13,6 +16,7 @@
 #include <TFE_FileSystem/paths.h>
 #include <TFE_Jedi/Memory/allocator.h>
 #include <TFE_Jedi/Level/level.h>
+#include <TFE_Jedi/Level/levelCache.h>
 #include <TFE_Jedi/Level/levelData.h>
 #include <TFE_Jedi/Collision/collision.h>
 #include <TFE_Settings/settings.h>
@@ -57,17 +61,40 @@ namespace TFE_Jedi
 	SoundSourceId s_switchDefaultSndId = NULL_SOUND;
 
 	// Temporary state that does not need to be cleared or serialized.
+	enum { INF_ARG_LEN = 256, INF_MAX_ARGS = 7 };
 	static std::vector<char> s_buffer;
-	static char s_infArg0[256];
-	static char s_infArg1[256];
-	static char s_infArg2[256];
-	static char s_infArg3[256];
-	static char s_infArg4[256];
-	static char s_infArgExtra[256];
+	static char s_infArg0[INF_ARG_LEN];
+	static char s_infArg1[INF_ARG_LEN];
+	static char s_infArg2[INF_ARG_LEN];
+	static char s_infArg3[INF_ARG_LEN];
+	static char s_infArg4[INF_ARG_LEN];
+	static char s_infArgExtra[INF_ARG_LEN];
 
 	// DOS hack... this is required since elevators with an invalid delay use the previous valid delay.
 	static Tick s_prevStopDelay = 0;
 
+	/////////////////////////////////////////////////////
+	// Elevator Schedule
+	// TFE: Rather than visiting every elevator each tick, the elevator task only visits "awake" elevators that may be
+	// ready to run. Elevators waiting on a delay are moved to a timer heap keyed on nextTick, while elevators that are
+	// holding, turned off or deleted are dropped until a message wakes them. Awake elevators are visited in allocator
+	// order, so they run in the same order as walking the whole list.
+	/////////////////////////////////////////////////////
+	struct ElevatorTimer
+	{
+		Tick tick;
+		s32 index;
+	};
+
+	struct ElevatorTimerCmp
+	{
+		// std heaps are max heaps, so reverse the comparison to get the earliest tick on top.
+		bool operator()(const ElevatorTimer& a, const ElevatorTimer& b) const { return a.tick > b.tick; }
+	};
+
+	static std::set<s32> s_elevAwake;
+	static std::vector<ElevatorTimer> s_elevTimers;
+
 	// Forward Declarations.
 	void inf_elevatorTaskFunc(MessageType msg);
 	void inf_telelporterTaskFunc(MessageType msg);
@@ -99,6 +126,11 @@ namespace TFE_Jedi
 	void inf_elevatorTaskLocal(MessageType msg);
 	void inf_triggerTaskLocal(MessageType msg);
 
+	void inf_wakeElevator(InfElevator* elev);
+	void inf_wakeElevatorTimers();
+	InfElevator* inf_getNextAwakeElevator(s32* index);
+	JBool inf_elevatorSleeps(InfElevator* elev, s32 index);
+
 	/////////////////////////////////////////////////////
 	// API
 	/////////////////////////////////////////////////////
@@ -120,6 +152,24 @@ namespace TFE_Jedi
 	{
 		s_infSerState.infElevators = allocator_create(sizeof(InfElevator));
 		s_infState.infElevTask = createSubTask("elevator", inf_elevatorTaskFunc, inf_elevatorTaskLocal);
+		inf_resetElevatorSchedule();
+	}
+
+	// Rebuild the schedule from the elevator list, every elevator starts awake and is sorted out on the next update.
+	void inf_resetElevatorSchedule()
+	{
+		s_elevAwake.clear();
+		s_elevTimers.clear();
+
+		const s32 count = s_infSerState.infElevators ? allocator_getCount(s_infSerState.infElevators) : 0;
+		for (s32 i = 0; i < count; i++)
+		{
+			InfElevator* elev = (InfElevator*)allocator_getByIndex(s_infSerState.infElevators, i);
+			if (elev && !elev->deleted)
+			{
+				s_elevAwake.insert(i);
+			}
+		}
 	}
 
 	void inf_createTeleportTask()
@@ -196,7 +246,11 @@ namespace TFE_Jedi
 	{
 		if (!elev || !elev->stops)
 		{
-			if (elev) { elev->nextTick = s_curTick; }
+			if (elev)
+			{
+				elev->nextTick = s_curTick;
+				inf_wakeElevator(elev);
+			}
 			return;
 		}
 
@@ -236,6 +290,7 @@ namespace TFE_Jedi
 		{
 			elev->nextTick = s_curTick + next->delay;
 		}
+		inf_wakeElevator(elev);
 
 		// Setup the next stop.
 		elev->nextStop = inf_advanceStops(elev->stops, 0, 1);
@@ -269,6 +324,7 @@ namespace TFE_Jedi
 		elev->sound0 = NULL_SOUND;
 		elev->sound1 = NULL_SOUND;
 		elev->sound2 = NULL_SOUND;
+		inf_wakeElevator(elev);
 
 		switch (type)
 		{
@@ -737,6 +793,23 @@ namespace TFE_Jedi
 		teleport->dstAngle[2] = roll;
 	}
 	
+	// TFE: Reads the same strings and returns the same count as sscanf(line, " %s %s ..."), where each
+	// destination holds INF_ARG_LEN characters, using the parser's non-allocating tokenizer.
+	static s32 inf_readArgs(TFE_Parser& parser, const char* line, char* arg0, char* arg1, char* arg2, char* arg3, char* arg4,
+		                    char* arg5 = nullptr, char* arg6 = nullptr)
+	{
+		char* args[INF_MAX_ARGS] = { arg0, arg1, arg2, arg3, arg4, arg5, arg6 };
+		const s32 maxArgs = arg6 ? 7 : (arg5 ? 6 : 5);
+
+		TokenSpan tokens[INF_MAX_ARGS];
+		const s32 argCount = parser.tokenizeLine(line, tokens, maxArgs);
+		for (s32 i = 0; i < argCount; i++)
+		{
+			TFE_Token::copy(tokens[i], args[i], INF_ARG_LEN);
+		}
+		return argCount;
+	}
+
 	// Return true if "SEQEND" found.
 	bool parseElevator(TFE_Parser& parser, size_t& bufferPos, const char* itemName)
 	{
@@ -874,8 +947,8 @@ namespace TFE_Jedi
 				break;
 			}
 
-			char id[256];
-			s32 argCount = sscanf(line, " %s %s %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3, s_infArg4, s_infArgExtra);
+			char id[INF_ARG_LEN];
+			s32 argCount = inf_readArgs(parser, line, id, s_infArg0, s_infArg1, s_infArg2, s_infArg3, s_infArg4, s_infArgExtra);
 			KEYWORD action = getKeywordIndex(id);
 			if (action == KW_UNKNOWN)
 			{
@@ -917,8 +990,8 @@ namespace TFE_Jedi
 				break;
 			}
 			
-			char id[256];
-			argCount = sscanf(line, " %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
+			char id[INF_ARG_LEN];
+			argCount = inf_readArgs(parser, line, id, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
 			KEYWORD itemId = getKeywordIndex(id);
 			assert(itemId != KW_UNKNOWN);
 
@@ -1035,8 +1108,8 @@ namespace TFE_Jedi
 				break;
 			}
 
-			char name[256];
-			sscanf(line, " %s %s %s %s %s", name, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
+			char name[INF_ARG_LEN];
+			inf_readArgs(parser, line, name, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
 			KEYWORD kw = getKeywordIndex(name);
 
 			if (kw == KW_TARGET)
@@ -1132,8 +1205,8 @@ namespace TFE_Jedi
 				break;
 			}
 
-			char id[256];
-			argCount = sscanf(line, " %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
+			char id[INF_ARG_LEN];
+			argCount = inf_readArgs(parser, line, id, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
 			KEYWORD itemId = getKeywordIndex(id);
 			if (itemId == KW_UNKNOWN)
 			{
@@ -1236,17 +1309,18 @@ namespace TFE_Jedi
 			TFE_System::logWrite(LOG_ERROR, "level_loadINF", "Cannot open level INF '%s'.", levelPath);
 			return JFALSE;
 		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
+		size_t len;
+		const char* data = file.readView(s_buffer, &len);
 		file.close();
 
+		// TFE: Read the lines from the cache if this INF file was loaded before.
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), s_buffer.size());
 		parser.enableBlockComments();
 		parser.addCommentString("//");
 		parser.convertToUpperCase(true);
+		parser.enableWhitespaceOnlyTokens(true);
+		level_initCachedParser(parser, levelPath, data, len);
 
 		const char* line;
 		line = parser.readLine(bufferPos);
@@ -1334,8 +1408,8 @@ namespace TFE_Jedi
 					{
 						while (nullptr != (line = parser.readLine(bufferPos)))
 						{
-							char itemName[256];
-							s32 argCount = sscanf(line, " %s %s %s %s %s %s %s", itemName, s_infArg0, s_infArg1, s_infArg2, s_infArg3, s_infArgExtra, s_infArgExtra);
+							char itemName[INF_ARG_LEN];
+							s32 argCount = inf_readArgs(parser, line, itemName, s_infArg0, s_infArg1, s_infArg2, s_infArg3, s_infArgExtra, s_infArgExtra);
 							KEYWORD levelItem = getKeywordIndex(itemName);
 							switch (levelItem)
 							{
@@ -1368,8 +1442,8 @@ namespace TFE_Jedi
 							break;
 						}
 
-						char id[256];
-						s32 argCount = sscanf(line, " %s %s %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3, s_infArg4, s_infArgExtra);
+						char id[INF_ARG_LEN];
+						s32 argCount = inf_readArgs(parser, line, id, s_infArg0, s_infArg1, s_infArg2, s_infArg3, s_infArg4, s_infArgExtra);
 						KEYWORD itemClass = getKeywordIndex(s_infArg0);
 						assert(itemClass != KW_UNKNOWN);
 
@@ -1418,8 +1492,8 @@ namespace TFE_Jedi
 							break;
 						}
 
-						char id[256];
-						s32 argCount = sscanf(line, " %s %s %s %s %s", id, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
+						char id[INF_ARG_LEN];
+						s32 argCount = inf_readArgs(parser, line, id, s_infArg0, s_infArg1, s_infArg2, s_infArg3);
 						if (parseLineTrigger(parser, bufferPos, argCount, name, wallNum))
 						{
 							break;
@@ -1505,6 +1579,7 @@ namespace TFE_Jedi
 			InfElevator* elev;
 			Stop* nextStop;
 			s32 elevDeleted;
+			s32 elevIndex;
 
 		};
 		task_begin_ctx;
@@ -1517,12 +1592,15 @@ namespace TFE_Jedi
 			}
 			else  // id == MSG_RUN_TASK
 			{
-				taskCtx->elev = (InfElevator*)allocator_getHead(s_infSerState.infElevators);
+				// TFE: Only visit the awake elevators, see "Elevator Schedule" above.
+				inf_wakeElevatorTimers();
+				taskCtx->elevIndex = -1;
+				taskCtx->elev = inf_getNextAwakeElevator(&taskCtx->elevIndex);
 				while (taskCtx->elev)
 				{
-					if (taskCtx->elev->deleted)
+					if (inf_elevatorSleeps(taskCtx->elev, taskCtx->elevIndex))
 					{
-						taskCtx->elev = (InfElevator*)allocator_getNext(s_infSerState.infElevators);
+						taskCtx->elev = inf_getNextAwakeElevator(&taskCtx->elevIndex);
 						continue;
 					}
 
@@ -1613,7 +1691,7 @@ namespace TFE_Jedi
 					} // ((elev->updateFlags & ELEV_MASTER_ON) && elev->nextTick < s_curTick)
 
 					// Next elevator.
-					taskCtx->elev = (InfElevator*)allocator_getNext(s_infSerState.infElevators);
+					taskCtx->elev = inf_getNextAwakeElevator(&taskCtx->elevIndex);
 				} // while (elev)
 			}  // id == 0 (main elevator update loop)
 			task_yield(TASK_NO_DELAY);
@@ -1622,6 +1700,55 @@ namespace TFE_Jedi
 		task_end;
 	}
 		
+	void inf_wakeElevator(InfElevator* elev)
+	{
+		if (!elev || elev->deleted) { return; }
+		const s32 index = allocator_getIndex(s_infSerState.infElevators, elev);
+		if (index >= 0)
+		{
+			s_elevAwake.insert(index);
+		}
+	}
+
+	void inf_wakeElevatorTimers()
+	{
+		while (!s_elevTimers.empty() && s_elevTimers.front().tick < s_curTick)
+		{
+			// The elevator may have been woken up or rescheduled since, in which case this is a no-op.
+			s_elevAwake.insert(s_elevTimers.front().index);
+			std::pop_heap(s_elevTimers.begin(), s_elevTimers.end(), ElevatorTimerCmp());
+			s_elevTimers.pop_back();
+		}
+	}
+
+	// Returns the next awake elevator after 'index', elevators woken up during the update are picked up if they come later in the list.
+	InfElevator* inf_getNextAwakeElevator(s32* index)
+	{
+		std::set<s32>::iterator iElev = s_elevAwake.upper_bound(*index);
+		if (iElev == s_elevAwake.end())
+		{
+			return nullptr;
+		}
+		*index = *iElev;
+		return (InfElevator*)allocator_getByIndex(s_infSerState.infElevators, *index);
+	}
+
+	// Returns JTRUE and takes the elevator out of the awake set if it cannot run this tick.
+	JBool inf_elevatorSleeps(InfElevator* elev, s32 index)
+	{
+		if (!elev->deleted && (elev->updateFlags & ELEV_MASTER_ON) && elev->nextTick < s_curTick)
+		{
+			return JFALSE;
+		}
+		s_elevAwake.erase(index);
+		if (!elev->deleted && (elev->updateFlags & ELEV_MASTER_ON) && elev->nextTick != DELAY_SLEEP)
+		{
+			s_elevTimers.push_back({ elev->nextTick, index });
+			std::push_heap(s_elevTimers.begin(), s_elevTimers.end(), ElevatorTimerCmp());
+		}
+		return JTRUE;
+	}
+
 	void inf_teleporterTaskLocal(MessageType msg)
 	{
 		if (msg == MSG_TRIGGER && s_msgEvent == INF_EVENT_ENTER_SECTOR)
@@ -2786,6 +2913,8 @@ namespace TFE_Jedi
 			return;
 		}
 		infElevatorMessageInternal(msgType);
+		// Messages can start the elevator, turn the master on or change the next tick.
+		inf_wakeElevator((InfElevator*)s_msgTarget);
 	}
 		
 	void infTriggerMsgFunc(MessageType msgType)
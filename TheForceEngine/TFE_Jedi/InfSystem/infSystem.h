@@ -36,6 +36,8 @@ namespace TFE_Jedi
 	// Serialization & State
 	void inf_clearState();
 	void inf_serialize(Stream* stream);
+	// Rebuild the set of elevators to update from the elevator list.
+	void inf_resetElevatorSchedule();
 	
 	// ** Runtime API **
 	// Messages are the way entities and the player interact with the INF system during gameplay.
@@ -7,12 +7,16 @@
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/Task/task.h>
 #include <TFE_Jedi/Level/robject.h>
+#include <TFE_Jedi/Serialization/serialization.h>
 #include <TFE_DarkForces/logic.h>
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
 #include <algorithm>
+#include <cctype>
+#include <string>
+#include <unordered_map>
 
 namespace TFE_Jedi
 {
@@ -23,9 +27,25 @@ namespace TFE_Jedi
 	u32 s_msgArg2;
 	u32 s_msgEvent;
 
+	// TFE: Addresses are also hashed by name, so looking them up does not require walking the list.
+	typedef std::unordered_map<std::string, MessageAddress*> AddressTable;
+	static AddressTable s_addressTable;
+
+	// Names are compared up to 16 characters, ignoring case.
+	static std::string message_getAddressKey(const char* name)
+	{
+		std::string key(name, strnlen(name, 16));
+		for (size_t i = 0; i < key.length(); i++)
+		{
+			key[i] = toupper((u8)key[i]);
+		}
+		return key;
+	}
+
 	void message_free()
 	{
 		s_messageAddr = nullptr;
+		s_addressTable.clear();
 	}
 
 	void message_addAddress(const char* name, s32 param0, s32 param1, RSector* sector)
@@ -44,18 +64,58 @@ namespace TFE_Jedi
 		msgAddr->param0 = param0;
 		msgAddr->param1 = param1;
 		msgAddr->sector = sector;
+
+		// If names are repeated, the first address is used to match the original search order.
+		s_addressTable.insert({ message_getAddressKey(name), msgAddr });
 	}
 
-	MessageAddress* message_getAddress(const char* name)
+	void message_serializeAddresses(Stream* stream)
 	{
-		MessageAddress* msgAddr = (MessageAddress*)allocator_getHead(s_messageAddr);
-		while (msgAddr)
+		s32 count = 0;
+		if (serialization_getMode() == SMODE_WRITE)
+		{
+			count = s_messageAddr ? allocator_getCount(s_messageAddr) : 0;
+		}
+		SERIALIZE(SaveVersionInit, count, 0);
+
+		if (serialization_getMode() == SMODE_WRITE)
 		{
-			if (strncasecmp(name, msgAddr->name, 16) == 0)
+			MessageAddress* msgAddr = (MessageAddress*)allocator_getHead(s_messageAddr);
+			while (msgAddr)
 			{
-				return msgAddr;
+				SERIALIZE_BUF(SaveVersionInit, msgAddr->name, 16);
+				SERIALIZE(SaveVersionInit, msgAddr->param0, 0);
+				SERIALIZE(SaveVersionInit, msgAddr->param1, 0);
+				serialization_serializeSectorPtr(stream, SaveVersionInit, msgAddr->sector);
+				msgAddr = (MessageAddress*)allocator_getNext(s_messageAddr);
 			}
-			msgAddr = (MessageAddress*)allocator_getNext(s_messageAddr);
+		}
+		else
+		{
+			message_free();
+			for (s32 i = 0; i < count; i++)
+			{
+				MessageAddress addr;
+				SERIALIZE_BUF(SaveVersionInit, addr.name, 16);
+				SERIALIZE(SaveVersionInit, addr.param0, 0);
+				SERIALIZE(SaveVersionInit, addr.param1, 0);
+				serialization_serializeSectorPtr(stream, SaveVersionInit, addr.sector);
+
+				// Names are not null terminated if they use all 16 characters.
+				char name[17];
+				memcpy(name, addr.name, 16);
+				name[16] = 0;
+				message_addAddress(name, addr.param0, addr.param1, addr.sector);
+			}
+		}
+	}
+
+	MessageAddress* message_getAddress(const char* name)
+	{
+		AddressTable::iterator iAddr = s_addressTable.find(message_getAddressKey(name));
+		if (iAddr != s_addressTable.end())
+		{
+			return iAddr->second;
 		}
 
 		TFE_System::logWrite(LOG_ERROR, "INF", "Message_GetAddress: ADDRESS NOT FOUND: %s", name);
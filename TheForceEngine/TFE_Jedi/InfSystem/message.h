@@ -5,6 +5,7 @@
 //////////////////////////////////////////////////////////////////////
 
 #include <TFE_System/types.h>
+#include <TFE_FileSystem/stream.h>
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Level/rsector.h>
 #include <vector>
@@ -55,6 +56,8 @@ namespace TFE_Jedi
 	void message_addAddress(const char* name, s32 param0, s32 param1, RSector* sector);
 	MessageAddress* message_getAddress(const char* name);
 	void message_free();
+	// Serialize the address list, the sectors must already be serialized.
+	void message_serializeAddresses(Stream* stream);
 
 	// Send a message to either an object or sector.
 	void message_sendToObj(SecObject* obj, MessageType msgType, MessageFunc func);
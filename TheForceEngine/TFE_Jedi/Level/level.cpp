@@ -3,7 +3,10 @@
 
 #include "level.h"
 #include "levelBin.h"
+#include "levelCache.h"
 #include "levelData.h"
+#include "levelPrefetch.h"
+#include "sectorGrid.h"
 #include "rwall.h"
 #include "rtexture.h"
 #include <TFE_Game/igame.h>
@@ -46,8 +49,66 @@ namespace TFE_Jedi
 	static s32 s_dataIndex;
 	static char s_readBuffer[256];
 	static std::vector<char> s_buffer;
+	static LevelLoadTimes s_loadTimes = {};
+
+	// TFE: The sector, wall and object lines make up nearly all of the .LEV and .O files, so they are
+	// split with the non-allocating tokenizer instead of sscanf(). Keywords are matched without the ':'.
+	enum { LEVEL_MAX_TOKENS = 48 };
+	static TokenSpan s_tokens[LEVEL_MAX_TOKENS];
+	static s32 s_tokenCount;
+
+	// Returns true if the line has at least 'minCount' tokens and starts with 'key0' (and 'key1' if not null).
+	static bool level_tokenizeLine(TFE_Parser& parser, const char* line, s32 minCount, const char* key0, const char* key1 = nullptr)
+	{
+		s_tokenCount = line ? parser.tokenizeLine(line, s_tokens, LEVEL_MAX_TOKENS) : 0;
+		if (s_tokenCount < minCount || !TFE_Token::equals(s_tokens[0], key0)) { return false; }
+		return !key1 || TFE_Token::equals(s_tokens[1], key1);
+	}
+
+	// Returns true if the token at 'index' matches 'key'.
+	static bool level_tokenIs(s32 index, const char* key)
+	{
+		return index < s_tokenCount && TFE_Token::equals(s_tokens[index], key);
+	}
+
+	static bool level_tokenInt(s32 index, s32* value)
+	{
+		return index < s_tokenCount && TFE_Token::toInt(s_tokens[index], value);
+	}
+
+	static bool level_tokenFloat(s32 index, f32* value)
+	{
+		return index < s_tokenCount && TFE_Token::toFloat(s_tokens[index], value);
+	}
+
+	// Read a single name from an item line, such as "POD: name".
+	static bool level_tokenizeItemLine(TFE_Parser& parser, const char* line, const char* key, char* name, size_t nameSize)
+	{
+		if (!level_tokenizeLine(parser, line, 2, key)) { return false; }
+		TFE_Token::copy(s_tokens[1], name, nameSize);
+		return true;
+	}
+
+	// CLASS: name DATA: v X: v Y: v Z: v PCH: v YAW: v ROL: v DIFF: v
+	// Values are read until the first mismatch and the number read is returned, matching the original sscanf().
+	static s32 level_tokenizeObjectLine(TFE_Parser& parser, const char* line, char* objClass, size_t classSize, s32* data, f32* values, s32* diff)
+	{
+		static const char* c_objectKeys[] = { "X", "Y", "Z", "PCH", "YAW", "ROL" };
+		if (!level_tokenizeLine(parser, line, 2, "CLASS")) { return 0; }
+		TFE_Token::copy(s_tokens[1], objClass, classSize);
+
+		if (!level_tokenIs(2, "DATA") || !level_tokenInt(3, data)) { return 1; }
+		s32 count = 2;
+		for (s32 i = 0; i < s32(TFE_ARRAYSIZE(c_objectKeys)); i++, count++)
+		{
+			if (!level_tokenIs(4 + i*2, c_objectKeys[i]) || !level_tokenFloat(5 + i*2, &values[i])) { return count; }
+		}
+		if (level_tokenIs(16, "DIFF") && level_tokenInt(17, diff)) { count++; }
+		return count;
+	}
 
 	JBool level_loadGeometry(const char* levelName);
+	f64 level_getPhaseTime(u64& ticks);
 	JBool level_loadObjects(const char* levelName, u8 difficulty);
 	JBool level_loadGoals(const char* levelName);
 
@@ -68,14 +129,51 @@ namespace TFE_Jedi
 		// Settings helper
 		TFE_Settings::setLevelName(levelName);
 
-		if (!level_loadGeometry(levelName)) { return JFALSE; }
+		// Start reading the level assets in the background while the level files are parsed.
+		u64 time = TFE_System::getCurrentTimeInTicks();
+		level_prefetchBegin(levelName);
+		const f64 prefetchTime = level_getPhaseTime(time);
+
+		if (!level_loadGeometry(levelName))
+		{
+			level_prefetchEnd();
+			return JFALSE;
+		}
+		const f64 geometryTime = level_getPhaseTime(time);
 		level_loadObjects(levelName, difficulty);
+		const f64 objectTime = level_getPhaseTime(time);
 		inf_load(levelName);
+		const f64 infTime = level_getPhaseTime(time);
 		level_loadGoals(levelName);
-
+		const f64 goalTime = level_getPhaseTime(time);
+		level_prefetchEnd();
+
+		s_loadTimes.prefetch = prefetchTime;
+		s_loadTimes.geometry = geometryTime;
+		s_loadTimes.objects  = objectTime;
+		s_loadTimes.inf      = infTime;
+		s_loadTimes.goals    = goalTime;
+		s_loadTimes.total    = prefetchTime + geometryTime + objectTime + infTime + goalTime + level_getPhaseTime(time);
+
+		TFE_System::logWrite(LOG_MSG, "Level Load", "Loaded '%s' in %.2f ms: prefetch %.2f, geometry %.2f, objects %.2f, INF %.2f, goals %.2f.",
+			levelName, s_loadTimes.total, prefetchTime, geometryTime, objectTime, infTime, goalTime);
 		return JTRUE;
 	}
 
+	const LevelLoadTimes* level_getLoadTimes()
+	{
+		return &s_loadTimes;
+	}
+
+	// Returns the time since 'ticks' in milliseconds and resets 'ticks' to the current time.
+	f64 level_getPhaseTime(u64& ticks)
+	{
+		const u64 curTicks = TFE_System::getCurrentTimeInTicks();
+		const f64 ms = TFE_System::convertFromTicksToSeconds(curTicks - ticks) * 1000.0;
+		ticks = curTicks;
+		return ms;
+	}
+
 	void level_loadPalette()
 	{
 		// Palette *IS* loaded from the level file.
@@ -132,6 +230,9 @@ namespace TFE_Jedi
 		// Setup the control sector.
 		s_levelState.controlSector->id = s_levelState.sectorCount;
 		s_levelState.controlSector->index = s_levelState.controlSector->id;
+
+		// TFE: Spatial index used for sector point and range queries.
+		sectorGrid_build();
 	}
 
 	JBool level_loadGeometry(const char* levelName)
@@ -165,16 +266,23 @@ namespace TFE_Jedi
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot open level geometry '%s'.", levelName);
 			return false;
 		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
+		size_t len;
+		const char* data = file.readView(s_buffer, &len);
 		file.close();
 
+		// TFE: Skip parsing if the geometry is cached from an earlier load of the same .LEV file.
+		const u64 sourceHash = level_hashCacheSource(data, len);
+		if (level_loadGeometryCache(levelPath, sourceHash, u32(len)))
+		{
+			return JTRUE;
+		}
+
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), s_buffer.size());
+		parser.init(data, len);
 		parser.addCommentString("#");
 		parser.convertToUpperCase(true);
+		parser.enableColonSeperator();
 
 		// Only use the parser "read line" functionality and otherwise read in the same was as the DOS code.
 		const char* line;
@@ -302,7 +410,7 @@ namespace TFE_Jedi
 
 			// Sector ID and Name
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " SECTOR %d", &sector->id) != 1)
+			if (!level_tokenizeLine(parser, line, 2, "SECTOR") || !level_tokenInt(1, &sector->id))
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector id.");
 				return false;
@@ -336,7 +444,7 @@ namespace TFE_Jedi
 			// Lighting
 			line = parser.readLine(bufferPos);
 			s32 ambient;
-			if (sscanf(line, " AMBIENT %d", &ambient) != 1)
+			if (!level_tokenizeLine(parser, line, 2, "AMBIENT") || !level_tokenInt(1, &ambient))
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector ambient.");
 				return false;
@@ -347,7 +455,8 @@ namespace TFE_Jedi
 			line = parser.readLine(bufferPos);
 			s32 index, tmp;
 			f32 offsetX, offsetZ;
-			if (sscanf(line, " FLOOR TEXTURE %d %f %f %d", &index, &offsetX, &offsetZ, &tmp) != 4)
+			if (!level_tokenizeLine(parser, line, 6, "FLOOR", "TEXTURE") || !level_tokenInt(2, &index) || !level_tokenFloat(3, &offsetX) ||
+				!level_tokenFloat(4, &offsetZ) || !level_tokenInt(5, &tmp))
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read floor texture.");
 				return false;
@@ -364,7 +473,7 @@ namespace TFE_Jedi
 			// Floor Altitude
 			line = parser.readLine(bufferPos);
 			f32 alt;
-			if (sscanf(line, " FLOOR ALTITUDE %f", &alt) != 1)
+			if (!level_tokenizeLine(parser, line, 3, "FLOOR", "ALTITUDE") || !level_tokenFloat(2, &alt))
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read floor altitude.");
 				return false;
@@ -373,7 +482,8 @@ namespace TFE_Jedi
 
 			// Ceiling Texture & Offset
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " CEILING TEXTURE %d %f %f %d", &index, &offsetX, &offsetZ, &tmp) != 4)
+			if (!level_tokenizeLine(parser, line, 6, "CEILING", "TEXTURE") || !level_tokenInt(2, &index) || !level_tokenFloat(3, &offsetX) ||
+				!level_tokenFloat(4, &offsetZ) || !level_tokenInt(5, &tmp))
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read ceiling texture.");
 				return false;
@@ -388,7 +498,7 @@ namespace TFE_Jedi
 
 			// Ceiling Altitude
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " CEILING ALTITUDE %f", &alt) != 1)
+			if (!level_tokenizeLine(parser, line, 3, "CEILING", "ALTITUDE") || !level_tokenFloat(2, &alt))
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read ceiling altitude.");
 				return false;
@@ -397,7 +507,7 @@ namespace TFE_Jedi
 
 			// Second Altitude
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " SECOND ALTITUDE %f", &alt) != 1)
+			if (!level_tokenizeLine(parser, line, 3, "SECOND", "ALTITUDE") || !level_tokenFloat(2, &alt))
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read second altitude.");
 				return false;
@@ -406,7 +516,8 @@ namespace TFE_Jedi
 
 			// Sector flags
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " FLAGS %d %d %d", &sector->flags1, &sector->flags2, &sector->flags3) != 3)
+			if (!level_tokenizeLine(parser, line, 4, "FLAGS") || !level_tokenInt(1, (s32*)&sector->flags1) ||
+				!level_tokenInt(2, (s32*)&sector->flags2) || !level_tokenInt(3, (s32*)&sector->flags3))
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector flags.");
 				return false;
@@ -430,7 +541,7 @@ namespace TFE_Jedi
 
 			// Layer
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " LAYER %d", &sector->layer) != 1)
+			if (!level_tokenizeLine(parser, line, 2, "LAYER") || !level_tokenInt(1, &sector->layer))
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector layer.");
 				return false;
@@ -441,7 +552,7 @@ namespace TFE_Jedi
 			// Vertices
 			line = parser.readLine(bufferPos);
 			s32 vertexCount;
-			if (sscanf(line, " VERTICES %d", &vertexCount) != 1)
+			if (!level_tokenizeLine(parser, line, 2, "VERTICES") || !level_tokenInt(1, &vertexCount))
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector vertices.");
 				return false;
@@ -455,8 +566,11 @@ namespace TFE_Jedi
 			{
 				line = parser.readLine(bufferPos);
 
-				f32 x, z;
-				sscanf(line, " X: %f Z: %f ", &x, &z);
+				f32 x = 0.0f, z = 0.0f;
+				if (level_tokenizeLine(parser, line, 2, "X") && level_tokenFloat(1, &x) && level_tokenIs(2, "Z"))
+				{
+					level_tokenFloat(3, &z);
+				}
 				sector->verticesWS[v].x = floatToFixed16(x);
 				sector->verticesWS[v].z = floatToFixed16(z);
 			}
@@ -464,7 +578,7 @@ namespace TFE_Jedi
 			// Walls
 			line = parser.readLine(bufferPos);
 			s32 wallCount;
-			if (sscanf(line, " WALLS %d", &wallCount) != 1)
+			if (!level_tokenizeLine(parser, line, 2, "WALLS") || !level_tokenInt(1, &wallCount))
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector walls.");
 				return false;
@@ -483,9 +597,18 @@ namespace TFE_Jedi
 				f32 midOffsetZ, midOffsetX;
 
 				line = parser.readLine(bufferPos);
-				if (sscanf(line, " WALL LEFT: %d RIGHT: %d MID: %d %f %f %d TOP: %d %f %f %d BOT: %d %f %f %d SIGN: %d %f %f ADJOIN: %d MIRROR: %d WALK: %d FLAGS: %d %d %d LIGHT: %d",
-					&left, &right, &midTex, &midOffsetX, &midOffsetZ, &unused, &topTex, &topOffsetX, &topOffsetZ, &unused, &botTex, &botOffsetX, &botOffsetZ, &unused,
-					&signTex, &signOffsetX, &signOffsetZ, &adjoin, &mirror, &walk, &flags1, &flags2, &flags3, &light) != 24)
+				// WALL LEFT: v RIGHT: v MID: v v v v TOP: v v v v BOT: v v v v SIGN: v v v ADJOIN: v MIRROR: v WALK: v FLAGS: v v v LIGHT: v
+				if (!level_tokenizeLine(parser, line, 36, "WALL", "LEFT") || !level_tokenInt(2, &left) ||
+					!level_tokenIs(3, "RIGHT")  || !level_tokenInt(4, &right) ||
+					!level_tokenIs(5, "MID")    || !level_tokenInt(6, &midTex) || !level_tokenFloat(7, &midOffsetX) || !level_tokenFloat(8, &midOffsetZ) || !level_tokenInt(9, &unused) ||
+					!level_tokenIs(10, "TOP")   || !level_tokenInt(11, &topTex) || !level_tokenFloat(12, &topOffsetX) || !level_tokenFloat(13, &topOffsetZ) || !level_tokenInt(14, &unused) ||
+					!level_tokenIs(15, "BOT")   || !level_tokenInt(16, &botTex) || !level_tokenFloat(17, &botOffsetX) || !level_tokenFloat(18, &botOffsetZ) || !level_tokenInt(19, &unused) ||
+					!level_tokenIs(20, "SIGN")  || !level_tokenInt(21, &signTex) || !level_tokenFloat(22, &signOffsetX) || !level_tokenFloat(23, &signOffsetZ) ||
+					!level_tokenIs(24, "ADJOIN") || !level_tokenInt(25, &adjoin) ||
+					!level_tokenIs(26, "MIRROR") || !level_tokenInt(27, &mirror) ||
+					!level_tokenIs(28, "WALK")  || !level_tokenInt(29, &walk) ||
+					!level_tokenIs(30, "FLAGS") || !level_tokenInt(31, &flags1) || !level_tokenInt(32, &flags2) || !level_tokenInt(33, &flags3) ||
+					!level_tokenIs(34, "LIGHT") || !level_tokenInt(35, &light))
 				{
 					TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read wall.");
 					return false;
@@ -570,6 +693,7 @@ namespace TFE_Jedi
 		}
 
 		level_postProcessGeometry();
+		level_saveGeometryCache(levelPath, sourceHash, u32(len));
 
 		return true;
 	}
@@ -616,14 +740,13 @@ namespace TFE_Jedi
 			return JFALSE;
 		}
 
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
+		size_t len;
+		const char* data = file.readView(s_buffer, &len);
 		file.close();
 
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), s_buffer.size());
+		parser.init(data, len);
 		parser.enableBlockComments();
 		parser.addCommentString("//");
 		parser.addCommentString("#");
@@ -728,18 +851,19 @@ namespace TFE_Jedi
 			return false;
 		}
 
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
+		size_t len;
+		const char* data = file.readView(s_buffer, &len);
 		file.close();
 
+		// TFE: Read the lines from the cache if this .O file was loaded before.
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), s_buffer.size());
 		parser.enableBlockComments();
 		parser.addCommentString("//");
 		parser.addCommentString("#");
 		parser.convertToUpperCase(true);
+		parser.enableColonSeperator();
+		level_initCachedParser(parser, levelPath, data, len);
 
 		// Only use the parser "read line" functionality and otherwise read in the same was as the DOS code.
 		const char* line;
@@ -764,7 +888,7 @@ namespace TFE_Jedi
 					if (line)
 					{
 						char podName[32];
-						if (sscanf(line, " POD: %s", podName) == 1)
+						if (level_tokenizeItemLine(parser, line, "POD", podName, sizeof(podName)))
 						{
 							s_levelIntState.pods[p] = TFE_Model_Jedi::get(podName);
 							if (!s_levelIntState.pods[p])
@@ -790,7 +914,7 @@ namespace TFE_Jedi
 					if (line)
 					{
 						char name[32];
-						if (sscanf(line, " SPR: %s ", name) == 1)
+						if (level_tokenizeItemLine(parser, line, "SPR", name, sizeof(name)))
 						{
 							s_levelIntState.sprites[s] = TFE_Sprite_Jedi::getWax(name);
 							if (!s_levelIntState.sprites[s])
@@ -816,7 +940,7 @@ namespace TFE_Jedi
 					if (line)
 					{
 						char name[32];
-						if (sscanf(line, " FME: %s ", name) == 1)
+						if (level_tokenizeItemLine(parser, line, "FME", name, sizeof(name)))
 						{
 							s_levelIntState.frames[f] = TFE_Sprite_Jedi::getFrame(name);
 							if (!s_levelIntState.frames[f])
@@ -842,7 +966,7 @@ namespace TFE_Jedi
 					if (line)
 					{
 						char name[32];
-						if (sscanf(line, " SOUND: %s ", name) == 1)
+						if (level_tokenizeItemLine(parser, line, "SOUND", name, sizeof(name)))
 						{
 							s_levelIntState.soundIds[s] = sound_load(name, SOUND_PRIORITY_LOW2);
 						}
@@ -870,11 +994,13 @@ namespace TFE_Jedi
 					}
 
 					s32 objDiff = 0;
-					f32 x, y, z, pch, yaw, rol;
+					f32 values[6] = { 0 };
 					char objClass[32];
 
-					if (sscanf(line, " CLASS: %s DATA: %d X: %f Y: %f Z: %f PCH: %f YAW: %f ROL: %f DIFF: %d", objClass, &s_dataIndex, &x, &y, &z, &pch, &yaw, &rol, &objDiff) > 5)
+					if (level_tokenizeObjectLine(parser, line, objClass, sizeof(objClass), &s_dataIndex, values, &objDiff) > 5)
 					{
+						const f32 x = values[0], y = values[1], z = values[2];
+						const f32 pch = values[3], yaw = values[4], rol = values[5];
 						objIndex++;
 						// objDiff >= 0: This difficulty and all greater.
 						// objDiff <  0: Less than this difficulty.
@@ -26,6 +26,17 @@
 #include <TFE_Jedi/InfSystem/message.h>
 #include "rsector.h"
 
+// Time spent in each phase of the last level_load(), in milliseconds.
+struct LevelLoadTimes
+{
+	f64 prefetch;
+	f64 geometry;
+	f64 objects;
+	f64 inf;
+	f64 goals;
+	f64 total;
+};
+
 struct Safe
 {
 	RSector* sector;
@@ -40,8 +51,10 @@ namespace TFE_Jedi
 	JBool level_load(const char* levelName, u8 difficulty);
 	void  level_clearData();
 	void  level_freeAllAssets();
+	const LevelLoadTimes* level_getLoadTimes();
 
 	void level_serialize(Stream* stream);
+	void level_serializeGeometry(Stream* stream);
 
 	void setObjPos_AddToSector(SecObject* obj, s32 x, s32 y, s32 z, RSector* sector);
 	void getSkyParallax(fixed16_16* parallax0, fixed16_16* parallax1);
@@ -0,0 +1,208 @@
+#include <cstdio>
+#include <cstring>
+
+#include "levelCache.h"
+#include "level.h"
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/memorystream.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_Jedi/Serialization/serialization.h>
+#include <TFE_Settings/settings.h>
+#include <TFE_System/parser.h>
+#include <TFE_System/system.h>
+
+namespace TFE_Jedi
+{
+	enum LevelCacheConstants : u32
+	{
+		LEVEL_CACHE_MAGIC = 0x434c4654,	// "TFLC"
+		// Increment whenever level_serializeGeometry(), the line format or the header changes.
+		LEVEL_CACHE_VERSION = 2,
+	};
+
+	enum LevelCacheType : u32
+	{
+		LEVEL_CACHE_GEOMETRY = 0,	// level_serializeGeometry()
+		LEVEL_CACHE_LINES,			// Null terminated lines read by TFE_Parser.
+	};
+
+	struct LevelCacheHeader
+	{
+		u32 magic;
+		u32 version;
+		u64 sourceHash;
+		u32 sourceSize;
+		u32 payloadSize;
+		u32 payloadHash;
+		u32 type;
+	};
+
+	static MemoryStream s_cacheStream;
+
+	// FNV-1a
+	static u64 level_hash64(const u8* data, size_t size)
+	{
+		u64 hash = 14695981039346656037ull;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ data[i]) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	static u32 level_hash32(const u8* data, size_t size)
+	{
+		const u64 hash = level_hash64(data, size);
+		return u32(hash ^ (hash >> 32ull));
+	}
+
+	static bool level_cacheEnabled()
+	{
+		return TFE_Settings::getSystemSettings()->levelCache;
+	}
+
+	static void level_getCachePath(const char* fileName, u64 sourceHash, char* path)
+	{
+		sprintf(path, "%sCache/%s.%016llx.lvc", TFE_Paths::getPath(PATH_PROGRAM_DATA), fileName, (unsigned long long)sourceHash);
+	}
+
+	// Read the cached payload into s_cacheStream.
+	static bool level_readCache(const char* fileName, LevelCacheType type, u64 sourceHash, u32 sourceSize)
+	{
+		char cachePath[TFE_MAX_PATH];
+		level_getCachePath(fileName, sourceHash, cachePath);
+		FileStream file;
+		if (!file.open(cachePath, Stream::MODE_READ))
+		{
+			return false;
+		}
+
+		// Validate everything before the payload is used.
+		LevelCacheHeader header;
+		if (file.readBuffer(&header, sizeof(LevelCacheHeader)) != sizeof(LevelCacheHeader) ||
+			header.magic != LEVEL_CACHE_MAGIC || header.version != LEVEL_CACHE_VERSION || header.type != type ||
+			header.sourceHash != sourceHash || header.sourceSize != sourceSize || !header.payloadSize)
+		{
+			TFE_System::logWrite(LOG_MSG, "Level Cache", "Cache for '%s' is out of date.", fileName);
+			return false;
+		}
+		if (!s_cacheStream.allocate(header.payloadSize) ||
+			file.readBuffer(s_cacheStream.data(), header.payloadSize) != header.payloadSize ||
+			level_hash32((const u8*)s_cacheStream.data(), header.payloadSize) != header.payloadHash)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level Cache", "Cache for '%s' is corrupt.", fileName);
+			return false;
+		}
+		file.close();
+		return true;
+	}
+
+	// Write the contents of s_cacheStream to the cache.
+	static void level_writeCache(const char* fileName, LevelCacheType type, u64 sourceHash, u32 sourceSize)
+	{
+		LevelCacheHeader header = {};
+		header.magic = LEVEL_CACHE_MAGIC;
+		header.version = LEVEL_CACHE_VERSION;
+		header.sourceHash = sourceHash;
+		header.sourceSize = sourceSize;
+		header.payloadSize = (u32)s_cacheStream.getSize();
+		header.payloadHash = level_hash32((const u8*)s_cacheStream.data(), header.payloadSize);
+		header.type = type;
+		if (!header.payloadSize) { return; }
+
+		char cacheDir[TFE_MAX_PATH];
+		sprintf(cacheDir, "%sCache/", TFE_Paths::getPath(PATH_PROGRAM_DATA));
+		if (!FileUtil::directoryExits(cacheDir))
+		{
+			FileUtil::makeDirectory(cacheDir);
+		}
+
+		char cachePath[TFE_MAX_PATH];
+		level_getCachePath(fileName, sourceHash, cachePath);
+		FileStream file;
+		if (!file.open(cachePath, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level Cache", "Cannot write the cache for '%s'.", fileName);
+			return;
+		}
+		file.writeBuffer(&header, sizeof(LevelCacheHeader));
+		file.writeBuffer(s_cacheStream.data(), header.payloadSize);
+		file.close();
+	}
+
+	u64 level_hashCacheSource(const void* data, size_t size)
+	{
+		return level_hash64((const u8*)data, size);
+	}
+
+	JBool level_loadGeometryCache(const char* fileName, u64 sourceHash, u32 sourceSize)
+	{
+		if (!level_cacheEnabled() || !level_readCache(fileName, LEVEL_CACHE_GEOMETRY, sourceHash, sourceSize))
+		{
+			return JFALSE;
+		}
+
+		const SerializationMode prevMode = serialization_getMode();
+		const u32 prevVersion = s_sVersion;
+		serialization_setMode(SMODE_READ);
+		s_cacheStream.open(Stream::MODE_READ);
+		level_serializeGeometry(&s_cacheStream);
+		s_cacheStream.close();
+		serialization_setMode(prevMode);
+		serialization_setVersion(prevVersion);
+
+		TFE_System::logWrite(LOG_MSG, "Level Cache", "Loaded '%s' from the cache.", fileName);
+		return JTRUE;
+	}
+
+	void level_saveGeometryCache(const char* fileName, u64 sourceHash, u32 sourceSize)
+	{
+		if (!level_cacheEnabled()) { return; }
+
+		const SerializationMode prevMode = serialization_getMode();
+		const u32 prevVersion = s_sVersion;
+		serialization_setMode(SMODE_WRITE);
+		s_cacheStream.clear();
+		s_cacheStream.open(Stream::MODE_WRITE);
+		level_serializeGeometry(&s_cacheStream);
+		s_cacheStream.close();
+		serialization_setMode(prevMode);
+		serialization_setVersion(prevVersion);
+
+		level_writeCache(fileName, LEVEL_CACHE_GEOMETRY, sourceHash, sourceSize);
+	}
+
+	void level_initCachedParser(TFE_Parser& parser, const char* fileName, const char* data, size_t size)
+	{
+		if (!level_cacheEnabled())
+		{
+			parser.init(data, size);
+			return;
+		}
+
+		const u64 sourceHash = level_hashCacheSource(data, size);
+		if (level_readCache(fileName, LEVEL_CACHE_LINES, sourceHash, u32(size)))
+		{
+			parser.initLines((const char*)s_cacheStream.data(), s_cacheStream.getSize());
+			TFE_System::logWrite(LOG_MSG, "Level Cache", "Loaded '%s' from the cache.", fileName);
+			return;
+		}
+
+		// The lines do not depend on how they are used, so read them all up front.
+		// This is the same sequence the loaders would get from readLine().
+		parser.init(data, size);
+		s_cacheStream.clear();
+		s_cacheStream.open(Stream::MODE_WRITE);
+		size_t bufferPos = 0;
+		const char* line;
+		while (nullptr != (line = parser.readLine(bufferPos)))
+		{
+			s_cacheStream.writeBuffer(line, u32(strlen(line) + 1));
+		}
+		s_cacheStream.close();
+
+		level_writeCache(fileName, LEVEL_CACHE_LINES, sourceHash, u32(size));
+		parser.initLines((const char*)s_cacheStream.data(), s_cacheStream.getSize());
+	}
+}
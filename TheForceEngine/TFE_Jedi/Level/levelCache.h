@@ -0,0 +1,34 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Level Cache
+// Parsed level files are written to a binary cache the first time a
+// level is loaded, later loads of the same files skip the text parsing:
+// - The .LEV geometry is restored with level_serializeGeometry().
+// - The .O and .INF files are cached as the lines read by TFE_Parser,
+//   with comments and case already handled. The object list and INF
+//   setup code runs on the cached lines, since it creates logics and
+//   tasks and moves sectors, which the cache cannot reproduce.
+//
+// Cache files are named after the source file and a hash of its
+// contents, so mods that replace a level do not share a cache entry.
+// Each file carries a version and payload checksum, any mismatch
+// causes the source to be parsed again and the cache to be rewritten.
+// The cache is controlled by the "levelCache" system setting.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+class TFE_Parser;
+
+namespace TFE_Jedi
+{
+	u64   level_hashCacheSource(const void* data, size_t size);
+
+	// Returns JFALSE if there is no valid cache entry for this source, in which case the level state is unchanged.
+	JBool level_loadGeometryCache(const char* fileName, u64 sourceHash, u32 sourceSize);
+	// Write the current level geometry to the cache.
+	void  level_saveGeometryCache(const char* fileName, u64 sourceHash, u32 sourceSize);
+
+	// Set up 'parser' to read the lines of 'data', either from the cache or by reading them once and caching them.
+	// The parser options must already be set, the lines are valid until the next level cache call.
+	void  level_initCachedParser(TFE_Parser& parser, const char* fileName, const char* data, size_t size);
+}
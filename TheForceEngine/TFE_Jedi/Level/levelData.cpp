@@ -5,10 +5,14 @@
 #include "rsector.h"
 #include "rwall.h"
 #include "robjData.h"
+#include "sectorGrid.h"
 #include <TFE_Game/igame.h>
 #include <TFE_System/system.h>
 #include <TFE_Asset/spriteAsset_Jedi.h>
 #include <TFE_Jedi/Serialization/serialization.h>
+#include <TFE_Jedi/InfSystem/infSystem.h>
+#include <TFE_Jedi/InfSystem/infTypesInternal.h>
+#include <TFE_Jedi/InfSystem/message.h>
 
 // TODO: coupling between Dark Forces and Jedi.
 using namespace TFE_DarkForces;
@@ -54,6 +58,7 @@ namespace TFE_Jedi
 		sector_clear(s_levelState.controlSector);
 
 		objData_clear();
+		sectorGrid_clear();
 	}
 
 	void level_serializeFixupMirrors()
@@ -219,12 +224,69 @@ namespace TFE_Jedi
 			}
 
 			level_serializeFixupMirrors();
+			sectorGrid_build();
 		}
 
 		// Serialize objects.
 		objData_serialize(stream);
 	}
 		
+	// Serialize the state produced by level_loadGeometry(), this is used by the level cache.
+	// Unlike level_serialize(), objects and INF are not included and doors and exploding walls are recreated from the sector flags.
+	void level_serializeGeometry(Stream* stream)
+	{
+		const bool read = serialization_getMode() == SMODE_READ;
+		SERIALIZE_VERSION(LevelState_CurVersion);
+
+		SERIALIZE(LevelState_InitVersion, s_levelState.minLayer, 0);
+		SERIALIZE(LevelState_InitVersion, s_levelState.maxLayer, 0);
+		SERIALIZE(LevelState_InitVersion, s_levelState.secretCount, 0);
+		SERIALIZE(LevelState_InitVersion, s_levelState.sectorCount, 0);
+		SERIALIZE(LevelState_InitVersion, s_levelState.parallax0, 0);
+		SERIALIZE(LevelState_InitVersion, s_levelState.parallax1, 0);
+
+		level_serializePalette(stream);
+		bitmap_serializeLevelTextures(stream);
+		level_serializeTextureList(stream);
+
+		if (read)
+		{
+			s_levelState.sectors = (RSector*)level_alloc(sizeof(RSector) * s_levelState.sectorCount);
+			memset(s_levelState.sectors, 0, sizeof(RSector) * s_levelState.sectorCount);
+		}
+		RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; s < s_levelState.sectorCount; s++, sector++)
+		{
+			if (read) { sector_clear(sector); }
+			level_serializeSector(stream, sector);
+		}
+
+		serialization_serializeSectorPtr(stream, LevelState_InitVersion, s_levelState.bossSector);
+		serialization_serializeSectorPtr(stream, LevelState_InitVersion, s_levelState.mohcSector);
+		serialization_serializeSectorPtr(stream, LevelState_InitVersion, s_levelState.completeSector);
+		message_serializeAddresses(stream);
+
+		if (read)
+		{
+			level_serializeFixupMirrors();
+			level_postProcessGeometry();
+
+			sector = s_levelState.sectors;
+			for (u32 s = 0; s < s_levelState.sectorCount; s++, sector++)
+			{
+				if (sector->flags1 & SEC_FLAGS1_DOOR)
+				{
+					InfElevator* elev = inf_allocateSpecialElevator(sector, IELEV_SP_DOOR);
+					if (elev) { elev->flags |= INF_EFLAG_DOOR; }
+				}
+				if (sector->flags1 & SEC_FLAGS1_EXP_WALL)
+				{
+					inf_allocateSpecialElevator(sector, IELEV_SP_EXPLOSIVE_WALL);
+				}
+			}
+		}
+	}
+
 	/////////////////////////////////////////////
 	// Internal - Serialize
 	/////////////////////////////////////////////
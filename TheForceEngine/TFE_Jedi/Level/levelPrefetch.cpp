@@ -0,0 +1,301 @@
+#include <cstdio>
+#include <cstring>
+
+#include "levelPrefetch.h"
+#include <TFE_Archive/archive.h>
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_Jedi/Level/rtexture.h>
+#include <TFE_System/jobs.h>
+#include <TFE_System/parser.h>
+#include <TFE_System/system.h>
+#include <atomic>
+#include <cctype>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace TFE_Jedi
+{
+	enum PrefetchConstants
+	{
+		PREFETCH_PAGE_SIZE = 4096,
+		PREFETCH_MAX_PATTERNS = 4,
+	};
+
+	// Compressed textures are decompressed by whichever thread claims them first.
+	enum PrefetchImageState : s32
+	{
+		PREFETCH_IMAGE_NONE = 0,	// Not a texture, already taken, or claimed by the main thread.
+		PREFETCH_IMAGE_PENDING,
+		PREFETCH_IMAGE_DECODING,
+		PREFETCH_IMAGE_READY,
+	};
+
+	struct PrefetchItem
+	{
+		const u8* data;			// File data in a mapped archive, null if the file has to be read from disk.
+		size_t size;
+		bool isTexture;
+		char path[TFE_MAX_PATH];
+	};
+
+	// Lines of the form "<pattern> <file name>" that reference assets, scanning stops at 'stop'.
+	struct PrefetchScan
+	{
+		const char* ext;
+		const char* stop;
+		const char* patterns[PREFETCH_MAX_PATTERNS];
+		bool blockComments;
+	};
+
+	static const PrefetchScan c_levelScan   = { ".LEV", "NUMSECTORS", { " TEXTURE: %s" }, false };
+	static const PrefetchScan c_objectsScan = { ".O",   "OBJECTS",    { " POD: %s", " SPR: %s", " FME: %s", " SOUND: %s" }, true };
+
+	bool s_levelPrefetch = true;
+	static std::vector<PrefetchItem> s_prefetchItems;
+	static std::vector<char> s_prefetchBuffer;
+	static JobCounter s_prefetchCounter;
+	static std::atomic<u32> s_prefetchSum(0);
+	static u64 s_prefetchStart = 0;
+	static size_t s_prefetchBytes = 0;
+	static u32 s_prefetchLooseCount = 0;
+	static std::atomic<size_t> s_prefetchLooseBytes(0);
+
+	// Decompressed textures, indexed in the same way as s_prefetchItems and looked up by the upper case texture name.
+	static std::unordered_map<std::string, s32> s_prefetchTextures;
+	static std::vector<std::atomic<s32>> s_prefetchImageState;
+	static std::vector<std::vector<u8>> s_prefetchImages;
+	static std::atomic<u32> s_prefetchDecoded(0);
+
+	void prefetch_addFile(const char* name);
+	std::string prefetch_getKey(const char* name);
+	void prefetch_scanFile(const char* levelName, const PrefetchScan* scan);
+	void prefetch_job(void* userData, s32 index);
+
+	void level_prefetchBegin(const char* levelName)
+	{
+		level_prefetchEnd();
+		if (!s_levelPrefetch || !levelName || TFE_Jobs::getWorkerCount() < 1) { return; }
+
+		s_prefetchStart = TFE_System::getCurrentTimeInTicks();
+		s_prefetchItems.clear();
+		s_prefetchBytes = 0;
+		s_prefetchLooseCount = 0;
+		s_prefetchLooseBytes.store(0);
+		s_prefetchDecoded.store(0);
+
+		// The level files themselves, in the order they are loaded.
+		const char* levelExt[] = { ".LEV", ".O", ".INF", ".GOL" };
+		for (s32 i = 0; i < (s32)TFE_ARRAYSIZE(levelExt); i++)
+		{
+			char fileName[TFE_MAX_PATH];
+			sprintf(fileName, "%s%s", levelName, levelExt[i]);
+			prefetch_addFile(fileName);
+		}
+		// Then the assets they reference.
+		prefetch_scanFile(levelName, &c_levelScan);
+		prefetch_scanFile(levelName, &c_objectsScan);
+
+		const size_t itemCount = s_prefetchItems.size();
+		std::vector<std::atomic<s32>>(itemCount).swap(s_prefetchImageState);
+		s_prefetchImages.resize(itemCount);
+		for (size_t i = 0; i < itemCount; i++)
+		{
+			s_prefetchImageState[i].store(s_prefetchItems[i].isTexture ? PREFETCH_IMAGE_PENDING : PREFETCH_IMAGE_NONE);
+		}
+
+		// Nothing else can be added until the jobs have completed.
+		TFE_Jobs::submit(prefetch_job, s_prefetchItems.data(), (s32)itemCount, &s_prefetchCounter);
+
+		const f64 scanTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - s_prefetchStart);
+		TFE_System::logWrite(LOG_MSG, "Level Prefetch", "Prefetching %u files for '%s' (%u KB from archives, %u loose files, %u textures), scan took %.2f ms.",
+			(u32)itemCount, levelName, u32(s_prefetchBytes / 1024), s_prefetchLooseCount, (u32)s_prefetchTextures.size(), scanTime * 1000.0);
+	}
+
+	void level_prefetchEnd()
+	{
+		if (s_prefetchItems.empty()) { return; }
+
+		const u64 waitStart = TFE_System::getCurrentTimeInTicks();
+		TFE_Jobs::wait(&s_prefetchCounter);
+		const u64 end = TFE_System::getCurrentTimeInTicks();
+
+		TFE_System::logWrite(LOG_MSG, "Level Prefetch", "Prefetch complete after %.2f ms, waited %.2f ms, read %u KB of loose files, decompressed %u of %u textures on the workers.",
+			TFE_System::convertFromTicksToSeconds(end - s_prefetchStart) * 1000.0,
+			TFE_System::convertFromTicksToSeconds(end - waitStart) * 1000.0,
+			u32(s_prefetchLooseBytes.load() / 1024), s_prefetchDecoded.load(), (u32)s_prefetchTextures.size());
+		s_prefetchItems.clear();
+		s_prefetchTextures.clear();
+		s_prefetchImageState.clear();
+		s_prefetchImages.clear();
+	}
+
+	bool level_prefetchGetImage(const char* name, u8* image, size_t size)
+	{
+		if (s_prefetchTextures.empty() || !name) { return false; }
+		std::unordered_map<std::string, s32>::iterator iTex = s_prefetchTextures.find(prefetch_getKey(name));
+		if (iTex == s_prefetchTextures.end()) { return false; }
+		const s32 index = iTex->second;
+
+		// Claim the texture if the job hasn't started on it yet, so it is only decompressed once.
+		s32 state = PREFETCH_IMAGE_PENDING;
+		if (s_prefetchImageState[index].compare_exchange_strong(state, PREFETCH_IMAGE_NONE, std::memory_order_acq_rel))
+		{
+			return false;
+		}
+		while (state == PREFETCH_IMAGE_DECODING)
+		{
+			std::this_thread::yield();
+			state = s_prefetchImageState[index].load(std::memory_order_acquire);
+		}
+		if (state != PREFETCH_IMAGE_READY) { return false; }
+
+		std::vector<u8>& decoded = s_prefetchImages[index];
+		const bool valid = decoded.size() == size;
+		if (valid)
+		{
+			memcpy(image, decoded.data(), size);
+		}
+		std::vector<u8>().swap(decoded);
+		s_prefetchImageState[index].store(PREFETCH_IMAGE_NONE, std::memory_order_relaxed);
+		return valid;
+	}
+
+	////////////////////////////////////////////
+	// Internal
+	////////////////////////////////////////////
+	void prefetch_addFile(const char* name)
+	{
+		FilePath filePath;
+		if (!TFE_Paths::getFilePath(name, &filePath)) { return; }
+
+		// Textures are listed once in the level, so repeated names are only prefetched once.
+		char ext[16] = "";
+		FileUtil::getFileExtension(name, ext);
+		const bool isTexture = strcasecmp(ext, "BM") == 0;
+		if (isTexture && s_prefetchTextures.find(prefetch_getKey(name)) != s_prefetchTextures.end()) { return; }
+
+		PrefetchItem item = {};
+		item.isTexture = isTexture;
+		if (filePath.archive)
+		{
+			// Archives that are not in memory, such as zip files, are left to load on demand.
+			item.data = filePath.archive->getFileData(filePath.index);
+			if (!item.data) { return; }
+			item.size = filePath.archive->getFileLength(filePath.index);
+		}
+		else
+		{
+			strcpy(item.path, filePath.path);
+			s_prefetchLooseCount++;
+		}
+		if (isTexture)
+		{
+			s_prefetchTextures[prefetch_getKey(name)] = (s32)s_prefetchItems.size();
+		}
+		s_prefetchItems.push_back(item);
+		s_prefetchBytes += item.size;
+	}
+
+	std::string prefetch_getKey(const char* name)
+	{
+		std::string key(name);
+		for (size_t i = 0; i < key.length(); i++)
+		{
+			key[i] = toupper((u8)key[i]);
+		}
+		return key;
+	}
+
+	void prefetch_scanFile(const char* levelName, const PrefetchScan* scan)
+	{
+		char fileName[TFE_MAX_PATH];
+		sprintf(fileName, "%s%s", levelName, scan->ext);
+
+		FilePath filePath;
+		FileStream file;
+		if (!TFE_Paths::getFilePath(fileName, &filePath) || !file.open(&filePath, Stream::MODE_READ))
+		{
+			return;
+		}
+		size_t len;
+		const char* data = file.readView(s_prefetchBuffer, &len);
+		file.close();
+
+		TFE_Parser parser;
+		size_t bufferPos = 0;
+		parser.init(data, len);
+		if (scan->blockComments)
+		{
+			parser.enableBlockComments();
+			parser.addCommentString("//");
+		}
+		parser.addCommentString("#");
+		parser.convertToUpperCase(true);
+
+		const char* line;
+		char name[TFE_MAX_PATH];
+		while ((line = parser.readLine(bufferPos)) != nullptr)
+		{
+			if (sscanf(line, " %255s", name) == 1 && strcmp(name, scan->stop) == 0)
+			{
+				break;
+			}
+			for (s32 i = 0; i < PREFETCH_MAX_PATTERNS && scan->patterns[i]; i++)
+			{
+				if (sscanf(line, scan->patterns[i], name) == 1)
+				{
+					prefetch_addFile(name);
+					break;
+				}
+			}
+		}
+	}
+
+	void prefetch_job(void* userData, s32 index)
+	{
+		const PrefetchItem* item = &((const PrefetchItem*)userData)[index];
+		const u8* data = item->data;
+		size_t size = item->size;
+		std::vector<u8> fileData;
+		u32 sum = 0;
+		if (data)
+		{
+			// Touch every page so the data is faulted in here instead of on the main thread.
+			for (size_t i = 0; i < size; i += PREFETCH_PAGE_SIZE)
+			{
+				sum += data[i];
+			}
+		}
+		else
+		{
+			// Loose files are read in full, so the on-demand load hits the OS file cache and textures can be decompressed.
+			FileStream file;
+			if (file.open(item->path, Stream::MODE_READ))
+			{
+				size = file.getSize();
+				fileData.resize(size);
+				file.readBuffer(fileData.data(), u32(size));
+				file.close();
+
+				data = fileData.data();
+				sum += size ? data[0] : 0;
+				s_prefetchLooseBytes.fetch_add(size, std::memory_order_relaxed);
+			}
+		}
+		// Keep the reads from being optimized away.
+		s_prefetchSum.fetch_add(sum, std::memory_order_relaxed);
+
+		// Decompress the texture, unless the main thread has already claimed it.
+		s32 state = PREFETCH_IMAGE_PENDING;
+		if (data && s_prefetchImageState[index].compare_exchange_strong(state, PREFETCH_IMAGE_DECODING, std::memory_order_acq_rel))
+		{
+			const bool decoded = bitmap_decompress(data, size, s_prefetchImages[index]);
+			if (decoded) { s_prefetchDecoded.fetch_add(1, std::memory_order_relaxed); }
+			s_prefetchImageState[index].store(decoded ? PREFETCH_IMAGE_READY : PREFETCH_IMAGE_NONE, std::memory_order_release);
+		}
+	}
+}
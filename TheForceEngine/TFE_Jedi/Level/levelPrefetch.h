@@ -0,0 +1,24 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Level Prefetch
+// Scans the level files for the assets they reference and reads them
+// on the job system while the level is parsed on the main thread, so
+// the on-demand loads no longer block on disk I/O. Compressed BM
+// textures are also decompressed by the jobs, leaving only the copy
+// into level memory to the main thread.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+namespace TFE_Jedi
+{
+	// Build the asset manifest for the level and start reading the files in the background.
+	void level_prefetchBegin(const char* levelName);
+	// Wait for any outstanding reads, this must be called before the archives change.
+	void level_prefetchEnd();
+	// Copy the image decompressed by the prefetch jobs for 'name' into 'image', returns false if it is not available
+	// and the caller should decompress it instead. If the job is still decompressing the image, this waits for it.
+	bool level_prefetchGetImage(const char* name, u8* image, size_t size);
+
+	// Set to false to load assets on demand only.
+	extern bool s_levelPrefetch;
+}
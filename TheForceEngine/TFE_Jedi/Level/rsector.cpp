@@ -6,6 +6,7 @@
 #include "robject.h"
 #include "level.h"
 #include "levelData.h"
+#include "sectorGrid.h"
 #include <TFE_Game/igame.h>
 #include <TFE_System/system.h>
 #include <TFE_DarkForces/player.h>
@@ -212,6 +213,8 @@ namespace TFE_Jedi
 		sector->boundsMax.x = maxX;
 		sector->boundsMin.z = minZ;
 		sector->boundsMax.z = maxZ;
+		// TFE: Keep the sector grid up to date as walls move.
+		sectorGrid_updateSector(sector);
 	}
 
 	fixed16_16 sector_getMaxObjectHeight(RSector* sector)
@@ -513,13 +516,16 @@ namespace TFE_Jedi
 		fixed16_16 iz = dz;
 		fixed16_16 y = dy;
 		
-		RSector* sector = s_levelState.sectors;
 		RSector* foundSector = nullptr;
 		s32 sectorUnitArea = 0;
 		s32 prevSectorUnitArea = INT_MAX;
 
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		// TFE: Only test the sectors near the point, in the same order as the full scan.
+		SectorQuery query = sectorGrid_query(ix, iz, ix, iz);
+		RSector** sectorList = sectorGrid_getList(query);
+		for (u32 i = 0; i < query.count; i++)
 		{
+			RSector* sector = sectorList[i];
 			if (y >= sector->ceilingHeight && y <= sector->floorHeight)
 			{
 				const fixed16_16 sectorMaxX = sector->boundsMax.x;
@@ -543,6 +549,7 @@ namespace TFE_Jedi
 				}
 			}
 		}
+		sectorGrid_endQuery(query);
 
 		return foundSector;
 	}
@@ -552,13 +559,15 @@ namespace TFE_Jedi
 		fixed16_16 ix = dx;
 		fixed16_16 iz = dz;
 
-		RSector* sector = s_levelState.sectors;
 		RSector* foundSector = nullptr;
 		s32 sectorUnitArea = 0;
 		s32 prevSectorUnitArea = INT_MAX;
 
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		SectorQuery query = sectorGrid_query(ix, iz, ix, iz);
+		RSector** sectorList = sectorGrid_getList(query);
+		for (u32 i = 0; i < query.count; i++)
 		{
+			RSector* sector = sectorList[i];
 			if (sector->layer == layer)
 			{
 				const fixed16_16 sectorMaxX = sector->boundsMax.x;
@@ -582,6 +591,7 @@ namespace TFE_Jedi
 				}
 			}
 		}
+		sectorGrid_endQuery(query);
 
 		return foundSector;
 	}
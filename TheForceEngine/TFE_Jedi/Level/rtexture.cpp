@@ -8,6 +8,7 @@
 #include <TFE_FileSystem/fileutil.h>
 #include <TFE_FileSystem/paths.h>
 #include <TFE_FileSystem/filestream.h>
+#include <TFE_Jedi/Level/levelPrefetch.h>
 #include <TFE_Jedi/Task/task.h>
 #include <TFE_Jedi/Serialization/serialization.h>
 #include <TFE_System/math.h>
@@ -329,15 +330,14 @@ namespace TFE_Jedi
 			return nullptr;
 		}
 
-		size_t size = file.getSize();
-		s_buffer.resize(size);
-		file.readBuffer(s_buffer.data(), (u32)size);
+		// Archived textures are parsed in place when possible.
+		size_t size;
+		const u8* data = file.readView(s_buffer, &size);
 		file.close();
 
 		TextureData* texture = (TextureData*)region_alloc(s_texState.memoryRegion, sizeof(TextureData));
 		memset(texture, 0, sizeof(TextureData));
 
-		const u8* data = s_buffer.data();
 		const u8* end = data + size;
 		const u8* fheader = data;
 		data += 3;
@@ -389,7 +389,9 @@ namespace TFE_Jedi
 				data += sizeof(u32) * texture->width;
 				assert(data <= end);
 
-				if (texture->compressed == 1)
+				// TFE: Level textures may already have been decompressed on the job workers while the level was parsed.
+				const bool prefetched = level_prefetchGetImage(name, texture->image, texture->dataSize);
+				if (!prefetched && texture->compressed == 1)
 				{
 					u8* dst = texture->image;
 					for (s32 i = 0; i < texture->width; i++, dst += texture->height)
@@ -398,7 +400,7 @@ namespace TFE_Jedi
 						decompressColumn_Type1(src, dst, texture->height);
 					}
 				}
-				else if (texture->compressed == 2)
+				else if (!prefetched && texture->compressed == 2)
 				{
 					u8* dst = texture->image;
 					for (s32 i = 0; i < texture->width; i++, dst += texture->height)
@@ -480,6 +482,45 @@ namespace TFE_Jedi
 		return texture;
 	}
 
+	bool bitmap_decompress(const u8* data, size_t size, std::vector<u8>& image)
+	{
+		// "BM " + version, the image header and the compressed size followed by 12 unused bytes.
+		const size_t headerSize = 32;
+		if (size < headerSize || strncmp((const char*)data, "BM ", 3) || data[3] != DF_BM_VERSION) { return false; }
+
+		const u8* end = data + size;
+		data += 4;
+		const s32 width  = readUShort(data);
+		const s32 height = readUShort(data);
+		data += 6;	// uvWidth, uvHeight, flags, logSizeY
+		const u8 compressed = readByte(data);
+		data++;
+		if (compressed != 1 && compressed != 2) { return false; }
+
+		const s32 inSize = readInt(data);
+		data += 12;
+		const u8* inBuffer = data;
+		if (inSize < 0 || size_t(end - data) < size_t(inSize) + sizeof(u32) * width) { return false; }
+		const u32* columns = (u32*)(data + inSize);
+
+		image.resize(size_t(width) * size_t(height));
+		u8* dst = image.data();
+		for (s32 i = 0; i < width; i++, dst += height)
+		{
+			if (columns[i] >= u32(inSize)) { return false; }
+			const u8* src = &inBuffer[columns[i]];
+			if (compressed == 1)
+			{
+				decompressColumn_Type1(src, dst, height);
+			}
+			else
+			{
+				decompressColumn_Type2(src, dst, height);
+			}
+		}
+		return true;
+	}
+
 	TextureData* bitmap_loadFromMemory(const u8* data, size_t size, u32 decompress)
 	{
 		TextureData* texture = (TextureData*)malloc(sizeof(TextureData));
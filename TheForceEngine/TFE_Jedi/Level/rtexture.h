@@ -7,6 +7,7 @@
 #include <TFE_Jedi/Memory/allocator.h>
 #include <TFE_FileSystem/paths.h>
 #include <TFE_DarkForces/time.h>
+#include <vector>
 
 struct BM_Header
 {
@@ -103,6 +104,9 @@ namespace TFE_Jedi
 	// levelTexture bool was added for TFE to make serializing texture state easier.
 	// if levelTexture is false, then textures are not serialized and not cleared at level end.
 	TextureData* bitmap_load(const char* name, u32 decompress, AssetPool pool = POOL_LEVEL, bool addToCache = true);
+	// Decompress the image of an RLE compressed BM in the same way as bitmap_load(), returns false if the BM is not compressed.
+	// No shared state is used, so this can be called from the job workers.
+	bool bitmap_decompress(const u8* data, size_t size, std::vector<u8>& image);
 	bool bitmap_setupAnimatedTexture(TextureData** texture, s32 index);
 
 	Allocator* bitmap_getAnimatedTextures();
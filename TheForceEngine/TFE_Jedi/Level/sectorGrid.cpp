@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <vector>
+
+#include "sectorGrid.h"
+#include "levelData.h"
+#include "rsector.h"
+#include "robject.h"
+#include <TFE_FrontEndUI/console.h>
+#include <TFE_System/system.h>
+
+namespace TFE_Jedi
+{
+	enum SectorGridConstants
+	{
+		SECTOR_GRID_MIN_SHIFT = 20,			// 16 units.
+		SECTOR_GRID_MAX_SHIFT = 30,
+		SECTOR_GRID_MAX_DIM   = 256,
+		SECTOR_GRID_CELLS_PER_SECTOR = 2,
+		// Sector footprints are expanded by this amount so objects that sit on or just past a sector edge are still found.
+		SECTOR_GRID_MARGIN = FIXED(2),
+	};
+
+	struct CellRect
+	{
+		s32 x0, z0;
+		s32 x1, z1;
+	};
+
+	typedef std::vector<RSector*> SectorList;
+
+	bool s_sectorGrid = true;
+	bool s_sectorGridValidate = false;
+
+	static RSector* s_gridSectors = nullptr;
+	static u32 s_gridSectorCount = 0;
+	static fixed16_16 s_gridMinX = 0;
+	static fixed16_16 s_gridMinZ = 0;
+	static s32 s_gridShift = SECTOR_GRID_MIN_SHIFT;
+	static s32 s_gridWidth = 0;
+	static s32 s_gridHeight = 0;
+	static std::vector<SectorList> s_gridCells;
+	static std::vector<CellRect> s_sectorCells;
+	static std::vector<u32> s_sectorStamp;
+	static u32 s_queryStamp = 0;
+	// Query results, nested queries are pushed on top of the current results.
+	static SectorList s_queryStack;
+
+	CellRect sectorGrid_getCellRect(fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1);
+	void sectorGrid_addSector(RSector* sector, const CellRect& rect);
+	void sectorGrid_removeSector(RSector* sector, const CellRect& rect);
+	void sectorGrid_validate(SectorQuery query, fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1);
+
+	static bool sectorGrid_overlaps(const RSector* sector, fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1)
+	{
+		return x0 <= sector->boundsMax.x + SECTOR_GRID_MARGIN && x1 >= sector->boundsMin.x - SECTOR_GRID_MARGIN &&
+			   z0 <= sector->boundsMax.z + SECTOR_GRID_MARGIN && z1 >= sector->boundsMin.z - SECTOR_GRID_MARGIN;
+	}
+
+	void sectorGrid_build()
+	{
+		CVAR_BOOL(s_sectorGrid, "d_sectorGrid", CVFLAG_DO_NOT_SERIALIZE, "Use the sector grid for sector point and range queries.");
+		CVAR_BOOL(s_sectorGridValidate, "d_sectorGridValidate", CVFLAG_DO_NOT_SERIALIZE, "Check sector grid queries against a scan of every sector and log any differences.");
+
+		sectorGrid_clear();
+		if (!s_levelState.sectors || !s_levelState.sectorCount) { return; }
+
+		s_gridSectors = s_levelState.sectors;
+		s_gridSectorCount = s_levelState.sectorCount;
+
+		// Level extents.
+		RSector* sector = s_gridSectors;
+		fixed16_16 minX = sector->boundsMin.x, maxX = sector->boundsMax.x;
+		fixed16_16 minZ = sector->boundsMin.z, maxZ = sector->boundsMax.z;
+		for (u32 i = 1; i < s_gridSectorCount; i++)
+		{
+			sector = &s_gridSectors[i];
+			minX = min(minX, sector->boundsMin.x);
+			minZ = min(minZ, sector->boundsMin.z);
+			maxX = max(maxX, sector->boundsMax.x);
+			maxZ = max(maxZ, sector->boundsMax.z);
+		}
+		s_gridMinX = minX;
+		s_gridMinZ = minZ;
+
+		// Pick the smallest power of two cell size that keeps the cell count proportional to the sector count.
+		const s64 extentX = s64(maxX) - s64(minX);
+		const s64 extentZ = s64(maxZ) - s64(minZ);
+		const s64 maxCells = s64(s_gridSectorCount) * SECTOR_GRID_CELLS_PER_SECTOR;
+		s_gridShift = SECTOR_GRID_MIN_SHIFT;
+		for (; s_gridShift < SECTOR_GRID_MAX_SHIFT; s_gridShift++)
+		{
+			const s64 w = (extentX >> s_gridShift) + 1;
+			const s64 h = (extentZ >> s_gridShift) + 1;
+			if (w <= SECTOR_GRID_MAX_DIM && h <= SECTOR_GRID_MAX_DIM && w * h <= maxCells)
+			{
+				break;
+			}
+		}
+		s_gridWidth  = s32((extentX >> s_gridShift) + 1);
+		s_gridHeight = s32((extentZ >> s_gridShift) + 1);
+		s_gridCells.resize(s_gridWidth * s_gridHeight);
+
+		s_sectorCells.resize(s_gridSectorCount);
+		s_sectorStamp.assign(s_gridSectorCount, 0);
+		s_queryStamp = 0;
+		for (u32 i = 0; i < s_gridSectorCount; i++)
+		{
+			sector = &s_gridSectors[i];
+			s_sectorCells[i] = sectorGrid_getCellRect(sector->boundsMin.x - SECTOR_GRID_MARGIN, sector->boundsMin.z - SECTOR_GRID_MARGIN,
+				sector->boundsMax.x + SECTOR_GRID_MARGIN, sector->boundsMax.z + SECTOR_GRID_MARGIN);
+			sectorGrid_addSector(sector, s_sectorCells[i]);
+		}
+
+		TFE_System::logWrite(LOG_MSG, "Sector Grid", "Built a %d x %d sector grid with %d unit cells for %u sectors.",
+			s_gridWidth, s_gridHeight, 1 << (s_gridShift - 16), s_gridSectorCount);
+	}
+
+	void sectorGrid_clear()
+	{
+		s_gridSectors = nullptr;
+		s_gridSectorCount = 0;
+		s_gridWidth = 0;
+		s_gridHeight = 0;
+		s_gridCells.clear();
+		s_sectorCells.clear();
+		s_sectorStamp.clear();
+		s_queryStack.clear();
+	}
+
+	void sectorGrid_updateSector(RSector* sector)
+	{
+		if (!s_gridSectors || sector < s_gridSectors || sector >= s_gridSectors + s_gridSectorCount) { return; }
+
+		const s32 index = s32(sector - s_gridSectors);
+		const CellRect rect = sectorGrid_getCellRect(sector->boundsMin.x - SECTOR_GRID_MARGIN, sector->boundsMin.z - SECTOR_GRID_MARGIN,
+			sector->boundsMax.x + SECTOR_GRID_MARGIN, sector->boundsMax.z + SECTOR_GRID_MARGIN);
+		const CellRect& prevRect = s_sectorCells[index];
+		if (rect.x0 == prevRect.x0 && rect.z0 == prevRect.z0 && rect.x1 == prevRect.x1 && rect.z1 == prevRect.z1)
+		{
+			return;
+		}
+		sectorGrid_removeSector(sector, prevRect);
+		sectorGrid_addSector(sector, rect);
+		s_sectorCells[index] = rect;
+	}
+
+	SectorQuery sectorGrid_query(fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1)
+	{
+		SectorQuery query = { u32(s_queryStack.size()), 0 };
+		if (!s_sectorGrid || !s_gridSectors || s_gridSectors != s_levelState.sectors)
+		{
+			// Fall back to every sector.
+			for (u32 i = 0; i < s_levelState.sectorCount; i++)
+			{
+				s_queryStack.push_back(&s_levelState.sectors[i]);
+			}
+			query.count = s_levelState.sectorCount;
+			return query;
+		}
+
+		s_queryStamp++;
+		if (!s_queryStamp)
+		{
+			s_sectorStamp.assign(s_gridSectorCount, 0);
+			s_queryStamp = 1;
+		}
+
+		const CellRect rect = sectorGrid_getCellRect(x0, z0, x1, z1);
+		for (s32 z = rect.z0; z <= rect.z1; z++)
+		{
+			const SectorList* cell = &s_gridCells[z * s_gridWidth + rect.x0];
+			for (s32 x = rect.x0; x <= rect.x1; x++, cell++)
+			{
+				const size_t count = cell->size();
+				for (size_t i = 0; i < count; i++)
+				{
+					RSector* sector = (*cell)[i];
+					u32& stamp = s_sectorStamp[sector - s_gridSectors];
+					if (stamp == s_queryStamp) { continue; }
+					stamp = s_queryStamp;
+
+					if (sectorGrid_overlaps(sector, x0, z0, x1, z1))
+					{
+						s_queryStack.push_back(sector);
+					}
+				}
+			}
+		}
+		query.count = u32(s_queryStack.size()) - query.start;
+		// Sectors are contiguous, so pointer order matches the order of a full scan.
+		std::sort(s_queryStack.begin() + query.start, s_queryStack.end());
+
+		if (s_sectorGridValidate)
+		{
+			sectorGrid_validate(query, x0, z0, x1, z1);
+		}
+		return query;
+	}
+
+	RSector** sectorGrid_getList(SectorQuery query)
+	{
+		return query.count ? &s_queryStack[query.start] : nullptr;
+	}
+
+	void sectorGrid_endQuery(SectorQuery query)
+	{
+		assert(query.start + query.count == s_queryStack.size());
+		if (query.start < s_queryStack.size())
+		{
+			s_queryStack.resize(query.start);
+		}
+	}
+
+	////////////////////////////////////////////
+	// Internal
+	////////////////////////////////////////////
+	s32 sectorGrid_getCell(fixed16_16 v, fixed16_16 base, s32 dim)
+	{
+		const s64 cell = (s64(v) - s64(base)) >> s_gridShift;
+		if (cell < 0) { return 0; }
+		return cell >= dim ? dim - 1 : s32(cell);
+	}
+
+	// Coordinates outside of the grid are clamped to the edge cells, so sectors that grow past the original extents are still found.
+	CellRect sectorGrid_getCellRect(fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1)
+	{
+		CellRect rect;
+		rect.x0 = sectorGrid_getCell(x0, s_gridMinX, s_gridWidth);
+		rect.z0 = sectorGrid_getCell(z0, s_gridMinZ, s_gridHeight);
+		rect.x1 = sectorGrid_getCell(x1, s_gridMinX, s_gridWidth);
+		rect.z1 = sectorGrid_getCell(z1, s_gridMinZ, s_gridHeight);
+		return rect;
+	}
+
+	void sectorGrid_addSector(RSector* sector, const CellRect& rect)
+	{
+		for (s32 z = rect.z0; z <= rect.z1; z++)
+		{
+			for (s32 x = rect.x0; x <= rect.x1; x++)
+			{
+				s_gridCells[z * s_gridWidth + x].push_back(sector);
+			}
+		}
+	}
+
+	void sectorGrid_removeSector(RSector* sector, const CellRect& rect)
+	{
+		for (s32 z = rect.z0; z <= rect.z1; z++)
+		{
+			for (s32 x = rect.x0; x <= rect.x1; x++)
+			{
+				SectorList& cell = s_gridCells[z * s_gridWidth + x];
+				SectorList::iterator iSector = std::find(cell.begin(), cell.end(), sector);
+				if (iSector != cell.end())
+				{
+					*iSector = cell.back();
+					cell.pop_back();
+				}
+			}
+		}
+	}
+
+	// Debug: compare the query results against a scan of every sector.
+	void sectorGrid_validate(SectorQuery query, fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1)
+	{
+		// Every sector that overlaps the query or holds an object inside of it must be in the results.
+		RSector* sector = s_gridSectors;
+		for (u32 i = 0; i < s_gridSectorCount; i++, sector++)
+		{
+			const bool found = s_sectorStamp[i] == s_queryStamp && std::binary_search(s_queryStack.begin() + query.start, s_queryStack.end(), sector);
+			if (found) { continue; }
+
+			if (sectorGrid_overlaps(sector, x0, z0, x1, z1))
+			{
+				TFE_System::logWrite(LOG_WARNING, "Sector Grid", "Sector %d overlaps the query but is missing from the grid results.", sector->id);
+				continue;
+			}
+			for (s32 objIndex = 0, objListIndex = 0; objIndex < sector->objectCount && objListIndex < sector->objectCapacity; objListIndex++)
+			{
+				SecObject* obj = sector->objectList[objListIndex];
+				if (!obj) { continue; }
+				objIndex++;
+
+				if (obj->posWS.x >= x0 && obj->posWS.x <= x1 && obj->posWS.z >= z0 && obj->posWS.z <= z1)
+				{
+					TFE_System::logWrite(LOG_WARNING, "Sector Grid", "Object in sector %d at (%.2f, %.2f) is outside of the sector bounds and missed by the query.",
+						sector->id, fixed16ToFloat(obj->posWS.x), fixed16ToFloat(obj->posWS.z));
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Sector Grid
+// A uniform 2D grid over the sector bounds, used to find the sectors
+// near a point or rectangle without testing every sector in the level.
+//
+// Queries return the candidates in sector order, so callers visit
+// sectors in the same order as a full scan. Results are kept on a
+// stack, which allows nested queries from effect callbacks.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Math/core_math.h>
+
+struct RSector;
+
+namespace TFE_Jedi
+{
+	struct SectorQuery
+	{
+		u32 start;
+		u32 count;
+	};
+
+	// Build the grid from the current level sectors, called after the geometry is loaded.
+	void sectorGrid_build();
+	void sectorGrid_clear();
+	// Called when the sector bounds change, such as from moving or rotating walls.
+	void sectorGrid_updateSector(RSector* sector);
+
+	// Find the sectors whose bounds may overlap the rectangle [x0, x1] x [z0, z1].
+	// If the grid has not been built, every sector is returned.
+	SectorQuery sectorGrid_query(fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1);
+	// The result pointer is only valid until the next query.
+	RSector**   sectorGrid_getList(SectorQuery query);
+	// Release the query results, queries must be released in reverse order.
+	void        sectorGrid_endQuery(SectorQuery query);
+
+	extern bool s_sectorGrid;
+	extern bool s_sectorGridValidate;
+}
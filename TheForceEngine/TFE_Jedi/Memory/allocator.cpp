@@ -1,15 +1,29 @@
 #include "allocator.h"
 #include <TFE_System/system.h>
 #include <TFE_Game/igame.h>
+#include <TFE_Jedi/Math/core_math.h>
 #include <cstring>
+#include <assert.h>
 
 struct AllocHeader
 {
 	AllocHeader* prev;
-	AllocHeader* next;
+	AllocHeader* next;	// next free slot while the item is on the free list.
+	s32 index;			// position in the list, only valid if the allocator index table is valid.
+	s32 pad;
 	char data[];		// actual data storage area.
 };
 
+// Items are carved out of contiguous slabs, so that iteration mostly walks linearly through memory
+// and allocating an item does not go through the region free lists.
+struct AllocSlab
+{
+	AllocSlab* next;
+	s32 capacity;
+	s32 used;
+	// followed by 'capacity' items of Allocator::size bytes.
+};
+
 struct Allocator
 {
 	Allocator*   self;
@@ -24,6 +38,16 @@ struct Allocator
 	// TFE
 	AllocHeader* iterSave;
 	AllocHeader* iterPrevSave;
+
+	s32 count;
+	s32 slabCapacity;		// item count of the next slab.
+	AllocSlab* slabs;
+	AllocHeader* freeList;
+
+	// Lazily built table mapping index -> item, so random access doesn't walk the list.
+	AllocHeader** indexTable;
+	s32 indexCapacity;
+	JBool indexValid;
 };
 
 // given an "item" (=allocheader->data), get the "AllocHeader" it belongs to.
@@ -42,6 +66,123 @@ namespace TFE_Jedi
 {
 	#define MAX_ALLOC_SIZE (8*1024*1024)  // 8MB
 
+	enum
+	{
+		SLAB_MIN_ITEMS = 4,			// Small first slab, most allocators only hold a few items.
+		SLAB_MAX_ITEMS = 128,
+		SLAB_MAX_SIZE  = 16 * 1024,	// Slabs grow until they reach this size, larger items get one slab each.
+	};
+
+	AllocHeader* allocator_allocSlot(Allocator* alloc)
+	{
+		// Reuse a deleted item if possible.
+		AllocHeader* header = alloc->freeList;
+		if (header)
+		{
+			alloc->freeList = header->next;
+			return header;
+		}
+
+		AllocSlab* slab = alloc->slabs;
+		if (!slab || slab->used >= slab->capacity)
+		{
+			const s32 capacity = max(1, min(alloc->slabCapacity, s32(SLAB_MAX_SIZE / alloc->size)));
+			slab = (AllocSlab*)TFE_Memory::region_alloc(alloc->region, sizeof(AllocSlab) + u64(capacity) * alloc->size);
+			if (!slab) { return nullptr; }
+
+			slab->next = alloc->slabs;
+			slab->capacity = capacity;
+			slab->used = 0;
+			alloc->slabs = slab;
+			alloc->slabCapacity = min(alloc->slabCapacity * 2, (s32)SLAB_MAX_ITEMS);
+		}
+
+		header = (AllocHeader*)((u8*)slab + sizeof(AllocSlab) + size_t(slab->used) * alloc->size);
+		slab->used++;
+		return header;
+	}
+
+	void allocator_freeSlabs(Allocator* alloc)
+	{
+		AllocSlab* slab = alloc->slabs;
+		while (slab)
+		{
+			AllocSlab* next = slab->next;
+			TFE_Memory::region_free(alloc->region, slab);
+			slab = next;
+		}
+		alloc->slabs = nullptr;
+		alloc->freeList = nullptr;
+		alloc->slabCapacity = SLAB_MIN_ITEMS;
+	}
+
+	bool allocator_reserveIndex(Allocator* alloc, s32 count)
+	{
+		if (count <= alloc->indexCapacity) { return true; }
+
+		const s32 capacity = max(count, alloc->indexCapacity * 2);
+		AllocHeader** table = (AllocHeader**)TFE_Memory::region_realloc(alloc->region, alloc->indexTable, sizeof(AllocHeader*) * capacity);
+		if (!table) { return false; }
+
+		alloc->indexTable = table;
+		alloc->indexCapacity = capacity;
+		return true;
+	}
+
+	// Returns false if the index table cannot be built, in which case the caller should walk the list.
+	bool allocator_buildIndex(Allocator* alloc)
+	{
+		if (alloc->indexValid) { return true; }
+		if (!allocator_reserveIndex(alloc, alloc->count)) { return false; }
+
+		s32 index = 0;
+		for (AllocHeader* header = alloc->head; header; header = header->next, index++)
+		{
+			header->index = index;
+			alloc->indexTable[index] = header;
+		}
+		assert(index == alloc->count);
+		alloc->indexValid = JTRUE;
+		return true;
+	}
+
+	// Returns the index of 'header' or -1 if it isn't in the list.
+	s32 allocator_findHeader(Allocator* alloc, AllocHeader* header)
+	{
+		if (!header) { return -1; }
+		if (allocator_buildIndex(alloc))
+		{
+			// The header may be a deleted item, so verify that it is actually in the list.
+			const s32 index = header->index;
+			return (index >= 0 && index < alloc->count && alloc->indexTable[index] == header) ? index : -1;
+		}
+
+		s32 index = 0;
+		for (AllocHeader* cur = alloc->head; cur; cur = cur->next, index++)
+		{
+			if (cur == header) { return index; }
+		}
+		return -1;
+	}
+
+	// Returns the header at 'index' or null if it is out of range.
+	AllocHeader* allocator_getHeader(Allocator* alloc, s32 index)
+	{
+		if (index < 0 || index >= alloc->count) { return nullptr; }
+		if (allocator_buildIndex(alloc))
+		{
+			return alloc->indexTable[index];
+		}
+
+		AllocHeader* header = alloc->head;
+		while (index > 0 && header)
+		{
+			index--;
+			header = header->next;
+		}
+		return header;
+	}
+
 	// Create and free an allocator.
 	Allocator* allocator_create(s32 allocSize, MemoryRegion* region)
 	{
@@ -62,6 +203,7 @@ namespace TFE_Jedi
 		res->region = region;
 		res->size = allocSize + sizeof(AllocHeader);
 		res->refCount = 0;
+		res->slabCapacity = SLAB_MIN_ITEMS;
 
 		return res;
 	}
@@ -70,11 +212,11 @@ namespace TFE_Jedi
 	{
 		if (!alloc) { return; }
 
-		void* item = allocator_getHead(alloc);
-		while (item)
+		// Items live in the slabs, so they don't need to be freed individually.
+		allocator_freeSlabs(alloc);
+		if (alloc->indexTable)
 		{
-			allocator_deleteItem(alloc, item);
-			item = allocator_getNext(alloc);
+			TFE_Memory::region_free(alloc->region, alloc->indexTable);
 		}
 
 		alloc->self = nullptr;
@@ -91,7 +233,7 @@ namespace TFE_Jedi
 	{
 		if (!alloc) { return nullptr; }
 
-		AllocHeader* header = (AllocHeader*)TFE_Memory::region_alloc(alloc->region, alloc->size);
+		AllocHeader* header = allocator_allocSlot(alloc);
 		if (!header)
 		{
 			TFE_System::logWrite(LOG_ERROR, "Allocator", "allocator_newItem - cannot allocate header of size %d", alloc->size);
@@ -113,6 +255,21 @@ namespace TFE_Jedi
 			alloc->head = header;
 		}
 
+		// Appending keeps the index table valid.
+		if (alloc->indexValid)
+		{
+			if (allocator_reserveIndex(alloc, alloc->count + 1))
+			{
+				header->index = alloc->count;
+				alloc->indexTable[alloc->count] = header;
+			}
+			else
+			{
+				alloc->indexValid = JFALSE;
+			}
+		}
+		alloc->count++;
+
 		return GET_DATA(header);
 	}
 
@@ -141,128 +298,73 @@ namespace TFE_Jedi
 			alloc->iterPrev = header->next;
 		}
 
-		TFE_Memory::region_free(alloc->region, header);
+		// Removing the tail keeps the index table valid, otherwise the indices after the item change.
+		if (next != nullptr)
+		{
+			alloc->indexValid = JFALSE;
+		}
+		header->index = -1;
+		alloc->count--;
+
+		if (alloc->count == 0)
+		{
+			// Release the memory once the allocator is empty.
+			allocator_freeSlabs(alloc);
+		}
+		else
+		{
+			header->next = alloc->freeList;
+			alloc->freeList = header;
+		}
 	}
 
 	// Random access.
 	s32 allocator_getCount(Allocator* alloc)
 	{
-		if (!alloc) { return 0; }
-
-		s32 count = 0;
-		AllocHeader* header = alloc->head;
-		while (header)
-		{
-			count++;
-			header = header->next;
-		}
-		return count;
+		return alloc ? alloc->count : 0;
 	}
 		
 	s32 allocator_getCurPos(Allocator* alloc)
 	{
 		if (!alloc) { return -1; }
-
-		s32 index = 0;
-		AllocHeader* iter = alloc->iter;
-		AllocHeader* header = alloc->head;
-		while (header)
-		{
-			if (header == iter)
-			{
-				return index;
-			}
-			index++;
-			header = header->next;
-		}
-		return -1;
+		return allocator_findHeader(alloc, alloc->iter);
 	}
 
 	void allocator_setPos(Allocator* alloc, s32 pos)
 	{
 		if (!alloc) { return; }
-
-		s32 index = 0;
-		AllocHeader* header = alloc->head;
-		alloc->iter = nullptr;
-		while (header)
-		{
-			if (index == pos)
-			{
-				alloc->iter = header;
-				break;
-			}
-			index++;
-			header = header->next;
-		}
+		alloc->iter = allocator_getHeader(alloc, pos);
 	}
 		
 	s32 allocator_getPrevPos(Allocator* alloc)
 	{
 		if (!alloc) { return -1; }
-
-		s32 index = 0;
-		AllocHeader* iterPrev = alloc->iterPrev;
-		AllocHeader* header = alloc->head;
-		while (header)
-		{
-			if (header == iterPrev)
-			{
-				return index;
-			}
-			index++;
-			header = header->next;
-		}
-		return -1;
+		return allocator_findHeader(alloc, alloc->iterPrev);
 	}
 
 	void allocator_setPrevPos(Allocator* alloc, s32 pos)
 	{
 		if (!alloc) { return; }
 
-		s32 index = 0;
-		AllocHeader* header = alloc->head;
-		while (header)
+		AllocHeader* header = allocator_getHeader(alloc, pos);
+		if (header)
 		{
-			if (index == pos)
-			{
-				alloc->iterPrev = header;
-				break;
-			}
-			index++;
-			header = header->next;
+			alloc->iterPrev = header;
 		}
 	}
 
 	s32 allocator_getIndex(Allocator* alloc, void* item)
 	{
 		if (!item || !alloc) { return -1; }
-
-		AllocHeader* header = alloc->head;
-		s32 index = 0;
-		while (header)
-		{
-			if (item == &(header->data))
-			{
-				return index;
-			}
-			index++;
-			header = header->next;
-		}
-		return -1;
+		return allocator_findHeader(alloc, AllocHeader_of(item));
 	}
 
 	void* allocator_getByIndex(Allocator* alloc, s32 index)
 	{
 		if (!alloc) { return nullptr; }
 
-		AllocHeader* header = alloc->head;
-		while (index > 0 && header)
-		{
-			index--;
-			header = header->next;
-		}
-
+		// Negative indices return the head.
+		AllocHeader* header = allocator_getHeader(alloc, max(index, 0));
 		alloc->iterPrev = header;
 		alloc->iter = header;
 		return GET_DATA(header);
@@ -0,0 +1,147 @@
+#include <TFE_System/profiler.h>
+#include <TFE_System/jobs.h>
+#include "rbandsFloat.h"
+#include "../rcommon.h"
+#include <vector>
+
+namespace TFE_Jedi
+{
+
+namespace RClassic_Float
+{
+	enum
+	{
+		MAX_BAND_COUNT = 16,
+	};
+
+	struct Band
+	{
+		s32 x0;
+		s32 x1;
+		std::vector<u32> cmdList;
+	};
+
+	JBool s_bandRecord = JFALSE;
+
+	static std::vector<RasterCmd> s_rasterCmds;
+	static std::vector<u8> s_columnBand;
+	static Band s_bands[MAX_BAND_COUNT];
+	static s32 s_bandCount = 0;
+
+	void bands_rasterize(void* userData, s32 index);
+
+	void bands_beginFrame(s32 bandCount)
+	{
+		const s32 width = s_maxScreenX_Pixels - s_minScreenX_Pixels + 1;
+		bandCount = min(bandCount, MAX_BAND_COUNT);
+		// Bands narrower than a few columns cost more than they save.
+		bandCount = min(bandCount, width / 16);
+		if (bandCount <= 1)
+		{
+			s_bandCount = 0;
+			s_bandRecord = JFALSE;
+			return;
+		}
+
+		s_bandCount = bandCount;
+		s_bandRecord = JTRUE;
+		s_rasterCmds.clear();
+
+		// Split the view into evenly sized bands and map each column to its band.
+		s_columnBand.resize(s_width);
+		for (s32 b = 0; b < bandCount; b++)
+		{
+			Band* band = &s_bands[b];
+			band->x0 = s_minScreenX_Pixels + width * b / bandCount;
+			band->x1 = s_minScreenX_Pixels + width * (b + 1) / bandCount - 1;
+			band->cmdList.clear();
+
+			for (s32 x = band->x0; x <= band->x1; x++)
+			{
+				s_columnBand[x] = u8(b);
+			}
+		}
+	}
+
+	void bands_endFrame()
+	{
+		if (!s_bandRecord) { return; }
+		s_bandRecord = JFALSE;
+
+		TFE_ZONE("Band Rasterize");
+		TFE_Jobs::parallelFor(bands_rasterize, nullptr, s_bandCount);
+	}
+
+	void bands_reset()
+	{
+		s_bandRecord = JFALSE;
+		s_bandCount = 0;
+		s_rasterCmds.clear();
+		s_columnBand.clear();
+		for (s32 b = 0; b < MAX_BAND_COUNT; b++)
+		{
+			s_bands[b].cmdList.clear();
+		}
+	}
+
+	RasterCmd* bands_addColumn(s32 x)
+	{
+		const u32 index = (u32)s_rasterCmds.size();
+		s_rasterCmds.emplace_back();
+		s_bands[s_columnBand[x]].cmdList.push_back(index);
+
+		RasterCmd* cmd = &s_rasterCmds.back();
+		cmd->x = x;
+		return cmd;
+	}
+
+	RasterCmd* bands_addScanline(s32 x0, s32 width)
+	{
+		const u32 index = (u32)s_rasterCmds.size();
+		s_rasterCmds.emplace_back();
+
+		// Scanlines may cross several bands.
+		const s32 b0 = s_columnBand[x0];
+		const s32 b1 = s_columnBand[x0 + width - 1];
+		for (s32 b = b0; b <= b1; b++)
+		{
+			s_bands[b].cmdList.push_back(index);
+		}
+
+		RasterCmd* cmd = &s_rasterCmds.back();
+		cmd->x = x0;
+		cmd->count = width;
+		return cmd;
+	}
+
+	// Job function: replay the commands that touch a single band, in the order they were recorded.
+	void bands_rasterize(void* userData, s32 index)
+	{
+		const Band* band = &s_bands[index];
+		const RasterCmd* cmdList = s_rasterCmds.data();
+		const size_t count = band->cmdList.size();
+		const u32* cmdIndex = band->cmdList.data();
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const RasterCmd* cmd = &cmdList[cmdIndex[i]];
+			switch (cmd->type)
+			{
+				case RCMD_WALL_COLUMN:
+				{
+					wall_drawColumnCmd(cmd);
+				} break;
+				case RCMD_SCANLINE:
+				{
+					flat_drawScanlineCmd(cmd, band->x0, band->x1);
+				} break;
+				case RCMD_POLY_COLUMN:
+				{
+					robj3d_drawColumnCmd(cmd);
+				} break;
+			}
+		}
+	}
+}  // RClassic_Float
+
+}  // TFE_Jedi
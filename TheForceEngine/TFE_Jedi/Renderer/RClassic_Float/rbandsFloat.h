@@ -0,0 +1,71 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Bands
+// Optional multi-threaded rasterization for the floating point
+// sub-renderer.
+//
+// Sector traversal still runs on the main thread, but instead of
+// writing pixels the column and scanline functions record their
+// parameters as commands. Once traversal is complete the 3D view is
+// split into vertical bands and each band replays the commands, in
+// order, clipped to its own columns on a worker thread. Since every
+// pixel receives the same writes in the same order, the output
+// matches the single-threaded path exactly.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include "fixedPoint20.h"
+
+struct TextureData;
+
+namespace TFE_Jedi
+{
+	namespace RClassic_Float
+	{
+		enum RasterCmdType
+		{
+			RCMD_WALL_COLUMN = 0,	// drawColumn_*, used by walls, sky and sprites.
+			RCMD_SCANLINE,			// drawScanline_*, used by flats and 3D object "plane" polygons.
+			RCMD_POLY_COLUMN,		// robj3d_drawColumn*, used by 3D object polygons.
+		};
+
+		struct RasterCmd
+		{
+			u8  type;
+			u8  func;			// Function index, depends on the type.
+			u8  color;			// Polygon color index.
+			s8  dither;			// Polygon dither state.
+			s32 x;				// Left-most screen column.
+			s32 count;			// Column height or scanline width.
+			s32 texParam;		// Wall column height mask or scanline texture data end.
+			u8* out;
+			const u8* tex;
+			const u8* light;
+			const TextureData* texture;
+
+			fixed44_20 u0;		// Wall column: compressed sprite column height or 0; Polygon column: U; Scanline: U
+			fixed44_20 v0;		// Column: V;    Scanline: V
+			fixed44_20 du;		// Column: dUdY; Scanline: dUdX
+			fixed44_20 dv;		// Column: dVdY; Scanline: dVdX
+			fixed44_20 i0;		// Polygon intensity.
+			fixed44_20 di;		// Polygon intensity step.
+		};
+
+		// Set to JTRUE while the main thread is recording commands.
+		extern JBool s_bandRecord;
+
+		// Starts recording the current frame if band rendering is enabled.
+		void bands_beginFrame(s32 bandCount);
+		// Rasterizes the recorded commands, returns once the 3D view is complete.
+		void bands_endFrame();
+		void bands_reset();
+
+		// Add commands, the caller fills in the parameters.
+		RasterCmd* bands_addColumn(s32 x);
+		RasterCmd* bands_addScanline(s32 x0, s32 width);
+
+		// Replay functions implemented by the rasterizers.
+		void wall_drawColumnCmd(const RasterCmd* cmd);
+		void flat_drawScanlineCmd(const RasterCmd* cmd, s32 x0, s32 x1);
+		void robj3d_drawColumnCmd(const RasterCmd* cmd);
+	}
+}
@@ -0,0 +1,179 @@
+#include "rcolumnBatchFloat.h"
+#include "../rcommon.h"
+#include <cstring>
+#include <assert.h>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define COLUMN_BATCH_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define COLUMN_BATCH_SSE2 0
+#endif
+
+namespace TFE_Jedi
+{
+
+namespace RClassic_Float
+{
+	enum
+	{
+		// Tile rows are stored as a single u64.
+		BATCH_WIDTH = 8,
+		// Maximum wall or sprite column height in pixels.
+		BATCH_MAX_COLUMN = 8192,
+	};
+
+	bool s_columnBatching = true;
+	JBool s_columnBatchActive = JFALSE;
+
+	static s32 s_batchX0 = -1;
+	static s32 s_batchYMin;
+	static s32 s_batchYMax;
+	// One entry per framebuffer row, indexed by screen y.
+	static std::vector<u64> s_batchTile;
+	// 0xff for each byte that has been written in the tile.
+	static std::vector<u64> s_batchMask;
+	static s32 s_batchTexel[BATCH_MAX_COLUMN];
+
+	void colbatch_beginFrame(JBool enable)
+	{
+		s_batchX0 = -1;
+		s_columnBatchActive = (enable && s_columnBatching && s_width >= BATCH_WIDTH) ? JTRUE : JFALSE;
+		if (s_columnBatchActive && s_batchTile.size() < size_t(s_height))
+		{
+			// New entries are zeroed and the mask is cleared on flush, so existing contents don't need to be reset.
+			s_batchTile.resize(s_height);
+			s_batchMask.resize(s_height);
+		}
+	}
+
+	void colbatch_endFrame()
+	{
+		colbatch_flush();
+		s_columnBatchActive = JFALSE;
+	}
+
+	// texel[n] = floor20(vCoord + n*vCoordStep) & texHeightMask
+	void colbatch_computeTexels(s32 count, fixed44_20 vCoord, fixed44_20 vCoordStep, s32 texHeightMask)
+	{
+		s32 n = 0;
+#if COLUMN_BATCH_SSE2
+		// Two 64-bit coordinates per step. A logical shift is fine since the mask discards the upper bits.
+		const __m128i mask = _mm_set1_epi64x(texHeightMask);
+		const __m128i step = _mm_set1_epi64x(vCoordStep * 2);
+		__m128i v = _mm_set_epi64x(vCoord + vCoordStep, vCoord);
+		for (; n + 2 <= count; n += 2, v = _mm_add_epi64(v, step))
+		{
+			const __m128i texel = _mm_and_si128(_mm_srli_epi64(v, FRAC_BITS_20), mask);
+			_mm_storel_epi64((__m128i*)&s_batchTexel[n], _mm_shuffle_epi32(texel, _MM_SHUFFLE(2, 0, 2, 0)));
+		}
+		vCoord += vCoordStep * n;
+#endif
+		for (; n < count; n++, vCoord += vCoordStep)
+		{
+			s_batchTexel[n] = floor20(vCoord) & texHeightMask;
+		}
+	}
+
+	void colbatch_addColumn(u32 flags, u8* out, s32 count, const u8* tex, const u8* light, s32 texHeightMask, fixed44_20 vCoord, fixed44_20 vCoordStep)
+	{
+		if (count <= 0) { return; }
+		assert(count <= BATCH_MAX_COLUMN);
+
+		const s32 offset = s32(out - s_display);
+		const s32 x = offset % s_width;
+		const s32 y0 = offset / s_width;
+		const s32 y1 = y0 + count - 1;
+
+		// Start a new tile if the column doesn't fit in the current one.
+		if (s_batchX0 >= 0 && (x < s_batchX0 || x >= s_batchX0 + BATCH_WIDTH))
+		{
+			colbatch_flush();
+		}
+		if (s_batchX0 < 0)
+		{
+			s_batchX0 = min(x, s_width - BATCH_WIDTH);
+			s_batchYMin = y0;
+			s_batchYMax = y1;
+		}
+		else
+		{
+			s_batchYMin = min(s_batchYMin, y0);
+			s_batchYMax = max(s_batchYMax, y1);
+		}
+
+		colbatch_computeTexels(count, vCoord, vCoordStep, texHeightMask);
+
+		// Columns are drawn from the bottom up: texel n is written to row (y1 - n).
+		u8* tileOut = (u8*)&s_batchTile[y1] + (x - s_batchX0);
+		u8* maskOut = (u8*)&s_batchMask[y1] + (x - s_batchX0);
+		const s32* texel = s_batchTexel;
+		switch (flags)
+		{
+			case 0:
+			{
+				for (s32 n = 0; n < count; n++, tileOut -= BATCH_WIDTH, maskOut -= BATCH_WIDTH)
+				{
+					*tileOut = tex[texel[n]];
+					*maskOut = 0xff;
+				}
+			} break;
+			case CBATCH_LIT:
+			{
+				for (s32 n = 0; n < count; n++, tileOut -= BATCH_WIDTH, maskOut -= BATCH_WIDTH)
+				{
+					*tileOut = light[tex[texel[n]]];
+					*maskOut = 0xff;
+				}
+			} break;
+			case CBATCH_TRANS:
+			{
+				for (s32 n = 0; n < count; n++, tileOut -= BATCH_WIDTH, maskOut -= BATCH_WIDTH)
+				{
+					const u8 c = tex[texel[n]];
+					if (c)
+					{
+						*tileOut = c;
+						*maskOut = 0xff;
+					}
+				}
+			} break;
+			case CBATCH_LIT | CBATCH_TRANS:
+			{
+				for (s32 n = 0; n < count; n++, tileOut -= BATCH_WIDTH, maskOut -= BATCH_WIDTH)
+				{
+					const u8 c = tex[texel[n]];
+					if (c)
+					{
+						*tileOut = light[c];
+						*maskOut = 0xff;
+					}
+				}
+			} break;
+		}
+	}
+
+	void colbatch_flush()
+	{
+		if (s_batchX0 < 0) { return; }
+
+		u8* out = s_display + s_batchYMin * s_width + s_batchX0;
+		const u64* tile = &s_batchTile[s_batchYMin];
+		u64* mask = &s_batchMask[s_batchYMin];
+		for (s32 y = s_batchYMin; y <= s_batchYMax; y++, out += s_width, tile++, mask++)
+		{
+			const u64 m = *mask;
+			if (!m) { continue; }
+
+			u64 row;
+			memcpy(&row, out, sizeof(u64));
+			row = (row & ~m) | (*tile & m);
+			memcpy(out, &row, sizeof(u64));
+			*mask = 0;
+		}
+		s_batchX0 = -1;
+	}
+}  // RClassic_Float
+
+}  // TFE_Jedi
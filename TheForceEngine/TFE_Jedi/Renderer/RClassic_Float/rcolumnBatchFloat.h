@@ -0,0 +1,36 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Column Batching
+// Wall and sprite columns are written one byte per row, which strides
+// through the framebuffer. When batching is enabled, adjacent columns
+// are instead rasterized into a small row-major tile which is then
+// written to the framebuffer one row at a time. Each tile pixel keeps
+// the last value written to it so the output is identical to drawing
+// the columns directly.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include "fixedPoint20.h"
+
+namespace TFE_Jedi
+{
+	namespace RClassic_Float
+	{
+		enum ColumnBatchFlags
+		{
+			CBATCH_LIT   = FLAG_BIT(0),	// Apply the column light table.
+			CBATCH_TRANS = FLAG_BIT(1),	// Texel 0 is transparent.
+		};
+
+		// Set to false to draw columns directly.
+		extern bool s_columnBatching;
+		// True while columns should be sent to the batch.
+		extern JBool s_columnBatchActive;
+
+		void colbatch_beginFrame(JBool enable);
+		void colbatch_endFrame();
+
+		void colbatch_addColumn(u32 flags, u8* out, s32 count, const u8* tex, const u8* light, s32 texHeightMask, fixed44_20 vCoord, fixed44_20 vCoordStep);
+		// Write any pending columns to the framebuffer, this must be called before anything else is drawn.
+		void colbatch_flush();
+	}
+}
@@ -6,6 +6,9 @@
 #include "redgePairFloat.h"
 #include "rclassicFloat.h"
 #include "rclassicFloatSharedState.h"
+#include "rbandsFloat.h"
+#include "rflatSimdFloat.h"
+#include "rcolumnBatchFloat.h"
 #include "fixedPoint20.h"
 #include "../rscanline.h"
 #include "../rsectorRender.h"
@@ -20,17 +23,18 @@ namespace RClassic_Float
 {
 	static s32 s_scanlineX0;
 
-	static fixed44_20 s_scanlineU0;
-	static fixed44_20 s_scanlineV0;
-	static fixed44_20 s_scanline_dUdX;
-	static fixed44_20 s_scanline_dVdX;
+	// Scanline state is per-thread so that recorded scanlines can be replayed by the band workers.
+	static thread_local fixed44_20 s_scanlineU0;
+	static thread_local fixed44_20 s_scanlineV0;
+	static thread_local fixed44_20 s_scanline_dUdX;
+	static thread_local fixed44_20 s_scanline_dVdX;
 
-	static s32 s_scanlineWidth;
-	static const u8* s_scanlineLight;
-	static u8* s_scanlineOut;
+	static thread_local s32 s_scanlineWidth;
+	static thread_local const u8* s_scanlineLight;
+	static thread_local u8* s_scanlineOut;
 
-	static u8* s_ftexImage;
-	static s32 s_ftexDataEnd;
+	static thread_local u8* s_ftexImage;
+	static thread_local s32 s_ftexDataEnd;
 	static s32 s_ftexHeight;
 	static s32 s_ftexWidthMask;
 	static s32 s_ftexHeightMask;
@@ -77,10 +81,48 @@ namespace RClassic_Float
 		}
 	}
 				
+	// Record the current scanline for band rendering instead of drawing it.
+	void flat_recordScanline(ScanlineFuncId func)
+	{
+		RasterCmd* cmd = bands_addScanline(s_scanlineX0, s_scanlineWidth);
+		cmd->type = RCMD_SCANLINE;
+		cmd->func = u8(func);
+		cmd->texParam = s_ftexDataEnd;
+		cmd->out = s_scanlineOut;
+		cmd->tex = s_ftexImage;
+		cmd->light = s_scanlineLight;
+		cmd->u0 = s_scanlineU0;
+		cmd->v0 = s_scanlineV0;
+		cmd->du = s_scanline_dUdX;
+		cmd->dv = s_scanline_dVdX;
+	}
+
+	// Draw the current scanline using a SIMD kernel if one is available, returns false if the scalar path should be used.
+	bool flat_drawScanlineSimd(ScanlineFuncId func)
+	{
+		if (!s_scanlineSimd || !s_scanlineKernel[func] || s_scanlineWidth < SCANLINE_SIMD_MIN_WIDTH) { return false; }
+
+		ScanlineArgs args;
+		args.out = s_scanlineOut;
+		args.width = s_scanlineWidth;
+		args.U0 = s_scanlineU0;
+		args.V0 = s_scanlineV0;
+		args.dUdX = s_scanline_dUdX;
+		args.dVdX = s_scanline_dVdX;
+		args.tex = s_ftexImage;
+		args.texDataEnd = s_ftexDataEnd;
+		args.light = s_scanlineLight;
+		s_scanlineKernel[func](&args);
+		return true;
+	}
+
 	// This produces functionally identical results to the original but splits apart the U/V and dUdx/dVdx into seperate variables
 	// to account for C vs ASM differences.
 	void drawScanline()
 	{
+		if (s_bandRecord) { flat_recordScanline(SCANFUNC_LIT); return; }
+		if (flat_drawScanlineSimd(SCANFUNC_LIT)) { return; }
+
 		const fixed44_20 dVdX = s_scanline_dVdX;
 		const fixed44_20 dUdX = s_scanline_dUdX;
 		fixed44_20 V = s_scanlineV0;
@@ -97,6 +139,9 @@ namespace RClassic_Float
 
 	void drawScanline_Fullbright()
 	{
+		if (s_bandRecord) { flat_recordScanline(SCANFUNC_FULLBRIGHT); return; }
+		if (flat_drawScanlineSimd(SCANFUNC_FULLBRIGHT)) { return; }
+
 		const fixed44_20 dVdX = s_scanline_dVdX;
 		const fixed44_20 dUdX = s_scanline_dUdX;
 		fixed44_20 V = s_scanlineV0;
@@ -113,6 +158,9 @@ namespace RClassic_Float
 
 	void drawScanline_Trans()
 	{
+		if (s_bandRecord) { flat_recordScanline(SCANFUNC_LIT_TRANS); return; }
+		if (flat_drawScanlineSimd(SCANFUNC_LIT_TRANS)) { return; }
+
 		const fixed44_20 dVdX = s_scanline_dVdX;
 		const fixed44_20 dUdX = s_scanline_dUdX;
 		fixed44_20 V = s_scanlineV0;
@@ -131,6 +179,9 @@ namespace RClassic_Float
 
 	void drawScanline_Fullbright_Trans()
 	{
+		if (s_bandRecord) { flat_recordScanline(SCANFUNC_FULLBRIGHT_TRANS); return; }
+		if (flat_drawScanlineSimd(SCANFUNC_FULLBRIGHT_TRANS)) { return; }
+
 		const fixed44_20 dVdX = s_scanline_dVdX;
 		const fixed44_20 dUdX = s_scanline_dUdX;
 		fixed44_20 V = s_scanlineV0;
@@ -163,6 +214,7 @@ namespace RClassic_Float
 	
 	void flat_drawCeiling(SectorCached* sectorCached, EdgePairFloat* edges, s32 count)
 	{
+		colbatch_flush();
 		f32 textureOffsetU = s_rcfltState.cameraPos.x - sectorCached->ceilOffset.x;
 		f32 textureOffsetV = sectorCached->ceilOffset.z - s_rcfltState.cameraPos.z;
 
@@ -227,6 +279,7 @@ namespace RClassic_Float
 		
 	void flat_drawFloor(SectorCached* sectorCached, EdgePairFloat* edges, s32 count)
 	{
+		colbatch_flush();
 		f32 textureOffsetU = s_rcfltState.cameraPos.x - sectorCached->floorOffset.x;
 		f32 textureOffsetV = sectorCached->floorOffset.z - s_rcfltState.cameraPos.z;
 
@@ -304,6 +357,29 @@ namespace RClassic_Float
 		drawScanline_Fullbright_Trans
 	};
 
+	// Replay the part of a recorded scanline that overlaps columns [x0, x1] on the current thread.
+	void flat_drawScanlineCmd(const RasterCmd* cmd, s32 x0, s32 x1)
+	{
+		// Scanlines are drawn from right to left, so pixel 'i' has U = U0 + (width - 1 - i) * dUdX.
+		// The fixed point steps are exact so the clipped scanline writes the same texels as the full scanline.
+		const s32 left  = max(x0 - cmd->x, 0);
+		const s32 right = min(x1 - cmd->x, cmd->count - 1);
+		if (left > right) { return; }
+
+		const s32 skip = cmd->count - 1 - right;
+		s_scanlineWidth = right - left + 1;
+		s_scanlineOut = cmd->out + left;
+		s_scanlineLight = cmd->light;
+		s_ftexImage = (u8*)cmd->tex;
+		s_ftexDataEnd = cmd->texParam;
+		s_scanlineU0 = cmd->u0 + cmd->du * skip;
+		s_scanlineV0 = cmd->v0 + cmd->dv * skip;
+		s_scanline_dUdX = cmd->du;
+		s_scanline_dVdX = cmd->dv;
+
+		c_scanlineDrawFunc[cmd->func]();
+	}
+
 	static f32 s_poly_offsetX;
 	static f32 s_poly_offsetZ;
 
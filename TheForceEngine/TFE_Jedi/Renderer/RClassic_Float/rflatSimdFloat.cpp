@@ -0,0 +1,213 @@
+#include <TFE_System/system.h>
+#include "rflatSimdFloat.h"
+#include <SDL_cpuinfo.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define FLAT_SIMD_X86 1
+	#include <immintrin.h>
+
+	// MSVC allows any intrinsic to be used, GCC and Clang need the instruction set enabled per function.
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#define TARGET_SSE41
+		#define TARGET_AVX2
+	#else
+		#define TARGET_SSE41 __attribute__((target("sse4.1")))
+		#define TARGET_AVX2  __attribute__((target("avx2")))
+	#endif
+#else
+	#define FLAT_SIMD_X86 0
+#endif
+
+namespace TFE_Jedi
+{
+
+namespace RClassic_Float
+{
+	bool s_scanlineSimd = true;
+	ScanlineKernel s_scanlineKernel[SCANFUNC_COUNT] = { nullptr };
+
+#if FLAT_SIMD_X86
+	// Only bits 20 - 25 of U and V are used to compute the texel, so the coordinates can be
+	// stepped using wrapping 32-bit math and still match the 44.20 scalar code exactly.
+
+	// Draw out[0, count), which is the left-most part of the scanline, using the scalar path.
+	template<s32 FUNC>
+	void scanline_drawScalar(const ScanlineArgs* args, s32 count)
+	{
+		const s32 skip = args->width - count;
+		const fixed44_20 dUdX = args->dUdX;
+		const fixed44_20 dVdX = args->dVdX;
+		fixed44_20 U = args->U0 + dUdX * skip;
+		fixed44_20 V = args->V0 + dVdX * skip;
+
+		for (s32 i = count - 1; i >= 0; i--, U += dUdX, V += dVdX)
+		{
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & args->texDataEnd;
+			const u8 baseColor = args->tex[texel];
+			switch (FUNC)
+			{
+				case SCANFUNC_LIT:
+					args->out[i] = args->light[baseColor];
+					break;
+				case SCANFUNC_FULLBRIGHT:
+					args->out[i] = baseColor;
+					break;
+				case SCANFUNC_LIT_TRANS:
+					if (baseColor) { args->out[i] = args->light[baseColor]; }
+					break;
+				case SCANFUNC_FULLBRIGHT_TRANS:
+					if (baseColor) { args->out[i] = baseColor; }
+					break;
+			}
+		}
+	}
+
+	// Fetch and write 'count' pixels (8 or 16) given the texel indices.
+	// Transparent pixels keep the existing output using a masked blend.
+	template<s32 FUNC, s32 count>
+	TARGET_SSE41 inline void scanline_writeBlock(u8* out, const s32* texel, const u8* tex, const u8* light)
+	{
+		alignas(16) u8 baseColor[count];
+		alignas(16) u8 color[count];
+		for (s32 k = 0; k < count; k++)
+		{
+			baseColor[k] = tex[texel[k]];
+		}
+		if (FUNC == SCANFUNC_LIT || FUNC == SCANFUNC_LIT_TRANS)
+		{
+			for (s32 k = 0; k < count; k++)
+			{
+				color[k] = light[baseColor[k]];
+			}
+		}
+		const u8* src = (FUNC == SCANFUNC_LIT || FUNC == SCANFUNC_LIT_TRANS) ? color : baseColor;
+
+		if (FUNC == SCANFUNC_LIT || FUNC == SCANFUNC_FULLBRIGHT)
+		{
+			for (s32 k = 0; k < count; k++)
+			{
+				out[k] = src[k];
+			}
+		}
+		else if (count == 8)
+		{
+			const __m128i base = _mm_loadl_epi64((const __m128i*)baseColor);
+			const __m128i transparent = _mm_cmpeq_epi8(base, _mm_setzero_si128());
+			const __m128i result = _mm_blendv_epi8(_mm_loadl_epi64((const __m128i*)src), _mm_loadl_epi64((const __m128i*)out), transparent);
+			_mm_storel_epi64((__m128i*)out, result);
+		}
+		else
+		{
+			const __m128i base = _mm_load_si128((const __m128i*)baseColor);
+			const __m128i transparent = _mm_cmpeq_epi8(base, _mm_setzero_si128());
+			const __m128i result = _mm_blendv_epi8(_mm_load_si128((const __m128i*)src), _mm_loadu_si128((const __m128i*)out), transparent);
+			_mm_storeu_si128((__m128i*)out, result);
+		}
+	}
+
+	TARGET_SSE41 inline __m128i scanline_computeTexel4(__m128i u, __m128i v, __m128i texDataEnd)
+	{
+		const __m128i mask = _mm_set1_epi32(63);
+		const __m128i tu = _mm_and_si128(_mm_srli_epi32(u, FRAC_BITS_20), mask);
+		const __m128i tv = _mm_and_si128(_mm_srli_epi32(v, FRAC_BITS_20), mask);
+		return _mm_and_si128(_mm_or_si128(_mm_slli_epi32(tu, 6), tv), texDataEnd);
+	}
+
+	// 8 pixels per iteration.
+	template<s32 FUNC>
+	TARGET_SSE41 void scanline_sse41(const ScanlineArgs* args)
+	{
+		const u32 dU = u32(args->dUdX);
+		const u32 dV = u32(args->dVdX);
+		// Lane k of a block maps to out[x + k], which is (7 - k) steps past out[x + 7].
+		const __m128i stepU0 = _mm_setr_epi32(s32(7*dU), s32(6*dU), s32(5*dU), s32(4*dU));
+		const __m128i stepU1 = _mm_setr_epi32(s32(3*dU), s32(2*dU), s32(dU), 0);
+		const __m128i stepV0 = _mm_setr_epi32(s32(7*dV), s32(6*dV), s32(5*dV), s32(4*dV));
+		const __m128i stepV1 = _mm_setr_epi32(s32(3*dV), s32(2*dV), s32(dV), 0);
+		const __m128i texDataEnd = _mm_set1_epi32(args->texDataEnd);
+
+		alignas(16) s32 texel[8];
+		u32 U = u32(args->U0);
+		u32 V = u32(args->V0);
+		s32 x = args->width - 8;
+		for (; x >= 0; x -= 8, U += 8*dU, V += 8*dV)
+		{
+			const __m128i u = _mm_set1_epi32(s32(U));
+			const __m128i v = _mm_set1_epi32(s32(V));
+			_mm_store_si128((__m128i*)&texel[0], scanline_computeTexel4(_mm_add_epi32(u, stepU0), _mm_add_epi32(v, stepV0), texDataEnd));
+			_mm_store_si128((__m128i*)&texel[4], scanline_computeTexel4(_mm_add_epi32(u, stepU1), _mm_add_epi32(v, stepV1), texDataEnd));
+			scanline_writeBlock<FUNC, 8>(args->out + x, texel, args->tex, args->light);
+		}
+		scanline_drawScalar<FUNC>(args, x + 8);
+	}
+
+	TARGET_AVX2 inline __m256i scanline_computeTexel8(__m256i u, __m256i v, __m256i texDataEnd)
+	{
+		const __m256i mask = _mm256_set1_epi32(63);
+		const __m256i tu = _mm256_and_si256(_mm256_srli_epi32(u, FRAC_BITS_20), mask);
+		const __m256i tv = _mm256_and_si256(_mm256_srli_epi32(v, FRAC_BITS_20), mask);
+		return _mm256_and_si256(_mm256_or_si256(_mm256_slli_epi32(tu, 6), tv), texDataEnd);
+	}
+
+	// 16 pixels per iteration.
+	template<s32 FUNC>
+	TARGET_AVX2 void scanline_avx2(const ScanlineArgs* args)
+	{
+		const u32 dU = u32(args->dUdX);
+		const u32 dV = u32(args->dVdX);
+		// Lane k of a block maps to out[x + k], which is (15 - k) steps past out[x + 15].
+		const __m256i scale0 = _mm256_setr_epi32(15, 14, 13, 12, 11, 10, 9, 8);
+		const __m256i scale1 = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+		const __m256i dUv = _mm256_set1_epi32(s32(dU));
+		const __m256i dVv = _mm256_set1_epi32(s32(dV));
+		const __m256i stepU0 = _mm256_mullo_epi32(scale0, dUv);
+		const __m256i stepU1 = _mm256_mullo_epi32(scale1, dUv);
+		const __m256i stepV0 = _mm256_mullo_epi32(scale0, dVv);
+		const __m256i stepV1 = _mm256_mullo_epi32(scale1, dVv);
+		const __m256i texDataEnd = _mm256_set1_epi32(args->texDataEnd);
+
+		alignas(32) s32 texel[16];
+		u32 U = u32(args->U0);
+		u32 V = u32(args->V0);
+		s32 x = args->width - 16;
+		for (; x >= 0; x -= 16, U += 16*dU, V += 16*dV)
+		{
+			const __m256i u = _mm256_set1_epi32(s32(U));
+			const __m256i v = _mm256_set1_epi32(s32(V));
+			_mm256_store_si256((__m256i*)&texel[0], scanline_computeTexel8(_mm256_add_epi32(u, stepU0), _mm256_add_epi32(v, stepV0), texDataEnd));
+			_mm256_store_si256((__m256i*)&texel[8], scanline_computeTexel8(_mm256_add_epi32(u, stepU1), _mm256_add_epi32(v, stepV1), texDataEnd));
+			scanline_writeBlock<FUNC, 16>(args->out + x, texel, args->tex, args->light);
+		}
+		scanline_drawScalar<FUNC>(args, x + 16);
+	}
+#endif
+
+	void flat_initScanlineKernels()
+	{
+		for (s32 i = 0; i < SCANFUNC_COUNT; i++)
+		{
+			s_scanlineKernel[i] = nullptr;
+		}
+
+#if FLAT_SIMD_X86
+		if (SDL_HasAVX2())
+		{
+			s_scanlineKernel[SCANFUNC_LIT] = scanline_avx2<SCANFUNC_LIT>;
+			s_scanlineKernel[SCANFUNC_FULLBRIGHT] = scanline_avx2<SCANFUNC_FULLBRIGHT>;
+			s_scanlineKernel[SCANFUNC_LIT_TRANS] = scanline_avx2<SCANFUNC_LIT_TRANS>;
+			s_scanlineKernel[SCANFUNC_FULLBRIGHT_TRANS] = scanline_avx2<SCANFUNC_FULLBRIGHT_TRANS>;
+			TFE_System::logWrite(LOG_MSG, "Renderer", "Using AVX2 flat scanlines.");
+		}
+		else if (SDL_HasSSE41())
+		{
+			s_scanlineKernel[SCANFUNC_LIT] = scanline_sse41<SCANFUNC_LIT>;
+			s_scanlineKernel[SCANFUNC_FULLBRIGHT] = scanline_sse41<SCANFUNC_FULLBRIGHT>;
+			s_scanlineKernel[SCANFUNC_LIT_TRANS] = scanline_sse41<SCANFUNC_LIT_TRANS>;
+			s_scanlineKernel[SCANFUNC_FULLBRIGHT_TRANS] = scanline_sse41<SCANFUNC_FULLBRIGHT_TRANS>;
+			TFE_System::logWrite(LOG_MSG, "Renderer", "Using SSE4.1 flat scanlines.");
+		}
+#endif
+	}
+}  // RClassic_Float
+
+}  // TFE_Jedi
@@ -0,0 +1,55 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Flat SIMD
+// Vectorized versions of the flat scanline functions.
+//
+// The kernels are selected at runtime based on the CPU features and
+// produce the same output as the scalar functions in rflatFloat.cpp,
+// which remain the reference implementation.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include "fixedPoint20.h"
+
+namespace TFE_Jedi
+{
+	namespace RClassic_Float
+	{
+		// Scanline functions, in the same order as c_scanlineDrawFunc[].
+		enum ScanlineFuncId
+		{
+			SCANFUNC_LIT = 0,
+			SCANFUNC_FULLBRIGHT,
+			SCANFUNC_LIT_TRANS,
+			SCANFUNC_FULLBRIGHT_TRANS,
+			SCANFUNC_COUNT
+		};
+
+		struct ScanlineArgs
+		{
+			u8* out;
+			s32 width;
+			fixed44_20 U0;		// U at out[width - 1], scanlines are drawn from right to left.
+			fixed44_20 V0;
+			fixed44_20 dUdX;
+			fixed44_20 dVdX;
+			const u8* tex;
+			s32 texDataEnd;
+			const u8* light;
+		};
+		typedef void(*ScanlineKernel)(const ScanlineArgs* args);
+
+		enum
+		{
+			// Shorter scanlines are not worth the setup cost.
+			SCANLINE_SIMD_MIN_WIDTH = 16,
+		};
+
+		// Set to false to force the scalar functions.
+		extern bool s_scanlineSimd;
+		// Kernels for the current CPU, null if the scalar function should be used.
+		extern ScanlineKernel s_scanlineKernel[SCANFUNC_COUNT];
+
+		// Select the kernels based on the CPU features.
+		void flat_initScanlineKernels();
+	}
+}
@@ -12,6 +12,8 @@
 #include "robj3dFloat_Clipping.h"
 #include "robj3dFloat_PolygonDraw.h"
 #include "../rclassicFloatSharedState.h"
+#include "../rbandsFloat.h"
+#include "../rcolumnBatchFloat.h"
 #include "../../rcommon.h"
 
 namespace TFE_Jedi
@@ -27,6 +29,9 @@ namespace RClassic_Float
 
 	void robj3d_draw(SecObject* obj, JediModel* model)
 	{
+		// Pending wall and sprite columns must be written before the object is drawn on top of them.
+		colbatch_flush();
+
 		// Handle transforms and vertex lighting.
 		robj3d_transformAndLight(obj, model);
 
@@ -111,7 +116,14 @@ namespace RClassic_Float
 			{
 				const s32 x = clamp(pixel_x - halfSize + (i % size), s_minScreenX_Pixels, s_maxScreenX_Pixels);
 				const s32 y = clamp(pixel_y - halfSize + (i / size), s_windowMinY_Pixels, s_windowMaxY_Pixels);
-				s_display[y*s_width + x] = color;
+				if (s_bandRecord)
+				{
+					robj3d_recordPixel(x, y, color);
+				}
+				else
+				{
+					s_display[y*s_width + x] = color;
+				}
 			}
 		}
 	}
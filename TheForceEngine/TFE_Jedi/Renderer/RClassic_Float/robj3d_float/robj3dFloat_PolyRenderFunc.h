@@ -169,6 +169,8 @@ s32 robj3d_findPrevEdge(s32 minXIndex)
 #if !defined(POLY_INTENSITY) && !defined(POLY_UV)
 void robj3d_drawColumnFlatColor()
 {
+	if (s_bandRecord) { robj3d_recordColumn(POLYCOL_FLAT_COLOR); return; }
+
 	s32 end = s_columnHeight - 1;
 	s32 offset = end * s_width;
 	for (s32 i = end; i >= 0; i--, offset -= s_width)
@@ -181,6 +183,8 @@ void robj3d_drawColumnFlatColor()
 #if defined(POLY_INTENSITY) && !defined(POLY_UV)
 void robj3d_drawColumnShadedColor()
 {
+	if (s_bandRecord) { robj3d_recordColumn(POLYCOL_SHADED_COLOR); return; }
+
 	const u8* colorMap = s_polyColorMap;
 
 	fixed44_20 intensity = s_col_I0;
@@ -211,6 +215,8 @@ void robj3d_drawColumnShadedColor()
 #if !defined(POLY_INTENSITY) && defined(POLY_UV)
 void robj3d_drawColumnFlatTexture()
 {
+	if (s_bandRecord) { robj3d_recordColumn(POLYCOL_FLAT_TEXTURE); return; }
+
 	const u8* colorMap = &s_polyColorMap[s_polyColorIndex * 256];
 	const u8* textureData = s_polyTexture->image;
 	const s32 texHeight = s_polyTexture->height;
@@ -236,6 +242,8 @@ void robj3d_drawColumnFlatTexture()
 #if defined(POLY_INTENSITY) && defined(POLY_UV)
 void robj3d_drawColumnShadedTexture()
 {
+	if (s_bandRecord) { robj3d_recordColumn(POLYCOL_SHADED_TEXTURE); return; }
+
 	const u8* colorMap = s_polyColorMap;
 	const u8* textureData = s_polyTexture->image;
 	const s32 texHeight = s_polyTexture->height;
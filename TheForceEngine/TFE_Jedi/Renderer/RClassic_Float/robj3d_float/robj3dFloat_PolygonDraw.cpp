@@ -13,6 +13,7 @@
 #include "../rsectorFloat.h"
 #include "../rflatFloat.h"
 #include "../rclassicFloatSharedState.h"
+#include "../rbandsFloat.h"
 #include "../rlightingFloat.h"
 #include "../../rcommon.h"
 
@@ -30,29 +31,30 @@ namespace RClassic_Float
 	// Polygon Drawing
 	////////////////////////////////////////////////
 	// Polygon
-	static u8  s_polyColorIndex;
+	// State read by the column functions is per-thread so that recorded columns can be replayed by the band workers.
+	static thread_local u8  s_polyColorIndex;
 	static s32 s_polyVertexCount;
 	static s32 s_polyMaxIndex;
 	static f32* s_polyIntensity;
 	static vec2_float* s_polyUv;
 	static vec3_float* s_polyProjVtx;
-	static const u8*   s_polyColorMap;
-	static TextureData* s_polyTexture;
+	static thread_local const u8*   s_polyColorMap;
+	static thread_local TextureData* s_polyTexture;
 
 	// Column
 	static s32 s_columnX;
 	static s32 s_rowY;
-	static s32 s_columnHeight;
-	static s32 s_dither;
-	static u8* s_pcolumnOut;
+	static thread_local s32 s_columnHeight;
+	static thread_local s32 s_dither;
+	static thread_local u8* s_pcolumnOut;
 		
-	static fixed44_20 s_col_I0;
-	static fixed44_20 s_col_dIdY;
-	static vec2_fixed20 s_col_Uv0;
-	static vec2_fixed20 s_col_dUVdY;
+	static thread_local fixed44_20 s_col_I0;
+	static thread_local fixed44_20 s_col_dIdY;
+	static thread_local vec2_fixed20 s_col_Uv0;
+	static thread_local vec2_fixed20 s_col_dUVdY;
 
 	// Polygon Edges
-	static fixed44_20  s_ditherOffset;
+	static thread_local fixed44_20  s_ditherOffset;
 	// Bottom Edge
 	static f32  s_edgeBot_Z0;
 	static f32  s_edgeBot_dZdX;
@@ -95,6 +97,34 @@ namespace RClassic_Float
 	static s32 s_edgeLeftLength;
 	static s32 s_edgeRightLength;
 
+	enum PolyColumnFuncId
+	{
+		POLYCOL_FLAT_COLOR = 0,
+		POLYCOL_SHADED_COLOR,
+		POLYCOL_FLAT_TEXTURE,
+		POLYCOL_SHADED_TEXTURE,
+	};
+
+	// Record the current polygon column for band rendering instead of drawing it.
+	void robj3d_recordColumn(PolyColumnFuncId func)
+	{
+		RasterCmd* cmd = bands_addColumn(s32((s_pcolumnOut - s_display) % s_width));
+		cmd->type = RCMD_POLY_COLUMN;
+		cmd->func = u8(func);
+		cmd->color = s_polyColorIndex;
+		cmd->dither = s8(s_dither);
+		cmd->count = s_columnHeight;
+		cmd->out = s_pcolumnOut;
+		cmd->light = s_polyColorMap;
+		cmd->texture = s_polyTexture;
+		cmd->u0 = s_col_Uv0.x;
+		cmd->v0 = s_col_Uv0.z;
+		cmd->du = s_col_dUVdY.x;
+		cmd->dv = s_col_dUVdY.z;
+		cmd->i0 = s_col_I0;
+		cmd->di = s_col_dIdY;
+	}
+
 	u8 robj3d_computePolygonColor(vec3_float* normal, u8 color, f32 z)
 	{
 		if (s_sectorAmbient >= 31) { return color; }
@@ -202,6 +232,51 @@ namespace RClassic_Float
 	#define POLY_INTENSITY
 	#include "robj3dFloat_PolyRenderFunc.h"
 
+	// Record a single pixel, used for vertex rendering.
+	void robj3d_recordPixel(s32 x, s32 y, u8 color)
+	{
+		RasterCmd* cmd = bands_addColumn(x);
+		cmd->type = RCMD_POLY_COLUMN;
+		cmd->func = POLYCOL_FLAT_COLOR;
+		cmd->color = color;
+		cmd->count = 1;
+		cmd->out = &s_display[y*s_width + x];
+	}
+
+	// Replay a recorded polygon column on the current thread.
+	void robj3d_drawColumnCmd(const RasterCmd* cmd)
+	{
+		s_polyColorIndex = cmd->color;
+		s_dither = cmd->dither;
+		s_columnHeight = cmd->count;
+		s_pcolumnOut = cmd->out;
+		s_polyColorMap = cmd->light;
+		s_polyTexture = (TextureData*)cmd->texture;
+		s_col_Uv0.x = cmd->u0;
+		s_col_Uv0.z = cmd->v0;
+		s_col_dUVdY.x = cmd->du;
+		s_col_dUVdY.z = cmd->dv;
+		s_col_I0 = cmd->i0;
+		s_col_dIdY = cmd->di;
+		s_ditherOffset = HALF_20;
+
+		switch (cmd->func)
+		{
+			case POLYCOL_FLAT_COLOR:
+				robj3d_drawColumnFlatColor();
+				break;
+			case POLYCOL_SHADED_COLOR:
+				robj3d_drawColumnShadedColor();
+				break;
+			case POLYCOL_FLAT_TEXTURE:
+				robj3d_drawColumnFlatTexture();
+				break;
+			case POLYCOL_SHADED_TEXTURE:
+				robj3d_drawColumnShadedTexture();
+				break;
+		}
+	}
+
 	////////////////////////////////////////////
 	// Polygon Draw Routine for Shading = PLANE
 	// and support functions.
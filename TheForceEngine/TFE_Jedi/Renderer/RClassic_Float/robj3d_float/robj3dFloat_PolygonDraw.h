@@ -15,5 +15,6 @@ namespace TFE_Jedi
 	namespace RClassic_Float
 	{
 		void robj3d_drawPolygon(JmPolygon* polygon, s32 polyVertexCount, SecObject* obj, JediModel* model);
+		void robj3d_recordPixel(s32 x, s32 y, u8 color);
 	}
 }
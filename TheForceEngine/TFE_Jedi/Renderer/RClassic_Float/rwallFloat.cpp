@@ -12,6 +12,8 @@
 #include "rsectorFloat.h"
 #include "redgePairFloat.h"
 #include "rclassicFloatSharedState.h"
+#include "rbandsFloat.h"
+#include "rcolumnBatchFloat.h"
 #include "../rcommon.h"
 #include "../jediRenderer.h"
 
@@ -29,14 +31,18 @@ namespace RClassic_Float
 	};
 
 	static f32 s_segmentCross;
-	static s32 s_texHeightMask;
-	static s32 s_yPixelCount;
-	static fixed44_20 s_vCoordStep;
-	static fixed44_20 s_vCoordFixed;
-	static const u8* s_columnLight;
-	static u8* s_texImage;
-	static u8* s_columnOut;
-	static u8  s_workBuffer[WAX_DECOMPRESS_SIZE];
+	// Column state is per-thread so that recorded columns can be replayed by the band workers.
+	static thread_local s32 s_texHeightMask;
+	static thread_local s32 s_yPixelCount;
+	static thread_local fixed44_20 s_vCoordStep;
+	static thread_local fixed44_20 s_vCoordFixed;
+	static thread_local const u8* s_columnLight;
+	static thread_local u8* s_texImage;
+	static thread_local u8* s_columnOut;
+	static thread_local u8  s_workBuffer[WAX_DECOMPRESS_SIZE];
+	// Height of the compressed sprite column in s_texImage, 0 if the column is not compressed.
+	// This is only used when recording band commands, otherwise columns are decompressed immediately.
+	static s32 s_texCompressedHeight = 0;
 
 	s32 segmentCrossesLine(f32 ax0, f32 ay0, f32 ax1, f32 ay1, f32 bx0, f32 by0, f32 bx1, f32 by1);
 	f32 solveForZ_Numerator(RWallSegmentFloat* wallSegment);
@@ -2140,8 +2146,53 @@ namespace RClassic_Float
 		return z;
 	}
 
+	// Record the current column for band rendering instead of drawing it.
+	void wall_recordColumn(ColumnFuncId func)
+	{
+		RasterCmd* cmd = bands_addColumn(s32((s_columnOut - s_display) % s_width));
+		cmd->type = RCMD_WALL_COLUMN;
+		cmd->func = u8(func);
+		cmd->count = s_yPixelCount;
+		cmd->texParam = s_texHeightMask;
+		cmd->out = s_columnOut;
+		cmd->tex = s_texImage;
+		cmd->light = s_columnLight;
+		cmd->u0 = s_texCompressedHeight;
+		cmd->v0 = s_vCoordFixed;
+		cmd->dv = s_vCoordStep;
+	}
+
+	// Replay a recorded column on the current thread.
+	void wall_drawColumnCmd(const RasterCmd* cmd)
+	{
+		s_yPixelCount = cmd->count;
+		s_texHeightMask = cmd->texParam;
+		s_columnOut = cmd->out;
+		s_columnLight = cmd->light;
+		s_vCoordFixed = cmd->v0;
+		s_vCoordStep = cmd->dv;
+		if (cmd->u0)
+		{
+			// Compressed sprite columns are decompressed here since the work buffer is per-thread.
+			sprite_decompressColumn(cmd->tex, s_workBuffer, s32(cmd->u0));
+			s_texImage = s_workBuffer;
+		}
+		else
+		{
+			s_texImage = (u8*)cmd->tex;
+		}
+		s_columnFunc[cmd->func]();
+	}
+
 	void drawColumn_Fullbright()
 	{
+		if (s_bandRecord) { wall_recordColumn(COLFUNC_FULLBRIGHT); return; }
+		if (s_columnBatchActive)
+		{
+			colbatch_addColumn(0, s_columnOut, s_yPixelCount, s_texImage, s_columnLight, s_texHeightMask, s_vCoordFixed, s_vCoordStep);
+			return;
+		}
+
 		fixed44_20 vCoordFixed = s_vCoordFixed;
 		const u8* tex = s_texImage;
 		const s32 end = s_yPixelCount - 1;
@@ -2156,6 +2207,13 @@ namespace RClassic_Float
 
 	void drawColumn_Lit()
 	{
+		if (s_bandRecord) { wall_recordColumn(COLFUNC_LIT); return; }
+		if (s_columnBatchActive)
+		{
+			colbatch_addColumn(CBATCH_LIT, s_columnOut, s_yPixelCount, s_texImage, s_columnLight, s_texHeightMask, s_vCoordFixed, s_vCoordStep);
+			return;
+		}
+
 		fixed44_20 vCoordFixed = s_vCoordFixed;
 		const u8* tex = s_texImage;
 		const s32 end = s_yPixelCount - 1;
@@ -2170,6 +2228,13 @@ namespace RClassic_Float
 
 	void drawColumn_Fullbright_Trans()
 	{
+		if (s_bandRecord) { wall_recordColumn(COLFUNC_FULLBRIGHT_TRANS); return; }
+		if (s_columnBatchActive)
+		{
+			colbatch_addColumn(CBATCH_TRANS, s_columnOut, s_yPixelCount, s_texImage, s_columnLight, s_texHeightMask, s_vCoordFixed, s_vCoordStep);
+			return;
+		}
+
 		fixed44_20 vCoordFixed = s_vCoordFixed;
 		const u8* tex = s_texImage;
 		const s32 end = s_yPixelCount - 1;
@@ -2185,6 +2250,13 @@ namespace RClassic_Float
 
 	void drawColumn_Lit_Trans()
 	{
+		if (s_bandRecord) { wall_recordColumn(COLFUNC_LIT_TRANS); return; }
+		if (s_columnBatchActive)
+		{
+			colbatch_addColumn(CBATCH_LIT | CBATCH_TRANS, s_columnOut, s_yPixelCount, s_texImage, s_columnLight, s_texHeightMask, s_vCoordFixed, s_vCoordStep);
+			return;
+		}
+
 		fixed44_20 vCoordFixed = s_vCoordFixed;
 		const u8* tex = s_texImage;
 		const s32 end = s_yPixelCount - 1;
@@ -2363,11 +2435,19 @@ namespace RClassic_Float
 					if (compressed)
 					{
 						const u8* colPtr = (u8*)cell + columnOffset[texelU];
-
-						// Decompress the column into "work buffer."
 						assert(cell->sizeY <= 1024 && texelU >= 0 && texelU < cell->sizeX);
-						sprite_decompressColumn(colPtr, s_workBuffer, cell->sizeY);
-						s_texImage = (u8*)s_workBuffer;
+						if (s_bandRecord)
+						{
+							// Defer decompression until the column is replayed.
+							s_texImage = (u8*)colPtr;
+							s_texCompressedHeight = cell->sizeY;
+						}
+						else
+						{
+							// Decompress the column into "work buffer."
+							sprite_decompressColumn(colPtr, s_workBuffer, cell->sizeY);
+							s_texImage = (u8*)s_workBuffer;
+						}
 					}
 					else
 					{
@@ -2377,6 +2457,7 @@ namespace RClassic_Float
 					s_columnOut = &s_display[y0 * s_width + x];
 					// Draw the column.
 					spriteColumnFunc();
+					s_texCompressedHeight = 0;
 					if (s_yPixelCount > 1) { drawn = JTRUE; }
 				}
 			}
@@ -12,12 +12,16 @@
 #include "RClassic_Float/rclassicFloat.h"
 #include "RClassic_Float/rsectorFloat.h"
 #include "RClassic_Float/rclassicFloatSharedState.h"
+#include "RClassic_Float/rbandsFloat.h"
+#include "RClassic_Float/rflatSimdFloat.h"
+#include "RClassic_Float/rcolumnBatchFloat.h"
 
 #include "RClassic_GPU/rclassicGPU.h"
 #include "RClassic_GPU/rsectorGPU.h"
 #include "RClassic_GPU/screenDrawGPU.h"
 
 #include <TFE_System/profiler.h>
+#include <TFE_System/jobs.h>
 #include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_Settings/settings.h>
 #include <TFE_Asset/spriteAsset_Jedi.h>
@@ -53,6 +57,7 @@ namespace TFE_Jedi
 	{
 		RClassic_Fixed::resetState();
 		RClassic_Float::resetState();
+		RClassic_Float::bands_reset();
 		RClassic_GPU::resetState();
 		s_hudTextureCallbacks.clear();
 		screen_clear();
@@ -116,6 +121,8 @@ namespace TFE_Jedi
 		CVAR_INT(s_maxDepthCount, "d_maxDepthCount", CVFLAG_DO_NOT_SERIALIZE, "Maximum adjoin depth count.");
 		CVAR_INT(s_sectorAmbient, "d_sectorAmbient", CVFLAG_DO_NOT_SERIALIZE, "Current Sector Ambient.");
 		CVAR_BOOL(s_showWireframe, "d_enableWireframe", CVFLAG_DO_NOT_SERIALIZE, "Enable wireframe rendering.");
+		CVAR_BOOL(RClassic_Float::s_columnBatching, "d_columnBatching", CVFLAG_DO_NOT_SERIALIZE, "Batch adjacent wall and sprite columns into tiles that are written row by row.");
+		CVAR_BOOL(RClassic_Float::s_scanlineSimd, "d_simdScanlines", CVFLAG_DO_NOT_SERIALIZE, "Use SIMD flat scanlines when supported, disable to use the reference scalar path.");
 
 		// Remove temporarily until they do something useful again.
 		CCMD("rsetSubRenderer", console_setSubRenderer, 1, "Set the sub-renderer - valid values are: Classic_Fixed, Classic_Float, Classic_GPU.");
@@ -129,6 +136,8 @@ namespace TFE_Jedi
 		TFE_COUNTER(s_curWallSeg,     "Wall Segment Count");
 		TFE_COUNTER(s_adjoinSegCount, "Adjoin Segment Count");
 
+		RClassic_Float::flat_initScanlineKernels();
+
 		s_sectorRenderer = renderer_getSectorRenderer(TSR_CLASSIC_FIXED);
 		renderer_setLimits();
 	}
@@ -554,12 +563,27 @@ namespace TFE_Jedi
 			}
 		}
 				
+		// Optionally record the rasterization work so it can be split into bands.
+		if (s_subRenderer == TSR_CLASSIC_FLOAT)
+		{
+			const bool multithreaded = TFE_Settings::getGraphicsSettings()->multithreadedRender;
+			RClassic_Float::bands_beginFrame(multithreaded ? TFE_Jobs::getWorkerCount() + 1 : 0);
+			// Column batching writes directly to the framebuffer, so it is only used when the frame is not split into bands.
+			RClassic_Float::colbatch_beginFrame(!RClassic_Float::s_bandRecord);
+		}
+				
 		// Recursively draws sectors and their contents (sprites, 3D objects).
 		{
 			TFE_ZONE("Sector Draw");
 			s_sectorRenderer->prepare();
 			s_sectorRenderer->draw(sector);
 		}
+
+		if (s_subRenderer == TSR_CLASSIC_FLOAT)
+		{
+			RClassic_Float::colbatch_endFrame();
+			RClassic_Float::bands_endFrame();
+		}
 	}
 
 	/////////////////////////////////////////////
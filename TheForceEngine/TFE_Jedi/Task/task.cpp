@@ -9,6 +9,8 @@
 #include <TFE_FrontEndUI/console.h>
 #include <TFE_Jedi/Serialization/serialization.h>
 #include <stdarg.h>
+#include <algorithm>
+#include <set>
 #include <tuple>
 #include <vector>
 
@@ -63,6 +65,15 @@ struct Task
 
 	// Timing.
 	Tick nextTick;
+
+	// Scheduling (TFE).
+	// All tasks are kept in a circular list in execution order, so that sleeping tasks can be skipped without changing
+	// the order in which the awake tasks run.
+	Task* schedPrev;
+	Task* schedNext;
+	u64   schedOrder;	// Increases along the execution order (except at the wrap point), used to sort the awake set.
+	u64   schedStamp;	// Changes every time the task is rescheduled, used to discard stale timer entries.
+	JBool awake;		// JTRUE if the task is in the awake set.
 };
 
 namespace TFE_Jedi
@@ -94,8 +105,198 @@ namespace TFE_Jedi
 	static bool s_enableTimeLimiter = true;
 	static Task* s_taskPauseTask = nullptr;
 
+	/////////////////////////////////////////////////////
+	// Scheduler
+	// Tasks that can run (nextTick <= s_curTick or framebreak) are kept in an "awake" set ordered by execution order.
+	// Other tasks are either asleep (TASK_SLEEP) until task_makeActive() or task_setNextTick() is called, or waiting
+	// on a timer heap keyed on nextTick. So selecting the next task only touches runnable tasks, while the tasks run
+	// in the same order as walking the whole task list.
+	/////////////////////////////////////////////////////
+	enum
+	{
+		SCHED_ORDER_GAP = 1 << 16,
+	};
+
+	struct TaskTimer
+	{
+		Tick tick;
+		u64  stamp;
+		Task* task;
+	};
+
+	struct TaskOrderCmp
+	{
+		bool operator()(const Task* a, const Task* b) const { return a->schedOrder < b->schedOrder; }
+	};
+
+	struct TaskTimerCmp
+	{
+		// std heaps are max heaps, so reverse the comparison to get the earliest tick on top.
+		bool operator()(const TaskTimer& a, const TaskTimer& b) const { return a.tick > b.tick; }
+	};
+
+	static std::set<Task*, TaskOrderCmp> s_awakeTasks;
+	static std::vector<TaskTimer> s_taskTimers;
+	static u64 s_schedStamp = 0;
+	static Tick s_schedTick = 0;
+	static s32 s_awakeTaskCount = 0;
+	static s32 s_timerTaskCount = 0;
+
 	void selectNextTask();
 
+	void sched_updateCounters()
+	{
+		s_awakeTaskCount = (s32)s_awakeTasks.size();
+		s_timerTaskCount = (s32)s_taskTimers.size();
+	}
+
+	void sched_reset()
+	{
+		s_awakeTasks.clear();
+		s_taskTimers.clear();
+
+		s_rootTask.schedPrev = &s_rootTask;
+		s_rootTask.schedNext = &s_rootTask;
+		s_rootTask.schedOrder = SCHED_ORDER_GAP;
+		s_rootTask.schedStamp = 0;
+		s_rootTask.awake = JFALSE;
+
+		s_schedTick = s_curTick;
+		sched_updateCounters();
+	}
+
+	void sched_setAwake(Task* task, JBool awake)
+	{
+		if (task->awake == awake) { return; }
+		if (awake) { s_awakeTasks.insert(task); }
+		else { s_awakeTasks.erase(task); }
+		task->awake = awake;
+	}
+
+	// Reassign the order of every task, starting at the root, when there is no space left between neighbors.
+	void sched_reorder()
+	{
+		// The set is sorted by order, so it has to be rebuilt.
+		s_awakeTasks.clear();
+
+		u64 order = SCHED_ORDER_GAP;
+		Task* task = &s_rootTask;
+		do
+		{
+			task->schedOrder = order;
+			order += SCHED_ORDER_GAP;
+			task = task->schedNext;
+		} while (task != &s_rootTask);
+
+		do
+		{
+			if (task->awake) { s_awakeTasks.insert(task); }
+			task = task->schedNext;
+		} while (task != &s_rootTask);
+	}
+
+	// Insert 'task' into the execution order after 'prev'.
+	void sched_insert(Task* prev, Task* task)
+	{
+		Task* next = prev->schedNext;
+		task->schedPrev = prev;
+		task->schedNext = next;
+		prev->schedNext = task;
+		next->schedPrev = task;
+		task->schedStamp = 0;
+		task->awake = JFALSE;
+
+		const u64 order0 = prev->schedOrder;
+		const u64 order1 = next->schedOrder;
+		if (order1 > order0 + 1)
+		{
+			task->schedOrder = order0 + (order1 - order0) / 2;
+		}
+		else if (order1 <= order0 && order0 < UINT64_MAX - SCHED_ORDER_GAP)
+		{
+			// Inserting at the end of the order, right before wrapping around to the root.
+			task->schedOrder = order0 + SCHED_ORDER_GAP;
+		}
+		else
+		{
+			sched_reorder();
+		}
+	}
+
+	void sched_remove(Task* task)
+	{
+		sched_setAwake(task, JFALSE);
+		// Invalidate any pending timer.
+		task->schedStamp = 0;
+
+		task->schedPrev->schedNext = task->schedNext;
+		task->schedNext->schedPrev = task->schedPrev;
+		task->schedPrev = nullptr;
+		task->schedNext = nullptr;
+		sched_updateCounters();
+	}
+
+	void sched_removeSubtasks(Task* parent)
+	{
+		for (Task* subtask = parent->subtaskNext; subtask; subtask = subtask->next)
+		{
+			sched_removeSubtasks(subtask);
+			if (subtask->schedNext) { sched_remove(subtask); }
+		}
+	}
+
+	// Must be called whenever the task's nextTick changes.
+	void sched_update(Task* task)
+	{
+		task->schedStamp = ++s_schedStamp;
+		if (task->framebreak || task->nextTick <= s_curTick)
+		{
+			sched_setAwake(task, JTRUE);
+		}
+		else
+		{
+			sched_setAwake(task, JFALSE);
+			// Sleeping tasks only wake up when task_makeActive() or task_setNextTick() is called.
+			if (task->nextTick != TASK_SLEEP)
+			{
+				s_taskTimers.push_back({ task->nextTick, task->schedStamp, task });
+				std::push_heap(s_taskTimers.begin(), s_taskTimers.end(), TaskTimerCmp());
+			}
+		}
+		sched_updateCounters();
+	}
+
+	// Move tasks whose timers have expired into the awake set.
+	void sched_wakeTasks()
+	{
+		// Time went backwards (such as loading a save), so re-evaluate every task.
+		if (s_curTick < s_schedTick)
+		{
+			s_awakeTasks.clear();
+			s_taskTimers.clear();
+			for (Task* task = s_rootTask.schedNext; task != &s_rootTask; task = task->schedNext)
+			{
+				task->awake = JFALSE;
+				sched_update(task);
+			}
+		}
+		s_schedTick = s_curTick;
+
+		while (!s_taskTimers.empty() && s_taskTimers.front().tick <= s_curTick)
+		{
+			const TaskTimer timer = s_taskTimers.front();
+			std::pop_heap(s_taskTimers.begin(), s_taskTimers.end(), TaskTimerCmp());
+			s_taskTimers.pop_back();
+
+			// Skip timers for tasks that have been rescheduled or freed since.
+			if (timer.task->schedStamp == timer.stamp)
+			{
+				sched_setAwake(timer.task, JTRUE);
+			}
+		}
+		sched_updateCounters();
+	}
+
 	void createRootTask()
 	{
 		s_tasks = createChunkedArray(sizeof(Task), TASK_CHUNK_SIZE, TASK_PREALLOCATED_CHUNKS, s_gameRegion);
@@ -105,6 +306,7 @@ namespace TFE_Jedi
 		s_rootTask.prev = &s_rootTask;
 		s_rootTask.next = &s_rootTask;
 		s_rootTask.nextTick = TASK_SLEEP;
+		sched_reset();
 
 		s_taskIter = &s_rootTask;
 		s_curTask = &s_rootTask;
@@ -127,6 +329,14 @@ namespace TFE_Jedi
 		s_taskCount++;
 		strcpy(newTask->name, name);
 
+		// The new subtask executes before the first task in the current task's subtask "tree".
+		Task* schedNext = s_curTask;
+		while (schedNext->subtaskNext)
+		{
+			schedNext = schedNext->subtaskNext;
+		}
+		sched_insert(schedNext->schedPrev, newTask);
+
 		// Insert newTask at the head of the subtask list in the current "mainline" task.
 		newTask->next = s_curTask->subtaskNext;
 		newTask->prev = nullptr;
@@ -150,6 +360,7 @@ namespace TFE_Jedi
 		newTask->context.callstack[0] = func;
 		newTask->localRunFunc = localRunFunc;
 		newTask->context.level = TASK_INIT_LEVEL;
+		sched_update(newTask);
 		return newTask;
 	}
 
@@ -166,6 +377,7 @@ namespace TFE_Jedi
 		s_taskCount++;
 		// Insert the task after 's_taskIter'
 		strcpy(newTask->name, name);
+		sched_insert(s_taskIter, newTask);
 		newTask->next = s_taskIter->next;
 		// This was missing?
 		if (s_taskIter->next)
@@ -186,6 +398,7 @@ namespace TFE_Jedi
 		newTask->localRunFunc = localRunFunc;
 		newTask->context.level = TASK_INIT_LEVEL;
 		newTask->nextTick = s_curTick;
+		sched_update(newTask);
 
 		return newTask;
 	}
@@ -195,6 +408,10 @@ namespace TFE_Jedi
 		SERIALIZE(SaveVersionInit, task->context.ip[0], 0);
 		SERIALIZE(SaveVersionInit, task->context.stackSize[0], 0);
 		SERIALIZE(SaveVersionInit, task->nextTick, 0);
+		if (serialization_getMode() == SMODE_READ)
+		{
+			sched_update(task);
+		}
 		if (serialization_getMode() == SMODE_READ && !task->context.stackMem)
 		{
 			task->context.stackMem = (u8*)allocFromChunkedArray(s_stackBlocks);
@@ -246,7 +463,10 @@ namespace TFE_Jedi
 		{
 			// Should we free subtasks?
 			assert(0);
+			// The sub-tasks can no longer be reached, so they should not be scheduled either.
+			sched_removeSubtasks(task);
 		}
+		sched_remove(task);
 		// If this task was the subtaskNext, then move the next subtask into that role.
 		Task* parent = task->subtaskParent;
 		if (parent && parent->subtaskNext == task)
@@ -267,6 +487,7 @@ namespace TFE_Jedi
 		s_rootTask.prev = &s_rootTask;
 		s_rootTask.next = &s_rootTask;
 		s_rootTask.nextTick = TASK_SLEEP;
+		sched_reset();
 
 		s_taskIter = &s_rootTask;
 		s_curTask = &s_rootTask;
@@ -281,6 +502,8 @@ namespace TFE_Jedi
 	{
 		chunkedArrayClear(s_tasks);
 		chunkedArrayClear(s_stackBlocks);
+		// The root task no longer has any valid tasks to link to.
+		sched_reset();
 
 		s_curTask    = nullptr;
 		s_curContext = nullptr;
@@ -298,6 +521,7 @@ namespace TFE_Jedi
 		s_stackBlocks = nullptr;
 		s_curContext  = nullptr;
 		s_taskCount   = 0;
+		sched_reset();
 
 		s_prevTime = 0.0;
 		s_minIntervalInSec = 0.0;
@@ -309,11 +533,13 @@ namespace TFE_Jedi
 	void task_makeActive(Task* task)
 	{
 		task->nextTick = 0;
+		sched_update(task);
 	}
 
 	void task_setNextTick(Task* task, Tick tick)
 	{
 		task->nextTick = tick;
+		sched_update(task);
 	}
 
 	void task_setUserData(Task* task, void* data)
@@ -394,51 +620,25 @@ namespace TFE_Jedi
 
 	void selectNextTask()
 	{
-		// Find the next task to run.
-		Task* task = s_curTask;
-		while (1)
-		{
-			//////////////////////////////////////////////////////////////////////////////////////////
-			// Execution:
-			//  * Go to the next task
-			//  * Check to see if there are sub-tasks
-			//  * If so, the assign current to the sub-task.
-			//  * Execute the task.
-			//  * Once we are on the last sub-task, then go back to the parent.
-			//  * Once the parent executes, then we move on to parent->next and start all over.
-			if (task->next)
-			{
-				// Move the to the next task.
-				task = task->next;
-				// If the task has sub-tasks, loop until we find the last one.
-				// This is usually only one deep.
-				while (task->subtaskNext)
-				{
-					task = task->subtaskNext;
-				}
-				// Then execute the task.
-				if (task->nextTick <= s_curTick || task->framebreak)
-				{
-					s_currentMsg = MSG_RUN_TASK;
-					s_curTask = task;
-					return;
-				}
-			}
-			else if (task->subtaskParent)
-			{
-				// Otherwise, try to execute the parent.
-				task = task->subtaskParent;
-				if (task->nextTick <= s_curTick || task->framebreak)
-				{
-					s_currentMsg = MSG_RUN_TASK;
-					s_curTask = task;
-					return;
-				}
-			}
-			else
+		// This produces the same result as walking the task list in execution order:
+		//  * Go to the next task
+		//  * Check to see if there are sub-tasks
+		//  * If so, the assign current to the sub-task.
+		//  * Execute the task.
+		//  * Once we are on the last sub-task, then go back to the parent.
+		//  * Once the parent executes, then we move on to parent->next and start all over.
+		// But only tasks that can run are visited.
+		sched_wakeTasks();
+		if (s_curTask && !s_awakeTasks.empty())
+		{
+			std::set<Task*, TaskOrderCmp>::iterator next = s_awakeTasks.upper_bound(s_curTask);
+			if (next == s_awakeTasks.end())
 			{
-				break;
+				next = s_awakeTasks.begin();
 			}
+			s_currentMsg = MSG_RUN_TASK;
+			s_curTask = *next;
+			return;
 		}
 
 		// If no selection is possible, assign the first task.
@@ -508,6 +708,7 @@ namespace TFE_Jedi
 
 		// Update the current tick based on the delay.
 		s_curTask->nextTick = (delay < TASK_SLEEP) ? s_curTick + delay : delay;
+		sched_update(s_curTask);
 		
 		// Find the next task to run.
 		selectNextTask();
@@ -610,7 +811,10 @@ namespace TFE_Jedi
 			}
 			else
 			{
+				Task* prevTask = s_curTask;
 				selectNextTask();
+				// Nothing can run, this would loop forever.
+				if (s_curTask == prevTask) { break; }
 			}
 
 			if (framebreak)
@@ -628,6 +832,8 @@ namespace TFE_Jedi
 
 		TFE_COUNTER(s_taskCount, "Task Count");
 		TFE_COUNTER(s_frameActiveTaskCount, "Active Tasks");
+		TFE_COUNTER(s_awakeTaskCount, "Runnable Tasks");
+		TFE_COUNTER(s_timerTaskCount, "Task Timers");
 	}
 
 	s32 task_getCount()
@@ -32,7 +32,20 @@ enum
 	MAX_BLOCK_COUNT = 256,
 	MAX_BLOCK_SIZE  = 16 * 1024 * 1024,
 	RELATIVE_NON_NULL_BIT = 1u,
-	SHARED_HEADER_SIZE = 8,	// 8 bytes are shared between RegionAllocHeader{} and AllocHeaderFree{}
+	SHARED_HEADER_SIZE = 16,	// 16 bytes are shared between RegionAllocHeader{} and AllocHeaderFree{}
+	// Allocations of up to SLAB_MAX_SIZE bytes are served from slabs of fixed size items.
+	SLAB_CLASS_COUNT = 10,
+	SLAB_MAX_SIZE = 512,
+	SLAB_TARGET_SIZE = 4096,
+	SLAB_MIN_ITEMS = 8,
+	SLAB_NULL_ITEM = 0xffff,
+};
+
+enum RegionChunkType
+{
+	CHUNK_GENERAL = 0,	// Allocated from the block free lists.
+	CHUNK_SLAB,			// General chunk which holds a slab.
+	CHUNK_SLAB_ITEM,	// Item within a slab.
 };
 
 struct RegionAllocHeader
@@ -40,18 +53,22 @@ struct RegionAllocHeader
 	u32 size;
 	u8  free;
 	u8  bin;
-	u8  pad8[2];
-	u32 pad4[2];	// pad to 16 bytes.
+	u8  type;
+	u8  pad8;
+	u32 prevSize;	// Size of the previous chunk in the block or 0 for the first chunk, used to merge free chunks.
+	u32 pad4;		// pad to 16 bytes.
 };
 
-// free structure is larger than header, because it fits within the
-// alignment: align(8, sizeof(header)=16 + size), so at least 24 bytes is allocated.
+// free structure is larger than header, so at least 32 bytes is allocated from the blocks.
 struct AllocHeaderFree
 {
 	u32 size;
 	u8  free;
 	u8  bin;
-	u8  pad8[2];
+	u8  type;
+	u8  pad8;
+	u32 prevSize;
+	u32 pad4;
 	AllocHeaderFree* binNext;
 	AllocHeaderFree* binPrev;
 #if (defined(_WIN32) && !defined(_WIN64)) || (__SIZEOF_POINTER__ == 4)
@@ -61,6 +78,30 @@ struct AllocHeaderFree
 #endif
 };
 
+// Slab items share the first 8 bytes with RegionAllocHeader{}, so the type can be read from any header.
+struct SlabItemHeader
+{
+	u32 size;		// Item stride, including the header.
+	u8  free;
+	u8  sizeClass;
+	u8  type;		// CHUNK_SLAB_ITEM
+	u8  pad8;
+	u32 slabOffset;	// Offset from the slab to this header.
+	u32 nextFree;	// Index of the next free item in the slab.
+};
+
+// Stored directly after the RegionAllocHeader{} of a CHUNK_SLAB, followed by the items.
+struct RegionSlab
+{
+	// Slabs with free items, per size class.
+	RegionSlab* next;
+	RegionSlab* prev;
+	u16 sizeClass;
+	u16 itemCount;
+	u16 freeCount;
+	u16 freeHead;
+};
+
 struct MemoryBlock
 {
 	u32 sizeFree;
@@ -85,10 +126,19 @@ struct MemoryRegion
 	u64 blockCount;
 	u64 blockSize;
 	u64 maxBlocks;
+
+	// Slabs with free items, these are not serialized but rebuilt from the blocks on restore.
+	RegionSlab* slabs[SLAB_CLASS_COUNT];
+	// Stats
+	u64 allocCount;
+	u64 freeCount;
+	u64 histogram[TFE_Memory::REGION_HISTOGRAM_BINS];
 };
 
 static_assert(sizeof(RegionAllocHeader) == 16, "RegionAllocHeader is the wrong size.");
-static_assert(sizeof(AllocHeaderFree) == 24, "AllocHeaderFree is the wrong size.");
+static_assert(sizeof(AllocHeaderFree) == 32, "AllocHeaderFree is the wrong size.");
+static_assert(sizeof(SlabItemHeader) == sizeof(RegionAllocHeader), "SlabItemHeader is the wrong size.");
+static_assert((sizeof(RegionSlab) & (ALIGNMENT - 1)) == 0, "RegionSlab must keep the items aligned.");
 
 namespace TFE_Memory
 {
@@ -97,7 +147,23 @@ namespace TFE_Memory
 	static const u32 c_relativeBlockShift = 24u;
 	static const u32 c_relativeOffsetMask = (1u << c_relativeBlockShift) - 1u;
 
-	void freeSlot(RegionAllocHeader* alloc, RegionAllocHeader* next, MemoryBlock* block);
+	// Item size, excluding the header, for each slab size class.
+	static const u32 c_slabClassSize[SLAB_CLASS_COUNT] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512 };
+	// Size class indexed by (size + 15) / 16
+	static const u8 c_slabClassFromSize[SLAB_MAX_SIZE / 16 + 1] =
+	{
+		0, 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7,
+		8, 8, 8, 8, 8, 8, 8, 8,
+		9, 9, 9, 9, 9, 9, 9, 9,
+	};
+
+	void freeSlot(RegionAllocHeader* alloc, MemoryBlock* block, u8* blockEnd);
+	void* allocGeneral(MemoryRegion* region, u64 size);
+	void  freeGeneral(MemoryRegion* region, void* ptr);
+	void* slab_alloc(MemoryRegion* region, s32 sizeClass);
+	void  slab_free(MemoryRegion* region, SlabItemHeader* item);
+	void  slab_rebuildLists(MemoryRegion* region);
+	s32  getHistogramBin(u64 size);
 	u64 alloc_align(u64 baseSize);
 	s32  getBinFromSize(u32 size);
 	bool allocateNewBlock(MemoryRegion* region);
@@ -106,7 +172,7 @@ namespace TFE_Memory
 
 	void verifyMemory(MemoryRegion* region)
 	{
-		for (s32 i = 0; i < region->blockCount; i++)
+		for (u64 i = 0; i < region->blockCount; i++)
 		{
 			MemoryBlock* block = region->memBlocks[i];
 			assert(block->sizeFree <= region->blockSize);
@@ -117,6 +183,20 @@ namespace TFE_Memory
 				RegionAllocHeader* header = (RegionAllocHeader*)mem;
 				assert(header->free == 0 || header->free == 1);
 				assert(header->size <= region->blockSize);
+				assert(header->prevSize == (prev ? prev->size : 0));
+				assert(!header->free || !prev || !prev->free);
+				if (!header->free && header->type == CHUNK_SLAB)
+				{
+					RegionSlab* slab = (RegionSlab*)(mem + sizeof(RegionAllocHeader));
+					u32 freeCount = 0;
+					for (u32 index = slab->freeHead; index != SLAB_NULL_ITEM; freeCount++)
+					{
+						SlabItemHeader* item = (SlabItemHeader*)((u8*)slab + sizeof(RegionSlab) + index * (sizeof(SlabItemHeader) + c_slabClassSize[slab->sizeClass]));
+						assert(item->free == 1 && item->type == CHUNK_SLAB_ITEM);
+						index = item->nextFree;
+					}
+					assert(freeCount == slab->freeCount);
+				}
 				mem += header->size;
 				prev = header;
 			}
@@ -160,6 +240,10 @@ namespace TFE_Memory
 		region->blockCount = 0;
 		region->blockSize = blockSize;
 		region->maxBlocks = maxSize ? (maxSize + blockSize - 1) / blockSize : 0;
+		memset(region->slabs, 0, sizeof(RegionSlab*) * SLAB_CLASS_COUNT);
+		region->allocCount = 0;
+		region->freeCount = 0;
+		memset(region->histogram, 0, sizeof(u64) * REGION_HISTOGRAM_BINS);
 		if (!allocateNewBlock(region))
 		{
 			free(region);
@@ -174,7 +258,8 @@ namespace TFE_Memory
 	void region_clear(MemoryRegion* region)
 	{
 		assert(region);
-		for (s32 i = 0; i < region->blockCount; i++)
+		memset(region->slabs, 0, sizeof(RegionSlab*) * SLAB_CLASS_COUNT);
+		for (u64 i = 0; i < region->blockCount; i++)
 		{
 			MemoryBlock* block = region->memBlocks[i];
 			block->sizeFree = u32(region->blockSize);
@@ -183,6 +268,7 @@ namespace TFE_Memory
 			RegionAllocHeader* header = (RegionAllocHeader*)((u8*)block + sizeof(MemoryBlock));
 			header->size = block->sizeFree;
 			header->free = 0;
+			header->prevSize = 0;
 			memset(block->freeListBins, 0, sizeof(AllocHeaderFree*)*ALLOC_BIN_COUNT);
 			insertBlockIntoFreelist(block, header);
 			VERIFY_MEMORY();
@@ -192,7 +278,7 @@ namespace TFE_Memory
 	void region_destroy(MemoryRegion* region)
 	{
 		assert(region);
-		for (s32 i = 0; i < region->blockCount; i++)
+		for (u64 i = 0; i < region->blockCount; i++)
 		{
 			free(region->memBlocks[i]);
 		}
@@ -200,7 +286,36 @@ namespace TFE_Memory
 		free(region);
 	}
 		
-	void* allocFromHeader(MemoryBlock* block, RegionAllocHeader* header, u32 size)
+	u8* getBlockEnd(MemoryRegion* region, MemoryBlock* block)
+	{
+		return (u8*)block + sizeof(MemoryBlock) + region->blockSize;
+	}
+
+	// Blocks are allocated separately, so their addresses are not ordered.
+	s32 getBlockIndex(MemoryRegion* region, void* ptr)
+	{
+		for (s32 i = (s32)region->blockCount - 1; i >= 0; i--)
+		{
+			MemoryBlock* block = region->memBlocks[i];
+			if (ptr >= block && ptr < getBlockEnd(region, block))
+			{
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	// Keep the prevSize of the chunk following 'header' up to date.
+	void updateNextPrevSize(RegionAllocHeader* header, u8* blockEnd)
+	{
+		RegionAllocHeader* next = (RegionAllocHeader*)((u8*)header + header->size);
+		if ((u8*)next < blockEnd)
+		{
+			next->prevSize = header->size;
+		}
+	}
+
+	void* allocFromHeader(MemoryBlock* block, RegionAllocHeader* header, u32 size, u8* blockEnd)
 	{
 		assert(header->free == 1);
 		if (header->size - size >= MIN_SPLIT_SIZE)
@@ -217,7 +332,9 @@ namespace TFE_Memory
 			// Create a new free block.
 			next->size = u32(split1);
 			next->free = 0;
+			next->prevSize = u32(split0);
 			block->count++;
+			updateNextPrevSize(next, blockEnd);
 						
 			// Add the new block to the free list.
 			insertBlockIntoFreelist(block, next);
@@ -231,65 +348,90 @@ namespace TFE_Memory
 		return (u8*)header + sizeof(RegionAllocHeader);
 	}
 
-	void* region_alloc(MemoryRegion* region, u64 size)
+	void* allocFromBlock(MemoryBlock* block, u32 size, u8* blockEnd)
 	{
-		assert(region);
-		if (size == 0) { return nullptr; }
-
-		size = alloc_align(size + sizeof(RegionAllocHeader));
-		assert(size >= 24);	// at least 24 bytes is required to hold the free header.
-		if (size > region->blockSize) { return nullptr; }
-		
-		for (s32 i = 0; i < region->blockCount; i++)
+		if (block->sizeFree < size)
 		{
-			MemoryBlock* block = region->memBlocks[i];
-			if (block->sizeFree < size)
-			{
-				continue;
-			}
+			return nullptr;
+		}
 
-			// Try to allocate from the closest matching bin.
-			s32 bin = getBinFromSize((u32)size);
-			for (s32 b = bin; b < ALLOC_BIN_COUNT; b++)
+		// Try to allocate from the closest matching bin.
+		s32 bin = getBinFromSize(size);
+		for (s32 b = bin; b < ALLOC_BIN_COUNT; b++)
+		{
+			AllocHeaderFree* header = block->freeListBins[b];
+			while (header)
 			{
-				AllocHeaderFree* header = block->freeListBins[b];
-				while (header)
+				if (header->size >= size)
 				{
-					if (header->size >= size)
-					{
-						VERIFY_MEMORY();
-						void* mem = allocFromHeader(block, (RegionAllocHeader*)header, (u32)size);
-						VERIFY_MEMORY();
-						return mem;
-					}
-					header = header->binNext;
+					return allocFromHeader(block, (RegionAllocHeader*)header, size, blockEnd);
 				}
+				header = header->binNext;
 			}
 		}
+		return nullptr;
+	}
+
+	// Allocate from the blocks, 'size' is aligned and includes the header.
+	void* allocGeneral(MemoryRegion* region, u64 size)
+	{
+		for (u64 i = 0; i < region->blockCount; i++)
+		{
+			VERIFY_MEMORY();
+			MemoryBlock* block = region->memBlocks[i];
+			void* mem = allocFromBlock(block, (u32)size, getBlockEnd(region, block));
+			VERIFY_MEMORY();
+			if (mem) { return mem; }
+		}
 
 		if (!region->maxBlocks || region->blockCount < region->maxBlocks)
 		{
 			if (allocateNewBlock(region))
 			{
-				VERIFY_MEMORY();
-				void* mem = region_alloc(region, size);
+				MemoryBlock* block = region->memBlocks[region->blockCount - 1];
+				void* mem = allocFromBlock(block, (u32)size, getBlockEnd(region, block));
 				VERIFY_MEMORY();
 				return mem;
 			}
 		}
-		
-		// We are all out of memory...
-		TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Failed to allocate %u bytes in region '%s'.", size, region->name);
 		return nullptr;
 	}
 
+	void* region_alloc(MemoryRegion* region, u64 size)
+	{
+		assert(region);
+		if (size == 0) { return nullptr; }
+		region->allocCount++;
+		region->histogram[getHistogramBin(size)]++;
+
+		// Small allocations come from the slabs, fallback to the general allocator if a new slab doesn't fit.
+		if (size <= SLAB_MAX_SIZE)
+		{
+			void* mem = slab_alloc(region, c_slabClassFromSize[(size + 15) >> 4]);
+			if (mem) { return mem; }
+		}
+
+		// At least 32 bytes is required to hold the free header.
+		size = std::max(alloc_align(size + sizeof(RegionAllocHeader)), u64(sizeof(AllocHeaderFree)));
+		if (size > region->blockSize) { return nullptr; }
+		
+		void* mem = allocGeneral(region, size);
+		if (!mem)
+		{
+			// We are all out of memory...
+			TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Failed to allocate %u bytes in region '%s'.", size, region->name);
+		}
+		return mem;
+	}
+
 	void* region_realloc(MemoryRegion* region, void* ptr, u64 size)
 	{
 		assert(region);
 		if (!ptr) { return region_alloc(region, size); }
 		if (size == 0) { return nullptr; }
 
-		size = alloc_align(size + sizeof(RegionAllocHeader));
+		const u64 requestSize = size;
+		size = std::max(alloc_align(size + sizeof(RegionAllocHeader)), u64(sizeof(AllocHeaderFree)));
 		if (size > region->blockSize) { return nullptr; }
 
 		// If the current block is already large enough, skip looping over the memory blocks.
@@ -299,71 +441,79 @@ namespace TFE_Memory
 			return ptr;
 		}
 
-		// First try to reallocate in the same region.
+		// Slab items cannot grow in place.
 		u32 prevSize = 0;
-		for (s32 i = (s32)region->blockCount - 1; i >= 0; i--)
+		if (header->type == CHUNK_SLAB_ITEM)
 		{
-			MemoryBlock* block = region->memBlocks[i];
-			if (ptr >= block)
-			{
-				RegionAllocHeader* header = (RegionAllocHeader*)((u8*)ptr - sizeof(RegionAllocHeader));
-				RegionAllocHeader* nextHeader = (RegionAllocHeader*)((u8*)header + header->size);
-				assert(header->free == 0);
+			prevSize = header->size;
+		}
+		// First try to reallocate in the same region.
+		const s32 blockIndex = prevSize ? -1 : getBlockIndex(region, ptr);
+		if (blockIndex >= 0)
+		{
+			MemoryBlock* block = region->memBlocks[blockIndex];
+			u8* blockEnd = getBlockEnd(region, block);
+			RegionAllocHeader* nextHeader = (RegionAllocHeader*)((u8*)header + header->size);
+			assert(header->free == 0);
 
-				if ((u8*)nextHeader >= (u8*)block + region->blockSize)
-				{
-					nextHeader = nullptr;
-				}
-				// If it is big enough, just stick to the same memory.
-				if (header->size >= size)
+			if ((u8*)nextHeader >= blockEnd)
+			{
+				nextHeader = nullptr;
+			}
+			// If it is big enough, just stick to the same memory.
+			if (header->size >= size)
+			{
+				return ptr;
+			}
+			// If the next block is free, merge the two blocks and then allocate from that.
+			if (nextHeader && nextHeader->free && header->size + nextHeader->size >= size)
+			{
+				VERIFY_MEMORY();
+				// Remove the nextHeader from the freelist.
+				assert(nextHeader->free == 1);
+				removeHeaderFromFreelist(block, nextHeader);
+
+				// Merge blocks.
+				block->sizeFree += header->size;
+				header->size += nextHeader->size;
+				block->count--;
+								
+				// Allocate from the new header.
+				if (header->size - size >= MIN_SPLIT_SIZE)
 				{
-					return ptr;
+					// Split.
+					u64 split0 = size;
+					u64 split1 = header->size - split0;
+					RegionAllocHeader* next = (RegionAllocHeader*)((u8*)header + split0);
+
+					// Reset the header.
+					header->free = 0;
+					header->size = u32(split0);
+
+					// Create a new free block.
+					next->size = u32(split1);
+					next->free = 0;
+					next->prevSize = u32(split0);
+					block->count++;
+					updateNextPrevSize(next, blockEnd);
+
+					// Add the new block to the free list.
+					insertBlockIntoFreelist(block, next);
 				}
-				// If the next block is free, merge the two blocks and then allocate from that.
-				if (nextHeader && nextHeader->free && header->size + nextHeader->size >= size)
+				else
 				{
-					VERIFY_MEMORY();
-					// Remove the nextHeader from the freelist.
-					assert(nextHeader->free == 1);
-					removeHeaderFromFreelist(block, nextHeader);
-
-					// Merge blocks.
-					block->sizeFree += header->size;
-					header->size += nextHeader->size;
-					block->count--;
-									
-					// Allocate from the new header.
-					if (header->size - size >= MIN_SPLIT_SIZE)
-					{
-						// Split.
-						u64 split0 = size;
-						u64 split1 = header->size - split0;
-						RegionAllocHeader* next = (RegionAllocHeader*)((u8*)header + split0);
-
-						// Reset the header.
-						header->free = 0;
-						header->size = u32(split0);
-
-						// Create a new free block.
-						next->size = u32(split1);
-						next->free = 0;
-						block->count++;
-
-						// Add the new block to the free list.
-						insertBlockIntoFreelist(block, next);
-					}
-					block->sizeFree -= header->size;
-					VERIFY_MEMORY();
-					return (u8*)header + sizeof(RegionAllocHeader);
+					updateNextPrevSize(header, blockEnd);
 				}
-				// Otherwise break, we have to free and reallocate.
-				prevSize = header->size;
-				break;
+				block->sizeFree -= header->size;
+				VERIFY_MEMORY();
+				return (u8*)header + sizeof(RegionAllocHeader);
 			}
+			// Otherwise we have to free and reallocate.
+			prevSize = header->size;
 		}
 
 		// Allocate a new block of memory.
-		void* newMem = region_alloc(region, size);
+		void* newMem = region_alloc(region, requestSize);
 		if (!newMem) { return nullptr; }
 		// Copy over the contents from the previous block.
 		if (prevSize > sizeof(RegionAllocHeader))
@@ -380,38 +530,46 @@ namespace TFE_Memory
 	void region_free(MemoryRegion* region, void* ptr)
 	{
 		if (!ptr || !region) { return; }
+		region->freeCount++;
 
-		for (s32 i = (s32)region->blockCount - 1; i >= 0; i--)
+		RegionAllocHeader* header = (RegionAllocHeader*)((u8*)ptr - sizeof(RegionAllocHeader));
+		if (header->type == CHUNK_SLAB_ITEM)
 		{
-			MemoryBlock* block = region->memBlocks[i];
-			if (ptr >= block)
+			assert(!header->free);
+			if (header->free)
 			{
-				RegionAllocHeader* header = (RegionAllocHeader*)((u8*)ptr - sizeof(RegionAllocHeader));
-				RegionAllocHeader* nextHeader = (RegionAllocHeader*)((u8*)header + header->size);
-				if ((u8*)nextHeader >= (u8*)block + region->blockSize)
-				{
-					nextHeader = nullptr;
-				}
-
-				assert(!header->free);
-				if (header->free)
-				{
-					TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Attempted to double free pointer %x in region '%s'.", ptr, region->name);
-					return;
-				}
-
-				VERIFY_MEMORY();
-				freeSlot(header, nextHeader, block);
-				VERIFY_MEMORY();
+				TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Attempted to double free pointer %x in region '%s'.", ptr, region->name);
 				return;
 			}
+			slab_free(region, (SlabItemHeader*)header);
+			return;
 		}
+		freeGeneral(region, ptr);
+	}
+
+	void freeGeneral(MemoryRegion* region, void* ptr)
+	{
+		const s32 blockIndex = getBlockIndex(region, ptr);
+		if (blockIndex < 0) { return; }
+
+		MemoryBlock* block = region->memBlocks[blockIndex];
+		RegionAllocHeader* header = (RegionAllocHeader*)((u8*)ptr - sizeof(RegionAllocHeader));
+		assert(!header->free);
+		if (header->free)
+		{
+			TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Attempted to double free pointer %x in region '%s'.", ptr, region->name);
+			return;
+		}
+
+		VERIFY_MEMORY();
+		freeSlot(header, block, getBlockEnd(region, block));
+		VERIFY_MEMORY();
 	}
 		
 	u64 region_getMemoryUsed(MemoryRegion* region)
 	{
 		u64 used = 0;
-		for (s32 i = 0; i < region->blockCount; i++)
+		for (u64 i = 0; i < region->blockCount; i++)
 		{
 			used += (region->blockSize - region->memBlocks[i]->sizeFree);
 		}
@@ -424,6 +582,41 @@ namespace TFE_Memory
 		*blockSize = region->blockSize;
 	}
 
+	void region_getStats(MemoryRegion* region, MemoryRegionStats* stats)
+	{
+		memset(stats, 0, sizeof(MemoryRegionStats));
+		stats->capacity = region_getMemoryCapacity(region);
+		stats->allocCount = region->allocCount;
+		stats->freeCount = region->freeCount;
+		memcpy(stats->histogram, region->histogram, sizeof(u64) * REGION_HISTOGRAM_BINS);
+
+		for (u64 i = 0; i < region->blockCount; i++)
+		{
+			MemoryBlock* block = region->memBlocks[i];
+			u8* mem = (u8*)block + sizeof(MemoryBlock);
+			for (u32 a = 0; a < block->count; a++)
+			{
+				RegionAllocHeader* header = (RegionAllocHeader*)mem;
+				if (header->free)
+				{
+					stats->free += header->size;
+					stats->freeChunkCount++;
+					stats->largestFreeChunk = std::max(stats->largestFreeChunk, u64(header->size));
+				}
+				else if (header->type == CHUNK_SLAB)
+				{
+					RegionSlab* slab = (RegionSlab*)(mem + sizeof(RegionAllocHeader));
+					stats->slabCount++;
+					stats->slabItemsUsed += slab->itemCount - slab->freeCount;
+					stats->slabItemsFree += slab->freeCount;
+				}
+				mem += header->size;
+			}
+		}
+		stats->used = stats->capacity - stats->free;
+		stats->fragmentation = stats->free ? 1.0f - f32(stats->largestFreeChunk) / f32(stats->free) : 0.0f;
+	}
+
 	u64 region_getMemoryCapacity(MemoryRegion* region)
 	{
 		return region->blockCount * region->blockSize;
@@ -434,19 +627,16 @@ namespace TFE_Memory
 		RelativePointer rp = NULL_RELATIVE_POINTER;
 		if (!ptr || !region) { return rp; }
 		
-		for (s32 i = (s32)region->blockCount - 1; i >= 0; i--)
+		const s32 i = getBlockIndex(region, ptr);
+		if (i >= 0)
 		{
 			MemoryBlock* block = region->memBlocks[i];
-			if (ptr >= block)
-			{
-				rp = RelativePointer((u8*)ptr - (u8*)block - sizeof(MemoryBlock));
-				rp |= (i << c_relativeBlockShift);
-				assert(!(rp & RELATIVE_NON_NULL_BIT));
+			rp = RelativePointer((u8*)ptr - (u8*)block - sizeof(MemoryBlock));
+			rp |= (i << c_relativeBlockShift);
+			assert(!(rp & RELATIVE_NON_NULL_BIT));
 
-				// With 8 byte alignment, the lowest bit should always be 0, so we can use it as a "non-null" bit.
-				rp |= RELATIVE_NON_NULL_BIT;
-				break;
-			}
+			// With 8 byte alignment, the lowest bit should always be 0, so we can use it as a "non-null" bit.
+			rp |= RELATIVE_NON_NULL_BIT;
 		}
 		// With alignment, the lower bit should always be zero.
 		return rp;
@@ -485,7 +675,7 @@ namespace TFE_Memory
 		file->write(&region->blockSize);
 		file->write(&region->maxBlocks);
 
-		for (s32 b = 0; b < region->blockCount; b++)
+		for (u64 b = 0; b < region->blockCount; b++)
 		{
 			MemoryBlock* block = region->memBlocks[b];
 			file->write(&block->count);
@@ -531,7 +721,13 @@ namespace TFE_Memory
 		if (!region)
 		{
 			region = (MemoryRegion*)malloc(sizeof(MemoryRegion));
-			region->blockArrCapacity = 0;
+			if (region)
+			{
+				region->blockArrCapacity = 0;
+				region->allocCount = 0;
+				region->freeCount = 0;
+				memset(region->histogram, 0, sizeof(u64) * REGION_HISTOGRAM_BINS);
+			}
 		}
 		if (!region)
 		{
@@ -561,7 +757,7 @@ namespace TFE_Memory
 			if (blockSize != region->blockSize)
 			{
 				// Free memory since we have to reallocate from scratch.
-				for (s32 i = 0; i < region->blockCount; i++)
+				for (u64 i = 0; i < region->blockCount; i++)
 				{
 					free(region->memBlocks[i]);
 				}
@@ -597,7 +793,7 @@ namespace TFE_Memory
 			return nullptr;
 		}
 		
-		for (s32 b = 0; b < region->blockCount; b++)
+		for (u64 b = 0; b < region->blockCount; b++)
 		{
 			// Only allocate the block if it was not part of the original region passed in.
 			if (b >= blockAllocStart)
@@ -646,16 +842,18 @@ namespace TFE_Memory
 				memPtr += header->size;
 			}
 		}
+		slab_rebuildLists(region);
 
 		return region;
 	}
 
-	void freeSlot(RegionAllocHeader* alloc, RegionAllocHeader* next, MemoryBlock* block)
+	void freeSlot(RegionAllocHeader* alloc, MemoryBlock* block, u8* blockEnd)
 	{
 		block->sizeFree += alloc->size;
 
 		assert(alloc->free == 0);
-		if (next && next->free)  // Then try merging the current and next.
+		RegionAllocHeader* next = (RegionAllocHeader*)((u8*)alloc + alloc->size);
+		if ((u8*)next < blockEnd && next->free)  // Then try merging the current and next.
 		{
 			assert(next->free == 1);
 			// Remove the next block from the freelist.
@@ -665,10 +863,151 @@ namespace TFE_Memory
 			alloc->size += next->size;
 			block->count--;
 		}
+		RegionAllocHeader* prev = alloc->prevSize ? (RegionAllocHeader*)((u8*)alloc - alloc->prevSize) : nullptr;
+		if (prev && prev->free)  // Then try merging the previous and current.
+		{
+			removeHeaderFromFreelist(block, prev);
+			prev->size += alloc->size;
+			block->count--;
+			alloc = prev;
+		}
+		updateNextPrevSize(alloc, blockEnd);
 		// Then add the new item to the free list.
 		insertBlockIntoFreelist(block, alloc);
 	}
 
+	SlabItemHeader* slab_getItem(RegionSlab* slab, u32 index)
+	{
+		const u32 stride = sizeof(SlabItemHeader) + c_slabClassSize[slab->sizeClass];
+		return (SlabItemHeader*)((u8*)slab + sizeof(RegionSlab) + index * stride);
+	}
+
+	void slab_link(MemoryRegion* region, RegionSlab* slab)
+	{
+		RegionSlab*& head = region->slabs[slab->sizeClass];
+		slab->prev = nullptr;
+		slab->next = head;
+		if (head) { head->prev = slab; }
+		head = slab;
+	}
+
+	void slab_unlink(MemoryRegion* region, RegionSlab* slab)
+	{
+		if (slab->prev) { slab->prev->next = slab->next; }
+		else { region->slabs[slab->sizeClass] = slab->next; }
+		if (slab->next) { slab->next->prev = slab->prev; }
+		slab->next = nullptr;
+		slab->prev = nullptr;
+	}
+
+	RegionSlab* slab_create(MemoryRegion* region, s32 sizeClass)
+	{
+		const u32 stride = sizeof(SlabItemHeader) + c_slabClassSize[sizeClass];
+		const u32 itemCount = std::max(u32(SLAB_MIN_ITEMS), u32((SLAB_TARGET_SIZE - sizeof(RegionSlab)) / stride));
+		const u64 size = alloc_align(sizeof(RegionAllocHeader) + sizeof(RegionSlab) + itemCount * stride);
+		if (size > region->blockSize) { return nullptr; }
+
+		RegionSlab* slab = (RegionSlab*)allocGeneral(region, size);
+		if (!slab) { return nullptr; }
+		RegionAllocHeader* header = (RegionAllocHeader*)((u8*)slab - sizeof(RegionAllocHeader));
+		header->type = CHUNK_SLAB;
+
+		slab->sizeClass = sizeClass;
+		slab->itemCount = itemCount;
+		slab->freeCount = itemCount;
+		slab->freeHead = 0;
+		u8* itemPtr = (u8*)slab + sizeof(RegionSlab);
+		for (u32 i = 0; i < itemCount; i++, itemPtr += stride)
+		{
+			SlabItemHeader* item = (SlabItemHeader*)itemPtr;
+			item->size = stride;
+			item->free = 1;
+			item->sizeClass = sizeClass;
+			item->type = CHUNK_SLAB_ITEM;
+			item->pad8 = 0;
+			item->slabOffset = u32(itemPtr - (u8*)slab);
+			item->nextFree = (i + 1 < itemCount) ? i + 1 : SLAB_NULL_ITEM;
+		}
+		slab_link(region, slab);
+		return slab;
+	}
+
+	void* slab_alloc(MemoryRegion* region, s32 sizeClass)
+	{
+		RegionSlab* slab = region->slabs[sizeClass];
+		if (!slab)
+		{
+			slab = slab_create(region, sizeClass);
+			if (!slab) { return nullptr; }
+		}
+		assert(slab->freeCount && slab->freeHead != SLAB_NULL_ITEM);
+
+		SlabItemHeader* item = slab_getItem(slab, slab->freeHead);
+		assert(item->free);
+		slab->freeHead = item->nextFree;
+		slab->freeCount--;
+		item->free = 0;
+		// Full slabs are removed from the list until an item is freed.
+		if (!slab->freeCount)
+		{
+			slab_unlink(region, slab);
+		}
+		return (u8*)item + sizeof(SlabItemHeader);
+	}
+
+	void slab_free(MemoryRegion* region, SlabItemHeader* item)
+	{
+		RegionSlab* slab = (RegionSlab*)((u8*)item - item->slabOffset);
+		const u32 index = (item->slabOffset - sizeof(RegionSlab)) / item->size;
+		item->free = 1;
+		item->nextFree = slab->freeHead;
+		slab->freeHead = index;
+		slab->freeCount++;
+
+		if (slab->freeCount == 1)
+		{
+			slab_link(region, slab);
+		}
+		else if (slab->freeCount == slab->itemCount && (slab->prev || slab->next))
+		{
+			// Keep one empty slab per size class so alternating allocations and frees don't keep creating slabs.
+			slab_unlink(region, slab);
+			freeGeneral(region, slab);
+		}
+	}
+
+	void slab_rebuildLists(MemoryRegion* region)
+	{
+		memset(region->slabs, 0, sizeof(RegionSlab*) * SLAB_CLASS_COUNT);
+		for (u64 i = 0; i < region->blockCount; i++)
+		{
+			MemoryBlock* block = region->memBlocks[i];
+			u8* mem = (u8*)block + sizeof(MemoryBlock);
+			for (u32 a = 0; a < block->count; a++)
+			{
+				RegionAllocHeader* header = (RegionAllocHeader*)mem;
+				if (!header->free && header->type == CHUNK_SLAB)
+				{
+					RegionSlab* slab = (RegionSlab*)(mem + sizeof(RegionAllocHeader));
+					slab->next = nullptr;
+					slab->prev = nullptr;
+					if (slab->freeCount) { slab_link(region, slab); }
+				}
+				mem += header->size;
+			}
+		}
+	}
+
+	s32 getHistogramBin(u64 size)
+	{
+		s32 bin = 0;
+		for (u64 binSize = 16; size > binSize && bin < REGION_HISTOGRAM_BINS - 1; binSize <<= 1)
+		{
+			bin++;
+		}
+		return bin;
+	}
+
 	u64 alloc_align(u64 baseSize)
 	{
 		return (baseSize + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
@@ -729,8 +1068,8 @@ namespace TFE_Memory
 		s32 bin = getBinFromSize(header->size);
 		freeNext->free = 1;
 		freeNext->bin = bin;
-		freeNext->pad8[0] = 0;
-		freeNext->pad8[1] = 0;
+		freeNext->type = CHUNK_GENERAL;
+		freeNext->pad8 = 0;
 		if (!block->freeListBins[bin])
 		{
 			block->freeListBins[bin] = freeNext;
@@ -789,6 +1128,7 @@ namespace TFE_Memory
 		RegionAllocHeader* header = (RegionAllocHeader*)((u8*)block + sizeof(MemoryBlock));
 		header->size = block->sizeFree;
 		header->free = 0;
+		header->prevSize = 0;
 		memset(block->freeListBins, 0, sizeof(AllocHeaderFree*)*ALLOC_BIN_COUNT);
 		insertBlockIntoFreelist(block, header);
 
@@ -801,6 +1141,65 @@ namespace TFE_Memory
 	#define ALLOC_COUNT 20000
 	const u64 _testAllocSize[] = { 16, 32, 24, 100, 200, 500, 327, 537, 200, 17, 57, 387, 874, 204, 100, 22 };
 
+	// Churn: keep CHURN_LIVE allocations alive while randomly replacing them, which is closer to
+	// how the level region is used during a long play session.
+	#define CHURN_LIVE  4096
+	#define CHURN_COUNT 200000
+
+	u32 churn_random(u32* seed)
+	{
+		*seed = (*seed) * 1103515245u + 12345u;
+		return (*seed) >> 8u;
+	}
+
+	u64 churn_size(u32* seed)
+	{
+		// Mostly small allocations with some mid-size ones.
+		const u32 r = churn_random(seed);
+		return (r & 15) ? 8 + (r >> 4) % 505 : 513 + (r >> 4) % 3584;
+	}
+
+	void region_testChurn()
+	{
+		void* alloc[CHURN_LIVE] = { 0 };
+		u32 seed = 1;
+		u64 start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < CHURN_COUNT; i++)
+		{
+			const u32 index = churn_random(&seed) % CHURN_LIVE;
+			free(alloc[index]);
+			alloc[index] = malloc(churn_size(&seed));
+		}
+		u64 mallocDelta = TFE_System::getCurrentTimeInTicks() - start;
+		for (s32 i = 0; i < CHURN_LIVE; i++)
+		{
+			free(alloc[i]);
+			alloc[i] = nullptr;
+		}
+
+		MemoryRegion* region = region_create("Churn", 8 * 1024 * 1024);
+		seed = 1;
+		start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < CHURN_COUNT; i++)
+		{
+			const u32 index = churn_random(&seed) % CHURN_LIVE;
+			region_free(region, alloc[index]);
+			alloc[index] = region_alloc(region, churn_size(&seed));
+		}
+		u64 regionDelta = TFE_System::getCurrentTimeInTicks() - start;
+
+		MemoryRegionStats stats;
+		region_getStats(region, &stats);
+		region_destroy(region);
+
+		const f64 mallocTime = TFE_System::convertFromTicksToSeconds(mallocDelta);
+		const f64 regionTime = TFE_System::convertFromTicksToSeconds(regionDelta);
+		TFE_System::logWrite(LOG_MSG, "MemoryRegion", "Churn %d: Malloc: %f (%.2f Mops/s), Region: %f (%.2f Mops/s)", CHURN_COUNT,
+			mallocTime, mallocTime > 0.0 ? CHURN_COUNT / mallocTime * 1e-6 : 0.0, regionTime, regionTime > 0.0 ? CHURN_COUNT / regionTime * 1e-6 : 0.0);
+		TFE_System::logWrite(LOG_MSG, "MemoryRegion", "Churn stats: used %zu / %zu, largest free %zu, fragmentation %.3f, slabs %zu (%zu / %zu items used)",
+			stats.used, stats.capacity, stats.largestFreeChunk, stats.fragmentation, stats.slabCount, stats.slabItemsUsed, stats.slabItemsUsed + stats.slabItemsFree);
+	}
+
 	void region_test()
 	{
 		u64 start = TFE_System::getCurrentTimeInTicks();
@@ -822,7 +1221,7 @@ namespace TFE_Memory
 			free(alloc[i]);
 		}
 
-		MemoryRegion* region = region_create("Test", 32 * 1024 * 1024);
+		MemoryRegion* region = region_create("Test", MAX_BLOCK_SIZE);
 		start = TFE_System::getCurrentTimeInTicks();
 		for (s32 i = 0; i < ALLOC_COUNT; i++)
 		{
@@ -838,5 +1237,7 @@ namespace TFE_Memory
 		region_destroy(region);
 
 		TFE_System::logWrite(LOG_MSG, "MemoryRegion", "Malloc: %f, Region: %f", TFE_System::convertFromTicksToSeconds(mallocDelta), TFE_System::convertFromTicksToSeconds(regionDelta));
+
+		region_testChurn();
 	}
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 //////////////////////////////////////////////////////////////////////
 // General purpose memory allocator which acts as a region of
 // memory which can be quickly cleared.
+// Allocations of up to 512 bytes are served from fixed size slabs,
+// larger allocations use the per-block free lists.
 //////////////////////////////////////////////////////////////////////
 #include <TFE_System/types.h>
 #include <TFE_FileSystem/filestream.h>
@@ -15,6 +17,33 @@ typedef u32 RelativePointer;
 
 namespace TFE_Memory
 {
+	enum RegionStatsConstants
+	{
+		// Allocation histogram bin = clamp(log2(nextPow2(size)) - 4, 0, 11)
+		// bin 0: [1, 16], 1: [17, 32], ..., 10: [8K+1, 16K], 11: 16K+
+		REGION_HISTOGRAM_BINS = 12,
+	};
+
+	struct MemoryRegionStats
+	{
+		u64 capacity;			// Total size of all blocks.
+		u64 used;				// Bytes allocated, including headers and slabs.
+		u64 free;				// Bytes available in the general free lists.
+		u64 freeChunkCount;
+		u64 largestFreeChunk;
+		f32 fragmentation;		// 1 - largestFreeChunk / free, 0 when all free memory is contiguous.
+
+		// Small allocations are served from fixed size slabs.
+		u64 slabCount;
+		u64 slabItemsUsed;
+		u64 slabItemsFree;
+
+		// Lifetime allocation counts, the histogram is based on the requested size.
+		u64 allocCount;
+		u64 freeCount;
+		u64 histogram[REGION_HISTOGRAM_BINS];
+	};
+
 	MemoryRegion* region_create(const char* name, u64 blockSize, u64 maxSize = 0u);
 	void region_clear(MemoryRegion* region);
 	void region_destroy(MemoryRegion* region);
@@ -26,6 +55,8 @@ namespace TFE_Memory
 	u64 region_getMemoryUsed(MemoryRegion* region);
 	u64 region_getMemoryCapacity(MemoryRegion* region);
 	void region_getBlockInfo(MemoryRegion* region, u64* blockCount, u64* blockSize);
+	// Walks the region, so avoid calling every frame.
+	void region_getStats(MemoryRegion* region, MemoryRegionStats* stats);
 
 	RelativePointer region_getRelativePointer(MemoryRegion* region, void* ptr);
 	void* region_getRealPointer(MemoryRegion* region, RelativePointer ptr);
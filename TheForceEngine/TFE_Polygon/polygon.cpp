@@ -42,24 +42,30 @@ namespace TFE_Polygon
 	const f64 c_toFixed = 65536.0;
 	const f64 c_fromFixed = 1.0 / 65536.0;
 
-	static bool s_init = false;
-	static std::vector<Vec2f> s_vertices;
-	static std::vector<Triangle> s_triangles;
-	static std::vector<s32> s_freeList;
-	static std::vector<TriEdge> s_edges;
-	static std::vector<Edge> s_constraints;
-	static Vec2f s_coordCenter;
+	// Triangulation working state, kept in a context so polygons can be triangulated on several threads at once.
+	struct TriangulationContext
+	{
+		std::vector<Vec2f> vertices;
+		std::vector<Triangle> triangles;
+		std::vector<s32> freeList;
+		std::vector<TriEdge> edges;
+		std::vector<Edge> constraints;
+		Vec2f coordCenter;
+	};
+
+	// Used by computeTriangulation() when no context is passed in, one per thread.
+	static thread_local TriangulationContext s_threadContext;
 	   
 	static ClipperLib::Clipper* s_clipper = nullptr;
 
-	void deleteTriangle(Triangle* tri);
+	void deleteTriangle(TriangulationContext* ctx, Triangle* tri);
 
-	s32 computeAdjacency(s32 i0, s32 i1, s32 id)
+	s32 computeAdjacency(TriangulationContext* ctx, s32 i0, s32 i1, s32 id)
 	{
 		s32 adj = -1;
 
-		const size_t count = s_triangles.size();
-		Triangle* tri = s_triangles.data();
+		const size_t count = ctx->triangles.size();
+		Triangle* tri = ctx->triangles.data();
 		for (size_t t = 0; t < count; t++, tri++)
 		{
 			if (t == id || !tri->allocated) { continue; }
@@ -85,22 +91,22 @@ namespace TFE_Polygon
 		return adj;
 	}
 
-	void addTriangle(s32 i0, s32 i1, s32 i2)
+	void addTriangle(TriangulationContext* ctx, s32 i0, s32 i1, s32 i2)
 	{
 		Triangle* tri = nullptr;
 		s32 id = -1;
-		if (!s_freeList.empty())
+		if (!ctx->freeList.empty())
 		{
-			id = s_freeList.back();
-			tri = &s_triangles[id];
+			id = ctx->freeList.back();
+			tri = &ctx->triangles[id];
 			PolyAssert(tri->id == id);
-			s_freeList.pop_back();
+			ctx->freeList.pop_back();
 		}
 		else
 		{
-			id = (s32)s_triangles.size();
-			s_triangles.push_back({});
-			tri = &s_triangles[id];
+			id = (s32)ctx->triangles.size();
+			ctx->triangles.push_back({});
+			tri = &ctx->triangles[id];
 			tri->id = id;
 		}
 
@@ -110,13 +116,13 @@ namespace TFE_Polygon
 		tri->idx[1] = i1;
 		tri->idx[2] = i2;
 
-		tri->adj[0] = computeAdjacency(i0, i1, id);
-		tri->adj[1] = computeAdjacency(i1, i2, id);
-		tri->adj[2] = computeAdjacency(i2, i0, id);
+		tri->adj[0] = computeAdjacency(ctx, i0, i1, id);
+		tri->adj[1] = computeAdjacency(ctx, i1, i2, id);
+		tri->adj[2] = computeAdjacency(ctx, i2, i0, id);
 
-		Vec2f v0 = s_vertices[i0];
-		Vec2f v1 = s_vertices[i1];
-		Vec2f v2 = s_vertices[i2];
+		Vec2f v0 = ctx->vertices[i0];
+		Vec2f v1 = ctx->vertices[i1];
+		Vec2f v2 = ctx->vertices[i2];
 
 		// Compute the centroid.
 		tri->centroid.x = (v0.x + v1.x + v2.x) / 3.0f;
@@ -145,21 +151,21 @@ namespace TFE_Polygon
 		tri->radiusSq = std::max(tri->radiusSq, r2);
 	}
 
-	void addTriangle(const Vec2f& v0, const Vec2f& v1, const Vec2f& v2)
+	void addTriangle(TriangulationContext* ctx, const Vec2f& v0, const Vec2f& v1, const Vec2f& v2)
 	{
 		Triangle* tri = nullptr;
 		s32 id = -1;
-		if (!s_freeList.empty())
+		if (!ctx->freeList.empty())
 		{
-			id = s_freeList.back();
-			tri = &s_triangles[id];
-			s_freeList.pop_back();
+			id = ctx->freeList.back();
+			tri = &ctx->triangles[id];
+			ctx->freeList.pop_back();
 		}
 		else
 		{
-			id = (s32)s_triangles.size();
-			s_triangles.push_back({});
-			tri = &s_triangles[id];
+			id = (s32)ctx->triangles.size();
+			ctx->triangles.push_back({});
+			tri = &ctx->triangles[id];
 			tri->id = id;
 		}
 
@@ -173,9 +179,9 @@ namespace TFE_Polygon
 		tri->adj[1] = -1;
 		tri->adj[2] = -1;
 
-		s_vertices.push_back(v0);
-		s_vertices.push_back(v1);
-		s_vertices.push_back(v2);
+		ctx->vertices.push_back(v0);
+		ctx->vertices.push_back(v1);
+		ctx->vertices.push_back(v2);
 
 		// Compute the centroid.
 		tri->centroid.x = (v0.x + v1.x + v2.x) / 3.0f;
@@ -195,13 +201,13 @@ namespace TFE_Polygon
 		tri->radiusSq = offset.x*offset.x + offset.z*offset.z;
 	}
 
-	void createSuperTriangle(Polygon* poly)
+	void createSuperTriangle(TriangulationContext* ctx, Polygon* poly)
 	{
 		Vec2f centroid = { (poly->bounds[0].x + poly->bounds[1].x) * 0.5f, (poly->bounds[0].z + poly->bounds[1].z) * 0.5f };
-		s_coordCenter.x = floorf(centroid.x);
-		s_coordCenter.z = floorf(centroid.z);
-		centroid.x -= s_coordCenter.x;
-		centroid.z -= s_coordCenter.z;
+		ctx->coordCenter.x = floorf(centroid.x);
+		ctx->coordCenter.z = floorf(centroid.z);
+		centroid.x -= ctx->coordCenter.x;
+		centroid.z -= ctx->coordCenter.z;
 
 		Vec2f ext = { poly->bounds[1].x - poly->bounds[0].x, poly->bounds[1].z - poly->bounds[0].z };
 		f32 maxExt = std::max(ext.x, ext.z);
@@ -209,7 +215,7 @@ namespace TFE_Polygon
 		Vec2f v0 = { centroid.x - maxExt * 5.0f, centroid.z - maxExt };
 		Vec2f v1 = { centroid.x, centroid.z + maxExt * 5.0f };
 		Vec2f v2 = { centroid.x + maxExt * 5.0f, centroid.z - maxExt };
-		addTriangle(v0, v1, v2);
+		addTriangle(ctx, v0, v1, v2);
 	}
 
 	void computePolygonBounds(Polygon* poly)
@@ -227,10 +233,10 @@ namespace TFE_Polygon
 		}
 	}
 
-	void addEdge(s32 i0, s32 i1)
+	void addEdge(TriangulationContext* ctx, s32 i0, s32 i1)
 	{
-		const size_t count = s_edges.size();
-		TriEdge* edge = s_edges.data();
+		const size_t count = ctx->edges.size();
+		TriEdge* edge = ctx->edges.data();
 		for (size_t e = 0; e < count; e++, edge++)
 		{
 			if ((edge->idx[0] == i0 && edge->idx[1] == i1) || (edge->idx[0] == i1 && edge->idx[1] == i0))
@@ -239,26 +245,26 @@ namespace TFE_Polygon
 				return;
 			}
 		}
-		s_edges.push_back({ i0, i1, 0 });
+		ctx->edges.push_back({ i0, i1, 0 });
 	}
 
-	void deleteTriangle(Triangle* tri)
+	void deleteTriangle(TriangulationContext* ctx, Triangle* tri)
 	{
 		tri->allocated = false;
 		tri->adj[0] = -1;
 		tri->adj[1] = -1;
 		tri->adj[2] = -1;
-		s_freeList.push_back(tri->id);
+		ctx->freeList.push_back(tri->id);
 	}
 
-	void addPoint(Vec2f vtx)
+	void addPoint(TriangulationContext* ctx, Vec2f vtx)
 	{
-		s32 vtxIndex = (s32)s_vertices.size();
-		s_vertices.push_back(vtx);
+		s32 vtxIndex = (s32)ctx->vertices.size();
+		ctx->vertices.push_back(vtx);
 
-		const size_t count = s_triangles.size();
-		Triangle* tri = s_triangles.data();
-		s_edges.clear();
+		const size_t count = ctx->triangles.size();
+		Triangle* tri = ctx->triangles.data();
+		ctx->edges.clear();
 
 		f32 smallestDiff = FLT_MAX;
 		for (size_t t = 0; t < count; t++, tri++)
@@ -275,34 +281,34 @@ namespace TFE_Polygon
 			if (distSq <= tri->radiusSq + eps)
 			{
 				// Add triangle edges for later processing.
-				addEdge(tri->idx[0], tri->idx[1]);
-				addEdge(tri->idx[1], tri->idx[2]);
-				addEdge(tri->idx[2], tri->idx[0]);
+				addEdge(ctx, tri->idx[0], tri->idx[1]);
+				addEdge(ctx, tri->idx[1], tri->idx[2]);
+				addEdge(ctx, tri->idx[2], tri->idx[0]);
 				// Delete the parent triangle.
-				deleteTriangle(tri);
+				deleteTriangle(ctx, tri);
 			}
 		}
-		PolyAssert(!s_edges.empty());
+		PolyAssert(!ctx->edges.empty());
 
 		// Fix up triangle adjacency.
-		tri = s_triangles.data();
+		tri = ctx->triangles.data();
 		for (size_t t = 0; t < count; t++, tri++)
 		{
 			if (!tri->allocated) { continue; }
-			if (tri->adj[0] >= 0 && !s_triangles[tri->adj[0]].allocated) { tri->adj[0] = -1; }
-			if (tri->adj[1] >= 0 && !s_triangles[tri->adj[1]].allocated) { tri->adj[1] = -1; }
-			if (tri->adj[2] >= 0 && !s_triangles[tri->adj[2]].allocated) { tri->adj[2] = -1; }
+			if (tri->adj[0] >= 0 && !ctx->triangles[tri->adj[0]].allocated) { tri->adj[0] = -1; }
+			if (tri->adj[1] >= 0 && !ctx->triangles[tri->adj[1]].allocated) { tri->adj[1] = -1; }
+			if (tri->adj[2] >= 0 && !ctx->triangles[tri->adj[2]].allocated) { tri->adj[2] = -1; }
 		}
 
 		// Form a new triangle between the vertex and any edge with adjacency.
-		const size_t edgeCount = s_edges.size();
-		const TriEdge* edge = s_edges.data();
+		const size_t edgeCount = ctx->edges.size();
+		const TriEdge* edge = ctx->edges.data();
 		for (size_t e = 0; e < edgeCount; e++, edge++)
 		{
 			if (edge->refCount) { continue; }
 
 			// Form a triangle from vtxIndex -> edge indices.
-			addTriangle(vtxIndex, edge->idx[0], edge->idx[1]);
+			addTriangle(ctx, vtxIndex, edge->idx[0], edge->idx[1]);
 		}
 	}
 
@@ -495,7 +501,7 @@ namespace TFE_Polygon
 		return (crossings & 1) != 0;
 	}
 		
-	void constraintSplit(s32 i0, s32 i1, s32 newVtx, Triangle* tri, Vec2f it, const Vec2f* c0, const Vec2f* c1, f32 prevConstIt)
+	void constraintSplit(TriangulationContext* ctx, s32 i0, s32 i1, s32 newVtx, Triangle* tri, Vec2f it, const Vec2f* c0, const Vec2f* c1, f32 prevConstIt)
 	{
 		// Find the matching edge.
 		s32 startIndex = -1;
@@ -522,8 +528,8 @@ namespace TFE_Polygon
 			s32 A = tri->idx[a];
 			s32 B = tri->idx[b];
 
-			const Vec2f* v0 = &s_vertices[A];
-			const Vec2f* v1 = &s_vertices[B];
+			const Vec2f* v0 = &ctx->vertices[A];
+			const Vec2f* v1 = &ctx->vertices[B];
 
 			// Compute the intersection between line segment c0->c1 and v0->v1
 			f32 constInter, triEdgeInter;
@@ -552,48 +558,48 @@ namespace TFE_Polygon
 				// T(newVtx, endVertex, t0)
 				// T(newVtx, t1, endVertex)
 
-				deleteTriangle(tri);
-				addTriangle(newVtx, endVertex, t0);
-				addTriangle(newVtx, t1, endVertex);
+				deleteTriangle(ctx, tri);
+				addTriangle(ctx, newVtx, endVertex, t0);
+				addTriangle(ctx, newVtx, t1, endVertex);
 			}
 			// Constraint hits the edge.
 			else
 			{
 				s32 adj = tri->adj[a];
 				s32 N = newVtx;
-				s32 P = (s32)s_vertices.size();
+				s32 P = (s32)ctx->vertices.size();
 				Vec2f newIt = { v0->x + triEdgeInter * (v1->x - v0->x), v0->z + triEdgeInter * (v1->z - v0->z) };
-				s_vertices.push_back(newIt);
+				ctx->vertices.push_back(newIt);
 
-				deleteTriangle(tri);
+				deleteTriangle(ctx, tri);
 				if (i == 1)  // Next adjacent edge
 				{
 					PolyAssert(A == t1);
 					PolyAssert(B != t0);
-					addTriangle(N, t1, P);
-					addTriangle(N, P, B);
-					addTriangle(N, B, t0);
+					addTriangle(ctx, N, t1, P);
+					addTriangle(ctx, N, P, B);
+					addTriangle(ctx, N, B, t0);
 				}
 				else
 				{
 					PolyAssert(B == t0);
 					PolyAssert(A != t1);
-					addTriangle(N, t1, A);
-					addTriangle(N, A, P);
-					addTriangle(N, P, t0);
+					addTriangle(ctx, N, t1, A);
+					addTriangle(ctx, N, A, P);
+					addTriangle(ctx, N, P, t0);
 				}
 
 				// Continue to the next triangle.
-				if (adj >= 0 && s_triangles[adj].allocated && constInter < 1.0f - eps)
+				if (adj >= 0 && ctx->triangles[adj].allocated && constInter < 1.0f - eps)
 				{
-					constraintSplit(A, B, P, &s_triangles[adj], newIt, c0, c1, constInter);
+					constraintSplit(ctx, A, B, P, &ctx->triangles[adj], newIt, c0, c1, constInter);
 				}
 			}
 			break;
 		}
 	}
 
-	bool insertConstraint(Polygon* poly, const Edge* constraint, Triangle* tri, s32 startIndex)
+	bool insertConstraint(TriangulationContext* ctx, Polygon* poly, const Edge* constraint, Triangle* tri, s32 startIndex)
 	{
 		// *If* the constraint intersects an edge of *this* triangle, it must
 		// be the opposite edge.
@@ -601,11 +607,11 @@ namespace TFE_Polygon
 		s32 e1 = (e0 + 1) % 3;
 		s32 i0 = tri->idx[e0];
 		s32 i1 = tri->idx[e1];
-		const Vec2f* c0 = &s_vertices[constraint->i0];
-		const Vec2f* c1 = &s_vertices[constraint->i1];
+		const Vec2f* c0 = &ctx->vertices[constraint->i0];
+		const Vec2f* c1 = &ctx->vertices[constraint->i1];
 
-		const Vec2f* v0 = &s_vertices[i0];
-		const Vec2f* v1 = &s_vertices[i1];
+		const Vec2f* v0 = &ctx->vertices[i0];
+		const Vec2f* v1 = &ctx->vertices[i1];
 
 		// Compute the intersection between line segment c0->c1 and v0->v1
 		f32 constInter, triEdgeInter;
@@ -625,21 +631,21 @@ namespace TFE_Polygon
 		const s32 S = tri->idx[startIndex];
 		
 		// Delete triangle.
-		deleteTriangle(tri);
+		deleteTriangle(ctx, tri);
 
 		// Add two new triangles:
 		// startIndex -> iEdge -> newVtx
 		// startIndex -> newVtx -> iEdge + 1
-		s32 N = (s32)s_vertices.size();
+		s32 N = (s32)ctx->vertices.size();
 		Vec2f it = { v0->x + triEdgeInter * (v1->x - v0->x), v0->z + triEdgeInter * (v1->z - v0->z) };
-		s_vertices.push_back(it);
-		addTriangle(S, i0, N);
-		addTriangle(S, N, i1);
+		ctx->vertices.push_back(it);
+		addTriangle(ctx, S, i0, N);
+		addTriangle(ctx, S, N, i1);
 
 		// Move on to the next triangle.
-		if (adj >= 0 && s_triangles[adj].allocated && constInter <= 1.0f - eps)
+		if (adj >= 0 && ctx->triangles[adj].allocated && constInter <= 1.0f - eps)
 		{
-			constraintSplit(i0, i1, N, &s_triangles[adj], it, c0, c1, constInter);
+			constraintSplit(ctx, i0, i1, N, &ctx->triangles[adj], it, c0, c1, constInter);
 		}
 		return true;
 	}
@@ -648,21 +654,32 @@ namespace TFE_Polygon
 	// Polygons may be complex, self-intersecting, and even be incomplete.
 	// The goal is a *robust* triangulation system that will always produce
 	// a plausible result even with malformed data.
+	TriangulationContext* createTriangulationContext()
+	{
+		TriangulationContext* ctx = new TriangulationContext();
+		ctx->freeList.reserve(256);
+		ctx->constraints.reserve(256);
+		ctx->triangles.reserve(1024);
+		ctx->vertices.reserve(1024);
+		return ctx;
+	}
+
+	void destroyTriangulationContext(TriangulationContext* ctx)
+	{
+		delete ctx;
+	}
+
 	bool computeTriangulation(Polygon* poly, u32 debug)
 	{
-		if (!s_init)
-		{
-			s_init = true;
-			s_freeList.reserve(256);
-			s_constraints.reserve(256);
-			s_triangles.reserve(1024);
-			s_vertices.reserve(1024);
-		}
+		return computeTriangulation(poly, &s_threadContext, debug);
+	}
 
-		s_freeList.clear();
-		s_triangles.clear();
-		s_vertices.clear();
-		s_constraints.clear();
+	bool computeTriangulation(Polygon* poly, TriangulationContext* ctx, u32 debug)
+	{
+		ctx->freeList.clear();
+		ctx->triangles.clear();
+		ctx->vertices.clear();
+		ctx->constraints.clear();
 
 		poly->triVtx.clear();
 		poly->triIdx.clear();
@@ -693,18 +710,18 @@ namespace TFE_Polygon
 
 		// 1. Given the vertices that make up the polygon, perform a Delaunary triangulation.
 		// 1.a Create a "super triangle" to hold all of the points.
-		createSuperTriangle(poly);
+		createSuperTriangle(ctx, poly);
 
 		// 1.b Add each point iteratively.
 		const size_t vtxCount = poly->vtx.size();
 		const Vec2f* vtx = poly->vtx.data();
 		for (size_t v = 0; v < vtxCount; v++, vtx++)
 		{
-			addPoint({ vtx->x - s_coordCenter.x, vtx->z - s_coordCenter.z });
+			addPoint(ctx, { vtx->x - ctx->coordCenter.x, vtx->z - ctx->coordCenter.z });
 		}
 
 		// 2. Insert edges, splitting triangles as needed (note: new vertices may be added, but polygons should be re-triangulated instead).
-		size_t triCount = s_triangles.size();
+		size_t triCount = ctx->triangles.size();
 		const Edge* edge = poly->edge.data();
 		for (size_t e = 0; e < edgeCount; e++, edge++)
 		{
@@ -713,7 +730,7 @@ namespace TFE_Polygon
 			s32 i1 = edge->i1 + 3;
 
 			bool edgeFound = false;
-			Triangle* tri = tri = s_triangles.data();
+			Triangle* tri = tri = ctx->triangles.data();
 			for (size_t t = 0; t < triCount; t++, tri++)
 			{
 				if (!tri->allocated) { continue; }
@@ -733,16 +750,16 @@ namespace TFE_Polygon
 			// Other add the edge for insertion.
 			if (!edgeFound)
 			{
-				s_constraints.push_back({ i0, i1 });
+				ctx->constraints.push_back({ i0, i1 });
 			}
 		}
-		const size_t constraintCount = s_constraints.size();
-		const Edge* constraint = s_constraints.data();
+		const size_t constraintCount = ctx->constraints.size();
+		const Edge* constraint = ctx->constraints.data();
 		for (size_t e = 0; e < constraintCount; e++, constraint++)
 		{
 			// Find all triangles that share a vertex with the constraint.
-			Triangle* triList = s_triangles.data();
-			size_t curTriCount = s_triangles.size(); // Update the count since triangles can change.
+			Triangle* triList = ctx->triangles.data();
+			size_t curTriCount = ctx->triangles.size(); // Update the count since triangles can change.
 			bool constraintHasMatch = false;
 			for (size_t t = 0; t < curTriCount; t++)
 			{
@@ -755,21 +772,21 @@ namespace TFE_Polygon
 
 				if (startIndex >= 0)
 				{
-					if (insertConstraint(poly, constraint, tri, startIndex))
+					if (insertConstraint(ctx, poly, constraint, tri, startIndex))
 					{
 						constraintHasMatch = true;
 					}
 					// The triangle count may change, but triangle order will not.
 					// The memory address may change if the array is resized.
-					triList = s_triangles.data();
+					triList = ctx->triangles.data();
 				}
 			}
 			//PolyAssert(constraintHasMatch);
 		}
 
 		// 3. Remove triangles that contain a super triangle vertex.
-		triCount = s_triangles.size();
-		Triangle* tri = s_triangles.data();
+		triCount = ctx->triangles.size();
+		Triangle* tri = ctx->triangles.data();
 		if (!(debug & PDBG_SHOW_SUPERTRI))
 		{
 			for (size_t t = 0; t < triCount; t++, tri++)
@@ -777,15 +794,15 @@ namespace TFE_Polygon
 				if (!tri->allocated) { continue; }
 				if (tri->idx[0] < 3 || tri->idx[1] < 3 || tri->idx[2] < 3)
 				{
-					deleteTriangle(tri);
+					deleteTriangle(ctx, tri);
 					continue;
 				}
 			}
 		}
 
 		// 4. Given the final resulting triangles, determine which are *inside* of the complex polygon, discard the rest.
-		tri = s_triangles.data();
-		triCount = s_triangles.size();
+		tri = ctx->triangles.data();
+		triCount = ctx->triangles.size();
 		for (size_t t = 0; t < triCount; t++, tri++)
 		{
 			if (!tri->allocated) { continue; }
@@ -795,9 +812,9 @@ namespace TFE_Polygon
 				// Always jitter the centroid z slightly so that it is less likely to be exactly the same as a vertex z,
 				// which can cause detection issues.
 				tri->centroid.z += 0.01f;
-				if (!pointInsidePolygon(poly, { tri->centroid.x + s_coordCenter.x, tri->centroid.z + s_coordCenter.z }))
+				if (!pointInsidePolygon(poly, { tri->centroid.x + ctx->coordCenter.x, tri->centroid.z + ctx->coordCenter.z }))
 				{
-					deleteTriangle(tri);
+					deleteTriangle(ctx, tri);
 					continue;
 				}
 			}
@@ -808,14 +825,14 @@ namespace TFE_Polygon
 			poly->triIdx.push_back(tri->idx[2]);
 		}
 		// TODO: Remove unused vertices.
-		const size_t finalVtxCount = s_vertices.size();
+		const size_t finalVtxCount = ctx->vertices.size();
 		poly->triVtx.resize(finalVtxCount);
 
-		const Vec2f* srcVtx = s_vertices.data();
+		const Vec2f* srcVtx = ctx->vertices.data();
 		Vec2f* dstVtx = poly->triVtx.data();
 		for (size_t v = 0; v < finalVtxCount; v++, srcVtx++)
 		{
-			dstVtx[v] = { srcVtx->x + s_coordCenter.x, srcVtx->z + s_coordCenter.z };
+			dstVtx[v] = { srcVtx->x + ctx->coordCenter.x, srcVtx->z + ctx->coordCenter.z };
 		}
 
 		return true;
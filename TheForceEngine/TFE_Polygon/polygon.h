@@ -51,11 +51,19 @@ struct BPolygon
 
 namespace TFE_Polygon
 {
+	// Working memory used by the triangulation, a context can only be used by one thread at a time.
+	struct TriangulationContext;
+	TriangulationContext* createTriangulationContext();
+	void destroyTriangulationContext(TriangulationContext* context);
+
+	// Triangulation is thread safe, the first version uses a per-thread context.
 	bool computeTriangulation(Polygon* poly, u32 debug=PDBG_NONE);
+	bool computeTriangulation(Polygon* poly, TriangulationContext* context, u32 debug=PDBG_NONE);
 	bool pointInsidePolygon(const Polygon* poly, Vec2f p);
 	// Return edge index or -1 if point not on an edge.
 	s32  pointOnPolygonEdge(const Polygon* poly, Vec2f p);
 
+	// Clipping shares a single clipper and must only be used from one thread.
 	void clipInit();
 	void clipDestroy();
 	void clipPolygons(const BPolygon* subject, const BPolygon* clip, std::vector<BPolygon>& outPoly, BoolMode boolMode);
@@ -400,6 +400,7 @@ namespace TFE_Settings
 		writeKeyValue_Bool(settings, "colorCorrection", s_graphicsSettings.colorCorrection);
 		writeKeyValue_Bool(settings, "perspectiveCorrect3DO", s_graphicsSettings.perspectiveCorrectTexturing);
 		writeKeyValue_Bool(settings, "extendAjoinLimits", s_graphicsSettings.extendAjoinLimits);
+		writeKeyValue_Bool(settings, "multithreadedRender", s_graphicsSettings.multithreadedRender);
 		writeKeyValue_Bool(settings, "vsync", s_graphicsSettings.vsync);
 		writeKeyValue_Bool(settings, "show_fps", s_graphicsSettings.showFps);
 		writeKeyValue_Bool(settings, "3doNormalFix", s_graphicsSettings.fix3doNormalOverflow);
@@ -474,6 +475,7 @@ namespace TFE_Settings
 		writeKeyValue_Bool(settings, "gameExitsToMenu", s_systemSettings.gameQuitExitsToMenu);
 		writeKeyValue_Bool(settings, "returnToModLoader", s_systemSettings.returnToModLoader);
 		writeKeyValue_Float(settings, "gifRecordingFramerate", s_systemSettings.gifRecordingFramerate);
+		writeKeyValue_Bool(settings, "levelCache", s_systemSettings.levelCache);
 	}
 
 	void writeA11ySettings(FileStream& settings)
@@ -729,6 +731,10 @@ namespace TFE_Settings
 		{
 			s_graphicsSettings.extendAjoinLimits = parseBool(value);
 		}
+		else if (strcasecmp("multithreadedRender", key) == 0)
+		{
+			s_graphicsSettings.multithreadedRender = parseBool(value);
+		}
 		else if (strcasecmp("vsync", key) == 0)
 		{
 			s_graphicsSettings.vsync = parseBool(value);
@@ -955,6 +961,10 @@ namespace TFE_Settings
 		{
 			s_systemSettings.gifRecordingFramerate = parseFloat(value);
 		}
+		else if (strcasecmp("levelCache", key) == 0)
+		{
+			s_systemSettings.levelCache = parseBool(value);
+		}
 	}
 	
 	void parseA11ySettings(const char* key, const char* value)
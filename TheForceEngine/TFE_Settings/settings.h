@@ -62,6 +62,7 @@ struct TFE_Settings_Graphics
 	bool  colorCorrection = false;
 	bool  perspectiveCorrectTexturing = false;
 	bool  extendAjoinLimits = true;
+	bool  multithreadedRender = false;
 	bool  vsync = true;
 	bool  showFps = false;
 	bool  fix3doNormalOverflow = true;
@@ -222,6 +223,7 @@ struct TFE_Settings_System
 	bool gameQuitExitsToMenu = true;	// Quitting from the game returns to the main menu instead.
 	bool returnToModLoader = true;		// Return to the Mod Loader if running a mod.
 	f32 gifRecordingFramerate = 18;		// Used with GIF recording (Alt-F2)
+	bool levelCache = true;				// Cache parsed level files in the program data "Cache/" directory.
 };
 
 struct TFE_Settings_A11y
@@ -0,0 +1,235 @@
+#include <TFE_System/jobs.h>
+#include <TFE_System/system.h>
+#include <TFE_System/profiler.h>
+#include <SDL_cpuinfo.h>
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+namespace TFE_Jobs
+{
+	enum
+	{
+		MAX_WORKER_COUNT = 15,
+	};
+
+	struct Job
+	{
+		JobFunc func;
+		void* userData;
+		s32 index;
+		JobCounter* counter;
+	};
+
+	static std::vector<SDL_Thread*> s_workers;
+	static std::deque<Job> s_jobQueue;
+	static SDL_mutex* s_mutex = nullptr;
+	static SDL_cond* s_workCond = nullptr;
+	static SDL_cond* s_doneCond = nullptr;
+	static std::atomic<bool> s_running(false);
+
+	int workerFunc(void* userData);
+
+	bool init(s32 workerCount)
+	{
+		if (s_running) { return true; }
+		if (workerCount <= 0)
+		{
+			workerCount = std::max(1, SDL_GetCPUCount() - 1);
+		}
+		workerCount = std::min(workerCount, (s32)MAX_WORKER_COUNT);
+
+		s_mutex = SDL_CreateMutex();
+		s_workCond = SDL_CreateCond();
+		s_doneCond = SDL_CreateCond();
+		if (!s_mutex || !s_workCond || !s_doneCond)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Jobs", "Cannot create the job system synchronization primitives, jobs will run inline.");
+			shutdown();
+			return false;
+		}
+
+		s_running = true;
+		for (s32 i = 0; i < workerCount; i++)
+		{
+			char name[32];
+			sprintf(name, "TFE_Worker%d", i);
+			SDL_Thread* thread = SDL_CreateThread(workerFunc, name, nullptr);
+			if (!thread)
+			{
+				TFE_System::logWrite(LOG_ERROR, "Jobs", "Cannot create worker thread %d.", i);
+				break;
+			}
+			s_workers.push_back(thread);
+		}
+		TFE_System::logWrite(LOG_MSG, "Jobs", "Started %d worker threads.", (s32)s_workers.size());
+		return true;
+	}
+
+	void shutdown()
+	{
+		if (s_mutex)
+		{
+			SDL_LockMutex(s_mutex);
+			s_running = false;
+			SDL_CondBroadcast(s_workCond);
+			SDL_UnlockMutex(s_mutex);
+		}
+		s_running = false;
+
+		for (size_t i = 0; i < s_workers.size(); i++)
+		{
+			SDL_WaitThread(s_workers[i], nullptr);
+		}
+		s_workers.clear();
+		s_jobQueue.clear();
+
+		if (s_doneCond) { SDL_DestroyCond(s_doneCond); }
+		if (s_workCond) { SDL_DestroyCond(s_workCond); }
+		if (s_mutex) { SDL_DestroyMutex(s_mutex); }
+		s_doneCond = nullptr;
+		s_workCond = nullptr;
+		s_mutex = nullptr;
+	}
+
+	s32 getWorkerCount()
+	{
+		return (s32)s_workers.size();
+	}
+
+	void runJob(const Job& job)
+	{
+		TFE_ZONE("Job");
+		job.func(job.userData, job.index);
+		if (job.counter->count.fetch_sub(1) == 1)
+		{
+			// Wake up any threads waiting on this batch.
+			SDL_LockMutex(s_mutex);
+			SDL_CondBroadcast(s_doneCond);
+			SDL_UnlockMutex(s_mutex);
+		}
+	}
+
+	// Must be called with the mutex held.
+	// If 'counter' is not null, only jobs belonging to that batch are considered.
+	bool popJob(Job* job, const JobCounter* counter = nullptr)
+	{
+		std::deque<Job>::iterator iJob = s_jobQueue.begin();
+		if (counter)
+		{
+			iJob = std::find_if(s_jobQueue.begin(), s_jobQueue.end(), [counter](const Job& j) { return j.counter == counter; });
+		}
+		if (iJob == s_jobQueue.end()) { return false; }
+
+		*job = *iJob;
+		s_jobQueue.erase(iJob);
+		return true;
+	}
+
+	int workerFunc(void* userData)
+	{
+		TFE_THREAD_NAME("Job Worker");
+		SDL_LockMutex(s_mutex);
+		while (s_running)
+		{
+			Job job;
+			if (popJob(&job))
+			{
+				SDL_UnlockMutex(s_mutex);
+				runJob(job);
+				SDL_LockMutex(s_mutex);
+			}
+			else
+			{
+				SDL_CondWait(s_workCond, s_mutex);
+			}
+		}
+		SDL_UnlockMutex(s_mutex);
+		return 0;
+	}
+
+	void submit(JobFunc func, void* userData, s32 count, JobCounter* counter)
+	{
+		if (count <= 0) { return; }
+		counter->count += count;
+
+		// No workers, so just run the jobs immediately.
+		if (s_workers.empty())
+		{
+			for (s32 i = 0; i < count; i++)
+			{
+				func(userData, i);
+				counter->count--;
+			}
+			return;
+		}
+
+		SDL_LockMutex(s_mutex);
+		for (s32 i = 0; i < count; i++)
+		{
+			s_jobQueue.push_back({ func, userData, i, counter });
+		}
+		if (count > 1) { SDL_CondBroadcast(s_workCond); }
+		else { SDL_CondSignal(s_workCond); }
+		SDL_UnlockMutex(s_mutex);
+	}
+
+	bool isDone(const JobCounter* counter)
+	{
+		return counter->count.load() <= 0;
+	}
+
+	void wait(JobCounter* counter)
+	{
+		if (isDone(counter)) { return; }
+
+		SDL_LockMutex(s_mutex);
+		while (!isDone(counter))
+		{
+			// Help out while waiting, but only with jobs from the same batch so that an unrelated
+			// long running job doesn't stall the caller.
+			Job job;
+			if (popJob(&job, counter))
+			{
+				SDL_UnlockMutex(s_mutex);
+				runJob(job);
+				SDL_LockMutex(s_mutex);
+			}
+			else
+			{
+				SDL_CondWait(s_doneCond, s_mutex);
+			}
+		}
+		SDL_UnlockMutex(s_mutex);
+	}
+
+	void parallelFor(JobFunc func, void* userData, s32 count)
+	{
+		if (count <= 0) { return; }
+		if (count == 1 || s_workers.empty())
+		{
+			for (s32 i = 0; i < count; i++)
+			{
+				func(userData, i);
+			}
+			return;
+		}
+
+		// Queue all but the first job, which runs on the calling thread.
+		JobCounter counter;
+		counter.count = count - 1;
+		SDL_LockMutex(s_mutex);
+		for (s32 i = 1; i < count; i++)
+		{
+			s_jobQueue.push_back({ func, userData, i, &counter });
+		}
+		SDL_CondBroadcast(s_workCond);
+		SDL_UnlockMutex(s_mutex);
+
+		func(userData, 0);
+		wait(&counter);
+	}
+}
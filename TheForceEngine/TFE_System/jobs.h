@@ -0,0 +1,43 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// The Force Engine Job System
+// A small pool of worker threads used to run work in the background
+// or to split a task into pieces that run in parallel.
+//////////////////////////////////////////////////////////////////////
+
+#include "types.h"
+#include <atomic>
+
+// Job function, 'index' is the index of the job within its batch.
+typedef void(*JobFunc)(void* userData, s32 index);
+
+// Tracks the number of outstanding jobs in a batch, this reaches zero
+// once every job in the batch has finished.
+struct JobCounter
+{
+	std::atomic<s32> count;
+
+	JobCounter() : count(0) {}
+};
+
+namespace TFE_Jobs
+{
+	// workerCount = 0 picks a count based on the number of CPU cores.
+	bool init(s32 workerCount = 0);
+	void shutdown();
+
+	// Returns the number of worker threads, 0 if jobs run inline on the calling thread.
+	s32  getWorkerCount();
+
+	// Calls func(userData, i) for i = [0, count) using the workers and the calling thread.
+	// Returns once all of the calls have completed.
+	void parallelFor(JobFunc func, void* userData, s32 count);
+
+	// Queue 'count' jobs to run in the background, 'counter' is incremented by 'count'
+	// and decremented as each job completes.
+	void submit(JobFunc func, void* userData, s32 count, JobCounter* counter);
+	bool isDone(const JobCounter* counter);
+	// Block until all of the jobs tracked by 'counter' have completed, the calling thread
+	// helps process queued jobs while waiting.
+	void wait(JobCounter* counter);
+}
@@ -3,10 +3,12 @@
 #include "parser.h"
 #include <assert.h>
 #include <algorithm>
+#include <cstdlib>
 
 namespace
 {
-	static char s_line[4096];
+	// Per-thread so that files can be parsed on the job workers.
+	static thread_local char s_line[4096];
 	bool isWhitespace(const char c)
 	{
 		if (c > 32 && c < 127)
@@ -24,15 +26,29 @@ namespace
 		}
 		return false;
 	}
+
+	// Matches isspace() in the "C" locale, which is what sscanf() uses to split "%s".
+	bool isScanWhitespace(const char c)
+	{
+		return c == ' ' || (c >= '\t' && c <= '\r');
+	}
 }
 
-TFE_Parser::TFE_Parser() : m_buffer(nullptr), m_bufferLen(0u), m_enableBlockComments(false), m_blockComment(false), m_enableColonSeperator(false), m_convertToUppercase(false) {}
+TFE_Parser::TFE_Parser() : m_buffer(nullptr), m_bufferLen(0u), m_enableBlockComments(false), m_blockComment(false), m_enableColonSeperator(false), m_convertToUppercase(false), m_whitespaceOnlyTokens(false), m_lineList(false) {}
 TFE_Parser::~TFE_Parser() {}
 
 void TFE_Parser::init(const char* buffer, size_t len)
 {
 	m_buffer = buffer;
 	m_bufferLen = len;
+	m_lineList = false;
+}
+
+void TFE_Parser::initLines(const char* lines, size_t len)
+{
+	m_buffer = lines;
+	m_bufferLen = len;
+	m_lineList = true;
 }
 
 // Enable block comments of the form /*...*/
@@ -59,6 +75,12 @@ void TFE_Parser::convertToUpperCase(bool enable)
 	m_convertToUppercase = enable;
 }
 
+// Split tokens on whitespace only, like a series of "%s" in sscanf().
+void TFE_Parser::enableWhitespaceOnlyTokens(bool enable)
+{
+	m_whitespaceOnlyTokens = enable;
+}
+
 bool TFE_Parser::isComment(const char* buffer)
 {
 	const size_t commentCount = m_commentStrings.size();
@@ -77,6 +99,18 @@ bool TFE_Parser::isComment(const char* buffer)
 const char* TFE_Parser::readLine(size_t& bufferPos, bool skipLeadingWhitespace, bool commentOnlyAtBeginning)
 {
 	if (bufferPos >= m_bufferLen || m_bufferLen < 1) { return nullptr; }
+	if (m_lineList)
+	{
+		const char* line = m_buffer + bufferPos;
+		bufferPos += strlen(line) + 1;
+		if (skipLeadingWhitespace)
+		{
+			const char* content = line;
+			while (*content && isWhitespace(*content)) { content++; }
+			if (*content) { line = content; }
+		}
+		return line;
+	}
 
 	// Keep reading lines until either one has real content or we reach the end of the buffer.
 	bool lineHasContent = false;
@@ -94,7 +128,7 @@ const char* TFE_Parser::readLine(size_t& bufferPos, bool skipLeadingWhitespace,
 			{
 				m_blockComment = false;
 			}
-			else if (m_enableBlockComments && m_buffer[i] == '/' && m_buffer[i+1] == '*')
+			else if (m_enableBlockComments && m_buffer[i] == '/' && i + 1 < m_bufferLen && m_buffer[i+1] == '*')
 			{
 				m_blockComment = true;
 			}
@@ -230,3 +264,168 @@ void TFE_Parser::tokenizeLine(const char* line, TokenList& tokens)
 		tokens.push_back(curToken);
 	}
 }
+
+s32 TFE_Parser::tokenizeLine(const char* line, TokenSpan* tokens, s32 maxTokens)
+{
+	s32 count = 0;
+	const char* tokenStart = nullptr;
+	bool inQuote = false;
+	for (const char* c = line; count < maxTokens; c++)
+	{
+		const char ch = *c;
+		bool split;
+		if (m_whitespaceOnlyTokens)
+		{
+			split = !ch || isScanWhitespace(ch);
+		}
+		else if (inQuote)
+		{
+			// Only the closing quote or the end of the line ends a quoted token.
+			if (ch == '"' || !ch)
+			{
+				tokens[count++] = { tokenStart, u32(c - tokenStart) };
+				tokenStart = nullptr;
+				inQuote = false;
+			}
+			if (!ch) { break; }
+			continue;
+		}
+		else if (ch == '"' && !tokenStart)
+		{
+			inQuote = true;
+			tokenStart = c + 1;
+			continue;
+		}
+		else
+		{
+			split = !ch || isWhitespace(ch) || isSeparator(ch) || (m_enableColonSeperator && ch == ':');
+		}
+
+		if (split)
+		{
+			if (tokenStart)
+			{
+				tokens[count++] = { tokenStart, u32(c - tokenStart) };
+				tokenStart = nullptr;
+			}
+			if (!ch) { break; }
+		}
+		else if (!tokenStart)
+		{
+			tokenStart = c;
+		}
+	}
+	return count;
+}
+
+namespace TFE_Token
+{
+	static const f64 c_pow10[] =
+	{
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	bool equals(const TokenSpan& token, const char* str)
+	{
+		for (u32 i = 0; i < token.len; i++, str++)
+		{
+			if (!*str || toupper(token.str[i]) != toupper(*str)) { return false; }
+		}
+		return *str == 0;
+	}
+
+	void copy(const TokenSpan& token, char* dst, size_t dstSize)
+	{
+		if (!dstSize) { return; }
+		const size_t len = std::min(size_t(token.len), dstSize - 1);
+		memcpy(dst, token.str, len);
+		dst[len] = 0;
+	}
+
+	bool toInt(const TokenSpan& token, s32* value)
+	{
+		u32 i = 0;
+		bool negative = false;
+		if (i < token.len && (token.str[i] == '-' || token.str[i] == '+'))
+		{
+			negative = token.str[i] == '-';
+			i++;
+		}
+
+		const u32 digitStart = i;
+		u32 result = 0;
+		for (; i < token.len && token.str[i] >= '0' && token.str[i] <= '9'; i++)
+		{
+			result = result * 10 + u32(token.str[i] - '0');
+		}
+		if (i == digitStart) { return false; }
+
+		*value = negative ? -s32(result) : s32(result);
+		return true;
+	}
+
+	// Slow path, used for anything the fast path cannot convert exactly.
+	static bool toFloatStrtod(const TokenSpan& token, f32* value)
+	{
+		char buffer[256];
+		copy(token, buffer, sizeof(buffer));
+		char* end = nullptr;
+		const f32 result = strtof(buffer, &end);
+		if (end == buffer) { return false; }
+		*value = result;
+		return true;
+	}
+
+	bool toFloat(const TokenSpan& token, f32* value)
+	{
+		u32 i = 0;
+		bool negative = false;
+		if (i < token.len && (token.str[i] == '-' || token.str[i] == '+'))
+		{
+			negative = token.str[i] == '-';
+			i++;
+		}
+
+		// Read up to 19 significant digits into an integer mantissa.
+		u64 mantissa = 0;
+		s32 digits = 0, exp10 = 0;
+		bool hasDigits = false;
+		for (; i < token.len && token.str[i] >= '0' && token.str[i] <= '9'; i++)
+		{
+			hasDigits = true;
+			if (mantissa || token.str[i] != '0') { digits++; }
+			mantissa = mantissa * 10 + u64(token.str[i] - '0');
+		}
+		if (i < token.len && token.str[i] == '.')
+		{
+			for (i++; i < token.len && token.str[i] >= '0' && token.str[i] <= '9'; i++)
+			{
+				hasDigits = true;
+				if (mantissa || token.str[i] != '0') { digits++; }
+				mantissa = mantissa * 10 + u64(token.str[i] - '0');
+				exp10--;
+			}
+		}
+		if (!hasDigits) { return toFloatStrtod(token, value); }
+		// Exponents, too many digits or values that are not exact in a double go through strtof().
+		if ((i < token.len && (token.str[i] == 'e' || token.str[i] == 'E')) || digits > 15 || exp10 < -22)
+		{
+			return toFloatStrtod(token, value);
+		}
+
+		// Both the mantissa and the power of 10 are exact, so the double is correctly rounded.
+		const f64 result = f64(mantissa) / c_pow10[-exp10];
+		// Rounding to a double and then a float can differ from rounding directly to a float if the double
+		// lands exactly halfway between two floats.
+		u64 bits;
+		memcpy(&bits, &result, sizeof(u64));
+		if ((bits & 0x1fffffffull) == 0x10000000ull)
+		{
+			return toFloatStrtod(token, value);
+		}
+
+		*value = negative ? -f32(result) : f32(result);
+		return true;
+	}
+}
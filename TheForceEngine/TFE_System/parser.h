@@ -10,6 +10,14 @@
 
 typedef std::vector<std::string> TokenList;
 
+// A token that points into the line it was read from, it is not null terminated.
+// Tokens are only valid until the line changes, such as the next call to readLine().
+struct TokenSpan
+{
+	const char* str;
+	u32 len;
+};
+
 class TFE_Parser
 {
 public:
@@ -17,6 +25,9 @@ public:
 	~TFE_Parser();
 
 	void init(const char* buffer, size_t len);
+	// Read lines that were already returned by readLine(), stored back to back as null terminated strings.
+	// readLine() returns them in order without handling comments or case again.
+	void initLines(const char* lines, size_t len);
 
 	// Enable block comments of the form /*...*/
 	void enableBlockComments();
@@ -30,11 +41,18 @@ public:
 	// Convert resulting strings to upper case, defaults to false.
 	void convertToUpperCase(bool enable);
 
+	// Split tokens on whitespace only, like a series of "%s" in sscanf(), so quotes, ',' and '=' are kept.
+	// This only affects the TokenSpan version of tokenizeLine().
+	void enableWhitespaceOnlyTokens(bool enable);
+
 	// Read the next non-comment/whitespace line.
 	const char* readLine(size_t& bufferPos, bool skipLeadingWhitespace = false, bool commentOnlyAtBeginning = false);
 	// Split a line into tokens using space, comma or equals as separators.
 	// Note strings with spaces still work, they need to be closed in quotes, which are removed upon tokenizing.
 	void tokenizeLine(const char* line, TokenList& tokens);
+	// Same as above but without allocating, the tokens point into 'line'. Returns the token count, at most 'maxTokens'.
+	// Quotes are only removed when they surround a whole token.
+	s32  tokenizeLine(const char* line, TokenSpan* tokens, s32 maxTokens);
 
 private:
 	const char* m_buffer;
@@ -44,7 +62,22 @@ private:
 	bool m_blockComment;
 	bool m_enableColonSeperator;
 	bool m_convertToUppercase;
+	bool m_whitespaceOnlyTokens;
+	bool m_lineList;
 
 private:
 	bool isComment(const char* buffer);
 };
+
+// Token conversion helpers, these read a prefix of the token like strtol() and strtod().
+namespace TFE_Token
+{
+	// Case insensitive comparison with a null terminated string.
+	bool equals(const TokenSpan& token, const char* str);
+	// Copy the token as a null terminated string, it is truncated to fit.
+	void copy(const TokenSpan& token, char* dst, size_t dstSize);
+
+	bool toInt(const TokenSpan& token, s32* value);
+	// Produces the same value as sscanf("%f").
+	bool toFloat(const TokenSpan& token, f32* value);
+}
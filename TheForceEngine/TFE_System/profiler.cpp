@@ -1,36 +1,98 @@
 #include <cstring>
 
 #include "profiler.h"
+#include <TFE_FileSystem/filestream.h>
 #include <assert.h>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <map>
-
-// TODO: Support call "paths" - with seperate time per path.
+#include <unordered_map>
 
 namespace TFE_Profiler
 {
 	#define ZONE_BUFFER_COUNT 2
-	#define MAX_ZONE_STACK 256
-	
-	struct Zone
+	#define MAX_ZONE_STACK 64
+	#define MAX_ZONES 1024
+	#define MAX_PROFILE_THREADS 64
+	// Per-thread ring of zone events, must be a power of 2.
+	#define ZONE_EVENT_RING_SIZE 32768
+	#define ZONE_EVENT_RING_MASK (ZONE_EVENT_RING_SIZE - 1)
+	// Call paths that have not been entered for this many frames are hidden.
+	#define ZONE_DISPLAY_FRAMES 120
+
+	enum ZoneEventType : u32
+	{
+		ZEVT_BEGIN = 0,
+		ZEVT_END,
+	};
+
+	// Registered once per call site, never removed.
+	struct ZoneDesc
 	{
-		u32  id;
-		u32  level = 0;
-		u32  parent = NULL_ZONE;
-		u64  path;
-		u64  frame;
 		char name[64];
 		char func[64];
 		u32  lineNumber;
+	};
+
+	struct ZoneEvent
+	{
+		u64 ticks;
+		u32 zone;
+		u32 type;
+	};
+
+	struct OpenZone
+	{
+		u64 ticks;
+		u32 zone;
+		u32 node;
+	};
+
+	struct ThreadState
+	{
+		// Allocated when the thread first records a zone.
+		ZoneEvent* events;
+		std::atomic<u32> write;
+		std::atomic<u32> read;
+		// Written by the owning thread while holding s_registerMutex, then copied to displayName by frameEnd().
+		char name[64];
+		std::atomic<bool> nameChanged;
+		u32  index;
+
+		// Only accessed by the thread running frameEnd().
+		char displayName[64];
+		u32  root;
+		u32  depth;
+		OpenZone stack[MAX_ZONE_STACK];
+	};
+
+	// A zone within a specific call path.
+	struct PathNode
+	{
+		u32  zone;
+		u32  parent;
+		u32  thread;
+		u32  level;
+		u64  frame;
 
 		f64  timeInZone[ZONE_BUFFER_COUNT];
 		f64  timeInZoneAve;
 		f64  fractOfParentAve;
 
-		u32  child = NULL_ZONE;
-		u32  sibling = NULL_ZONE;
+		u32  child;
+		u32  sibling;
+	};
+
+	// Completed zones recorded while capturing a trace.
+	struct TraceSpan
+	{
+		u64 start;
+		u64 end;
+		u32 zone;
+		u32 thread;
 	};
 
 	struct Counter
@@ -43,14 +105,26 @@ namespace TFE_Profiler
 	};
 
 	typedef std::map<std::string, u32> ZoneMap;
-	typedef std::vector<Zone> ZoneList;
+	typedef std::vector<PathNode> PathNodeList;
 	typedef std::vector<u32> SortedZoneList;
 	typedef std::vector<Counter> CounterList;
 
+	static std::mutex s_registerMutex;
 	static ZoneMap  s_zoneMap;
-	static ZoneList s_zoneList;
+	static ZoneDesc s_zones[MAX_ZONES];
+	static std::atomic<u32> s_zoneCount(0);
+
+	static ThreadState* s_threads[MAX_PROFILE_THREADS];
+	static std::atomic<u32> s_threadCount(0);
+	static thread_local ThreadState* s_threadState = nullptr;
+	static ThreadState* s_mainThread = nullptr;
+	static std::atomic<bool> s_recording(false);
+	static std::atomic<s32> s_droppedEvents(0);
+	static bool s_enabled = false;
+
+	static PathNodeList s_nodes;
+	static std::unordered_map<u64, u32> s_nodeMap;
 	static SortedZoneList s_sortedZoneList;
-	static SortedZoneList s_roots;
 
 	static ZoneMap  s_counterMap;
 	static CounterList s_counterList;
@@ -59,101 +133,102 @@ namespace TFE_Profiler
 	static f64 s_frameTime;
 	static u32 s_readBuffer = 0;
 	static u32 s_writeBuffer = 1;
-	static u32 s_level;
-	static u32 s_maxLevel;
-	static u32 s_zoneStack[MAX_ZONE_STACK];
 	static u64 s_currentFrame = 1;
-	static u64 s_currentPath;
 
-	void addZoneChild(u32 parentId, u32 zoneId)
+	static u32 s_traceFramesLeft = 0;
+	static char s_tracePath[TFE_MAX_PATH];
+	static std::vector<TraceSpan> s_traceSpans;
+
+	void writeTrace();
+
+	u32 registerZone(const char* name, const char* func, u32 lineNumber)
 	{
-		Zone& parent = s_zoneList[parentId];
-		Zone& zone = s_zoneList[zoneId];
-		// This has already been added.
-		if (zone.sibling != NULL_ZONE)
+		std::lock_guard<std::mutex> lock(s_registerMutex);
+		ZoneMap::iterator iZone = s_zoneMap.find(name);
+		if (iZone != s_zoneMap.end())
 		{
-			return;
+			return iZone->second;
 		}
 
-		if (parent.child == zoneId)
-		{
-			return;
-		}
-		else if (parent.child == NULL_ZONE)
-		{
-			parent.child = zoneId;
-		}
-		else
-		{
-			Zone* child = &s_zoneList[parent.child];
-			while (1)
-			{
-				if (child->sibling == zoneId)
-				{
-					return;
-				}
-				else if (child->sibling == NULL_ZONE)
-				{
-					child->sibling = zoneId;
-					break;
-				}
-				child = &s_zoneList[child->sibling];
-			};
-		}
+		const u32 id = s_zoneCount.load();
+		if (id >= MAX_ZONES) { return NULL_ZONE; }
+
+		ZoneDesc* zone = &s_zones[id];
+		strncpy(zone->name, name, sizeof(zone->name) - 1);
+		strncpy(zone->func, func, sizeof(zone->func) - 1);
+		zone->lineNumber = lineNumber;
+		s_zoneMap[name] = id;
+		s_zoneCount.store(id + 1);
+		return id;
 	}
 
-	u32 beginZone(const char* name, const char* func, u32 lineNumber)
+	ThreadState* getThreadState()
 	{
-		ZoneMap::iterator iZone = s_zoneMap.find(name);
-		u32 id = 0;
+		if (s_threadState) { return s_threadState; }
+
+		std::lock_guard<std::mutex> lock(s_registerMutex);
+		const u32 index = s_threadCount.load();
+		if (index >= MAX_PROFILE_THREADS) { return nullptr; }
+
+		ThreadState* thread = new ThreadState();
+		thread->events = nullptr;
+		thread->write.store(0);
+		thread->read.store(0);
+		sprintf(thread->name, "Thread %u", index);
+		strcpy(thread->displayName, thread->name);
+		thread->nameChanged.store(false);
+		thread->index = index;
+		thread->root = NULL_ZONE;
+		thread->depth = 0;
+
+		s_threads[index] = thread;
+		s_threadCount.store(index + 1);
+		s_threadState = thread;
+		return thread;
+	}
 
-		if (iZone == s_zoneMap.end())
-		{
-			id = (u32)s_zoneList.size();
-
-			Zone zone;
-			zone.id = id;
-			zone.path = s_currentPath;
-			zone.timeInZone[s_readBuffer]  = 0;
-			zone.timeInZone[s_writeBuffer] = 0;
-			zone.timeInZoneAve = 0.0;
-			zone.fractOfParentAve = 0.0;
-			zone.frame = 0;
-			
-			s_zoneList.push_back(zone);
-			s_zoneMap[name] = id;
-		}
-		else
+	void setThreadName(const char* name)
+	{
+		ThreadState* thread = getThreadState();
+		if (thread && strcmp(thread->name, name) != 0)
 		{
-			id = iZone->second;
+			std::lock_guard<std::mutex> lock(s_registerMutex);
+			strncpy(thread->name, name, sizeof(thread->name) - 1);
+			thread->nameChanged.store(true, std::memory_order_release);
 		}
+	}
 
-		Zone& zone = s_zoneList[id];
-		strcpy(zone.name, name);
-		strcpy(zone.func, func);
-		zone.lineNumber = lineNumber;
-		zone.level = s_level;
-
-		zone.parent = s_level > 0 ? s_zoneStack[s_level - 1] : NULL_ZONE;
-		if (zone.parent == NULL_ZONE)
+	static void pushEvent(u32 id, u32 type)
+	{
+		if (!s_recording.load(std::memory_order_relaxed) || id == NULL_ZONE) { return; }
+		ThreadState* thread = getThreadState();
+		if (!thread) { return; }
+		if (!thread->events)
 		{
-			s_roots.push_back(id);
+			thread->events = new ZoneEvent[ZONE_EVENT_RING_SIZE];
 		}
-		else
+
+		const u32 write = thread->write.load(std::memory_order_relaxed);
+		if (write - thread->read.load(std::memory_order_acquire) >= ZONE_EVENT_RING_SIZE)
 		{
-			addZoneChild(zone.parent, zone.id);
+			s_droppedEvents++;
+			return;
 		}
+		ZoneEvent* evt = &thread->events[write & ZONE_EVENT_RING_MASK];
+		evt->ticks = TFE_System::getCurrentTimeInTicks();
+		evt->zone = id;
+		evt->type = type;
+		thread->write.store(write + 1, std::memory_order_release);
+	}
 
-		s_zoneStack[s_level] = id;
-		s_level++;
-
-		return id;
+	void beginZone(u32 id)
+	{
+		pushEvent(id, ZEVT_BEGIN);
 	}
 
-	void endZone(u32 id, u64 dt)
+	void endZone(u32 id)
 	{
-		s_zoneList[id].timeInZone[s_writeBuffer] += TFE_System::convertFromTicksToSeconds(dt);
-		s_level--;
+		pushEvent(id, ZEVT_END);
 	}
 
 	void addCounter(const char* name, s32* counter)
@@ -174,6 +249,125 @@ namespace TFE_Profiler
 		}
 	}
 
+	static void updateRecording()
+	{
+		s_recording.store(s_enabled || s_traceFramesLeft > 0);
+	}
+
+	void setEnabled(bool enable)
+	{
+		s_enabled = enable;
+		updateRecording();
+	}
+
+	bool beginTraceCapture(u32 frameCount, const char* path)
+	{
+		if (!frameCount || s_traceFramesLeft) { return false; }
+		strcpy(s_tracePath, path);
+		s_traceSpans.clear();
+		s_traceFramesLeft = frameCount;
+		updateRecording();
+		return true;
+	}
+
+	u32 addNode(u32 parent, u32 zone, u32 thread, u32 level)
+	{
+		const u32 id = (u32)s_nodes.size();
+		PathNode node = {};
+		node.zone = zone;
+		node.parent = parent;
+		node.thread = thread;
+		node.level = level;
+		node.child = NULL_ZONE;
+		node.sibling = NULL_ZONE;
+		s_nodes.push_back(node);
+
+		// Link into the parent's child list, children are kept in the order they are first seen.
+		if (parent != NULL_ZONE)
+		{
+			u32* link = &s_nodes[parent].child;
+			while (*link != NULL_ZONE)
+			{
+				link = &s_nodes[*link].sibling;
+			}
+			*link = id;
+		}
+		return id;
+	}
+
+	u32 getPathNode(ThreadState* thread, u32 parent, u32 zone)
+	{
+		const u64 key = (u64(parent) << 32ull) | u64(zone);
+		std::unordered_map<u64, u32>::const_iterator iNode = s_nodeMap.find(key);
+		if (iNode != s_nodeMap.end())
+		{
+			return iNode->second;
+		}
+
+		// Zones on the main thread start at level 0, other threads are grouped under a root node.
+		const u32 level = parent == NULL_ZONE ? 0 : s_nodes[parent].level + (parent == s_mainThread->root ? 0 : 1);
+		const u32 id = addNode(parent, zone, thread->index, level);
+		s_nodeMap[key] = id;
+		return id;
+	}
+
+	void closeZone(ThreadState* thread, u64 ticks)
+	{
+		thread->depth--;
+		const OpenZone* open = &thread->stack[thread->depth];
+		PathNode* node = &s_nodes[open->node];
+		node->timeInZone[s_writeBuffer] += TFE_System::convertFromTicksToSeconds(ticks - open->ticks);
+		node->frame = s_currentFrame;
+
+		if (s_traceFramesLeft)
+		{
+			s_traceSpans.push_back({ open->ticks, ticks, open->zone, thread->index });
+		}
+	}
+
+	// Read the events recorded by a thread since the last frame.
+	void processThreadEvents(ThreadState* thread)
+	{
+		const u32 write = thread->write.load(std::memory_order_acquire);
+		u32 read = thread->read.load(std::memory_order_relaxed);
+		if (read == write) { return; }
+
+		if (thread->root == NULL_ZONE)
+		{
+			thread->root = addNode(NULL_ZONE, NULL_ZONE, thread->index, 0);
+		}
+
+		for (; read != write; read++)
+		{
+			const ZoneEvent* evt = &thread->events[read & ZONE_EVENT_RING_MASK];
+			if (evt->type == ZEVT_BEGIN)
+			{
+				if (thread->depth >= MAX_ZONE_STACK) { continue; }
+				const u32 parent = thread->depth ? thread->stack[thread->depth - 1].node : thread->root;
+				OpenZone* open = &thread->stack[thread->depth];
+				open->ticks = evt->ticks;
+				open->zone = evt->zone;
+				open->node = getPathNode(thread, parent, evt->zone);
+				thread->depth++;
+			}
+			else
+			{
+				// Events may have been dropped or recording enabled mid-zone,
+				// so close everything above the matching zone and ignore unmatched ends.
+				s32 match = -1;
+				for (s32 i = s32(thread->depth) - 1; i >= 0; i--)
+				{
+					if (thread->stack[i].zone == evt->zone) { match = i; break; }
+				}
+				while (match >= 0 && thread->depth > u32(match))
+				{
+					closeZone(thread, evt->ticks);
+				}
+			}
+		}
+		thread->read.store(write, std::memory_order_release);
+	}
+
 	void frameBegin()
 	{
 		std::swap(s_readBuffer, s_writeBuffer);
@@ -182,15 +376,19 @@ namespace TFE_Profiler
 		s_readBuffer  %= ZONE_BUFFER_COUNT;
 		s_writeBuffer %= ZONE_BUFFER_COUNT;
 
-		s_level = 0;
-		s_maxLevel = 0;
-		s_roots.clear();
+		// Frames are driven from the main thread.
+		if (!s_mainThread)
+		{
+			s_mainThread = getThreadState();
+			s_mainThread->root = addNode(NULL_ZONE, NULL_ZONE, s_mainThread->index, 0);
+			setThreadName("Main");
+		}
 
 		// Swap buffers, s_readBuffer is safe to read in the middle of the next frame.
-		const size_t zoneCount = s_zoneList.size();
-		for (size_t i = 0; i < zoneCount; i++)
+		const size_t nodeCount = s_nodes.size();
+		for (size_t i = 0; i < nodeCount; i++)
 		{
-			s_zoneList[i].timeInZone[s_writeBuffer] = 0;
+			s_nodes[i].timeInZone[s_writeBuffer] = 0;
 		}
 
 		// Copy counter values from the frame, so that the results can be used
@@ -206,66 +404,152 @@ namespace TFE_Profiler
 
 	void traverseZoneTree(u32 id)
 	{
-		if (id == NULL_ZONE) { return; }
-		Zone* zone = &s_zoneList[id];
-		// Make sure zones are only inserted once for now.
-		if (zone->frame != s_currentFrame)
+		for (; id != NULL_ZONE; id = s_nodes[id].sibling)
 		{
+			const PathNode* node = &s_nodes[id];
+			if (node->frame + ZONE_DISPLAY_FRAMES < s_currentFrame) { continue; }
+
 			s_sortedZoneList.push_back(id);
+			traverseZoneTree(node->child);
 		}
-		zone->frame = s_currentFrame;
-		
-		while (zone->child != NULL_ZONE)
+	}
+
+	void frameEnd()
+	{
+		if (!s_mainThread) { return; }
+		const u64 frameEndTicks = TFE_System::getCurrentTimeInTicks();
+		s_frameTime = TFE_System::convertFromTicksToSeconds(frameEndTicks - s_frameBegin);
+
+		const u32 threadCount = s_threadCount.load();
+		for (u32 t = 0; t < threadCount; t++)
 		{
-			traverseZoneTree(zone->child);
-			zone = &s_zoneList[zone->child];
+			// Threads can be renamed at any time, so the name used by the views and traces is copied under the lock.
+			if (s_threads[t]->nameChanged.exchange(false, std::memory_order_acquire))
+			{
+				std::lock_guard<std::mutex> lock(s_registerMutex);
+				strcpy(s_threads[t]->displayName, s_threads[t]->name);
+			}
+			processThreadEvents(s_threads[t]);
 		}
 
-		zone = &s_zoneList[id];
-		while (zone->sibling != NULL_ZONE)
+		// The time of the thread root nodes is the time spent in their top level zones.
+		const size_t nodeCount = s_nodes.size();
+		for (u32 t = 0; t < threadCount; t++)
 		{
-			traverseZoneTree(zone->sibling);
-			zone = &s_zoneList[zone->sibling];
+			const u32 root = s_threads[t]->root;
+			if (root == NULL_ZONE || s_threads[t] == s_mainThread) { continue; }
+
+			f64 time = 0.0;
+			for (u32 child = s_nodes[root].child; child != NULL_ZONE; child = s_nodes[child].sibling)
+			{
+				time += s_nodes[child].timeInZone[s_writeBuffer];
+				s_nodes[root].frame = std::max(s_nodes[root].frame, s_nodes[child].frame);
+			}
+			s_nodes[root].timeInZone[s_writeBuffer] = time;
 		}
-	}
 
-	void frameEnd()
-	{
-		s_frameTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - s_frameBegin);
-		const size_t zoneCount = s_zoneList.size();
+		// Compute the averages.
 		const f64 expBlend = 0.99;
+		for (size_t i = 0; i < nodeCount; i++)
+		{
+			PathNode* node = &s_nodes[i];
+			node->timeInZoneAve = expBlend * node->timeInZoneAve + (1.0 - expBlend)*node->timeInZone[s_writeBuffer];
+
+			const bool parentIsFrame = node->parent == NULL_ZONE || node->parent == s_mainThread->root;
+			const f64 parentTime = parentIsFrame ? s_frameTime : s_nodes[node->parent].timeInZone[s_writeBuffer];
+			// Skip the update when the parent time is 0, otherwise the average becomes NAN and never recovers.
+			if (parentTime > 0.0)
+			{
+				node->fractOfParentAve = expBlend * node->fractOfParentAve + (1.0 - expBlend)*node->timeInZone[s_writeBuffer] / parentTime;
+			}
+		}
 
-		// Sort Zones
+		// Sort zones by call path, the main thread first and then the other threads.
 		s_sortedZoneList.clear();
-		const size_t rootCount = s_roots.size();
-		for (size_t r = 0; r < rootCount; r++)
+		traverseZoneTree(s_nodes[s_mainThread->root].child);
+		for (u32 t = 0; t < threadCount; t++)
+		{
+			const u32 root = s_threads[t]->root;
+			if (root == NULL_ZONE || s_threads[t] == s_mainThread || s_nodes[root].frame + ZONE_DISPLAY_FRAMES < s_currentFrame) { continue; }
+
+			s_sortedZoneList.push_back(root);
+			traverseZoneTree(s_nodes[root].child);
+		}
+
+		if (s_traceFramesLeft)
+		{
+			s_traceSpans.push_back({ s_frameBegin, frameEndTicks, NULL_ZONE, s_mainThread->index });
+			s_traceFramesLeft--;
+			if (!s_traceFramesLeft)
+			{
+				writeTrace();
+				updateRecording();
+			}
+		}
+
+		s_currentFrame++;
+	}
+
+	void writeJsonString(FileStream* file, const char* str)
+	{
+		char escaped[256];
+		u32 len = 0;
+		for (; *str && len < sizeof(escaped) - 2; str++)
+		{
+			if (*str == '"' || *str == '\\') { escaped[len++] = '\\'; }
+			escaped[len++] = *str;
+		}
+		escaped[len] = 0;
+		file->writeString("\"%s\"", escaped);
+	}
+
+	// Write the captured spans in the Chrome trace event format, which can be loaded
+	// by chrome://tracing or ui.perfetto.dev.
+	void writeTrace()
+	{
+		FileStream file;
+		if (!file.open(s_tracePath, Stream::MODE_WRITE))
 		{
-			traverseZoneTree(s_roots[r]);
+			TFE_System::logWrite(LOG_ERROR, "Profiler", "Cannot write the trace '%s'.", s_tracePath);
+			s_traceSpans.clear();
+			return;
 		}
 
-		// First compute delta times for each zone.
-		for (size_t i = 0; i < zoneCount; i++)
+		file.writeString("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+		const u32 threadCount = s_threadCount.load();
+		for (u32 t = 0; t < threadCount; t++)
 		{
-			s_zoneList[i].timeInZoneAve = expBlend * s_zoneList[i].timeInZoneAve + (1.0 - expBlend)*s_zoneList[i].timeInZone[s_writeBuffer];
+			file.writeString("{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":", t);
+			writeJsonString(&file, s_threads[t]->displayName);
+			file.writeString("}},\n");
 		}
 
-		// Then handle percentage of parent and clear
-		for (size_t i = 0; i < zoneCount; i++)
+		const size_t spanCount = s_traceSpans.size();
+		const TraceSpan* span = s_traceSpans.data();
+		for (size_t i = 0; i < spanCount; i++, span++)
 		{
-			f64 parentTime = (s_zoneList[i].parent != NULL_ZONE) ? s_zoneList[s_zoneList[i].parent].timeInZone[s_writeBuffer] : s_frameTime;
-			s_zoneList[i].fractOfParentAve = expBlend * s_zoneList[i].fractOfParentAve + (1.0 - expBlend)*s_zoneList[i].timeInZone[s_writeBuffer] / parentTime;
-			// Handle the rare case the parentTime = 0 causing s_zoneList[i].fractOfParentAve to become NAN. Once that happens it will never fix itself
-			// because we are doing an average. So fix it manually.
-			if (isnan(s_zoneList[i].fractOfParentAve))
+			const f64 start = TFE_System::convertFromTicksToSeconds(span->start) * 1000000.0;
+			const f64 duration = TFE_System::convertFromTicksToSeconds(span->end - span->start) * 1000000.0;
+			file.writeString("{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":", span->thread, start, duration);
+			if (span->zone == NULL_ZONE)
 			{
-				s_zoneList[i].fractOfParentAve = 0.0;
+				file.writeString("\"Frame\",\"cat\":\"frame\"}");
 			}
-
-			s_zoneList[i].child = NULL_ZONE;
-			s_zoneList[i].sibling = NULL_ZONE;
+			else
+			{
+				const ZoneDesc* zone = &s_zones[span->zone];
+				writeJsonString(&file, zone->name);
+				file.writeString(",\"cat\":\"zone\",\"args\":{\"func\":");
+				writeJsonString(&file, zone->func);
+				file.writeString(",\"line\":%u}}", zone->lineNumber);
+			}
+			file.writeString(i + 1 < spanCount ? ",\n" : "\n");
 		}
+		file.writeString("]}\n");
+		file.close();
 
-		s_currentFrame++;
+		TFE_System::logWrite(LOG_MSG, "Profiler", "Wrote %u zones to the trace '%s', %d events were dropped.", (u32)spanCount, s_tracePath, s_droppedEvents.load());
+		s_traceSpans.clear();
 	}
 
 	u32 getZoneCount()
@@ -277,15 +561,26 @@ namespace TFE_Profiler
 	{
 		if (index >= (u32)s_sortedZoneList.size()) { return; }
 
-		Zone& zone = s_zoneList[s_sortedZoneList[index]];
-		info->name = zone.name;
-		info->func = zone.func;
-		info->level = zone.level;
-		info->lineNumber = zone.lineNumber;
-		info->timeInZone = zone.timeInZone[s_readBuffer];
-		info->timeInZoneAve = zone.timeInZoneAve;
-		info->fractOfParentAve = zone.fractOfParentAve;
-		info->parentId = zone.parent;
+		const PathNode& node = s_nodes[s_sortedZoneList[index]];
+		if (node.zone == NULL_ZONE)
+		{
+			// Thread root.
+			info->name = s_threads[node.thread]->displayName;
+			info->func = "";
+			info->lineNumber = 0;
+		}
+		else
+		{
+			const ZoneDesc& zone = s_zones[node.zone];
+			info->name = zone.name;
+			info->func = zone.func;
+			info->lineNumber = zone.lineNumber;
+		}
+		info->level = node.level;
+		info->timeInZone = node.timeInZone[s_readBuffer];
+		info->timeInZoneAve = node.timeInZoneAve;
+		info->fractOfParentAve = node.fractOfParentAve;
+		info->parentId = node.parent;
 	}
 
 	f64 getTimeInFrame()
@@ -3,7 +3,12 @@
 // The Force Engine Profiler
 // Simple "zone" based profiler.
 // Add TFE_PROFILE_ENABLED to preprocessor defines in the build to enable.
-// Currently does not respect the call path, that is TODO.
+//
+// Zones are registered once per call site, entering or leaving a zone
+// writes a timestamp into a per-thread ring buffer. The rings are read
+// at the end of each frame, where times are accumulated per call path.
+// Zones are only recorded while the profiler view is open or a trace
+// is being captured.
 //////////////////////////////////////////////////////////////////////
 
 #include "types.h"
@@ -14,9 +19,12 @@
 #define TOKENPASTE(x, y) x ## y
 #define TOKENPASTE2(x, y) TOKENPASTE(x, y)
 #ifdef  TFE_PROFILE_ENABLED
-#define TFE_ZONE(name)  TFE_Profiler_Zone TOKENPASTE2(__localZone, __LINE__)(name, __FUNCTION__, __LINE__)
-#define TFE_ZONE_BEGIN(varName, name)  TFE_Profiler_ZoneManual varName(name, __FUNCTION__, __LINE__)
+#define TFE_ZONE(name)  static const u32 TOKENPASTE2(__zoneId, __LINE__) = TFE_Profiler::registerZone(name, __FUNCTION__, __LINE__); \
+						TFE_Profiler_Zone TOKENPASTE2(__localZone, __LINE__)(TOKENPASTE2(__zoneId, __LINE__))
+#define TFE_ZONE_BEGIN(varName, name)  static const u32 TOKENPASTE2(varName, _zoneId) = TFE_Profiler::registerZone(name, __FUNCTION__, __LINE__); \
+						TFE_Profiler_ZoneManual varName(TOKENPASTE2(varName, _zoneId))
 #define TFE_ZONE_END(varName)  varName.end()
+#define TFE_THREAD_NAME(name) TFE_Profiler::setThreadName(name)
 #define TFE_FRAME_BEGIN() TFE_Profiler::frameBegin()
 #define TFE_FRAME_END() TFE_Profiler::frameEnd()
 #define TFE_COUNTER(varName, name) TFE_Profiler::addCounter(name, &varName)
@@ -24,6 +32,7 @@
 #define TFE_ZONE(name)
 #define TFE_ZONE_BEGIN(varName, name)
 #define TFE_ZONE_END(varName)
+#define TFE_THREAD_NAME(name)
 #define TFE_FRAME_BEGIN()
 #define TFE_FRAME_END()
 #define TFE_COUNTER(varName, name)
@@ -34,8 +43,8 @@
 #ifdef TFE_PROFILE_ENABLED
 struct TFE_ZoneInfo
 {
-	char* name;
-	char* func;
+	const char* name;
+	const char* func;
 	u32  lineNumber;
 	u32  level;
 	u32  parentId;
@@ -53,20 +62,31 @@ struct TFE_CounterInfo
 namespace TFE_Profiler
 {
 	// The main profiling API is used through Macros which can be disabled based on build flags.
-	u32  beginZone(const char* name, const char* func, u32 lineNumber);
-	void endZone(u32 id, u64 dt);
-		
+	// Zones with the same name share an id.
+	u32  registerZone(const char* name, const char* func, u32 lineNumber);
+	void beginZone(u32 id);
+	void endZone(u32 id);
+	// Name the calling thread in the profiler view and traces.
+	void setThreadName(const char* name);
+
 	void frameBegin();
 	void frameEnd();
 
 	void addCounter(const char* name, s32* counter);
 
+	// Zones are only recorded while enabled (the profiler view is open) or a trace is being captured.
+	void setEnabled(bool enable);
+	// Capture the zones from the next 'frameCount' frames and write them to 'path'
+	// in the Chrome trace event format (which Perfetto can also open).
+	bool beginTraceCapture(u32 frameCount, const char* path);
+
 	// Profile data API, this is used directly.
 	f64  getTimeInFrame();
 
+	// Zones are listed per call path, in depth first order.
 	u32  getZoneCount();
 	void getZoneInfo(u32 index, TFE_ZoneInfo* info);
-	
+
 	u32  getCounterCount();
 	void getCounterInfo(u32 index, TFE_CounterInfo* info);
 }
@@ -74,38 +94,32 @@ namespace TFE_Profiler
 class TFE_Profiler_Zone
 {
 public:
-	TFE_Profiler_Zone(const char* name, const char* func, u32 lineNumber)
+	TFE_Profiler_Zone(u32 id) : m_id(id)
 	{
-		m_time = TFE_System::getCurrentTimeInTicks();
-		m_id = TFE_Profiler::beginZone(name, func, lineNumber);
+		TFE_Profiler::beginZone(id);
 	}
 
 	~TFE_Profiler_Zone()
 	{
-		const u64 deltaTime = TFE_System::getCurrentTimeInTicks() - m_time;
-		TFE_Profiler::endZone(m_id, deltaTime);
+		TFE_Profiler::endZone(m_id);
 	}
 private:
-	u64 m_time;
-	s32 m_id;
+	u32 m_id;
 };
 
 class TFE_Profiler_ZoneManual
 {
 public:
-	TFE_Profiler_ZoneManual(const char* name, const char* func, u32 lineNumber)
+	TFE_Profiler_ZoneManual(u32 id) : m_id(id)
 	{
-		m_time = TFE_System::getCurrentTimeInTicks();
-		m_id = TFE_Profiler::beginZone(name, func, lineNumber);
+		TFE_Profiler::beginZone(id);
 	}
 
 	void end()
 	{
-		const u64 deltaTime = TFE_System::getCurrentTimeInTicks() - m_time;
-		TFE_Profiler::endZone(m_id, deltaTime);
+		TFE_Profiler::endZone(m_id);
 	}
 private:
-	u64 m_time;
-	s32 m_id;
+	u32 m_id;
 };
 #endif